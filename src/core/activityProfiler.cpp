@@ -0,0 +1,264 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "activityProfiler.hpp"
+
+#include <algorithm>
+#include <map>
+
+#include <core/component.hpp>
+#include <core/wire.hpp>
+
+namespace {
+std::string escape(const std::string_view s)
+{
+  std::string res{};
+  for (const char c : s) {
+    if (c == '"' || c == '\\')
+      res += '\\';
+    res += c;
+  }
+  return res;
+}
+
+// The keys of `map` in the order given by `order` of their values
+template <typename Map>
+auto inOrder(const Map& map)
+{
+  std::vector<const typename Map::value_type*> res(map.size());
+  for (const auto& entry : map)
+    res[entry.second.order] = &entry;
+  return res;
+}
+
+double toSeconds(const auto duration)
+{
+  return std::chrono::duration<double>(duration).count();
+}
+}  // namespace
+
+thread_local ActivityProfiler* ActivityProfiler::active = nullptr;
+
+ActivityProfiler::~ActivityProfiler()
+{
+  stop();
+}
+
+void ActivityProfiler::start()
+{
+  active = this;
+}
+
+void ActivityProfiler::stop()
+{
+  if (active == this)
+    active = nullptr;
+}
+
+void ActivityProfiler::clear()
+{
+  components.clear();
+  wires.clear();
+  eventsPerDelta.clear();
+  maxEvaluations = 0;
+  maxToggles     = 0;
+}
+
+uint64_t ActivityProfiler::getEvaluations(const Component* component) const
+{
+  const auto it = components.find(component);
+  return it == components.end() ? 0 : it->second.evaluations;
+}
+
+uint64_t ActivityProfiler::getToggles(const Wire* wire) const
+{
+  const auto it = wires.find(wire);
+  return it == wires.end() ? 0 : it->second.toggles;
+}
+
+void ActivityProfiler::propagate(const Wire*                         wire,
+                                 const std::span<const UpdateAction> actions)
+{
+  auto& w    = wires.try_emplace(wire, WireActivity{0, wires.size()}).first->second;
+  maxToggles = std::max(maxToggles, ++w.toggles);
+
+  if (eventsPerDelta.size() <= depth)
+    eventsPerDelta.resize(depth + 1);
+  eventsPerDelta[depth]++;
+
+  depth++;
+
+  for (const auto& [action, owner] : actions) {
+    if (!action)
+      continue;
+
+    ComponentActivity* activity = nullptr;
+    if (owner) {
+      auto it = components.find(owner);
+      if (it == components.end())
+        it = components.emplace(owner, ComponentActivity{owner->getName(), 0, {},
+                                                         components.size()})
+                 .first;
+      activity = &it->second;
+    }
+
+    childTime.emplace_back();
+    const auto start = Clock::now();
+
+    (*action)();
+
+    const auto elapsed = Clock::now() - start;
+    const auto own     = elapsed - childTime.back();
+    childTime.pop_back();
+
+    if (!childTime.empty())
+      childTime.back() += elapsed;
+
+    if (activity) {
+      activity->time += own;
+      maxEvaluations = std::max(maxEvaluations, ++activity->evaluations);
+    }
+  }
+
+  depth--;
+}
+
+std::vector<ComponentTypeActivity> ActivityProfiler::getTypes() const
+{
+  std::map<std::string_view, ComponentTypeActivity> types{};
+
+  for (const auto& [component, activity] : components) {
+    auto& t = types[activity.type];
+    t.type  = activity.type;
+    t.components++;
+    t.evaluations += activity.evaluations;
+    t.seconds += toSeconds(activity.time);
+  }
+
+  std::vector<ComponentTypeActivity> res{};
+  for (auto& [name, t] : types)
+    res.push_back(std::move(t));
+
+  std::ranges::stable_sort(res, std::greater{}, &ComponentTypeActivity::seconds);
+  return res;
+}
+
+void ActivityProfiler::writeCsv(std::ostream& out) const
+{
+  const auto types           = getTypes();
+  const auto componentsInOrder = inOrder(components);
+  const auto wiresInOrder      = inOrder(wires);
+
+  out << "kind,index,name,count,seconds\n";
+
+  for (const auto& [i, t] : types | silicon::views::enumerate)
+    out << "type," << i << ',' << t.type << ',' << t.evaluations << ',' << t.seconds
+        << '\n';
+
+  for (const auto& [delta, events] : eventsPerDelta | silicon::views::enumerate)
+    out << "delta," << delta << ",," << events << ",\n";
+
+  for (const auto& [i, entry] : componentsInOrder | silicon::views::enumerate)
+    out << "component," << i << ',' << entry->second.type << ','
+        << entry->second.evaluations << ',' << toSeconds(entry->second.time) << '\n';
+
+  for (const auto& [i, entry] : wiresInOrder | silicon::views::enumerate)
+    out << "wire," << i << ",," << entry->second.toggles << ",\n";
+}
+
+void ActivityProfiler::writeJson(std::ostream& out) const
+{
+  const auto types           = getTypes();
+  const auto componentsInOrder = inOrder(components);
+  const auto wiresInOrder      = inOrder(wires);
+
+  out << "{\n  \"types\": [";
+  for (const auto& [i, t] : types | silicon::views::enumerate)
+    out << (i ? ",\n    " : "\n    ") << "{\"type\": \"" << escape(t.type)
+        << "\", \"components\": " << t.components << ", \"evaluations\": "
+        << t.evaluations << ", \"seconds\": " << t.seconds << '}';
+
+  out << "],\n  \"eventsPerDelta\": [";
+  for (const auto& [i, events] : eventsPerDelta | silicon::views::enumerate)
+    out << (i ? ", " : "") << events;
+
+  out << "],\n  \"components\": [";
+  for (const auto& [i, entry] : componentsInOrder | silicon::views::enumerate)
+    out << (i ? ",\n    " : "\n    ") << "{\"type\": \"" << escape(entry->second.type)
+        << "\", \"evaluations\": " << entry->second.evaluations
+        << ", \"seconds\": " << toSeconds(entry->second.time) << '}';
+
+  out << "],\n  \"wireToggles\": [";
+  for (const auto& [i, entry] : wiresInOrder | silicon::views::enumerate)
+    out << (i ? ", " : "") << entry->second.toggles;
+
+  out << "]\n}\n";
+}
+
+/* SIMULATOR */
+
+void SimulatorProfile::writeCsv(std::ostream& out, const Netlist& netlist) const
+{
+  out << "kind,index,name,count,seconds\n";
+
+  for (size_t t = 0; t < GATE_TYPES; t++)
+    if (typeEvaluations[t] > 0)
+      out << "type," << t << ',' << to_str(static_cast<GateType>(t)) << ','
+          << typeEvaluations[t] << ',' << toSeconds(typeTime[t]) << '\n';
+
+  for (const auto& [delta, events] : eventsPerDelta | silicon::views::enumerate)
+    out << "delta," << delta << ",," << events << ",\n";
+
+  for (const auto& [g, evaluations] : gateEvaluations | silicon::views::enumerate)
+    out << "gate," << g << ',' << to_str(netlist.getGateType(g)) << ',' << evaluations
+        << ",\n";
+
+  for (const auto& [n, toggles] : netToggles | silicon::views::enumerate)
+    out << "net," << n << ',' << netlist.getNetName(n) << ',' << toggles << ",\n";
+}
+
+void SimulatorProfile::writeJson(std::ostream& out, const Netlist& netlist) const
+{
+  out << "{\n  \"types\": [";
+
+  bool first = true;
+  for (size_t t = 0; t < GATE_TYPES; t++) {
+    if (typeEvaluations[t] == 0)
+      continue;
+
+    out << (first ? "\n    " : ",\n    ") << "{\"type\": \""
+        << to_str(static_cast<GateType>(t)) << "\", \"evaluations\": "
+        << typeEvaluations[t] << ", \"seconds\": " << toSeconds(typeTime[t]) << '}';
+    first = false;
+  }
+
+  out << "],\n  \"eventsPerDelta\": [";
+  for (const auto& [i, events] : eventsPerDelta | silicon::views::enumerate)
+    out << (i ? ", " : "") << events;
+
+  out << "],\n  \"gateEvaluations\": [";
+  for (const auto& [i, evaluations] : gateEvaluations | silicon::views::enumerate)
+    out << (i ? ", " : "") << evaluations;
+
+  out << "],\n  \"nets\": [";
+  for (const auto& [n, toggles] : netToggles | silicon::views::enumerate)
+    out << (n ? ",\n    " : "\n    ") << "{\"name\": \""
+        << escape(netlist.getNetName(n)) << "\", \"toggles\": " << toggles << '}';
+
+  out << "]\n}\n";
+}
@@ -0,0 +1,136 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <core/netlist.hpp>
+
+/* Where the time of a simulation goes.
+ *
+ * An ActivityProfiler records the circuits made of Components and Wires on the thread
+ * that started it: the evaluations of every component, the toggles of every wire, the
+ * time spent in every type of component (excluding the components it triggered) and the
+ * number of wire changes at every delta cycle, i.e. at every depth of the propagation
+ * started by a change from the outside. When no profiler is running, a wire change only
+ * tests a thread-local pointer.
+ *
+ * A Simulator keeps a SimulatorProfile of its gates and nets instead, see
+ * Simulator::setProfiling(). */
+
+class Component;
+class Wire;
+struct UpdateAction;
+
+struct ComponentTypeActivity {
+  std::string type;
+  uint64_t    components  = 0;
+  uint64_t    evaluations = 0;
+  double      seconds     = 0;
+};
+
+class ActivityProfiler {
+public:
+  ActivityProfiler() = default;
+  ~ActivityProfiler();
+
+  ActivityProfiler(const ActivityProfiler&)            = delete;
+  ActivityProfiler& operator=(const ActivityProfiler&) = delete;
+
+  // Only one profiler at a time records a thread
+  void start();
+  void stop();
+  void clear();
+
+  [[nodiscard]] bool isRunning() const { return current() == this; }
+
+  [[nodiscard]] static ActivityProfiler* current() { return active; }
+
+  [[nodiscard]] uint64_t getEvaluations(const Component* component) const;
+  [[nodiscard]] uint64_t getToggles(const Wire* wire) const;
+  [[nodiscard]] uint64_t getMaxEvaluations() const { return maxEvaluations; }
+  [[nodiscard]] uint64_t getMaxToggles() const { return maxToggles; }
+
+  [[nodiscard]] const std::vector<uint64_t>& getEventsPerDelta() const
+  {
+    return eventsPerDelta;
+  }
+
+  // Sorted by time, the slowest first
+  [[nodiscard]] std::vector<ComponentTypeActivity> getTypes() const;
+
+  // The types, the events per delta cycle and then every component and wire, in the
+  // order in which they were first seen
+  void writeCsv(std::ostream& out) const;
+  void writeJson(std::ostream& out) const;
+
+  // Called by a Wire that changed state, instead of running its actions
+  void propagate(const Wire* wire, std::span<const UpdateAction> actions);
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  struct ComponentActivity {
+    std::string     type;
+    uint64_t        evaluations = 0;
+    Clock::duration time{};
+    size_t          order = 0;
+  };
+
+  struct WireActivity {
+    uint64_t toggles = 0;
+    size_t   order   = 0;
+  };
+
+  static thread_local ActivityProfiler* active;
+
+  std::unordered_map<const Component*, ComponentActivity> components;
+  std::unordered_map<const Wire*, WireActivity>           wires;
+  std::vector<uint64_t>                                   eventsPerDelta;
+
+  uint64_t maxEvaluations = 0;
+  uint64_t maxToggles     = 0;
+
+  // Nesting of the propagation, and time spent in the components called by the ones
+  // being evaluated
+  size_t                       depth = 0;
+  std::vector<Clock::duration> childTime;
+};
+
+struct SimulatorProfile {
+  std::vector<uint64_t> gateEvaluations;  // By gate
+  std::vector<uint64_t> netToggles;       // By net
+  std::vector<uint64_t> eventsPerDelta;   // Gates evaluated in every wave of settle()
+
+  static constexpr size_t GATE_TYPES = static_cast<size_t>(GateType::DFF) + 1;
+
+  std::array<uint64_t, GATE_TYPES>                 typeEvaluations{};
+  std::array<std::chrono::nanoseconds, GATE_TYPES> typeTime{};
+
+  // Nets are named after the netlist
+  void writeCsv(std::ostream& out, const Netlist& netlist) const;
+  void writeJson(std::ostream& out, const Netlist& netlist) const;
+};
@@ -0,0 +1,56 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "arena.hpp"
+
+#include <cassert>
+
+thread_local CircuitArena* CircuitArena::active = nullptr;
+
+CircuitArena::~CircuitArena()
+{
+  // The objects allocated in the arena must have been destroyed already
+  assert(active != this);
+  assert(allocations.live == 0);
+}
+
+void* CircuitArena::Upstream::do_allocate(const size_t bytes, const size_t alignment)
+{
+  reserved += bytes;
+  return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+}
+
+void CircuitArena::Upstream::do_deallocate(void* p, const size_t bytes,
+                                           const size_t alignment)
+{
+  std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+}
+
+void* CircuitArena::Allocations::do_allocate(const size_t bytes, const size_t alignment)
+{
+  live++;
+  return memory->allocate(bytes, alignment);
+}
+
+void CircuitArena::Allocations::do_deallocate(void* p, const size_t bytes,
+                                              const size_t alignment)
+{
+  assert(live > 0);
+  live--;
+  memory->deallocate(p, bytes, alignment);
+}
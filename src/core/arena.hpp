@@ -0,0 +1,127 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+
+/* Bulk allocation of the objects of a circuit.
+ *
+ * While an arena is active on a thread, the wires, the update actions and the lists of
+ * actions of the wires created by the core are allocated in its memory, together with
+ * their shared_ptr control blocks, and so are the components created with make().
+ * Nothing is freed one by one: the whole memory is released when the arena is destroyed,
+ * so it must outlive every object allocated in it. The allocations are counted to check
+ * it.
+ *
+ * An arena is meant to be used by one thread at a time. Without an active arena make()
+ * is std::make_shared(). */
+
+class CircuitArena {
+public:
+  // Size of the first block, the following ones are larger
+  static constexpr size_t INITIAL_SIZE = 64 * 1024;
+
+  CircuitArena() = default;
+  ~CircuitArena();
+
+  CircuitArena(const CircuitArena&)            = delete;
+  CircuitArena& operator=(const CircuitArena&) = delete;
+
+  // The arena is active until the returned object is destroyed, then the previous one is
+  class Scope {
+  public:
+    explicit Scope(CircuitArena* arena) : previous(active) { active = arena; }
+    ~Scope() { active = previous; }
+
+    Scope(const Scope&)            = delete;
+    Scope& operator=(const Scope&) = delete;
+
+  private:
+    CircuitArena* previous;
+  };
+
+  [[nodiscard]] Scope activate() { return Scope(this); }
+
+  [[nodiscard]] static CircuitArena* current() { return active; }
+
+  // The memory of the active arena, or the global heap
+  [[nodiscard]] static std::pmr::memory_resource* resource()
+  {
+    return active ? &active->allocations : std::pmr::new_delete_resource();
+  }
+
+  template <typename T, typename... Args>
+  [[nodiscard]] static std::shared_ptr<T> make(Args&&... args)
+  {
+    if (!active)
+      return std::make_shared<T>(std::forward<Args>(args)...);
+
+    return std::allocate_shared<T>(
+        std::pmr::polymorphic_allocator<T>(&active->allocations),
+        std::forward<Args>(args)...);
+  }
+
+  // Bytes taken from the global heap so far
+  [[nodiscard]] size_t getReservedBytes() const { return upstream.reserved; }
+
+  // Allocations in the arena that haven't been freed yet
+  [[nodiscard]] size_t getLiveAllocations() const { return allocations.live; }
+
+private:
+  // Counts the blocks requested by `memory`
+  class Upstream : public std::pmr::memory_resource {
+  public:
+    size_t reserved = 0;
+
+  private:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void  do_deallocate(void* p, size_t bytes, size_t alignment) override;
+    bool  do_is_equal(const memory_resource& other) const noexcept override
+    {
+      return this == &other;
+    }
+  };
+
+  // Counts the allocations made in `memory` that haven't been freed yet
+  class Allocations : public std::pmr::memory_resource {
+  public:
+    explicit Allocations(std::pmr::memory_resource* memory) : memory(memory) {}
+
+    size_t live = 0;
+
+  private:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void  do_deallocate(void* p, size_t bytes, size_t alignment) override;
+    bool  do_is_equal(const memory_resource& other) const noexcept override
+    {
+      return this == &other;
+    }
+
+    std::pmr::memory_resource* memory;
+  };
+
+  static thread_local CircuitArena* active;
+
+  Upstream                            upstream;
+  std::pmr::monotonic_buffer_resource memory{INITIAL_SIZE, &upstream};
+  Allocations                         allocations{&memory};
+};
@@ -0,0 +1,224 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "bdd.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <utility>
+
+namespace {
+// Variable of the terminals, below every other one in the order
+constexpr uint32_t TERMINAL = UINT32_MAX;
+
+// Variable of the nodes in the free list
+constexpr uint32_t FREE = UINT32_MAX - 1;
+
+size_t combine(size_t seed, const uint32_t value)
+{
+  return seed ^ (std::hash<uint32_t>{}(value) + 0x9E3779B9 + (seed << 6) + (seed >> 2));
+}
+}  // namespace
+
+size_t BddManager::KeyHash::operator()(const Key& k) const
+{
+  return combine(combine(std::hash<uint32_t>{}(k.variable), k.low), k.high);
+}
+
+BddManager::BddManager(const uint32_t variableCount)
+  : variableCount(variableCount), cache(CACHE_SIZE)
+{
+  assert(variableCount < FREE);
+
+  // The terminals are never freed
+  nodes.push_back({TERMINAL, ZERO, ZERO, 1});
+  nodes.push_back({TERMINAL, ONE, ONE, 1});
+}
+
+BddId BddManager::variable(const uint32_t index)
+{
+  assert(index < variableCount);
+  return makeNode(index, ZERO, ONE);
+}
+
+BddId BddManager::makeNode(const uint32_t variable, const BddId low, const BddId high)
+{
+  if (low == high)
+    return low;
+
+  const Key key{variable, low, high};
+  if (const auto it = unique.find(key); it != unique.end())
+    return it->second;
+
+  BddId id;
+  if (freeNodes.empty()) {
+    id = nodes.size();
+    nodes.push_back({variable, low, high});
+  } else {
+    id = freeNodes.back();
+    freeNodes.pop_back();
+    nodes[id] = {variable, low, high};
+  }
+
+  unique.emplace(key, id);
+  return id;
+}
+
+BddId BddManager::ite(const BddId f, const BddId g, const BddId h)
+{
+  if (f == ONE)
+    return g;
+  if (f == ZERO)
+    return h;
+  if (g == h)
+    return g;
+  if (g == ONE && h == ZERO)
+    return f;
+
+  const size_t slot = combine(combine(f, g), h) & (CACHE_SIZE - 1);
+  if (const auto& entry = cache[slot];
+      entry.valid && entry.f == f && entry.g == g && entry.h == h)
+    return entry.result;
+
+  const auto v = std::min({topVariable(f), topVariable(g), topVariable(h)});
+
+  const auto cofactor = [this, v](const BddId x, const bool high) {
+    if (topVariable(x) != v)
+      return x;
+    return high ? nodes[x].high : nodes[x].low;
+  };
+
+  const BddId t = ite(cofactor(f, true), cofactor(g, true), cofactor(h, true));
+  const BddId e = ite(cofactor(f, false), cofactor(g, false), cofactor(h, false));
+
+  const BddId res = makeNode(v, e, t);
+  cache[slot]     = {f, g, h, res, true};
+  return res;
+}
+
+bool BddManager::evaluate(BddId f, const std::vector<bool>& values) const
+{
+  assert(values.size() >= variableCount);
+
+  while (topVariable(f) != TERMINAL)
+    f = values[topVariable(f)] ? nodes[f].high : nodes[f].low;
+
+  return f == ONE;
+}
+
+std::optional<std::vector<bool>> BddManager::satisfy(BddId f) const
+{
+  if (f == ZERO)
+    return std::nullopt;
+
+  // Every node other than ZERO has a path to ONE
+  std::vector<bool> res(variableCount, false);
+  while (topVariable(f) != TERMINAL) {
+    const bool high = nodes[f].high != ZERO;
+
+    res[topVariable(f)] = high;
+    f                   = high ? nodes[f].high : nodes[f].low;
+  }
+
+  return res;
+}
+
+void BddManager::ref(const BddId f)
+{
+  assert(topVariable(f) != FREE);
+  nodes[f].refs++;
+}
+
+void BddManager::deref(const BddId f)
+{
+  assert(nodes[f].refs > 0);
+  nodes[f].refs--;
+}
+
+size_t BddManager::collectGarbage()
+{
+  std::vector<bool>  marked(nodes.size(), false);
+  std::vector<BddId> stack{};
+
+  for (BddId id = 0; id < nodes.size(); id++)
+    if (nodes[id].refs > 0)
+      stack.push_back(id);
+
+  while (!stack.empty()) {
+    const BddId id = stack.back();
+    stack.pop_back();
+
+    if (marked[id])
+      continue;
+
+    marked[id] = true;
+    if (topVariable(id) != TERMINAL) {
+      stack.push_back(nodes[id].low);
+      stack.push_back(nodes[id].high);
+    }
+  }
+
+  size_t freed = 0;
+  for (BddId id = 0; id < nodes.size(); id++) {
+    auto& node = nodes[id];
+    if (marked[id] || node.variable == FREE)
+      continue;
+
+    unique.erase({node.variable, node.low, node.high});
+    node.variable = FREE;
+    freeNodes.push_back(id);
+    freed++;
+  }
+
+  // The cached results could refer to the freed nodes
+  if (freed > 0)
+    std::ranges::fill(cache, CacheEntry{});
+
+  return freed;
+}
+
+/* HANDLES */
+
+Bdd::Bdd(BddManager& manager, const BddId id) : manager(&manager), id(id)
+{
+  manager.ref(id);
+}
+
+Bdd::Bdd(const Bdd& other) : manager(other.manager), id(other.id)
+{
+  if (manager)
+    manager->ref(id);
+}
+
+Bdd::Bdd(Bdd&& other) noexcept
+  : manager(std::exchange(other.manager, nullptr)), id(other.id)
+{}
+
+Bdd& Bdd::operator=(Bdd other) noexcept
+{
+  std::swap(manager, other.manager);
+  std::swap(id, other.id);
+  return *this;
+}
+
+Bdd::~Bdd()
+{
+  if (manager)
+    manager->deref(id);
+}
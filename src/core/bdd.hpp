@@ -0,0 +1,135 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+/* Reduced ordered binary decision diagrams.
+ *
+ * Every function built by a BddManager is stored only once, so two functions of the same
+ * variables are equal if and only if they have the same BddId. Variable 0 is the top of
+ * the order.
+ *
+ * Nodes are reference counted by the Bdd handles: collectGarbage() frees every node that
+ * can't be reached from a Bdd, BddIds that are not held by a Bdd must not be used after
+ * it. Operations never collect garbage on their own. */
+
+using BddId = uint32_t;
+
+class BddManager {
+public:
+  static constexpr BddId ZERO = 0;
+  static constexpr BddId ONE  = 1;
+
+  explicit BddManager(uint32_t variableCount);
+
+  BddManager(const BddManager&)            = delete;
+  BddManager& operator=(const BddManager&) = delete;
+
+  [[nodiscard]] uint32_t getVariableCount() const { return variableCount; }
+
+  BddId variable(uint32_t index);
+
+  // If-then-else: (f AND g) OR (NOT f AND h)
+  BddId ite(BddId f, BddId g, BddId h);
+
+  BddId negate(BddId f) { return ite(f, ZERO, ONE); }
+  BddId conjunction(BddId f, BddId g) { return ite(f, g, ZERO); }
+  BddId disjunction(BddId f, BddId g) { return ite(f, ONE, g); }
+  BddId exclusiveOr(BddId f, BddId g) { return ite(f, negate(g), g); }
+
+  [[nodiscard]] bool evaluate(BddId f, const std::vector<bool>& values) const;
+
+  // An assignment of the variables for which f is true (the ones f doesn't depend on
+  // are false), nullopt if f is ZERO
+  [[nodiscard]] std::optional<std::vector<bool>> satisfy(BddId f) const;
+
+  void ref(BddId f);
+  void deref(BddId f);
+
+  // Returns the number of nodes freed
+  size_t collectGarbage();
+
+  // Nodes in use, terminals included
+  [[nodiscard]] size_t getNodeCount() const { return nodes.size() - freeNodes.size(); }
+
+private:
+  struct Node {
+    uint32_t variable;
+    BddId    low;
+    BddId    high;
+    uint32_t refs = 0;
+  };
+
+  struct Key {
+    uint32_t variable;
+    BddId    low;
+    BddId    high;
+
+    bool operator==(const Key&) const = default;
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key& k) const;
+  };
+
+  struct CacheEntry {
+    BddId f = ZERO, g = ZERO, h = ZERO;
+    BddId result = ZERO;
+    bool  valid  = false;
+  };
+
+  static constexpr size_t CACHE_SIZE = 1 << 16;
+
+  BddId makeNode(uint32_t variable, BddId low, BddId high);
+
+  [[nodiscard]] uint32_t topVariable(BddId f) const { return nodes[f].variable; }
+
+  uint32_t variableCount;
+
+  std::vector<Node>                       nodes;
+  std::vector<BddId>                      freeNodes;
+  std::unordered_map<Key, BddId, KeyHash> unique;
+
+  // Lossy cache of the results of ite()
+  std::vector<CacheEntry> cache;
+};
+
+// A BddId that survives the garbage collection
+class Bdd {
+public:
+  Bdd() = default;
+  Bdd(BddManager& manager, BddId id);
+
+  Bdd(const Bdd& other);
+  Bdd(Bdd&& other) noexcept;
+  Bdd& operator=(Bdd other) noexcept;
+  ~Bdd();
+
+  [[nodiscard]] BddId getId() const { return id; }
+
+  bool operator==(const Bdd& other) const { return id == other.id; }
+
+private:
+  BddManager* manager = nullptr;
+  BddId       id      = BddManager::ZERO;
+};
@@ -0,0 +1,80 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "bitParallel.hpp"
+
+#include <cassert>
+
+BitParallelEvaluator::BitParallelEvaluator(const Netlist& netlist)
+  : netCount(netlist.getNetCount())
+{
+  assert(netlist.isFinalized());
+
+  const auto order = netlist.getCombinationalOrder();
+  assert(order.size() == netlist.getGateCount());
+
+  program.reserve(order.size());
+
+  for (const GateId g : order) {
+    const auto inputs = netlist.getGateInputs(g);
+    assert(netlist.getGateType(g) != GateType::DFF);
+
+    program.push_back({netlist.getGateType(g), netlist.getGateOutput(g),
+                       static_cast<uint32_t>(operands.size()),
+                       static_cast<uint32_t>(inputs.size())});
+    operands.insert(operands.end(), inputs.begin(), inputs.end());
+  }
+}
+
+void BitParallelEvaluator::evaluate(const std::span<uint64_t> words) const
+{
+  assert(words.size() == netCount);
+
+  for (const auto& [type, output, firstInput, inputCount] : program) {
+    const auto in = std::span(operands).subspan(firstInput, inputCount);
+
+    uint64_t res = 0;
+    switch (type) {
+      case GateType::BUF: res = words[in[0]]; break;
+      case GateType::NOT: res = ~words[in[0]]; break;
+      case GateType::AND:
+      case GateType::NAND:
+        res = ~uint64_t{0};
+        for (const NetId n : in)
+          res &= words[n];
+        break;
+      case GateType::OR:
+      case GateType::NOR:
+        for (const NetId n : in)
+          res |= words[n];
+        break;
+      case GateType::XOR:
+      case GateType::XNOR:
+        for (const NetId n : in)
+          res ^= words[n];
+        break;
+      case GateType::CONST0: res = 0; break;
+      case GateType::CONST1: res = ~uint64_t{0}; break;
+      case GateType::DFF: assert(false); break;
+    }
+
+    const bool inverted =
+        type == GateType::NAND || type == GateType::NOR || type == GateType::XNOR;
+    words[output] = inverted ? ~res : res;
+  }
+}
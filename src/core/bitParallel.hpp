@@ -0,0 +1,59 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <core/netlist.hpp>
+
+/* Evaluation of a combinational netlist on 64 input vectors at once.
+ *
+ * Every net is a word whose bit i is the value of the net in vector i, so a gate is
+ * evaluated for all the vectors with a single bitwise operation. Nets are only LOW or
+ * HIGH: the netlist must pass LogicAnalysis::checkCombinational.
+ *
+ * The gates are flattened once into a list of instructions in topological order. The
+ * evaluator is immutable, several threads can use it with their own words. */
+
+class BitParallelEvaluator {
+public:
+  static constexpr size_t LANES = 64;
+
+  explicit BitParallelEvaluator(const Netlist& netlist);
+
+  [[nodiscard]] size_t getNetCount() const { return netCount; }
+
+  // `words` has a word for every net, the ones of the primary inputs must be set. All
+  // the other nets are computed.
+  void evaluate(std::span<uint64_t> words) const;
+
+private:
+  struct Instruction {
+    GateType type;
+    NetId    output;
+    uint32_t firstInput;
+    uint32_t inputCount;
+  };
+
+  size_t                   netCount;
+  std::vector<Instruction> program;
+  std::vector<NetId>       operands;
+};
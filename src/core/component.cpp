@@ -19,6 +19,7 @@
 #include "component.hpp"
 
 #include <any>
+#include <atomic>
 
 Component::Component(std::vector<Bus> inputs, std::vector<Bus> outputs, std::string name)
 {
@@ -27,7 +28,7 @@ Component::Component(std::vector<Bus> inputs, std::vector<Bus> outputs, std::str
   this->name    = std::move(name);
 }
 
-void Component::setInput(const unsigned int index, const Bus& bus)
+void Component::setInput(const unsigned int index, Bus bus)
 {
   // If the action is already defined then we should remove it from the inputs:
   if (this->act)
@@ -36,12 +37,12 @@ void Component::setInput(const unsigned int index, const Bus& bus)
         w->deleteUpdateAction(this->act);
 
   // Then we set the new inputs and add the update action to them:
-  this->inputs[index] = bus;
+  this->inputs[index] = std::move(bus);
 
   if (this->act)
     for (const auto& w : this->inputs[index])
       if (w)
-        w->addUpdateAction(this->act);
+        w->addUpdateAction(this->act, this);
 }
 
 void Component::setInputs(const std::vector<Bus>& newInputs)
@@ -59,12 +60,28 @@ void Component::setInputs(const std::vector<Bus>& newInputs)
   }
 }
 
-void Component::setOutput(const unsigned int index, const Bus& bus)
+DriverId Component::newDriverId()
+{
+  // Components can be created by the worker threads that load circuits
+  static std::atomic<DriverId> next = NO_DRIVER + 1;
+  return next.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Component::releaseOutputs(const std::span<const Bus> buses) const
+{
+  for (const auto& bus : buses)
+    for (const auto& w : bus)
+      if (w)
+        w->releaseDriver(this->driverId);
+}
+
+void Component::setOutput(const unsigned int index, Bus bus)
 {
   if (this->outputs[index] == bus)
     return;
 
-  this->outputs[index] = bus;
+  releaseOutputs({&this->outputs[index], 1});
+  this->outputs[index] = std::move(bus);
 }
 
 void Component::setOutputs(const std::vector<Bus>& newOutputs)
@@ -74,46 +91,38 @@ void Component::setOutputs(const std::vector<Bus>& newOutputs)
     return;
 
   // We set the new outputs
+  releaseOutputs(this->outputs);
   this->outputs = newOutputs;
 }
 void Component::clearWires()
 {
-  for (const auto [index, bus] : this->outputs | silicon::views::enumerate) {
-    const auto                  busSize = bus.size();
-    const std::vector<Wire_ptr> wires(busSize);
+  // Buses of the same size, without any wire
+  for (const auto [index, bus] : this->outputs | silicon::views::enumerate)
+    setOutput(index, Bus(std::vector<Wire_ptr>(bus.size())));
 
-    const auto newBus = Bus(wires);
-
-    setOutput(index, newBus);
-  }
-
-  for (const auto [index, bus] : this->inputs | silicon::views::enumerate) {
-    const auto                  busSize = bus.size();
-    const std::vector<Wire_ptr> wires(busSize);
-
-    const auto newBus = Bus(wires);
-
-    setInput(index, newBus);
-  }
+  for (const auto [index, bus] : this->inputs | silicon::views::enumerate)
+    setInput(index, Bus(std::vector<Wire_ptr>(bus.size())));
 }
 
 void Component::setAction(const action& a)
 {
-  this->act = std::make_shared<action>(a);
+  this->act = CircuitArena::make<action>(a);
   assert(this->act);
 
   // The action is to be set for all the inputs of the component connected to wires:
-  for (auto bus : this->inputs)
+  for (const auto& bus : this->inputs)
     for (const auto& w : bus)
       if (w)
-        w->addUpdateAction(this->act);
+        w->addUpdateAction(this->act, this);
 }
 
 Component::~Component()
 {
   // Remove the associated update action from all the inputs:
-  for (auto bus : this->inputs)
+  for (const auto& bus : this->inputs)
     for (const auto& w : bus)
       if (w)
         w->deleteUpdateAction(this->act);
+
+  releaseOutputs(this->outputs);
 }
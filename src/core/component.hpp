@@ -22,6 +22,7 @@
 #include <cassert>
 #include <memory>
 #include <ranges>
+#include <span>
 #include <string>
 #include <utility>
 
@@ -38,25 +39,37 @@ protected:
 
   action_ptr act;
 
+  const DriverId driverId = newDriverId();
+
 public:
   Component() = default;
   Component(std::vector<Bus> inputs, std::vector<Bus> outputs, std::string name);
 
   void setAction(const action& a);
 
-  void setInput(const unsigned int index, const Bus& bus);
+  void setInput(unsigned int index, Bus bus);
   void setInputs(const std::vector<Bus>& newInputs);
 
-  void setOutput(unsigned int index, const Bus& bus);
+  void setOutput(unsigned int index, Bus bus);
   void setOutputs(const std::vector<Bus>& newOutputs);
 
   void setName(const std::string_view& newName) { this->name = newName; }
 
   void clearWires();
 
-  std::vector<Bus> getInputs() const { return inputs; }
-  std::vector<Bus> getOutputs() const { return outputs; }
-  std::string      getName() const { return name; }
+  // Views of the buses of the component: they are valid until the buses are changed
+  [[nodiscard]] std::span<const Bus> getInputs() const { return inputs; }
+  [[nodiscard]] std::span<const Bus> getOutputs() const { return outputs; }
+
+  [[nodiscard]] const std::string& getName() const { return name; }
+
+  [[nodiscard]] DriverId getDriverId() const { return driverId; }
 
   virtual ~Component();
+
+private:
+  static DriverId newDriverId();
+
+  // The outputs can be driven by other components
+  void releaseOutputs(std::span<const Bus> buses) const;
 };
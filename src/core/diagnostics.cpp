@@ -0,0 +1,238 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "diagnostics.hpp"
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+struct RateWindow {
+  Clock::time_point start;
+  unsigned          count = 0;
+};
+
+// A sink is shared with the reports calling it, removeSink() waits for them
+struct SinkEntry {
+  Diagnostics::SinkId id;
+  Diagnostics::Sink   sink;
+  unsigned            calls = 0;  // Reports calling the sink, guarded by the mutex
+};
+
+struct Registry {
+  std::mutex              mutex;
+  std::condition_variable sinkReturned;
+
+  std::vector<Diagnostic> ring;
+  size_t                  capacity   = Diagnostics::DEFAULT_CAPACITY;
+  size_t                  next       = 0;  // Where the next diagnostic goes in the ring
+  uint64_t                sequence   = 0;
+  uint64_t                suppressed = 0;
+
+  unsigned rateLimit = Diagnostics::DEFAULT_RATE_LIMIT;
+  std::array<RateWindow, static_cast<size_t>(DiagnosticCode::COUNT)> windows{};
+
+  std::vector<std::shared_ptr<SinkEntry>> sinks;
+  Diagnostics::SinkId                     nextSink = 0;
+};
+
+Registry& registry()
+{
+  static Registry r;
+  return r;
+}
+}  // namespace
+
+std::atomic<Severity> Diagnostics::level = Diagnostics::DEFAULT_LEVEL;
+
+std::string_view to_str(const Severity s)
+{
+  switch (s) {
+    case Severity::DEBUG: return "debug";
+    case Severity::INFO: return "info";
+    case Severity::WARNING: return "warning";
+    case Severity::ERROR: return "error";
+    default: return "none";
+  }
+}
+
+std::string_view to_str(const DiagnosticCode c)
+{
+  switch (c) {
+    case DiagnosticCode::CONFLICTING_DRIVERS: return "conflicting-drivers";
+    case DiagnosticCode::MISSING_WIRE: return "missing-wire";
+    case DiagnosticCode::WIDTH_MISMATCH: return "width-mismatch";
+    default: return "unknown";
+  }
+}
+
+void Diagnostics::setLevel(const Severity newLevel)
+{
+  level.store(newLevel, std::memory_order_relaxed);
+}
+
+void Diagnostics::setRateLimit(const unsigned perSecond)
+{
+  auto&                 r = registry();
+  const std::lock_guard lock(r.mutex);
+  r.rateLimit = perSecond;
+}
+
+void Diagnostics::setCapacity(const size_t capacity)
+{
+  auto                  recent = getRecent();
+  auto&                 r      = registry();
+  const std::lock_guard lock(r.mutex);
+
+  // The most recent diagnostics are kept
+  if (recent.size() > capacity)
+    recent.erase(recent.begin(), recent.end() - static_cast<ptrdiff_t>(capacity));
+
+  r.capacity = capacity;
+  r.ring     = std::move(recent);
+  r.next     = capacity ? r.ring.size() % capacity : 0;
+}
+
+std::vector<Diagnostic> Diagnostics::getRecent()
+{
+  auto&                 r = registry();
+  const std::lock_guard lock(r.mutex);
+
+  // Until the ring is full the oldest one is the first
+  if (r.ring.size() < r.capacity)
+    return r.ring;
+
+  std::vector<Diagnostic> res(r.ring.begin() + static_cast<ptrdiff_t>(r.next),
+                              r.ring.end());
+  res.insert(res.end(), r.ring.begin(), r.ring.begin() + static_cast<ptrdiff_t>(r.next));
+  return res;
+}
+
+uint64_t Diagnostics::getSuppressed()
+{
+  auto&                 r = registry();
+  const std::lock_guard lock(r.mutex);
+  return r.suppressed;
+}
+
+void Diagnostics::clear()
+{
+  auto&                 r = registry();
+  const std::lock_guard lock(r.mutex);
+
+  r.ring.clear();
+  r.next       = 0;
+  r.suppressed = 0;
+  r.windows    = {};
+}
+
+Diagnostics::SinkId Diagnostics::addSink(Sink sink)
+{
+  auto&                 r = registry();
+  const std::lock_guard lock(r.mutex);
+
+  r.sinks.push_back(std::make_shared<SinkEntry>(r.nextSink, std::move(sink)));
+  return r.nextSink++;
+}
+
+void Diagnostics::removeSink(const SinkId id)
+{
+  auto&            r = registry();
+  std::unique_lock lock(r.mutex);
+
+  const auto it = std::ranges::find(r.sinks, id, &SinkEntry::id);
+  if (it == r.sinks.end())
+    return;
+
+  const auto entry = *it;
+  r.sinks.erase(it);
+
+  // Whatever the sink uses may be destroyed once this returns
+  r.sinkReturned.wait(lock, [&entry] { return entry->calls == 0; });
+}
+
+Diagnostics::Sink Diagnostics::streamSink(std::ostream& out)
+{
+  return [&out](const Diagnostic& d) { out << format(d) << '\n'; };
+}
+
+std::string Diagnostics::format(const Diagnostic& d)
+{
+  std::string res(to_str(d.severity));
+  res += ": ";
+  res += to_str(d.code);
+  res += ": ";
+  res += d.message;
+  return res;
+}
+
+void Diagnostics::record(const Severity s, const DiagnosticCode code,
+                         const std::function<std::string()>& message)
+{
+  auto& r   = registry();
+  auto  now = Clock::now();
+
+  std::unique_lock lock(r.mutex);
+
+  auto& window = r.windows[static_cast<size_t>(code)];
+  if (now - window.start >= std::chrono::seconds(1))
+    window = {now, 0};
+
+  if (window.count >= r.rateLimit) {
+    r.suppressed++;
+    return;
+  }
+
+  window.count++;
+  lock.unlock();
+
+  // The message is built without holding the lock
+  Diagnostic d{s, code, message(), 0, std::chrono::system_clock::now()};
+
+  lock.lock();
+  d.sequence = r.sequence++;
+
+  if (r.capacity > 0) {
+    if (r.ring.size() < r.capacity)
+      r.ring.push_back(d);
+    else
+      r.ring[r.next] = d;
+    r.next = (r.next + 1) % r.capacity;
+  }
+
+  // The sinks are called without the lock, they may take a while
+  const auto sinks = r.sinks;
+  for (const auto& entry : sinks)
+    entry->calls++;
+  lock.unlock();
+
+  for (const auto& entry : sinks)
+    entry->sink(d);
+
+  lock.lock();
+  for (const auto& entry : sinks)
+    entry->calls--;
+  lock.unlock();
+
+  r.sinkReturned.notify_all();
+}
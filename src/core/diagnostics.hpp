@@ -0,0 +1,123 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/* Problems found while simulating, e.g. two components driving the same wire.
+ *
+ * Diagnostics are reported from the hot paths of the simulation, so a report below the
+ * current level only loads an atomic: the message is built by a callable that is never
+ * called in that case. The messages that are kept go to a ring buffer of the most recent
+ * ones and to the sinks (e.g. the status bar or a log file). Every code is rate limited:
+ * past the limit, the messages with that code are only counted until the next second.
+ *
+ * Reports can come from any thread, the sinks are called by the thread reporting. */
+
+enum class Severity : uint8_t {
+  DEBUG,
+  INFO,
+  WARNING,
+  ERROR,
+  NONE,  // As a level, disables the diagnostics
+};
+
+enum class DiagnosticCode : uint8_t {
+  CONFLICTING_DRIVERS,  // A wire was changed by a component that doesn't drive it
+  MISSING_WIRE,         // A component changed an output that isn't connected
+  WIDTH_MISMATCH,       // The buses of a component don't have the expected size
+  COUNT,
+};
+
+std::string_view to_str(Severity s);
+std::string_view to_str(DiagnosticCode c);
+
+struct Diagnostic {
+  Severity       severity = Severity::INFO;
+  DiagnosticCode code     = DiagnosticCode::COUNT;
+  std::string    message;
+  uint64_t       sequence = 0;  // Of the report, the first one is 0
+
+  std::chrono::system_clock::time_point time;
+};
+
+class Diagnostics {
+public:
+  using Sink   = std::function<void(const Diagnostic&)>;
+  using SinkId = uint32_t;
+
+  static constexpr Severity DEFAULT_LEVEL      = Severity::WARNING;
+  static constexpr size_t   DEFAULT_CAPACITY   = 256;
+  static constexpr unsigned DEFAULT_RATE_LIMIT = 20;  // Per code and second
+
+  // Reports below `level` are ignored
+  static void setLevel(Severity newLevel);
+
+  [[nodiscard]] static Severity getLevel()
+  {
+    return level.load(std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] static bool isEnabled(const Severity s) { return s >= getLevel(); }
+
+  // `message` returns the text, it's called only if the diagnostic is kept
+  template <typename MessageBuilder>
+  static void report(const Severity s, const DiagnosticCode code,
+                     MessageBuilder&& message)
+  {
+    if (isEnabled(s)) [[unlikely]]
+      record(s, code, std::forward<MessageBuilder>(message));
+  }
+
+  static void setRateLimit(unsigned perSecond);
+  static void setCapacity(size_t capacity);
+
+  // The kept diagnostics still in the ring buffer, the oldest first
+  [[nodiscard]] static std::vector<Diagnostic> getRecent();
+
+  // Dropped by the rate limit since the last clear()
+  [[nodiscard]] static uint64_t getSuppressed();
+
+  // Empties the ring buffer and resets the counters and the rate limits
+  static void clear();
+
+  static SinkId addSink(Sink sink);
+
+  // Waits for the reports still calling the sink, so it must not be called by a sink
+  static void removeSink(SinkId id);
+
+  // A sink writing one line per diagnostic, `out` must outlive it
+  [[nodiscard]] static Sink streamSink(std::ostream& out);
+
+  // "warning: conflicting-drivers: <message>"
+  [[nodiscard]] static std::string format(const Diagnostic& d);
+
+private:
+  static void record(Severity s, DiagnosticCode code,
+                     const std::function<std::string()>& message);
+
+  static std::atomic<Severity> level;
+};
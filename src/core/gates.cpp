@@ -24,9 +24,10 @@ Gate::Gate(const std::vector<Wire_ptr>& inputs, Wire_ptr output, std::string nam
 
   this->name = std::move(name);
 
+  this->inputs.reserve(inputs.size());
   for (const auto& input : inputs)
-    this->inputs.push_back({input});
-  this->outputs = {{output}};
+    this->inputs.push_back(Bus{input});
+  this->outputs.push_back(Bus{std::move(output)});
 }
 
 AndGate::AndGate(const std::vector<Wire_ptr>& inputs, Wire_ptr output)
@@ -36,10 +37,10 @@ AndGate::AndGate(const std::vector<Wire_ptr>& inputs, Wire_ptr output)
   this->setAction([this] {
     State s = State::HIGH;
 
-    for (auto input : this->inputs)
+    for (const auto& input : this->inputs)
       s = s && Wire::safeGetCurrentState(input[0]);
 
-    Wire::safeSetCurrentState(this->outputs[0][0], s, weak_from_this());
+    Wire::safeSetCurrentState(this->outputs[0][0], s, driverId);
   });
 }
 
@@ -50,10 +51,10 @@ OrGate::OrGate(const std::vector<Wire_ptr>& inputs, Wire_ptr output)
   this->setAction([this] {
     State s = State::LOW;
 
-    for (auto input : this->inputs)
+    for (const auto& input : this->inputs)
       s = s || Wire::safeGetCurrentState(input[0]);
 
-    Wire::safeSetCurrentState(this->outputs[0][0], s, weak_from_this());
+    Wire::safeSetCurrentState(this->outputs[0][0], s, driverId);
   });
 }
 
@@ -62,7 +63,7 @@ NotGate::NotGate(Wire_ptr input, Wire_ptr output) : Gate({input}, output, "Not")
   this->setAction([this] {
     State s = !Wire::safeGetCurrentState(inputs[0][0]);
 
-    Wire::safeSetCurrentState(this->outputs[0][0], s, weak_from_this());
+    Wire::safeSetCurrentState(this->outputs[0][0], s, driverId);
   });
 }
 
@@ -73,10 +74,10 @@ NandGate::NandGate(const std::vector<Wire_ptr>& inputs, Wire_ptr output)
   this->setAction([this] {
     State s = State::HIGH;
 
-    for (auto input : this->inputs)
+    for (const auto& input : this->inputs)
       s = s && Wire::safeGetCurrentState(input[0]);
 
-    Wire::safeSetCurrentState(this->outputs[0][0], !s, weak_from_this());
+    Wire::safeSetCurrentState(this->outputs[0][0], !s, driverId);
   });
 }
 
@@ -87,10 +88,10 @@ NorGate::NorGate(const std::vector<Wire_ptr>& inputs, Wire_ptr output)
   this->setAction([this] {
     State s = State::LOW;
 
-    for (auto input : this->inputs)
+    for (const auto& input : this->inputs)
       s = s || Wire::safeGetCurrentState(input[0]);
 
-    Wire::safeSetCurrentState(this->outputs[0][0], !s, weak_from_this());
+    Wire::safeSetCurrentState(this->outputs[0][0], !s, driverId);
   });
 }
 
@@ -102,6 +103,6 @@ XorGate::XorGate(const std::array<Wire_ptr, 2>& inputs, Wire_ptr output)
     const State s = Wire::safeGetCurrentState(this->inputs[0][0])
                     ^ Wire::safeGetCurrentState(this->inputs[1][0]);
 
-    Wire::safeSetCurrentState(this->outputs[0][0], s, weak_from_this());
+    Wire::safeSetCurrentState(this->outputs[0][0], s, driverId);
   });
 }
@@ -0,0 +1,309 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "logicAnalysis.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+#include <core/bitParallel.hpp>
+
+namespace {
+using Unexpected = std::unexpected<std::string>;
+
+std::string netName(const Netlist& netlist, const NetId net)
+{
+  const auto name = netlist.getNetName(net);
+  return name.empty() ? "#" + std::to_string(net) : std::string(name);
+}
+
+// Number of gates still to be evaluated that read every net. The values of the nets are
+// dropped once they reach 0, except for the primary outputs.
+std::vector<uint32_t> readers(const Netlist& netlist)
+{
+  std::vector<uint32_t> res(netlist.getNetCount(), 0);
+
+  for (NetId n = 0; n < netlist.getNetCount(); n++)
+    res[n] = netlist.getFanout(n).size();
+
+  for (const NetId n : netlist.getPrimaryOutputs())
+    res[n] = UINT32_MAX;
+
+  return res;
+}
+
+// The distinct nets read by `gate`, in the same way as the fan-out counts them
+template <typename F>
+void forEachInput(const Netlist& netlist, const GateId gate, F&& f)
+{
+  const auto inputs = netlist.getGateInputs(gate);
+  for (size_t i = 0; i < inputs.size(); i++)
+    if (std::ranges::find(inputs.first(i), inputs[i]) == inputs.begin() + i)
+      f(inputs[i]);
+}
+}  // namespace
+
+/* TRUTH TABLE */
+
+TruthTable::TruthTable(const uint32_t inputCount, const uint32_t outputCount)
+  : inputCount(inputCount), outputCount(outputCount),
+    wordsPerOutput(std::max<uint64_t>(1, (uint64_t{1} << inputCount) / 64)),
+    words(wordsPerOutput * outputCount, 0)
+{
+  assert(inputCount <= MAX_INPUTS);
+}
+
+bool TruthTable::get(const uint32_t output, const uint64_t row) const
+{
+  assert(row < getRowCount());
+  return (getWords(output)[row / 64] >> (row % 64)) & 1;
+}
+
+std::span<const uint64_t> TruthTable::getWords(const uint32_t output) const
+{
+  return std::span(words).subspan(output * wordsPerOutput, wordsPerOutput);
+}
+
+std::span<uint64_t> TruthTable::getWords(const uint32_t output)
+{
+  return std::span(words).subspan(output * wordsPerOutput, wordsPerOutput);
+}
+
+/* ANALYSIS */
+
+LogicAnalysis::Result<void> LogicAnalysis::checkCombinational(const Netlist& netlist)
+{
+  assert(netlist.isFinalized());
+
+  std::vector<bool> isInput(netlist.getNetCount(), false);
+  for (const NetId n : netlist.getPrimaryInputs())
+    isInput[n] = true;
+
+  for (GateId g = 0; g < netlist.getGateCount(); g++) {
+    if (netlist.getGateType(g) == GateType::DFF)
+      return Unexpected("The circuit has registers");
+
+    for (const NetId n : netlist.getGateInputs(g))
+      if (!isInput[n] && netlist.getDriver(n) == Netlist::NO_GATE)
+        return Unexpected("Net " + netName(netlist, n) + " is not driven");
+  }
+
+  for (const NetId n : netlist.getPrimaryOutputs())
+    if (!isInput[n] && netlist.getDriver(n) == Netlist::NO_GATE)
+      return Unexpected("Output " + netName(netlist, n) + " is not driven");
+
+  if (netlist.getCombinationalOrder().size() != netlist.getGateCount())
+    return Unexpected("The circuit has a combinational loop");
+
+  return {};
+}
+
+LogicAnalysis::Result<TruthTable> LogicAnalysis::truthTable(const Netlist& netlist)
+{
+  if (const auto res = checkCombinational(netlist); !res)
+    return Unexpected(res.error());
+
+  const auto inputs  = netlist.getPrimaryInputs();
+  const auto outputs = netlist.getPrimaryOutputs();
+
+  if (inputs.size() > TruthTable::MAX_INPUTS)
+    return Unexpected("Too many inputs for a truth table ("
+                      + std::to_string(inputs.size()) + ", at most "
+                      + std::to_string(TruthTable::MAX_INPUTS) + ")");
+
+  TruthTable table(inputs.size(), outputs.size());
+  const auto wordCount = table.getWords(0).size();
+
+  // The rows past the last one, when there are less than 64
+  const uint64_t mask =
+      table.getRowCount() >= 64 ? ~uint64_t{0} : (uint64_t{1} << table.getRowCount()) - 1;
+
+  // The first 6 inputs change inside every word, the other ones from a word to the next
+  constexpr std::array<uint64_t, 6> PATTERNS = {
+      0xAAAAAAAAAAAAAAAA, 0xCCCCCCCCCCCCCCCC, 0xF0F0F0F0F0F0F0F0,
+      0xFF00FF00FF00FF00, 0xFFFF0000FFFF0000, 0xFFFFFFFF00000000,
+  };
+
+  const BitParallelEvaluator evaluator(netlist);
+  std::vector<uint64_t>      words(netlist.getNetCount());
+
+  for (size_t w = 0; w < wordCount; w++) {
+    for (size_t i = 0; i < inputs.size(); i++)
+      words[inputs[i]] = i < 6 ? PATTERNS[i] : ((w >> (i - 6)) & 1) * ~uint64_t{0};
+
+    evaluator.evaluate(words);
+
+    for (size_t o = 0; o < outputs.size(); o++)
+      table.getWords(o)[w] = words[outputs[o]] & mask;
+  }
+
+  return table;
+}
+
+std::vector<uint32_t> LogicAnalysis::variableOrder(const Netlist& netlist)
+{
+  const auto inputs = netlist.getPrimaryInputs();
+
+  std::vector<uint32_t> inputIndex(netlist.getNetCount(), UINT32_MAX);
+  for (size_t i = 0; i < inputs.size(); i++)
+    inputIndex[inputs[i]] = i;
+
+  std::vector<uint32_t> res(inputs.size(), UINT32_MAX);
+  uint32_t              next = 0;
+
+  // Depth-first, the inputs of a gate from the first one
+  std::vector<bool>  visited(netlist.getNetCount(), false);
+  std::vector<NetId> stack{};
+
+  for (const NetId output : netlist.getPrimaryOutputs()) {
+    stack.push_back(output);
+
+    while (!stack.empty()) {
+      const NetId n = stack.back();
+      stack.pop_back();
+
+      if (visited[n])
+        continue;
+      visited[n] = true;
+
+      if (inputIndex[n] != UINT32_MAX && res[inputIndex[n]] == UINT32_MAX)
+        res[inputIndex[n]] = next++;
+
+      if (const GateId g = netlist.getDriver(n); g != Netlist::NO_GATE)
+        for (const NetId input : netlist.getGateInputs(g) | std::views::reverse)
+          stack.push_back(input);
+    }
+  }
+
+  // Inputs that no output depends on
+  for (auto& v : res)
+    if (v == UINT32_MAX)
+      v = next++;
+
+  return res;
+}
+
+LogicAnalysis::Result<std::vector<Bdd>>
+LogicAnalysis::buildBdds(BddManager& manager, const Netlist& netlist,
+                         const std::span<const uint32_t> variables)
+{
+  if (const auto res = checkCombinational(netlist); !res)
+    return Unexpected(res.error());
+
+  const auto inputs = netlist.getPrimaryInputs();
+  assert(variables.size() == inputs.size());
+
+  std::vector<Bdd> values(netlist.getNetCount());
+  for (size_t i = 0; i < inputs.size(); i++)
+    values[inputs[i]] = Bdd(manager, manager.variable(variables[i]));
+
+  auto remaining = readers(netlist);
+
+  // Intermediate results are only referenced by `values`: the garbage is collected
+  // between two gates, when the nodes have doubled since the last time
+  size_t collectAt = 1 << 16;
+
+  for (const GateId g : netlist.getCombinationalOrder()) {
+    const auto in   = netlist.getGateInputs(g);
+    const auto type = netlist.getGateType(g);
+
+    const auto fold = [&](BddId init, BddId (BddManager::*op)(BddId, BddId)) {
+      for (const NetId n : in)
+        init = (manager.*op)(init, values[n].getId());
+      return init;
+    };
+
+    BddId res = BddManager::ZERO;
+    switch (type) {
+      case GateType::BUF: res = values[in[0]].getId(); break;
+      case GateType::NOT: res = manager.negate(values[in[0]].getId()); break;
+      case GateType::AND:
+      case GateType::NAND: res = fold(BddManager::ONE, &BddManager::conjunction); break;
+      case GateType::OR:
+      case GateType::NOR: res = fold(BddManager::ZERO, &BddManager::disjunction); break;
+      case GateType::XOR:
+      case GateType::XNOR: res = fold(BddManager::ZERO, &BddManager::exclusiveOr); break;
+      case GateType::CONST0: res = BddManager::ZERO; break;
+      case GateType::CONST1: res = BddManager::ONE; break;
+      case GateType::DFF: assert(false); break;
+    }
+
+    if (type == GateType::NAND || type == GateType::NOR || type == GateType::XNOR)
+      res = manager.negate(res);
+
+    values[netlist.getGateOutput(g)] = Bdd(manager, res);
+
+    forEachInput(netlist, g, [&](const NetId n) {
+      if (--remaining[n] == 0)
+        values[n] = {};
+    });
+
+    if (manager.getNodeCount() > collectAt) {
+      manager.collectGarbage();
+      collectAt = std::max(collectAt, 2 * manager.getNodeCount());
+    }
+  }
+
+  std::vector<Bdd> res{};
+  for (const NetId n : netlist.getPrimaryOutputs())
+    res.push_back(values[n]);
+
+  return res;
+}
+
+LogicAnalysis::Result<LogicAnalysis::Equivalence>
+LogicAnalysis::checkEquivalence(const Netlist& a, const Netlist& b)
+{
+  const auto inputCount = a.getPrimaryInputs().size();
+
+  if (inputCount != b.getPrimaryInputs().size())
+    return Unexpected("The circuits have a different number of inputs");
+  if (a.getPrimaryOutputs().size() != b.getPrimaryOutputs().size())
+    return Unexpected("The circuits have a different number of outputs");
+
+  BddManager manager(inputCount);
+  const auto variables = variableOrder(a);
+
+  const auto fa = buildBdds(manager, a, variables);
+  if (!fa)
+    return Unexpected(fa.error());
+
+  const auto fb = buildBdds(manager, b, variables);
+  if (!fb)
+    return Unexpected(fb.error());
+
+  Equivalence res{};
+
+  for (size_t o = 0; o < fa->size(); o++) {
+    if ((*fa)[o] == (*fb)[o])
+      continue;
+
+    const auto difference = manager.exclusiveOr((*fa)[o].getId(), (*fb)[o].getId());
+    const auto assignment = manager.satisfy(difference);
+    assert(assignment);
+
+    res.equivalent = false;
+    res.output     = o;
+    res.counterexample.resize(inputCount);
+    for (size_t i = 0; i < inputCount; i++)
+      res.counterexample[i] = (*assignment)[variables[i]];
+    break;
+  }
+
+  return res;
+}
@@ -0,0 +1,93 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+#include <expected>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <core/bdd.hpp>
+#include <core/netlist.hpp>
+
+/* Combinational netlists as boolean functions of their primary inputs.
+ *
+ * Unlike the Simulator, nets are only LOW or HIGH: the netlist must not contain DFFs,
+ * combinational loops or gates reading an undriven net that is not a primary input.
+ * Small blocks are computed as truth tables, evaluating 64 rows at a time; the
+ * equivalence of two netlists is decided with BDDs, whatever the number of inputs. */
+
+// The outputs of a function for every row: input i is bit i of the row
+class TruthTable {
+public:
+  static constexpr uint32_t MAX_INPUTS = 20;
+
+  TruthTable(uint32_t inputCount, uint32_t outputCount);
+
+  [[nodiscard]] uint32_t getInputCount() const { return inputCount; }
+  [[nodiscard]] uint32_t getOutputCount() const { return outputCount; }
+  [[nodiscard]] uint64_t getRowCount() const { return uint64_t{1} << inputCount; }
+
+  [[nodiscard]] bool get(uint32_t output, uint64_t row) const;
+
+  // 64 rows for each word, the bits past the last row are 0
+  [[nodiscard]] std::span<const uint64_t> getWords(uint32_t output) const;
+  [[nodiscard]] std::span<uint64_t>       getWords(uint32_t output);
+
+  bool operator==(const TruthTable&) const = default;
+
+private:
+  uint32_t              inputCount;
+  uint32_t              outputCount;
+  size_t                wordsPerOutput;
+  std::vector<uint64_t> words;
+};
+
+class LogicAnalysis {
+public:
+  template <typename T>
+  using Result = std::expected<T, std::string>;
+
+  static Result<void> checkCombinational(const Netlist& netlist);
+
+  // At most TruthTable::MAX_INPUTS primary inputs
+  static Result<TruthTable> truthTable(const Netlist& netlist);
+
+  // A variable for every primary input: the inputs are ordered as they are met going
+  // backwards from the outputs, which keeps the BDDs of ripple structures (e.g. an adder
+  // with all the bits of a first and then all the bits of b) small
+  static std::vector<uint32_t> variableOrder(const Netlist& netlist);
+
+  // BDDs of the primary outputs, primary input i is variable `variables[i]`
+  static Result<std::vector<Bdd>> buildBdds(BddManager& manager, const Netlist& netlist,
+                                            std::span<const uint32_t> variables);
+
+  struct Equivalence {
+    bool equivalent = true;
+
+    // If not equivalent: the first output that differs, and the values of the inputs for
+    // which it does
+    uint32_t          output = 0;
+    std::vector<bool> counterexample;
+  };
+
+  // Inputs and outputs are matched by position
+  static Result<Equivalence> checkEquivalence(const Netlist& a, const Netlist& b);
+};
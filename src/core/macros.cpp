@@ -0,0 +1,719 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "macros.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <map>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <utils/ranges_wrapper.hpp>
+
+namespace {
+
+template <std::ranges::input_range R, typename T>
+bool contains(R&& range, const T& value)
+{
+  return std::ranges::find(range, value) != std::ranges::end(range);
+}
+
+/* CUTS */
+
+// Truth tables are 8 bits wide: bit m is the value of the function when leaf j is
+// (m >> j) & 1. Cuts with less than 3 leaves simply don't depend on the other bits.
+constexpr std::array<uint8_t, 3> VAR = {0xAA, 0xCC, 0xF0};
+
+constexpr uint8_t XOR2 = VAR[0] ^ VAR[1];
+constexpr uint8_t AND2 = VAR[0] & VAR[1];
+constexpr uint8_t XOR3 = VAR[0] ^ VAR[1] ^ VAR[2];
+constexpr uint8_t MAJ3 = (VAR[0] & VAR[1]) | (VAR[0] & VAR[2]) | (VAR[1] & VAR[2]);
+
+constexpr size_t MAX_LEAVES = 3;
+constexpr size_t MAX_CUTS   = 8;
+
+// The cuts of gates with more inputs are not enumerated (e.g. the OR of the terms of a
+// sum of products can't have less than 4 leaves unless its inputs share them)
+constexpr size_t MAX_FANIN = 4;
+
+// Smaller blocks are not worth a macro
+constexpr size_t MIN_GATES = 4;
+
+// y = sel ? hi : lo, for every assignment of the three leaves
+struct MuxVariant {
+  uint8_t tt;
+  size_t  sel, hi, lo;
+};
+
+constexpr std::array<MuxVariant, 6> MUX_VARIANTS = [] {
+  std::array<MuxVariant, 6> res{};
+  size_t                    i = 0;
+
+  for (size_t sel = 0; sel < 3; sel++) {
+    for (size_t hi = 0; hi < 3; hi++) {
+      if (hi == sel)
+        continue;
+
+      const size_t lo = 3 - sel - hi;
+      res[i++] = {static_cast<uint8_t>((VAR[sel] & VAR[hi]) | (~VAR[sel] & VAR[lo])), sel,
+                  hi, lo};
+    }
+  }
+
+  return res;
+}();
+
+// The AND of the leaves, negated where bit j of k is 0
+constexpr uint8_t minterm(const uint32_t k, const uint32_t size)
+{
+  uint8_t res = 0xFF;
+  for (uint32_t j = 0; j < size; j++)
+    res &= (k >> j) & 1 ? VAR[j] : static_cast<uint8_t>(~VAR[j]);
+  return res;
+}
+
+struct Cut {
+  std::array<NetId, MAX_LEAVES> leaves = {Netlist::NO_NET, Netlist::NO_NET,
+                                          Netlist::NO_NET};
+  uint8_t                       size   = 0;
+  uint8_t                       tt     = 0;
+
+  [[nodiscard]] std::span<const NetId> getLeaves() const
+  {
+    return std::span(leaves).first(size);
+  }
+
+  // Leaves and size, used to find the functions of the same nets
+  [[nodiscard]] std::array<NetId, MAX_LEAVES + 1> key() const
+  {
+    return {size, leaves[0], leaves[1], leaves[2]};
+  }
+};
+
+struct CutSet {
+  std::array<Cut, MAX_CUTS> cuts{};
+  uint8_t                   count = 0;
+
+  void add(const Cut& cut)
+  {
+    if (count == MAX_CUTS)
+      return;
+
+    for (uint8_t i = 0; i < count; i++)
+      if (cuts[i].size == cut.size && cuts[i].leaves == cut.leaves)
+        return;
+
+    cuts[count++] = cut;
+  }
+
+  [[nodiscard]] std::span<const Cut> get() const { return std::span(cuts).first(count); }
+};
+
+// Union of the (sorted) leaves of two cuts
+bool mergeLeaves(const Cut& a, Cut& res)
+{
+  std::array<NetId, 2 * MAX_LEAVES> merged{};
+
+  const auto end =
+      std::ranges::set_union(a.getLeaves(), res.getLeaves(), merged.begin()).out;
+  const auto size = static_cast<size_t>(end - merged.begin());
+
+  if (size > MAX_LEAVES)
+    return false;
+
+  std::ranges::copy(std::span(merged).first(size), res.leaves.begin());
+  res.size = size;
+  return true;
+}
+
+// The truth table of `from` over the leaves of `to`, which include the ones of `from`
+uint8_t expand(const Cut& from, const Cut& to)
+{
+  const auto leaves = to.getLeaves();
+
+  std::array<size_t, MAX_LEAVES> pos{};
+  for (size_t j = 0; j < from.size; j++)
+    pos[j] = std::ranges::find(leaves, from.leaves[j]) - leaves.begin();
+
+  uint8_t res = 0;
+  for (unsigned m = 0; m < 8; m++) {
+    unsigned index = 0;
+    for (size_t j = 0; j < from.size; j++)
+      index |= ((m >> pos[j]) & 1) << j;
+
+    if ((from.tt >> index) & 1)
+      res |= 1 << m;
+  }
+
+  return res;
+}
+
+uint8_t applyGate(const GateType type, const std::span<const uint8_t> tts)
+{
+  const auto fold = [tts](uint8_t init, auto op) {
+    for (const auto tt : tts)
+      init = op(init, tt);
+    return init;
+  };
+
+  const auto band = [](uint8_t a, uint8_t b) -> uint8_t { return a & b; };
+  const auto bor  = [](uint8_t a, uint8_t b) -> uint8_t { return a | b; };
+  const auto bxor = [](uint8_t a, uint8_t b) -> uint8_t { return a ^ b; };
+
+  switch (type) {
+    case GateType::BUF: return tts[0];
+    case GateType::NOT: return ~tts[0];
+    case GateType::AND: return fold(0xFF, band);
+    case GateType::NAND: return ~fold(0xFF, band);
+    case GateType::OR: return fold(0, bor);
+    case GateType::NOR: return ~fold(0, bor);
+    case GateType::XOR: return fold(0, bxor);
+    case GateType::XNOR: return ~fold(0, bxor);
+    case GateType::CONST0: return 0;
+    case GateType::CONST1: return 0xFF;
+    case GateType::DFF: break;
+  }
+
+  assert(false);
+  return 0;
+}
+
+std::vector<CutSet> enumerateCuts(const Netlist& netlist, std::span<const GateId> order)
+{
+  std::vector<CutSet> res(netlist.getNetCount());
+
+  // Every net is a cut of itself
+  for (NetId n = 0; n < res.size(); n++) {
+    Cut trivial{};
+    trivial.leaves[0] = n;
+    trivial.size      = 1;
+    trivial.tt        = VAR[0];
+    res[n].add(trivial);
+  }
+
+  std::array<uint8_t, MAX_FANIN> tts{};
+
+  for (const GateId g : order) {
+    const auto inputs = netlist.getGateInputs(g);
+    const auto type   = netlist.getGateType(g);
+    auto&      cuts   = res[netlist.getGateOutput(g)];
+
+    if (inputs.size() > MAX_FANIN)
+      continue;
+
+    if (inputs.empty()) {
+      cuts.add(Cut{.tt = applyGate(type, {})});
+      continue;
+    }
+
+    // Every combination of the cuts of the inputs
+    std::array<size_t, MAX_FANIN> choice{};
+    while (true) {
+      Cut  cut{};
+      bool fits = true;
+      for (size_t i = 0; i < inputs.size() && fits; i++)
+        fits = mergeLeaves(res[inputs[i]].get()[choice[i]], cut);
+
+      if (fits) {
+        for (size_t i = 0; i < inputs.size(); i++)
+          tts[i] = expand(res[inputs[i]].get()[choice[i]], cut);
+
+        cut.tt = applyGate(type, std::span(tts).first(inputs.size()));
+        cuts.add(cut);
+      }
+
+      size_t i = 0;
+      while (i < inputs.size() && ++choice[i] == res[inputs[i]].count)
+        choice[i++] = 0;
+
+      if (i == inputs.size())
+        break;
+    }
+  }
+
+  return res;
+}
+
+/* BLOCKS */
+
+// Builds the macros, making sure that they are evaluated exactly like their gates
+class Builder {
+public:
+  Builder(const Netlist& netlist, std::span<const GateId> order)
+    : netlist(netlist), topoIndex(netlist.getGateCount(), UINT32_MAX),
+      claimed(netlist.getGateCount(), false)
+  {
+    for (const auto [i, g] : order | silicon::views::enumerate)
+      topoIndex[g] = i;
+
+    for (const NetId n : netlist.getPrimaryOutputs())
+      primaryOutputs.insert(n);
+  }
+
+  // The gates between `outputs` and `leaves`, nullopt if the cone goes beyond the leaves
+  [[nodiscard]] std::optional<std::vector<GateId>>
+  cone(std::span<const NetId> outputs, std::span<const NetId> leaves) const
+  {
+    std::vector<GateId> gates{};
+    std::vector<NetId>  stack(outputs.begin(), outputs.end());
+
+    while (!stack.empty()) {
+      const NetId n = stack.back();
+      stack.pop_back();
+
+      if (contains(leaves, n))
+        continue;
+
+      const GateId g = netlist.getDriver(n);
+      if (g == Netlist::NO_GATE || topoIndex[g] == UINT32_MAX)
+        return std::nullopt;
+
+      if (contains(gates, g))
+        continue;
+
+      gates.push_back(g);
+      for (const NetId input : netlist.getGateInputs(g))
+        stack.push_back(input);
+    }
+
+    return gates;
+  }
+
+  // Removes the nets computed inside the cone of another net of `nets`
+  void keepOutermost(std::vector<NetId>& nets, std::span<const NetId> leaves) const
+  {
+    if (nets.size() < 2)
+      return;
+
+    std::vector<GateId> inner{};
+    for (const NetId n : nets)
+      if (const auto gates = cone(std::array{n}, leaves))
+        for (const GateId g : *gates)
+          if (netlist.getGateOutput(g) != n)
+            inner.push_back(g);
+
+    std::erase_if(nets, [&](NetId n) { return contains(inner, netlist.getDriver(n)); });
+  }
+
+  // Adds `macro` if its internal nets are not used outside of it and its gates are not
+  // part of another macro
+  bool add(Macro macro)
+  {
+    std::ranges::sort(macro.gates);
+    const auto [first, last] = std::ranges::unique(macro.gates);
+    macro.gates.erase(first, last);
+
+    if (macro.gates.size() < MIN_GATES)
+      return false;
+
+    const std::unordered_set<GateId> gates(macro.gates.begin(), macro.gates.end());
+    const std::unordered_set<NetId>  outputs(macro.outputs.begin(), macro.outputs.end());
+
+    for (const GateId g : macro.gates) {
+      if (claimed[g])
+        return false;
+
+      const NetId n = netlist.getGateOutput(g);
+
+      // The inputs are read before the outputs are computed
+      if (contains(macro.inputs, n))
+        return false;
+
+      if (outputs.contains(n))
+        continue;
+
+      if (primaryOutputs.contains(n))
+        return false;
+
+      for (const GateId next : netlist.getFanout(n))
+        if (!gates.contains(next))
+          return false;
+    }
+
+    for (const GateId g : macro.gates)
+      claimed[g] = true;
+
+    std::ranges::sort(macro.gates, {}, [this](GateId g) { return topoIndex[g]; });
+    macros.push_back(std::move(macro));
+    return true;
+  }
+
+  std::vector<Macro> takeMacros() { return std::move(macros); }
+
+private:
+  const Netlist& netlist;
+
+  std::vector<uint32_t>     topoIndex;
+  std::vector<bool>         claimed;
+  std::unordered_set<NetId> primaryOutputs;
+
+  std::vector<Macro> macros;
+};
+
+using CutIndex = std::map<std::array<NetId, MAX_LEAVES + 1>,
+                          std::vector<std::pair<NetId, uint8_t>>>;
+
+// A bit of a ripple-carry adder: a full adder, or a half adder
+struct AdderCell {
+  NetId               sum;
+  NetId               carry;
+  Cut                 cut;
+  std::vector<GateId> gates;
+};
+
+void recognizeAdders(const CutIndex& index, Builder& builder)
+{
+  std::vector<AdderCell>            cells{};
+  std::unordered_map<NetId, size_t> bySum{};
+  std::unordered_set<GateId>        fullAdderGates{};
+
+  // Full adders first: the half adders inside them must not become cells
+  for (const uint32_t size : {3u, 2u}) {
+    const auto [sumTT, carryTT] =
+        size == 3 ? std::pair(XOR3, MAJ3) : std::pair(XOR2, AND2);
+
+    for (const auto& [key, nets] : index) {
+      if (key[0] != size)
+        continue;
+
+      Cut cut{};
+      cut.size = size;
+      std::ranges::copy(std::span(key).subspan(1), cut.leaves.begin());
+
+      std::vector<NetId> sums, carries;
+      for (const auto& [net, tt] : nets) {
+        if (tt == sumTT)
+          sums.push_back(net);
+        if (tt == carryTT)
+          carries.push_back(net);
+      }
+
+      // Buffered copies of the same function: only the last one is the output of the cell
+      builder.keepOutermost(sums, cut.getLeaves());
+      builder.keepOutermost(carries, cut.getLeaves());
+
+      for (size_t i = 0; i < sums.size() && i < carries.size(); i++) {
+        auto gates = builder.cone(std::array{sums[i], carries[i]}, cut.getLeaves());
+        if (!gates)
+          continue;
+
+        const auto inFullAdder = [&](GateId g) { return fullAdderGates.contains(g); };
+        if (std::ranges::any_of(*gates, inFullAdder))
+          continue;
+
+        // The same cell can be cut further away from its outputs (e.g. after a buffer
+        // of the previous carry): the smallest cone reads the nets of the previous cell
+        const auto [it, inserted] = bySum.emplace(sums[i], cells.size());
+        if (inserted)
+          cells.push_back({sums[i], carries[i], cut, std::move(*gates)});
+        else if (cells[it->second].gates.size() > gates->size())
+          cells[it->second] = {sums[i], carries[i], cut, std::move(*gates)};
+      }
+    }
+
+    if (size == 3)
+      for (const auto& cell : cells)
+        fullAdderGates.insert(cell.gates.begin(), cell.gates.end());
+  }
+
+  // The carry of a cell is a leaf of the next one
+  std::unordered_map<NetId, size_t> byCarry{};
+  for (const auto [i, cell] : cells | silicon::views::enumerate)
+    byCarry.emplace(cell.carry, i);
+
+  constexpr size_t NONE = SIZE_MAX;
+
+  std::vector<size_t> prev(cells.size(), NONE), next(cells.size(), NONE);
+  for (const auto [i, cell] : cells | silicon::views::enumerate) {
+    for (const NetId leaf : cell.cut.getLeaves()) {
+      const auto it = byCarry.find(leaf);
+      if (it == byCarry.end() || it->second == static_cast<size_t>(i)
+          || next[it->second] != NONE)
+        continue;
+
+      prev[i]          = it->second;
+      next[it->second] = i;
+      break;
+    }
+  }
+
+  std::vector<bool> visited(cells.size(), false);
+
+  for (size_t start = 0; start < cells.size(); start++) {
+    if (prev[start] != NONE || visited[start])
+      continue;
+
+    // Bits of the adder, split in words of at most MAX_WIDTH bits
+    Macro macro{};
+    std::vector<NetId> a, b, sums, carries;
+    NetId              cin = Netlist::NO_NET;
+
+    const auto flush = [&] {
+      if (sums.empty())
+        return;
+
+      macro.type  = MacroType::ADDER;
+      macro.width = sums.size();
+      macro.inputs = a;
+      macro.inputs.insert(macro.inputs.end(), b.begin(), b.end());
+      macro.inputs.push_back(cin);
+      macro.outputs = sums;
+      macro.outputs.insert(macro.outputs.end(), carries.begin(), carries.end());
+
+      builder.add(std::move(macro));
+
+      macro = {};
+      cin   = carries.back();
+      a.clear(), b.clear(), sums.clear(), carries.clear();
+    };
+
+    for (size_t i = start; i != NONE && !visited[i]; i = next[i]) {
+      visited[i] = true;
+
+      const auto& cell = cells[i];
+
+      std::vector<NetId> leaves(cell.cut.getLeaves().begin(), cell.cut.getLeaves().end());
+
+      // The carry in is the carry of the previous bit, or the last leaf of the first one
+      // if it's a full adder
+      if (prev[i] != NONE)
+        std::erase(leaves, cells[prev[i]].carry);
+      else if (cell.cut.size == 3 && sums.empty())
+        cin = leaves.back(), leaves.pop_back();
+
+      leaves.resize(2, Netlist::NO_NET);
+
+      a.push_back(leaves[0]);
+      b.push_back(leaves[1]);
+      sums.push_back(cell.sum);
+      carries.push_back(cell.carry);
+      macro.gates.insert(macro.gates.end(), cell.gates.begin(), cell.gates.end());
+
+      if (sums.size() == Macro::MAX_WIDTH)
+        flush();
+    }
+
+    flush();
+  }
+}
+
+void recognizeMuxes(const CutIndex& index, Builder& builder)
+{
+  struct Cell {
+    NetId               y, lo, hi;
+    std::vector<GateId> gates;
+  };
+
+  // Bits sharing the same select are a single word
+  std::map<NetId, std::vector<Cell>> bySelect{};
+
+  for (const auto& [key, nets] : index) {
+    if (key[0] != 3)
+      continue;
+
+    const std::array leaves = {key[1], key[2], key[3]};
+
+    for (const auto& [net, tt] : nets) {
+      const auto v = std::ranges::find(MUX_VARIANTS, tt, &MuxVariant::tt);
+      if (v == MUX_VARIANTS.end())
+        continue;
+
+      if (auto gates = builder.cone(std::array{net}, leaves))
+        bySelect[leaves[v->sel]].push_back({net, leaves[v->lo], leaves[v->hi],
+                                            std::move(*gates)});
+    }
+  }
+
+  for (auto& [sel, cells] : bySelect) {
+    for (size_t first = 0; first < cells.size(); first += Macro::MAX_WIDTH) {
+      const auto word = std::span(cells).subspan(
+          first, std::min<size_t>(Macro::MAX_WIDTH, cells.size() - first));
+
+      Macro macro{};
+      macro.type  = MacroType::MUX;
+      macro.width = word.size();
+
+      for (const auto& cell : word)
+        macro.inputs.push_back(cell.lo);
+      for (const auto& cell : word)
+        macro.inputs.push_back(cell.hi);
+      macro.inputs.push_back(sel);
+
+      for (const auto& cell : word) {
+        macro.outputs.push_back(cell.y);
+        macro.gates.insert(macro.gates.end(), cell.gates.begin(), cell.gates.end());
+      }
+
+      builder.add(std::move(macro));
+    }
+  }
+}
+
+void recognizeDecoders(const CutIndex& index, Builder& builder)
+{
+  for (const auto size : {3u, 2u}) {
+    const uint32_t outputCount = 1u << size;
+
+    std::array<uint8_t, 8> minterms{};
+    for (uint32_t k = 0; k < outputCount; k++)
+      minterms[k] = minterm(k, size);
+
+    for (const auto& [key, nets] : index) {
+      if (key[0] != size)
+        continue;
+
+      const auto leaves = std::span(key).subspan(1, size);
+
+      std::vector<NetId> outputs(outputCount, Netlist::NO_NET);
+      for (const auto& [net, tt] : nets) {
+        const auto first = minterms.begin();
+        const auto k     = std::ranges::find(first, first + outputCount, tt) - first;
+        if (k < outputCount && outputs[k] == Netlist::NO_NET)
+          outputs[k] = net;
+      }
+
+      if (contains(outputs, Netlist::NO_NET))
+        continue;
+
+      auto gates = builder.cone(outputs, leaves);
+      if (!gates)
+        continue;
+
+      Macro macro{};
+      macro.type    = MacroType::DECODER;
+      macro.width   = size;
+      macro.inputs  = {leaves.begin(), leaves.end()};
+      macro.outputs = std::move(outputs);
+      macro.gates   = std::move(*gates);
+
+      builder.add(std::move(macro));
+    }
+  }
+}
+
+}  // namespace
+
+MacroSet::MacroSet(const Netlist& netlist, std::vector<Macro> macros)
+  : macros(std::move(macros)), gateMacros(netlist.getGateCount(), NO_MACRO)
+{
+  for (const auto [i, macro] : this->macros | silicon::views::enumerate) {
+    for (const GateId g : macro.gates) {
+      assert(gateMacros[g] == NO_MACRO);
+      gateMacros[g] = i;
+    }
+
+    coveredGates += macro.gates.size();
+  }
+}
+
+MacroSet MacroSet::recognize(const Netlist& netlist)
+{
+  assert(netlist.isFinalized());
+
+  const auto order = netlist.getCombinationalOrder();
+  const auto cuts  = enumerateCuts(netlist, order);
+
+  // Only the functions of the known cells are indexed
+  std::array<bool, 256> interesting{};
+  for (const auto tt : {XOR2, AND2, XOR3, MAJ3})
+    interesting[tt] = true;
+  for (const auto& variant : MUX_VARIANTS)
+    interesting[variant.tt] = true;
+  for (const uint32_t size : {2u, 3u})
+    for (uint32_t k = 0; k < 1u << size; k++)
+      interesting[minterm(k, size)] = true;
+
+  CutIndex index{};
+  for (NetId n = 0; n < cuts.size(); n++)
+    for (const auto& cut : cuts[n].get())
+      if (cut.size >= 2 && interesting[cut.tt])
+        index[cut.key()].emplace_back(n, cut.tt);
+
+  Builder builder(netlist, order);
+  recognizeAdders(index, builder);
+  recognizeMuxes(index, builder);
+  recognizeDecoders(index, builder);
+
+  return {netlist, builder.takeMacros()};
+}
+
+bool MacroSet::evaluate(const Macro& macro, const std::span<const State> states,
+                        const std::span<State> outputs)
+{
+  const auto read = [states](const std::span<const NetId> nets, uint64_t& value) {
+    value = 0;
+    for (const auto [i, n] : nets | silicon::views::enumerate) {
+      if (n == Netlist::NO_NET)
+        continue;
+      if (states[n] == State::ERROR)
+        return false;
+      if (states[n] == State::HIGH)
+        value |= uint64_t{1} << i;
+    }
+    return true;
+  };
+
+  const auto write = [outputs](const size_t first, const size_t count,
+                               const uint64_t value) {
+    for (size_t i = 0; i < count; i++)
+      outputs[first + i] = (value >> i) & 1 ? State::HIGH : State::LOW;
+  };
+
+  const auto   inputs = std::span(macro.inputs);
+  const size_t w      = macro.width;
+
+  uint64_t a = 0, b = 0, c = 0;
+
+  switch (macro.type) {
+    case MacroType::ADDER: {
+      if (!read(inputs.first(w), a) || !read(inputs.subspan(w, w), b)
+          || !read(inputs.subspan(2 * w, 1), c))
+        return false;
+
+      // Bit i + 1 of a ^ b ^ sum is the carry out of bit i
+      const uint64_t sum = a + b + c;
+      write(0, w, sum);
+      write(w, w, (a ^ b ^ sum) >> 1);
+      return true;
+    }
+
+    case MacroType::MUX: {
+      // Like the gates, an ERROR in the word not selected is still an ERROR
+      if (!read(inputs.first(w), a) || !read(inputs.subspan(w, w), b)
+          || !read(inputs.subspan(2 * w, 1), c))
+        return false;
+
+      write(0, w, c ? b : a);
+      return true;
+    }
+
+    case MacroType::DECODER: {
+      if (!read(inputs, a))
+        return false;
+
+      std::ranges::fill(outputs, State::LOW);
+      outputs[a] = State::HIGH;
+      return true;
+    }
+  }
+
+  assert(false);
+  return false;
+}
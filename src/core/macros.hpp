@@ -0,0 +1,93 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <core/netlist.hpp>
+#include <core/wire.hpp>
+
+/* Word-level evaluators for common blocks of gates.
+ *
+ * MacroSet::recognize() looks for ripple-carry adders, banks of 2:1 multiplexers sharing
+ * their select and 2-to-4 / 3-to-8 decoders in a finalized Netlist. Every recognized
+ * block becomes a Macro that the Simulator evaluates with a few integer operations
+ * instead of one gate at a time. The gates stay in the netlist: they are used when an
+ * input of the macro is in the ERROR state, and to cross-check the macros.
+ *
+ * The recognition enumerates the cuts of up to 3 nets of every net and compares their
+ * truth tables with the ones of the known cells, so it doesn't depend on how the cells
+ * are drawn (e.g. a full adder made of two half adders or of a 3-input XOR). A block is
+ * only accepted if its internal nets are not used outside of it. */
+
+enum class MacroType : uint8_t {
+  ADDER,    // a[w], b[w], cin             -> sum[w], carry out of every bit[w]
+  MUX,      // a[w], b[w], sel             -> y[w], b when sel is HIGH
+  DECODER,  // sel[w], least significant first -> y[2^w], y[i] is HIGH when sel == i
+};
+
+struct Macro {
+  // Words are at most 63 bits wide: longer blocks are split in more macros
+  static constexpr uint32_t MAX_WIDTH = 63;
+
+  MacroType type;
+  uint32_t  width;
+
+  // Netlist::NO_NET inputs are LOW (e.g. the carry in of an adder starting with a half
+  // adder)
+  std::vector<NetId> inputs;
+  std::vector<NetId> outputs;
+
+  // The gates replaced by the macro, in topological order
+  std::vector<GateId> gates;
+};
+
+class MacroSet {
+public:
+  static constexpr uint32_t NO_MACRO = UINT32_MAX;
+
+  MacroSet() = default;
+
+  // `macros` must not share any gate
+  MacroSet(const Netlist& netlist, std::vector<Macro> macros);
+
+  static MacroSet recognize(const Netlist& netlist);
+
+  // Computes the outputs of `macro` from `states`. Returns false if an input is in the
+  // ERROR state: the outputs must then be computed by the gates.
+  static bool evaluate(const Macro& macro, std::span<const State> states,
+                       std::span<State> outputs);
+
+  [[nodiscard]] std::span<const Macro> getMacros() const { return macros; }
+
+  // The macro containing `gate`, NO_MACRO if it's evaluated on its own
+  [[nodiscard]] uint32_t getMacro(GateId gate) const
+  {
+    return gate < gateMacros.size() ? gateMacros[gate] : NO_MACRO;
+  }
+
+  [[nodiscard]] bool   empty() const { return macros.empty(); }
+  [[nodiscard]] size_t getCoveredGateCount() const { return coveredGates; }
+
+private:
+  std::vector<Macro>    macros;
+  std::vector<uint32_t> gateMacros;
+  size_t                coveredGates = 0;
+};
@@ -0,0 +1,342 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "netlist.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+std::string_view to_str(const GateType type)
+{
+  switch (type) {
+    case GateType::BUF: return "BUF";
+    case GateType::NOT: return "NOT";
+    case GateType::AND: return "AND";
+    case GateType::NAND: return "NAND";
+    case GateType::OR: return "OR";
+    case GateType::NOR: return "NOR";
+    case GateType::XOR: return "XOR";
+    case GateType::XNOR: return "XNOR";
+    case GateType::CONST0: return "CONST0";
+    case GateType::CONST1: return "CONST1";
+    case GateType::DFF: return "DFF";
+  }
+  assert(false);
+  return {};
+}
+
+std::string_view Netlist::NamePool::add(const std::string_view name)
+{
+  // A name longer than a chunk gets one of its own, which is full right away
+  if (name.size() > capacity - used) {
+    capacity = std::max(CHUNK_SIZE, name.size());
+    chunks.push_back(std::make_unique<char[]>(capacity));
+    used = 0;
+  }
+
+  char* dest = chunks.back().get() + used;
+  std::memcpy(dest, name.data(), name.size());
+  used += name.size();
+
+  return {dest, name.size()};
+}
+
+NetId Netlist::addNet(const std::string_view name)
+{
+  const auto id = static_cast<NetId>(initialStates.size());
+
+  initialStates.push_back(State::ERROR);
+  finalized = false;
+
+  if (name.empty()) {
+    netNames.emplace_back();
+    return id;
+  }
+
+  assert(!netsByName.contains(name));
+
+  const auto stored = namePool.add(name);
+  netNames.push_back(stored);
+  netsByName.emplace(stored, id);
+
+  return id;
+}
+
+NetId Netlist::getOrAddNet(const std::string_view name)
+{
+  if (const auto it = netsByName.find(name); it != netsByName.end())
+    return it->second;
+
+  return addNet(name);
+}
+
+NetId Netlist::findNet(const std::string_view name) const
+{
+  const auto it = netsByName.find(name);
+  return it == netsByName.end() ? NO_NET : it->second;
+}
+
+std::string_view Netlist::getNetName(const NetId net) const
+{
+  return netNames[net];
+}
+
+GateId Netlist::addGate(const GateType type, const std::span<const NetId> inputs,
+                        const NetId output)
+{
+  assert(output < getNetCount());
+  assert(std::ranges::all_of(inputs, [this](NetId n) { return n < getNetCount(); }));
+
+  const auto id = static_cast<GateId>(gateTypes.size());
+
+  gateTypes.push_back(type);
+  gateInputs.insert(gateInputs.end(), inputs.begin(), inputs.end());
+  gateInputOffsets.push_back(static_cast<uint32_t>(gateInputs.size()));
+  gateOutputs.push_back(output);
+
+  finalized = false;
+  return id;
+}
+
+std::span<const NetId> Netlist::getGateInputs(const GateId gate) const
+{
+  const auto first = gateInputOffsets[gate];
+  return std::span(gateInputs).subspan(first, gateInputOffsets[gate + 1] - first);
+}
+
+std::span<const NetId> Netlist::getPrimaryInputs() const
+{
+  return primaryInputs;
+}
+
+std::span<const NetId> Netlist::getPrimaryOutputs() const
+{
+  return primaryOutputs;
+}
+
+GateId Netlist::getDriver(const NetId net) const
+{
+  assert(finalized);
+  return drivers[net];
+}
+
+std::span<const GateId> Netlist::getFanout(const NetId net) const
+{
+  assert(finalized);
+
+  const auto first = fanoutOffsets[net];
+  return std::span(fanout).subspan(first, fanoutOffsets[net + 1] - first);
+}
+
+std::expected<void, std::string> Netlist::finalize()
+{
+  const auto netCount = getNetCount();
+
+  const auto netName = [this](const NetId net) {
+    return netNames[net].empty() ? "#" + std::to_string(net) : std::string(netNames[net]);
+  };
+
+  /* DRIVERS */
+
+  drivers.assign(netCount, NO_GATE);
+
+  for (GateId g = 0; g < getGateCount(); g++) {
+    auto& driver = drivers[gateOutputs[g]];
+    if (driver != NO_GATE)
+      return std::unexpected("Net " + netName(gateOutputs[g]) + " has multiple drivers");
+    driver = g;
+  }
+
+  for (const NetId input : primaryInputs)
+    if (drivers[input] != NO_GATE)
+      return std::unexpected("Input " + netName(input) + " is driven by a gate");
+
+  /* FAN-OUT */
+
+  // Counting sort of the (net, gate) pairs by net
+  fanoutOffsets.assign(netCount + 1, 0);
+
+  for (const NetId input : gateInputs)
+    fanoutOffsets[input + 1]++;
+
+  for (size_t i = 0; i < netCount; i++)
+    fanoutOffsets[i + 1] += fanoutOffsets[i];
+
+  fanout.resize(gateInputs.size());
+  std::vector<uint32_t> next(fanoutOffsets.begin(), fanoutOffsets.end() - 1);
+
+  for (GateId g = 0; g < getGateCount(); g++) {
+    for (const NetId input : getGateInputs(g)) {
+      // A gate reading the same net twice is listed once
+      const auto first = fanoutOffsets[input];
+      if (next[input] > first && fanout[next[input] - 1] == g)
+        continue;
+      fanout[next[input]++] = g;
+    }
+  }
+
+  // Remove the holes left by the duplicates
+  uint32_t write = 0;
+  for (size_t net = 0; net < netCount; net++) {
+    const auto first   = fanoutOffsets[net];
+    fanoutOffsets[net] = write;
+    for (auto i = first; i < next[net]; i++)
+      fanout[write++] = fanout[i];
+  }
+  fanoutOffsets[netCount] = write;
+  fanout.resize(write);
+
+  finalized = true;
+  return {};
+}
+
+std::vector<GateId> Netlist::getCombinationalOrder() const
+{
+  assert(finalized);
+
+  const auto gateCount = getGateCount();
+
+  std::vector<bool> excluded(gateCount, false);
+  for (GateId g = 0; g < gateCount; g++)
+    excluded[g] = gateTypes[g] == GateType::DFF;
+
+  std::vector<GateId>   order{};
+  std::vector<uint32_t> missing(gateCount, 0);
+
+  // Kahn's algorithm over the gates that are not excluded. The fan-out lists a gate once
+  // even if it reads the same net twice, so the inputs are counted in the same way.
+  const auto sort = [&] {
+    std::ranges::fill(missing, 0);
+    for (GateId g = 0; g < gateCount; g++)
+      if (!excluded[g])
+        for (const GateId next : getFanout(gateOutputs[g]))
+          missing[next] += !excluded[next];
+
+    const auto first = order.size();
+    for (GateId g = 0; g < gateCount; g++)
+      if (!excluded[g] && missing[g] == 0)
+        order.push_back(g);
+
+    for (size_t i = first; i < order.size(); i++)
+      for (const GateId next : getFanout(gateOutputs[order[i]]))
+        if (!excluded[next] && --missing[next] == 0)
+          order.push_back(next);
+
+    for (size_t i = first; i < order.size(); i++)
+      excluded[order[i]] = true;
+  };
+
+  sort();
+
+  // The gates left are in a loop or after one
+  for (const auto& loop : findLoops(excluded))
+    for (const GateId g : loop)
+      excluded[g] = true;
+
+  sort();
+
+  return order;
+}
+
+std::vector<std::vector<GateId>> Netlist::getCombinationalLoops() const
+{
+  assert(finalized);
+
+  std::vector<bool> excluded(getGateCount(), false);
+  for (GateId g = 0; g < getGateCount(); g++)
+    excluded[g] = gateTypes[g] == GateType::DFF;
+
+  return findLoops(excluded);
+}
+
+std::vector<std::vector<GateId>>
+Netlist::findLoops(const std::vector<bool>& excluded) const
+{
+  const auto gateCount = getGateCount();
+
+  // The strongly connected components (Tarjan's algorithm, without recursion)
+  constexpr uint32_t UNVISITED = UINT32_MAX;
+
+  std::vector<uint32_t> index(gateCount, UNVISITED), low(gateCount, 0);
+  std::vector<bool>     onStack(gateCount, false);
+  std::vector<GateId>   stack{};
+  uint32_t              counter = 0;
+
+  std::vector<std::vector<GateId>> loops{};
+
+  struct Frame {
+    GateId gate;
+    size_t next;
+  };
+  std::vector<Frame> frames{};
+
+  const auto visit = [&](const GateId g) {
+    index[g] = low[g] = counter++;
+    stack.push_back(g);
+    onStack[g] = true;
+    frames.push_back({g, 0});
+  };
+
+  for (GateId root = 0; root < gateCount; root++) {
+    if (excluded[root] || index[root] != UNVISITED)
+      continue;
+
+    visit(root);
+
+    while (!frames.empty()) {
+      const GateId g      = frames.back().gate;
+      const auto   fanout = getFanout(gateOutputs[g]);
+
+      if (frames.back().next < fanout.size()) {
+        const GateId next = fanout[frames.back().next++];
+        if (excluded[next])
+          continue;
+
+        if (index[next] == UNVISITED)
+          visit(next);
+        else if (onStack[next])
+          low[g] = std::min(low[g], index[next]);
+        continue;
+      }
+
+      frames.pop_back();
+      if (!frames.empty())
+        low[frames.back().gate] = std::min(low[frames.back().gate], low[g]);
+
+      if (low[g] != index[g])
+        continue;
+
+      // A component of a single gate is a loop only if the gate reads its own output
+      const bool loop = stack.back() != g || std::ranges::find(fanout, g) != fanout.end();
+
+      if (loop)
+        loops.emplace_back();
+
+      GateId member = NO_GATE;
+      while (member != g) {
+        member = stack.back();
+        stack.pop_back();
+        onStack[member] = false;
+        if (loop)
+          loops.back().push_back(member);
+      }
+    }
+  }
+
+  return loops;
+}
@@ -0,0 +1,150 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <core/wire.hpp>
+
+/* A flat, bit-level netlist.
+ *
+ * Unlike the Wire/Component graph, nets and gates are plain indices and every gate is a
+ * record in a few flat arrays: building a circuit with millions of gates doesn't
+ * allocate anything per gate. This is the representation used to import netlists from
+ * other tools and to simulate them with the Simulator. */
+
+using NetId  = uint32_t;
+using GateId = uint32_t;
+
+enum class GateType : uint8_t {
+  BUF,
+  NOT,
+  AND,
+  NAND,
+  OR,
+  NOR,
+  XOR,
+  XNOR,
+  CONST0,
+  CONST1,
+  DFF,  // Samples its only input when the circuit is clocked
+};
+
+std::string_view to_str(GateType type);
+
+class Netlist {
+public:
+  static constexpr NetId  NO_NET  = UINT32_MAX;
+  static constexpr GateId NO_GATE = UINT32_MAX;
+
+  Netlist() = default;
+
+  Netlist(Netlist&&)            = default;
+  Netlist& operator=(Netlist&&) = default;
+
+  // Nets without a name are only reachable through the gates
+  NetId addNet(std::string_view name = {});
+  NetId getOrAddNet(std::string_view name);
+  NetId findNet(std::string_view name) const;
+
+  GateId addGate(GateType type, std::span<const NetId> inputs, NetId output);
+
+  void addPrimaryInput(NetId net) { primaryInputs.push_back(net); }
+  void addPrimaryOutput(NetId net) { primaryOutputs.push_back(net); }
+
+  // State of the net before the simulation starts, ERROR by default
+  void  setInitialState(NetId net, State s) { initialStates[net] = s; }
+  State getInitialState(NetId net) const { return initialStates[net]; }
+
+  // Computes the drivers and the fan-out of every net. It must be called after the last
+  // change and before the netlist is simulated.
+  std::expected<void, std::string> finalize();
+
+  [[nodiscard]] bool isFinalized() const { return finalized; }
+
+  [[nodiscard]] size_t getNetCount() const { return initialStates.size(); }
+  [[nodiscard]] size_t getGateCount() const { return gateTypes.size(); }
+
+  [[nodiscard]] std::string_view getNetName(NetId net) const;
+
+  [[nodiscard]] GateType getGateType(GateId gate) const { return gateTypes[gate]; }
+  [[nodiscard]] NetId    getGateOutput(GateId gate) const { return gateOutputs[gate]; }
+  [[nodiscard]] std::span<const NetId> getGateInputs(GateId gate) const;
+
+  [[nodiscard]] std::span<const NetId> getPrimaryInputs() const;
+  [[nodiscard]] std::span<const NetId> getPrimaryOutputs() const;
+
+  // Only valid once the netlist has been finalized
+  [[nodiscard]] GateId                  getDriver(NetId net) const;
+  [[nodiscard]] std::span<const GateId> getFanout(NetId net) const;
+
+  // The combinational gates, each one after the drivers of its inputs. The gates in a
+  // combinational loop are left out, the ones they drive come after them in the
+  // order.
+  [[nodiscard]] std::vector<GateId> getCombinationalOrder() const;
+
+  // The strongly connected components of the combinational gates that form a loop (the
+  // DFFs break the loops). The circuit may still be stable, e.g. a latch, but every
+  // oscillation happens in one of them.
+  [[nodiscard]] std::vector<std::vector<GateId>> getCombinationalLoops() const;
+
+private:
+  // The loops among the gates that are not excluded
+  std::vector<std::vector<GateId>> findLoops(const std::vector<bool>& excluded) const;
+
+  // Names are stored in fixed-size chunks, so the views used as keys in `netsByName`
+  // stay valid when new names are added
+  class NamePool {
+  public:
+    std::string_view add(std::string_view name);
+
+  private:
+    static constexpr size_t CHUNK_SIZE = 64 * 1024;
+
+    std::vector<std::unique_ptr<char[]>> chunks;
+    size_t                               capacity = 0;
+    size_t                               used     = 0;
+  };
+
+  NamePool                                    namePool;
+  std::vector<std::string_view>               netNames;
+  std::unordered_map<std::string_view, NetId> netsByName;
+
+  std::vector<State> initialStates;
+
+  std::vector<GateType> gateTypes;
+  std::vector<uint32_t> gateInputOffsets = {0};
+  std::vector<NetId>    gateInputs;
+  std::vector<NetId>    gateOutputs;
+
+  std::vector<NetId> primaryInputs;
+  std::vector<NetId> primaryOutputs;
+
+  bool finalized = false;
+
+  std::vector<GateId>   drivers;
+  std::vector<uint32_t> fanoutOffsets;
+  std::vector<GateId>   fanout;
+};
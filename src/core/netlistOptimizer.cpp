@@ -0,0 +1,440 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "netlistOptimizer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <unordered_map>
+
+namespace {
+// A node of the graph, inverted if the lowest bit is set
+using Literal = uint32_t;
+
+// Node 0 is the constant
+constexpr Literal FALSE_LITERAL = 0;
+constexpr Literal TRUE_LITERAL  = 1;
+
+constexpr uint32_t nodeOf(const Literal l) { return l >> 1; }
+constexpr bool     isInverted(const Literal l) { return l & 1; }
+
+enum class NodeKind : uint8_t {
+  CONSTANT,
+  SOURCE,  // A net without a driver: a primary input or a floating net
+  OPAQUE,  // The output of a DFF, or of a gate in a combinational loop
+  AND,
+  XOR,
+};
+
+struct Node {
+  NodeKind kind;
+  NetId    net  = Netlist::NO_NET;   // SOURCE and OPAQUE: the original net
+  GateId   gate = Netlist::NO_GATE;  // OPAQUE: the original gate
+
+  uint32_t firstInput = 0;
+  uint32_t inputCount = 0;
+};
+
+struct KeyHash {
+  size_t operator()(const std::vector<Literal>& key) const
+  {
+    size_t res = key.size();
+    for (const Literal l : key)
+      res ^= std::hash<Literal>{}(l) + 0x9E3779B9 + (res << 6) + (res >> 2);
+    return res;
+  }
+};
+
+// AND/XOR graph with structural hashing: a node is only created once for the same kind
+// and the same (sorted) inputs
+class Graph {
+public:
+  enum class Outcome {
+    NEW,
+    EXISTING,
+    REDUCED,  // Equal to a constant or to one of the inputs
+  };
+
+  explicit Graph(const bool preserveErrors) : preserveErrors(preserveErrors)
+  {
+    nodes.push_back({NodeKind::CONSTANT});
+  }
+
+  Literal addSource(const NodeKind kind, const NetId net, const GateId gate)
+  {
+    nodes.push_back({kind, net, gate});
+    return (nodes.size() - 1) << 1;
+  }
+
+  void setInputs(const uint32_t node, const std::span<const Literal> literals)
+  {
+    nodes[node].firstInput = inputs.size();
+    nodes[node].inputCount = literals.size();
+    inputs.insert(inputs.end(), literals.begin(), literals.end());
+  }
+
+  Literal makeAnd(std::vector<Literal>& literals, Outcome& outcome)
+  {
+    outcome = Outcome::REDUCED;
+
+    std::erase(literals, TRUE_LITERAL);
+    std::ranges::sort(literals);
+    const auto [first, last] = std::ranges::unique(literals);
+    literals.erase(first, last);
+
+    if (!preserveErrors) {
+      // x AND NOT x
+      const auto opposite = std::ranges::adjacent_find(
+          literals, [](Literal a, Literal b) { return b == (a ^ 1); });
+
+      const bool hasFalse = !literals.empty() && literals[0] == FALSE_LITERAL;
+      if (opposite != literals.end() || hasFalse)
+        return FALSE_LITERAL;
+    }
+
+    if (literals.empty())
+      return TRUE_LITERAL;
+    if (literals.size() == 1)
+      return literals[0];
+
+    return hashed(NodeKind::AND, literals, outcome);
+  }
+
+  Literal makeXor(std::vector<Literal>& literals, Outcome& outcome)
+  {
+    outcome = Outcome::REDUCED;
+
+    // The inversions of the inputs become an inversion of the output
+    Literal parity = 0;
+    for (auto& l : literals) {
+      parity ^= l & 1;
+      l &= ~1u;
+    }
+
+    std::erase(literals, FALSE_LITERAL);
+    std::ranges::sort(literals);
+
+    if (!preserveErrors) {
+      // x XOR x
+      std::vector<Literal> odd{};
+      for (const Literal l : literals) {
+        if (!odd.empty() && odd.back() == l)
+          odd.pop_back();
+        else
+          odd.push_back(l);
+      }
+      literals = std::move(odd);
+    }
+
+    if (literals.empty())
+      return FALSE_LITERAL ^ parity;
+    if (literals.size() == 1)
+      return literals[0] ^ parity;
+
+    return hashed(NodeKind::XOR, literals, outcome) ^ parity;
+  }
+
+  [[nodiscard]] size_t      size() const { return nodes.size(); }
+  [[nodiscard]] const Node& operator[](const uint32_t node) const { return nodes[node]; }
+
+  [[nodiscard]] std::span<const Literal> getInputs(const uint32_t node) const
+  {
+    return std::span(inputs).subspan(nodes[node].firstInput, nodes[node].inputCount);
+  }
+
+private:
+  Literal hashed(const NodeKind kind, std::span<const Literal> literals, Outcome& outcome)
+  {
+    key.assign(1, static_cast<Literal>(kind));
+    key.insert(key.end(), literals.begin(), literals.end());
+
+    const auto [it, inserted] = table.try_emplace(key, nodes.size());
+    if (!inserted) {
+      outcome = Outcome::EXISTING;
+      return it->second << 1;
+    }
+
+    outcome = Outcome::NEW;
+    nodes.push_back({kind});
+    setInputs(nodes.size() - 1, literals);
+    return (nodes.size() - 1) << 1;
+  }
+
+  bool preserveErrors;
+
+  std::vector<Node>    nodes;
+  std::vector<Literal> inputs;
+
+  std::vector<Literal>                                        key;
+  std::unordered_map<std::vector<Literal>, uint32_t, KeyHash> table;
+};
+}  // namespace
+
+NetlistOptimizer::Result NetlistOptimizer::optimize(const Netlist& netlist)
+{
+  return optimize(netlist, {});
+}
+
+NetlistOptimizer::Result NetlistOptimizer::optimize(const Netlist& netlist,
+                                                    const Options& options)
+{
+  assert(netlist.isFinalized());
+
+  Report report{.gatesBefore = netlist.getGateCount()};
+  Graph  graph(options.preserveErrors);
+
+  /* GRAPH */
+
+  const auto order = netlist.getCombinationalOrder();
+
+  std::vector<bool> ordered(netlist.getGateCount(), false);
+  for (const GateId g : order)
+    ordered[g] = true;
+
+  // Literal of every net of the netlist
+  std::vector<Literal> literals(netlist.getNetCount(), FALSE_LITERAL);
+
+  for (NetId n = 0; n < netlist.getNetCount(); n++) {
+    const GateId driver = netlist.getDriver(n);
+    if (driver == Netlist::NO_GATE)
+      literals[n] = graph.addSource(NodeKind::SOURCE, n, Netlist::NO_GATE);
+    else if (!ordered[driver])
+      literals[n] = graph.addSource(NodeKind::OPAQUE, n, driver);
+  }
+
+  std::vector<Literal> in{};
+
+  for (const GateId g : order) {
+    in.clear();
+    for (const NetId n : netlist.getGateInputs(g))
+      in.push_back(literals[n]);
+
+    auto    outcome = Graph::Outcome::REDUCED;
+    Literal res     = FALSE_LITERAL;
+
+    switch (const auto type = netlist.getGateType(g)) {
+      case GateType::BUF: res = in[0]; break;
+      case GateType::NOT: res = in[0] ^ 1; break;
+      case GateType::AND:
+      case GateType::NAND:
+        res = graph.makeAnd(in, outcome) ^ (type == GateType::NAND);
+        break;
+      case GateType::OR:
+      case GateType::NOR:
+        // De Morgan: OR(a, b) = NOT AND(NOT a, NOT b)
+        for (auto& l : in)
+          l ^= 1;
+        res = graph.makeAnd(in, outcome) ^ (type == GateType::OR);
+        break;
+      case GateType::XOR:
+      case GateType::XNOR:
+        res = graph.makeXor(in, outcome) ^ (type == GateType::XNOR);
+        break;
+      case GateType::CONST0: res = FALSE_LITERAL; break;
+      case GateType::CONST1: res = TRUE_LITERAL; break;
+      case GateType::DFF: assert(false); break;
+    }
+
+    literals[netlist.getGateOutput(g)] = res;
+
+    if (nodeOf(res) == 0)
+      report.constants++;
+    else if (outcome == Graph::Outcome::REDUCED)
+      report.buffers++;
+    else if (outcome == Graph::Outcome::EXISTING)
+      report.duplicates++;
+  }
+
+  // The inputs of the opaque gates can come from anywhere
+  for (uint32_t node = 0; node < graph.size(); node++) {
+    if (graph[node].kind != NodeKind::OPAQUE)
+      continue;
+
+    in.clear();
+    for (const NetId n : netlist.getGateInputs(graph[node].gate))
+      in.push_back(literals[n]);
+    graph.setInputs(node, in);
+  }
+
+  /* LIVENESS */
+
+  std::vector<bool>     live(graph.size(), false);
+  std::vector<uint32_t> stack{};
+
+  const auto reach = [&](const Literal l) {
+    if (!live[nodeOf(l)]) {
+      live[nodeOf(l)] = true;
+      stack.push_back(nodeOf(l));
+    }
+  };
+
+  for (const NetId n : netlist.getPrimaryInputs())
+    reach(literals[n]);
+  for (const NetId n : netlist.getPrimaryOutputs())
+    reach(literals[n]);
+
+  while (!stack.empty()) {
+    const auto node = stack.back();
+    stack.pop_back();
+
+    for (const Literal l : graph.getInputs(node))
+      reach(l);
+  }
+
+  for (uint32_t node = 0; node < graph.size(); node++)
+    if (!live[node] && graph[node].kind != NodeKind::CONSTANT
+        && graph[node].kind != NodeKind::SOURCE)
+      report.dead++;
+
+  /* LITERALS TO EMIT */
+
+  // An AND of inverted literals is emitted as a NOR of the nets
+  const auto isNor = [&graph](const uint32_t node) {
+    return graph[node].kind == NodeKind::AND
+           && std::ranges::all_of(graph.getInputs(node), isInverted);
+  };
+
+  std::vector<bool> used(graph.size() * 2, false);
+
+  for (uint32_t node = 0; node < graph.size(); node++) {
+    if (!live[node])
+      continue;
+
+    // The net of a source or of an opaque gate exists anyway
+    if (graph[node].kind == NodeKind::SOURCE || graph[node].kind == NodeKind::OPAQUE)
+      used[node << 1] = true;
+
+    const Literal flip = isNor(node) ? 1 : 0;
+    for (const Literal l : graph.getInputs(node))
+      used[l ^ flip] = true;
+  }
+
+  for (const NetId n : netlist.getPrimaryOutputs())
+    used[literals[n]] = true;
+
+  /* NAMES */
+
+  // The original net whose name is given to the net of every literal. A primary output
+  // whose literal already has the name of another port gets its own buffer.
+  std::vector<NetId> namedBy(used.size(), Netlist::NO_NET);
+  std::vector<bool>  isPort(netlist.getNetCount(), false);
+  std::vector<NetId> portBuffers{};
+
+  for (const NetId n : netlist.getPrimaryInputs()) {
+    namedBy[literals[n]] = n;
+    isPort[n]            = true;
+  }
+
+  for (const NetId n : netlist.getPrimaryOutputs()) {
+    auto& name = namedBy[literals[n]];
+
+    if (name == Netlist::NO_NET)
+      name = n;
+    else if (name != n && !netlist.getNetName(n).empty())
+      portBuffers.push_back(n);
+
+    isPort[n] = true;
+  }
+
+  for (NetId n = 0; n < netlist.getNetCount(); n++) {
+    auto& name = namedBy[literals[n]];
+    if (!isPort[n] && used[literals[n]] && name == Netlist::NO_NET
+        && !netlist.getNetName(n).empty())
+      name = n;
+  }
+
+  /* NETLIST */
+
+  Result result{};
+  result.report = report;
+
+  auto& res = result.netlist;
+
+  std::vector<NetId> nets(used.size(), Netlist::NO_NET);
+
+  for (Literal l = 0; l < used.size(); l++) {
+    if (!used[l])
+      continue;
+
+    nets[l] = res.addNet(namedBy[l] == Netlist::NO_NET ? std::string_view{}
+                                                       : netlist.getNetName(namedBy[l]));
+
+    const auto& node = graph[nodeOf(l)];
+    if (!isInverted(l) && node.net != Netlist::NO_NET)
+      res.setInitialState(nets[l], netlist.getInitialState(node.net));
+  }
+
+  std::vector<NetId> gateInputs{};
+
+  for (Literal l = 0; l < used.size(); l++) {
+    if (!used[l])
+      continue;
+
+    const auto  node     = nodeOf(l);
+    const bool  inverted = isInverted(l);
+    const auto& info     = graph[node];
+
+    gateInputs.clear();
+    for (const Literal input : graph.getInputs(node))
+      gateInputs.push_back(nets[isNor(node) ? input ^ 1 : input]);
+
+    if (info.kind == NodeKind::CONSTANT) {
+      res.addGate(inverted ? GateType::CONST1 : GateType::CONST0, {}, nets[l]);
+    } else if (inverted && used[l ^ 1]) {
+      res.addGate(GateType::NOT, std::array{nets[l ^ 1]}, nets[l]);
+    } else if (info.kind == NodeKind::OPAQUE) {
+      res.addGate(netlist.getGateType(info.gate), gateInputs, nets[l]);
+    } else if (info.kind == NodeKind::AND) {
+      const auto type = isNor(node) ? (inverted ? GateType::OR : GateType::NOR)
+                                    : (inverted ? GateType::NAND : GateType::AND);
+      res.addGate(type, gateInputs, nets[l]);
+    } else if (info.kind == NodeKind::XOR) {
+      res.addGate(inverted ? GateType::XNOR : GateType::XOR, gateInputs, nets[l]);
+    }
+  }
+
+  result.netMap.assign(netlist.getNetCount(), Netlist::NO_NET);
+  for (NetId n = 0; n < netlist.getNetCount(); n++)
+    result.netMap[n] = nets[literals[n]];
+
+  for (const NetId n : portBuffers) {
+    result.netMap[n] = res.addNet(netlist.getNetName(n));
+    res.addGate(GateType::BUF, std::array{nets[literals[n]]}, result.netMap[n]);
+  }
+
+  for (const NetId n : netlist.getPrimaryInputs())
+    res.addPrimaryInput(result.netMap[n]);
+  for (const NetId n : netlist.getPrimaryOutputs())
+    res.addPrimaryOutput(result.netMap[n]);
+
+  [[maybe_unused]] const auto finalized = res.finalize();
+  assert(finalized);
+
+  result.report.gatesAfter = res.getGateCount();
+  return result;
+}
+
+std::string to_str(const NetlistOptimizer::Report& report)
+{
+  return std::to_string(report.gatesBefore) + " gates -> "
+         + std::to_string(report.gatesAfter) + ": " + std::to_string(report.constants)
+         + " constant, " + std::to_string(report.buffers) + " buffers, "
+         + std::to_string(report.duplicates) + " duplicates, "
+         + std::to_string(report.dead) + " dead";
+}
@@ -0,0 +1,75 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <core/netlist.hpp>
+
+/* Simplifications of a Netlist that don't change what can be observed on its primary
+ * outputs.
+ *
+ * Every combinational gate is rewritten as an AND or a XOR of literals (nets, possibly
+ * inverted), so that:
+ * - gates whose inputs are constant become constants, and constant inputs that don't
+ *   decide the output are dropped;
+ * - buffers and chains of inverters disappear;
+ * - gates computing the same function of the same literals are merged, whatever their
+ *   original type (e.g. OR(a, b) and NAND(NOT a, NOT b)).
+ * Then only the gates reachable backwards from the primary outputs are kept.
+ *
+ * By default the ERROR state is preserved exactly: AND(x, 0) is still ERROR when x is,
+ * so constants that decide the output of a gate only fold it if `preserveErrors` is
+ * false. DFFs and the gates in (or after) a combinational loop are kept as they are,
+ * apart from their inputs. */
+
+class NetlistOptimizer {
+public:
+  struct Options {
+    bool preserveErrors = true;
+  };
+
+  // Gates of the original netlist, by the reason they were removed
+  struct Report {
+    size_t gatesBefore = 0;
+    size_t gatesAfter  = 0;
+
+    size_t constants  = 0;  // Computing a constant
+    size_t buffers    = 0;  // Buffers, inverters and gates equal to one of their inputs
+    size_t duplicates = 0;  // Equal to another gate
+    size_t dead       = 0;  // Not observable from the primary outputs
+  };
+
+  struct Result {
+    Netlist netlist;  // Finalized
+
+    // New net of every net of the original netlist, NO_NET if it was removed. Primary
+    // inputs and outputs are always kept with their names.
+    std::vector<NetId> netMap;
+
+    Report report;
+  };
+
+  // `netlist` must be finalized
+  static Result optimize(const Netlist& netlist);
+  static Result optimize(const Netlist& netlist, const Options& options);
+};
+
+std::string to_str(const NetlistOptimizer::Report& report);
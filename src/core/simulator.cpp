@@ -0,0 +1,422 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "simulator.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+
+namespace {
+const MacroSet& noMacros()
+{
+  static const MacroSet empty{};
+  return empty;
+}
+}  // namespace
+
+Simulator::Simulator(const Netlist& netlist)
+  : Simulator(netlist, noMacros(), MacroMode::OFF)
+{}
+
+Simulator::Simulator(const Netlist& netlist, const MacroSet& macros, const MacroMode mode)
+  : netlist(netlist), macros(&macros), macroMode(macros.empty() ? MacroMode::OFF : mode)
+{
+  assert(netlist.isFinalized());
+
+  isPending.assign(netlist.getGateCount(), false);
+  isMacroPending.assign(macros.getMacros().size(), false);
+
+  for (GateId g = 0; g < netlist.getGateCount(); g++)
+    if (netlist.getGateType(g) == GateType::DFF)
+      registers.push_back(g);
+
+  sampled.resize(registers.size());
+
+  loops = netlist.getCombinationalLoops();
+  if (!loops.empty()) {
+    gateLoops.assign(netlist.getGateCount(), NO_LOOP);
+    for (uint32_t i = 0; i < loops.size(); i++)
+      for (const GateId g : loops[i])
+        gateLoops[g] = i;
+
+    loopWaves.assign(loops.size(), 0);
+    loopIterations.assign(loops.size(), 0);
+  }
+
+  reset();
+}
+
+void Simulator::reset()
+{
+  const auto netCount = netlist.getNetCount();
+
+  states.resize(netCount);
+  for (NetId n = 0; n < netCount; n++)
+    states[n] = netlist.getInitialState(n);
+
+  pending.clear();
+  std::ranges::fill(isPending, false);
+
+  pendingMacros.clear();
+  std::ranges::fill(isMacroPending, false);
+  macroMismatches.clear();
+  oscillations.clear();
+  cycle = 0;
+
+  for (GateId g = 0; g < netlist.getGateCount(); g++) {
+    if (netlist.getGateType(g) == GateType::DFF)
+      continue;
+
+    const auto macro = macros->getMacro(g);
+    if (macroMode != MacroMode::OFF && macro != MacroSet::NO_MACRO) {
+      scheduleMacro(macro);
+      if (macroMode == MacroMode::ON)
+        continue;
+    }
+
+    pending.push_back(g);
+    isPending[g] = true;
+  }
+
+  settle();
+}
+
+void Simulator::setState(const NetId net, const State s)
+{
+  if (profile)
+    update<true>(net, s);
+  else
+    update<false>(net, s);
+}
+
+template <bool PROFILE>
+void Simulator::update(const NetId net, const State s)
+{
+  if (states[net] == s)
+    return;
+
+  states[net] = s;
+
+  if constexpr (PROFILE)
+    profile->netToggles[net]++;
+
+  schedule(net);
+}
+
+void Simulator::setProfiling(const bool enabled)
+{
+  if (!enabled) {
+    profile.reset();
+    return;
+  }
+
+  profile.emplace();
+  profile->gateEvaluations.assign(netlist.getGateCount(), 0);
+  profile->netToggles.assign(netlist.getNetCount(), 0);
+}
+
+void Simulator::setIterationLimit(const uint32_t limit)
+{
+  assert(limit > 0);
+  iterationLimit = limit;
+}
+
+void Simulator::setValue(const std::span<const NetId> nets, const uint64_t value)
+{
+  assert(nets.size() <= 64);
+
+  for (size_t i = 0; i < nets.size(); i++)
+    setState(nets[i], (value >> i) & 1 ? State::HIGH : State::LOW);
+}
+
+uint64_t Simulator::getValue(const std::span<const NetId> nets) const
+{
+  assert(nets.size() <= 64);
+
+  uint64_t value = 0;
+  for (size_t i = 0; i < nets.size(); i++)
+    if (states[nets[i]] == State::HIGH)
+      value |= uint64_t{1} << i;
+
+  return value;
+}
+
+bool Simulator::isInErrorState(const std::span<const NetId> nets) const
+{
+  return std::ranges::any_of(nets, [this](NetId n) { return states[n] == State::ERROR; });
+}
+
+void Simulator::schedule(const NetId net)
+{
+  for (const GateId g : netlist.getFanout(net)) {
+    if (isPending[g] || netlist.getGateType(g) == GateType::DFF)
+      continue;
+
+    if (macroMode != MacroMode::OFF) {
+      const auto macro = macros->getMacro(g);
+
+      // The gates of the macro being evaluated are already up to date
+      if (macro != MacroSet::NO_MACRO && macro != evaluatingMacro)
+        scheduleMacro(macro);
+
+      if (macro != MacroSet::NO_MACRO && macroMode == MacroMode::ON)
+        continue;
+    }
+
+    pending.push_back(g);
+    isPending[g] = true;
+  }
+}
+
+void Simulator::scheduleMacro(const uint32_t macro)
+{
+  if (isMacroPending[macro])
+    return;
+
+  pendingMacros.push_back(macro);
+  isMacroPending[macro] = true;
+}
+
+void Simulator::evaluateMacro(const uint32_t macro)
+{
+  const auto& m = macros->getMacros()[macro];
+  macroOutputs.resize(m.outputs.size());
+
+  evaluatingMacro = macro;
+
+  if (MacroSet::evaluate(m, states, macroOutputs)) {
+    for (size_t i = 0; i < m.outputs.size(); i++)
+      setState(m.outputs[i], macroOutputs[i]);
+  } else {
+    // An input is in the ERROR state: the gates know which outputs are affected
+    for (const GateId g : m.gates)
+      setState(netlist.getGateOutput(g), evaluate(g));
+  }
+
+  evaluatingMacro = MacroSet::NO_MACRO;
+}
+
+void Simulator::verifyMacros()
+{
+  for (const uint32_t macro : pendingMacros) {
+    isMacroPending[macro] = false;
+
+    const auto& m = macros->getMacros()[macro];
+    macroOutputs.resize(m.outputs.size());
+
+    if (!MacroSet::evaluate(m, states, macroOutputs))
+      continue;
+
+    for (size_t i = 0; i < m.outputs.size(); i++) {
+      if (states[m.outputs[i]] != macroOutputs[i]) {
+        macroMismatches.push_back(macro);
+        break;
+      }
+    }
+  }
+
+  pendingMacros.clear();
+}
+
+void Simulator::settle()
+{
+  if (profile)
+    settleWaves<true>();
+  else
+    settleWaves<false>();
+
+  // The macros are compared once the gates are stable
+  if (macroMode == MacroMode::VERIFY)
+    verifyMacros();
+}
+
+template <bool PROFILE>
+void Simulator::settleWaves()
+{
+  using Clock = std::chrono::steady_clock;
+
+  // The pending gates are evaluated in waves: the gates scheduled while evaluating a wave
+  // are evaluated in the next one. The wave buffers are swapped with the pending ones, so
+  // both keep their capacity across calls.
+  const bool evaluateMacros = macroMode == MacroMode::ON;
+
+  // Only a loop can keep the circuit from settling: the waves are numbered across the
+  // settles so that the iterations of a loop counted by an earlier one are discarded
+  const bool     checkLoops = !loops.empty();
+  const uint64_t firstWave  = waveCount + 1;
+
+  while (!pending.empty() || (evaluateMacros && !pendingMacros.empty())) {
+    if (!oscillatingLoops.empty()) [[unlikely]]
+      breakLoops<PROFILE>();
+
+    std::swap(wave, pending);
+    waveCount++;
+
+    if constexpr (PROFILE)
+      profile->eventsPerDelta.push_back(wave.size());
+
+    for (const GateId g : wave) {
+      isPending[g] = false;
+
+      if (checkLoops)
+        countIteration(g, firstWave);
+
+      if constexpr (PROFILE) {
+        const auto start = Clock::now();
+        const State s    = evaluate(g);
+        const auto type  = static_cast<size_t>(netlist.getGateType(g));
+
+        profile->typeTime[type] += Clock::now() - start;
+        profile->typeEvaluations[type]++;
+        profile->gateEvaluations[g]++;
+
+        update<true>(netlist.getGateOutput(g), s);
+      } else {
+        update<false>(netlist.getGateOutput(g), evaluate(g));
+      }
+    }
+
+    wave.clear();
+
+    if (!evaluateMacros)
+      continue;
+
+    std::swap(macroWave, pendingMacros);
+
+    for (const uint32_t macro : macroWave) {
+      isMacroPending[macro] = false;
+      evaluateMacro(macro);
+    }
+
+    macroWave.clear();
+  }
+
+  // A loop that reached the limit in the last wave has settled anyway
+  oscillatingLoops.clear();
+}
+
+void Simulator::countIteration(const GateId gate, const uint64_t firstWave)
+{
+  const auto loop = gateLoops[gate];
+  if (loop == NO_LOOP || loopWaves[loop] == waveCount)
+    return;
+
+  // The first of its gates evaluated in this wave
+  loopIterations[loop] = loopWaves[loop] < firstWave ? 1 : loopIterations[loop] + 1;
+  loopWaves[loop]      = waveCount;
+
+  if (loopIterations[loop] > iterationLimit)
+    oscillatingLoops.push_back(loop);
+}
+
+template <bool PROFILE>
+void Simulator::breakLoops()
+{
+  for (const uint32_t loop : oscillatingLoops) {
+    loopIterations[loop] = 0;
+
+    if (std::ranges::find(oscillations, loop) != oscillations.end())
+      continue;
+
+    oscillations.push_back(loop);
+    for (const GateId member : loops[loop])
+      update<PROFILE>(netlist.getGateOutput(member), State::ERROR);
+  }
+
+  oscillatingLoops.clear();
+}
+
+void Simulator::clock()
+{
+  // Sample every input before updating any output: a register feeding another one must
+  // pass its old value
+  for (size_t i = 0; i < registers.size(); i++)
+    sampled[i] = states[netlist.getGateInputs(registers[i])[0]];
+
+  for (size_t i = 0; i < registers.size(); i++)
+    setState(netlist.getGateOutput(registers[i]), sampled[i]);
+
+  cycle++;
+  settle();
+}
+
+Simulator::Snapshot Simulator::save() const
+{
+  return {states, pending, pendingMacros, oscillations, cycle};
+}
+
+bool Simulator::restore(const Snapshot& snapshot)
+{
+  const auto outOfRange = [](const auto& indices, const size_t size) {
+    return std::ranges::any_of(indices, [size](const auto i) { return i >= size; });
+  };
+
+  if (snapshot.states.size() != states.size()
+      || outOfRange(snapshot.pending, isPending.size())
+      || outOfRange(snapshot.pendingMacros, isMacroPending.size())
+      || outOfRange(snapshot.oscillations, loops.size()))
+    return false;
+
+  states = snapshot.states;
+
+  std::ranges::fill(isPending, false);
+  pending.clear();
+  for (const GateId g : snapshot.pending) {
+    if (!isPending[g]) {
+      pending.push_back(g);
+      isPending[g] = true;
+    }
+  }
+
+  std::ranges::fill(isMacroPending, false);
+  pendingMacros.clear();
+  for (const uint32_t m : snapshot.pendingMacros)
+    scheduleMacro(m);
+
+  oscillations = snapshot.oscillations;
+  cycle        = snapshot.cycle;
+  return true;
+}
+
+State Simulator::evaluate(const GateId gate) const
+{
+  const auto inputs = netlist.getGateInputs(gate);
+
+  const auto reduce = [&](State s, State (*op)(const State&, const State&)) {
+    for (const NetId n : inputs)
+      s = op(s, states[n]);
+    return s;
+  };
+
+  switch (netlist.getGateType(gate)) {
+    case GateType::BUF: return states[inputs[0]];
+    case GateType::NOT: return !states[inputs[0]];
+    case GateType::AND: return reduce(State::HIGH, operator&&);
+    case GateType::NAND: return !reduce(State::HIGH, operator&&);
+    case GateType::OR: return reduce(State::LOW, operator||);
+    case GateType::NOR: return !reduce(State::LOW, operator||);
+    case GateType::XOR: return reduce(State::LOW, operator^);
+    case GateType::XNOR: return !reduce(State::LOW, operator^);
+    case GateType::CONST0: return State::LOW;
+    case GateType::CONST1: return State::HIGH;
+    case GateType::DFF: return states[netlist.getGateOutput(gate)];
+  }
+
+  assert(false);
+  return State::ERROR;
+}
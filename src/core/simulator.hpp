@@ -0,0 +1,184 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <core/activityProfiler.hpp>
+#include <core/macros.hpp>
+#include <core/netlist.hpp>
+#include <core/wire.hpp>
+
+/* Event-driven simulator of a finalized Netlist.
+ *
+ * The state of the circuit is a single vector indexed by net. Changing a net schedules
+ * the gates in its fan-out, which are evaluated by settle() until nothing changes.
+ * DFFs only change when the circuit is clocked.
+ *
+ * With a MacroSet the blocks it recognized are evaluated as words, and the nets inside
+ * them are not updated. In VERIFY mode every gate is evaluated as usual, and the macros
+ * are evaluated too in order to be compared with the gates. */
+
+class Simulator {
+public:
+  enum class MacroMode {
+    OFF,
+    ON,
+    VERIFY,
+  };
+
+  // Everything that changes while simulating: restoring it in another simulator of the
+  // same netlist (and macros) goes on with the same simulation
+  struct Snapshot {
+    std::vector<State>    states;
+    std::vector<GateId>   pending;
+    std::vector<uint32_t> pendingMacros;
+    std::vector<uint32_t> oscillations;
+    uint64_t              cycle = 0;
+  };
+
+  explicit Simulator(const Netlist& netlist);
+
+  // `macros` must have been recognized in `netlist`
+  Simulator(const Netlist& netlist, const MacroSet& macros,
+            MacroMode mode = MacroMode::ON);
+
+  // Every net goes back to its initial state, then the whole circuit is evaluated
+  void reset();
+
+  [[nodiscard]] State getState(NetId net) const { return states[net]; }
+  void                setState(NetId net, State s);
+
+  // Sets a net without scheduling its fan-out, to bring back states recorded after
+  // settle() (see StateHistory): every gate already agrees with them
+  void restoreState(NetId net, State s) { states[net] = s; }
+
+  // Bit i of `value` is assigned to nets[i]
+  void                       setValue(std::span<const NetId> nets, uint64_t value);
+  [[nodiscard]] uint64_t     getValue(std::span<const NetId> nets) const;
+  [[nodiscard]] bool         isInErrorState(std::span<const NetId> nets) const;
+  [[nodiscard]] const auto&  getStates() const { return states; }
+  [[nodiscard]] const auto&  getNetlist() const { return netlist; }
+
+  // Evaluates the scheduled gates until the circuit is stable
+  void settle();
+
+  // Every DFF samples its input at the same time, then the circuit is settled
+  void clock();
+
+  // Clock cycles since the last reset()
+  [[nodiscard]] uint64_t getCycle() const { return cycle; }
+
+  [[nodiscard]] Snapshot save() const;
+
+  // The states are copied back as they are, no gate is evaluated. Returns false, leaving
+  // the simulator unchanged, if the snapshot doesn't fit the netlist.
+  [[nodiscard]] bool restore(const Snapshot& snapshot);
+
+  // Counting the evaluations of the gates and the toggles of the nets. When profiling is
+  // disabled settle() runs a copy of its loop without any counter. Enabling it clears the
+  // counters.
+  void setProfiling(bool enabled);
+
+  // nullptr if profiling is disabled
+  [[nodiscard]] const SimulatorProfile* getProfile() const
+  {
+    return profile ? &*profile : nullptr;
+  }
+
+  // A circuit with combinational loops may never settle: the gates of a loop evaluated in
+  // more than this many waves of a single settle() are oscillating. The nets they drive
+  // are set to ERROR, which every gate propagates, so the loop becomes stable.
+  static constexpr uint32_t DEFAULT_ITERATION_LIMIT = 1000;
+
+  void setIterationLimit(uint32_t limit);
+
+  // The loops of the netlist, found when the simulator is created
+  [[nodiscard]] const std::vector<std::vector<GateId>>& getLoops() const { return loops; }
+
+  // The loops (indices in getLoops()) that oscillated since the last reset()
+  [[nodiscard]] const std::vector<uint32_t>& getOscillations() const
+  {
+    return oscillations;
+  }
+
+  // In VERIFY mode, the macros whose outputs differed from the ones of their gates
+  [[nodiscard]] const std::vector<uint32_t>& getMacroMismatches() const
+  {
+    return macroMismatches;
+  }
+
+private:
+  template <bool PROFILE>
+  void update(NetId net, State s);
+
+  template <bool PROFILE>
+  void settleWaves();
+
+  template <bool PROFILE>
+  void breakLoops();
+
+  void countIteration(GateId gate, uint64_t firstWave);
+
+  void  schedule(NetId net);
+  State evaluate(GateId gate) const;
+
+  void scheduleMacro(uint32_t macro);
+  void evaluateMacro(uint32_t macro);
+  void verifyMacros();
+
+  const Netlist& netlist;
+
+  const MacroSet* macros    = nullptr;
+  MacroMode       macroMode = MacroMode::OFF;
+
+  std::vector<State>   states;
+  std::vector<GateId>  pending;
+  std::vector<GateId>  wave;  // The gates being evaluated by settle()
+  std::vector<uint8_t> isPending;
+  std::vector<GateId>  registers;
+  std::vector<State>   sampled;  // The inputs of the registers, reused by clock()
+  uint64_t             cycle = 0;
+
+  // Macros scheduled for evaluation (or, in VERIFY mode, for the comparison)
+  std::vector<uint32_t> pendingMacros;
+  std::vector<uint32_t> macroWave;
+  std::vector<uint8_t>  isMacroPending;
+  uint32_t              evaluatingMacro = MacroSet::NO_MACRO;
+  std::vector<State>    macroOutputs;
+  std::vector<uint32_t> macroMismatches;
+
+  static constexpr uint32_t NO_LOOP = UINT32_MAX;
+
+  std::vector<std::vector<GateId>> loops;
+  std::vector<uint32_t>            gateLoops;
+  std::vector<uint32_t>            oscillations;
+  uint32_t                         iterationLimit = DEFAULT_ITERATION_LIMIT;
+
+  // For every loop, the last wave that evaluated its gates and how many waves of the
+  // current settle() did. The loops over the limit are broken before the next wave.
+  uint64_t              waveCount = 0;
+  std::vector<uint64_t> loopWaves;
+  std::vector<uint32_t> loopIterations;
+  std::vector<uint32_t> oscillatingLoops;
+
+  std::optional<SimulatorProfile> profile;
+};
@@ -0,0 +1,240 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "stateHistory.hpp"
+
+#include <cassert>
+
+namespace {
+uint64_t distance(const uint64_t a, const uint64_t b)
+{
+  return a > b ? a - b : b - a;
+}
+}  // namespace
+
+StateHistory::StateHistory(const size_t budget, const uint32_t checkpointInterval)
+  : budget(budget), checkpointInterval(checkpointInterval)
+{
+  assert(checkpointInterval > 0);
+}
+
+void StateHistory::setBudget(const size_t bytes)
+{
+  budget = bytes;
+  trim();
+}
+
+size_t StateHistory::getMemoryUsage() const
+{
+  return base.size() * sizeof(Packed) + states.size() * sizeof(State)
+         + isChanged.size() + changed.capacity() * sizeof(uint32_t) + stepsSize;
+}
+
+size_t StateHistory::sizeOf(const Step& step)
+{
+  return sizeof(Step) + step.changes.capacity() * sizeof(Change)
+         + step.checkpoint.capacity() * sizeof(Packed);
+}
+
+void StateHistory::clear()
+{
+  base.clear();
+  steps.clear();
+  states.clear();
+  changed.clear();
+  isChanged.clear();
+
+  firstStep   = 0;
+  currentStep = 0;
+  stepsSize   = 0;
+}
+
+void StateHistory::record(const std::span<const State> newStates)
+{
+  clearChanged();
+
+  if (empty()) {
+    states.assign(newStates.begin(), newStates.end());
+    base.resize(states.size());
+    for (size_t i = 0; i < states.size(); i++)
+      base[i] = static_cast<Packed>(states[i]);
+
+    isChanged.assign(states.size(), false);
+    return;
+  }
+
+  assert(newStates.size() == states.size());
+
+  // The steps that were undone are overwritten
+  while (getLastStep() > currentStep) {
+    stepsSize -= sizeOf(steps.back());
+    steps.pop_back();
+  }
+
+  Step step;
+  for (uint32_t i = 0; i < states.size(); i++) {
+    if (states[i] == newStates[i])
+      continue;
+
+    step.changes.push_back(
+        {i, static_cast<Packed>(states[i]), static_cast<Packed>(newStates[i])});
+    states[i] = newStates[i];
+  }
+
+  currentStep++;
+  if (currentStep % checkpointInterval == 0) {
+    step.checkpoint.resize(states.size());
+    for (size_t i = 0; i < states.size(); i++)
+      step.checkpoint[i] = static_cast<Packed>(states[i]);
+  }
+
+  stepsSize += sizeOf(step);
+  steps.push_back(std::move(step));
+
+  trim();
+}
+
+bool StateHistory::stepBack()
+{
+  clearChanged();
+  if (empty() || currentStep == firstStep)
+    return false;
+
+  undo(steps[currentStep - firstStep - 1]);
+  currentStep--;
+  return true;
+}
+
+bool StateHistory::stepForward()
+{
+  clearChanged();
+  if (empty() || currentStep == getLastStep())
+    return false;
+
+  redo(steps[currentStep - firstStep]);
+  currentStep++;
+  return true;
+}
+
+bool StateHistory::jumpTo(const uint64_t step)
+{
+  clearChanged();
+  if (empty() || step < firstStep || step > getLastStep())
+    return false;
+
+  // Replaying from the current step, or from the closest full copy of the states: the
+  // first step or the checkpoints around `step`
+  const auto below = step - step % checkpointInterval;
+  const auto above = below + checkpointInterval;
+
+  const auto hasCheckpoint = [&](const uint64_t s) {
+    return s > firstStep && s <= getLastStep()
+           && !steps[s - firstStep - 1].checkpoint.empty();
+  };
+
+  uint64_t                start = firstStep;
+  std::span<const Packed> full  = base;
+
+  if (hasCheckpoint(below)) {
+    start = below;
+    full  = steps[below - firstStep - 1].checkpoint;
+  }
+  if (hasCheckpoint(above) && distance(above, step) < distance(start, step)) {
+    start = above;
+    full  = steps[above - firstStep - 1].checkpoint;
+  }
+
+  if (distance(start, step) < distance(currentStep, step)) {
+    restore(full);
+    currentStep = start;
+  }
+
+  for (; currentStep > step; currentStep--)
+    undo(steps[currentStep - firstStep - 1]);
+  for (; currentStep < step; currentStep++)
+    redo(steps[currentStep - firstStep]);
+
+  return true;
+}
+
+void StateHistory::apply(Simulator& sim) const
+{
+  for (const uint32_t i : changed)
+    sim.restoreState(i, states[i]);
+}
+
+void StateHistory::undo(const Step& step)
+{
+  for (const auto& [index, from, to] : step.changes) {
+    states[index] = static_cast<State>(from);
+    markChanged(index);
+  }
+}
+
+void StateHistory::redo(const Step& step)
+{
+  for (const auto& [index, from, to] : step.changes) {
+    states[index] = static_cast<State>(to);
+    markChanged(index);
+  }
+}
+
+void StateHistory::restore(const std::span<const Packed> full)
+{
+  for (uint32_t i = 0; i < states.size(); i++) {
+    const auto s = static_cast<State>(full[i]);
+    if (states[i] != s) {
+      states[i] = s;
+      markChanged(i);
+    }
+  }
+}
+
+void StateHistory::markChanged(const uint32_t index)
+{
+  if (isChanged[index])
+    return;
+
+  isChanged[index] = true;
+  changed.push_back(index);
+}
+
+void StateHistory::clearChanged()
+{
+  for (const uint32_t i : changed)
+    isChanged[i] = false;
+  changed.clear();
+}
+
+void StateHistory::trim()
+{
+  // The current step is never dropped
+  while (getMemoryUsage() > budget && firstStep < currentStep) {
+    auto& first = steps.front();
+    stepsSize -= sizeOf(first);
+
+    if (first.checkpoint.empty())
+      for (const auto& [index, from, to] : first.changes)
+        base[index] = to;
+    else
+      base = std::move(first.checkpoint);
+
+    steps.pop_front();
+    firstStep++;
+  }
+}
@@ -0,0 +1,118 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <span>
+#include <vector>
+
+#include <core/simulator.hpp>
+#include <core/wire.hpp>
+
+/* Rewindable history of the states of a circuit, recorded once per step: a clock cycle of
+ * a Simulator, or an input change in LogiFlow.
+ *
+ * A step stores only the states it changed, each with its old and new value, so moving
+ * one step back or forward costs as much as the changes of that step. Every
+ * `checkpointInterval` steps the whole state is stored too: jumping to a distant step
+ * starts from the closest checkpoint instead of replaying every step in between.
+ *
+ * The oldest steps are dropped when the history grows past its memory budget. Recording
+ * a step after going back discards the steps that followed, like an undo stack. */
+
+class StateHistory {
+public:
+  static constexpr size_t   DEFAULT_BUDGET              = size_t{64} << 20;
+  static constexpr uint32_t DEFAULT_CHECKPOINT_INTERVAL = 256;
+
+  explicit StateHistory(size_t   budget             = DEFAULT_BUDGET,
+                        uint32_t checkpointInterval = DEFAULT_CHECKPOINT_INTERVAL);
+
+  // In bytes: the oldest steps are dropped right away if the history doesn't fit
+  void                 setBudget(size_t bytes);
+  [[nodiscard]] size_t getBudget() const { return budget; }
+  [[nodiscard]] size_t getMemoryUsage() const;
+
+  void clear();
+
+  // The first recorded states are step 0, the following ones must have the same size
+  void record(std::span<const State> newStates);
+  void record(const Simulator& sim) { record(sim.getStates()); }
+
+  [[nodiscard]] bool     empty() const { return states.empty(); }
+  [[nodiscard]] uint64_t getFirstStep() const { return firstStep; }
+  [[nodiscard]] uint64_t getLastStep() const { return firstStep + steps.size(); }
+  [[nodiscard]] uint64_t getCurrentStep() const { return currentStep; }
+
+  [[nodiscard]] std::span<const State> getStates() const { return states; }
+
+  // Move to another step of the history, false if it isn't there
+  bool stepBack();
+  bool stepForward();
+  bool jumpTo(uint64_t step);
+
+  // The indices of the states changed by the last move
+  [[nodiscard]] std::span<const uint32_t> getChanged() const { return changed; }
+
+  // Restores the nets changed by the last move in `sim`, which recorded the history
+  void apply(Simulator& sim) const;
+
+private:
+  // States are stored as bytes
+  using Packed = uint8_t;
+
+  struct Change {
+    uint32_t index;
+    Packed   from;
+    Packed   to;
+  };
+
+  struct Step {
+    std::vector<Change> changes;
+
+    // The states after the step, if it's a multiple of the checkpoint interval
+    std::vector<Packed> checkpoint;
+  };
+
+  [[nodiscard]] static size_t sizeOf(const Step& step);
+
+  void undo(const Step& step);
+  void redo(const Step& step);
+  void restore(std::span<const Packed> full);
+  void markChanged(uint32_t index);
+  void clearChanged();
+  void trim();
+
+  size_t   budget;
+  uint32_t checkpointInterval;
+
+  // The states at the first step, the steps after it and the states at the current step
+  std::vector<Packed> base;
+  std::deque<Step>    steps;
+  std::vector<State>  states;
+
+  uint64_t firstStep   = 0;
+  uint64_t currentStep = 0;
+  size_t   stepsSize   = 0;
+
+  std::vector<uint32_t> changed;
+  std::vector<uint8_t>  isChanged;
+};
@@ -0,0 +1,216 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "stimulus.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <numeric>
+#include <optional>
+#include <unordered_map>
+
+namespace {
+constexpr uint64_t ALL_BITS = ~uint64_t{0};
+
+uint64_t widthMask(const size_t width)
+{
+  return width >= 64 ? ALL_BITS : (uint64_t{1} << width) - 1;
+}
+}  // namespace
+
+void Stimulus::add(Assignment assignment)
+{
+  assignments.push_back(std::move(assignment));
+}
+
+void Stimulus::set(const uint64_t time, std::string input, const uint64_t value)
+{
+  add({time, std::move(input), ALL_BITS, value, false});
+}
+
+void Stimulus::setBit(const uint64_t time, std::string input, const unsigned bit,
+                      const State s)
+{
+  assert(bit < 64);
+  const uint64_t mask = uint64_t{1} << bit;
+  add({time, std::move(input), mask, s == State::HIGH ? mask : 0, s == State::ERROR});
+}
+
+Stimulus::Result<Stimulus::Program>
+Stimulus::compile(const std::span<const std::string> names,
+                  const std::span<const size_t>      widths) const
+{
+  assert(names.size() == widths.size());
+
+  std::unordered_map<std::string_view, uint32_t> ports{};
+  for (uint32_t i = 0; i < names.size(); i++)
+    ports.emplace(names[i], i);
+
+  // Single bit port named `input[bit]`
+  const auto bitPort = [&](const std::string& input, const size_t bit) {
+    const auto it = ports.find(input + "[" + std::to_string(bit) + "]");
+    return it != ports.end() && widths[it->second] == 1 ? std::optional(it->second)
+                                                         : std::nullopt;
+  };
+
+  // Same time: same order as they were added
+  std::vector<size_t> order(assignments.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::ranges::stable_sort(order, {}, [&](size_t i) { return assignments[i].time; });
+
+  Program res{};
+
+  for (const size_t i : order) {
+    const auto& [time, input, mask, value, error] = assignments[i];
+
+    if (res.times.empty() || res.times.back() != time) {
+      res.times.push_back(time);
+      res.offsets.push_back(res.changes.size());
+    }
+
+    const auto stateOf = [&](const size_t bit) {
+      if (error)
+        return State::ERROR;
+      return (value >> bit) & 1 ? State::HIGH : State::LOW;
+    };
+
+    const auto fits = [&](const size_t width) -> Result<uint64_t> {
+      const uint64_t bits = mask & widthMask(width);
+      if (bits == 0 || (mask != ALL_BITS && bits != mask))
+        return std::unexpected(input + " has " + std::to_string(width) + " bits");
+      if (!error && (value & mask & ~bits) != 0)
+        return std::unexpected("The value of " + input + " doesn't fit in "
+                               + std::to_string(width) + " bits");
+      return bits;
+    };
+
+    if (const auto port = ports.find(input); port != ports.end()) {
+      const auto bits = fits(widths[port->second]);
+      if (!bits)
+        return std::unexpected(bits.error());
+
+      for (uint64_t b = *bits; b != 0; b &= b - 1) {
+        const auto bit = static_cast<uint32_t>(std::countr_zero(b));
+        res.changes.push_back({port->second, bit, stateOf(bit)});
+      }
+      continue;
+    }
+
+    // A bus of single bit ports: all of them, or the assigned ones
+    std::vector<uint32_t> bus{};
+    for (size_t bit = 0; bit < 64; bit++) {
+      const bool assigned = (mask >> bit) & 1;
+      const auto port     = bitPort(input, bit);
+
+      if (mask == ALL_BITS && !port)
+        break;
+      if (assigned && !port)
+        return std::unexpected("Unknown input " + input + "[" + std::to_string(bit)
+                               + "]");
+
+      bus.push_back(port.value_or(0));
+    }
+
+    if (bus.empty())
+      return std::unexpected("Unknown input " + input);
+
+    const auto bits = mask == ALL_BITS ? fits(bus.size()) : Result<uint64_t>(mask);
+    if (!bits)
+      return std::unexpected(bits.error());
+
+    for (uint64_t b = *bits; b != 0; b &= b - 1) {
+      const auto bit = static_cast<uint32_t>(std::countr_zero(b));
+      res.changes.push_back({bus[bit], 0, stateOf(bit)});
+    }
+  }
+
+  res.offsets.push_back(res.changes.size());
+  return res;
+}
+
+std::span<const Stimulus::Change> Stimulus::Program::getChanges(const size_t step) const
+{
+  return std::span(changes).subspan(offsets[step], offsets[step + 1] - offsets[step]);
+}
+
+void Stimulus::Program::run(const std::span<const TestBench::BusPort> inputs,
+                            const StepCallback&                       step) const
+{
+  // The components react to every change, there's nothing to settle
+  for (size_t s = 0; s < size(); s++) {
+    for (const auto& [port, bit, state] : getChanges(s))
+      if (const auto& w = inputs[port].bus[bit])
+        w->forceSetCurrentState(state);
+
+    if (step)
+      step(times[s]);
+  }
+}
+
+void Stimulus::Program::run(Simulator&                                        simulator,
+                            const std::span<const SubcircuitDefinition::Port> inputs,
+                            const StepCallback&                               step) const
+{
+  for (size_t s = 0; s < size(); s++) {
+    for (const auto& [port, bit, state] : getChanges(s))
+      simulator.setState(inputs[port].nets[bit], state);
+
+    simulator.settle();
+    if (step)
+      step(times[s]);
+  }
+}
+
+Stimulus::Result<size_t> Stimulus::run(const std::span<const TestBench::BusPort> inputs,
+                                       const StepCallback& step) const
+{
+  std::vector<std::string> names{};
+  std::vector<size_t>      widths{};
+  for (const auto& [name, bus] : inputs) {
+    names.push_back(name);
+    widths.push_back(bus.size());
+  }
+
+  const auto program = compile(names, widths);
+  if (!program)
+    return std::unexpected(program.error());
+
+  program->run(inputs, step);
+  return program->size();
+}
+
+Stimulus::Result<size_t>
+Stimulus::run(Simulator&                                        simulator,
+              const std::span<const SubcircuitDefinition::Port> inputs,
+              const StepCallback&                               step) const
+{
+  std::vector<std::string> names{};
+  std::vector<size_t>      widths{};
+  for (const auto& [name, nets] : inputs) {
+    names.push_back(name);
+    widths.push_back(nets.size());
+  }
+
+  const auto program = compile(names, widths);
+  if (!program)
+    return std::unexpected(program.error());
+
+  program->run(simulator, inputs, step);
+  return program->size();
+}
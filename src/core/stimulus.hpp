@@ -0,0 +1,115 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <core/simulator.hpp>
+#include <core/subcircuit.hpp>
+#include <core/testBench.hpp>
+#include <core/wire.hpp>
+
+/* Scripted stimuli: values of named inputs scheduled at simulation times.
+ *
+ * A Stimulus is a list of assignments, made by a script (see StimulusFile) or by code,
+ * that is compiled once against the input ports of a circuit and then run in batch as
+ * many times as needed: every time is a step, where the changes of the time are applied
+ * and the circuit settles before the next one.
+ *
+ * Assignments name an input port, or a bus made of single bit ports named like `a[0]`,
+ * `a[1]`... and can assign some bits only. Times are ticks without a unit. */
+
+class Stimulus {
+public:
+  // Bits `mask` of `input` become the ones of `value`, or ERROR
+  struct Assignment {
+    uint64_t    time = 0;
+    std::string input;
+    uint64_t    mask  = 0;
+    uint64_t    value = 0;
+    bool        error = false;
+  };
+
+  // Bit `bit` of input port `port` becomes `state`
+  struct Change {
+    uint32_t port = 0;
+    uint32_t bit  = 0;
+    State    state{};
+  };
+
+  template <typename T>
+  using Result = std::expected<T, std::string>;
+
+  // Called after every step, with the time of the step
+  using StepCallback = std::function<void(uint64_t time)>;
+
+  // The changes of every step, bound to the ports of a circuit
+  class Program {
+  public:
+    [[nodiscard]] size_t   size() const { return times.size(); }
+    [[nodiscard]] uint64_t getTime(const size_t step) const { return times[step]; }
+
+    [[nodiscard]] std::span<const Change> getChanges(size_t step) const;
+
+    // The ports are the ones the program was compiled for
+    void run(std::span<const TestBench::BusPort> inputs, const StepCallback& step) const;
+    void run(Simulator& simulator, std::span<const SubcircuitDefinition::Port> inputs,
+             const StepCallback& step) const;
+
+  private:
+    friend class Stimulus;
+
+    std::vector<uint64_t> times;
+    std::vector<size_t>   offsets;  // Of the first change of every step, and the end
+    std::vector<Change>   changes;
+  };
+
+  // Assignments can be added in any order, the ones at the same time are applied in the
+  // order they were added
+  void add(Assignment assignment);
+  void set(uint64_t time, std::string input, uint64_t value);
+  void setBit(uint64_t time, std::string input, unsigned bit, State s);
+
+  [[nodiscard]] const std::vector<Assignment>& getAssignments() const
+  {
+    return assignments;
+  }
+  [[nodiscard]] bool empty() const { return assignments.empty(); }
+
+  // `names` and `widths` are the ones of the input ports, every assignment must fit in
+  // one of them
+  [[nodiscard]] Result<Program> compile(std::span<const std::string> names,
+                                        std::span<const size_t>      widths) const;
+
+  // Compiles and runs the stimulus once, returns the number of steps
+  Result<size_t> run(std::span<const TestBench::BusPort> inputs,
+                     const StepCallback&                 step = {}) const;
+  Result<size_t> run(Simulator&                                  simulator,
+                     std::span<const SubcircuitDefinition::Port> inputs,
+                     const StepCallback&                         step = {}) const;
+
+private:
+  std::vector<Assignment> assignments;
+};
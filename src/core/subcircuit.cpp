@@ -0,0 +1,69 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "subcircuit.hpp"
+
+#include <cassert>
+
+namespace {
+std::vector<Bus> portBuses(const std::vector<SubcircuitDefinition::Port>& ports)
+{
+  std::vector<Bus> res{};
+  res.reserve(ports.size());
+
+  for (const auto& p : ports)
+    res.emplace_back(static_cast<unsigned short>(p.nets.size()));
+
+  return res;
+}
+}  // namespace
+
+SubcircuitDefinition::SubcircuitDefinition(std::string name, Netlist netlist,
+                                           std::vector<Port> inputs,
+                                           std::vector<Port> outputs)
+  : name(std::move(name)), netlist(std::move(netlist)), inputs(std::move(inputs)),
+    outputs(std::move(outputs))
+{
+  assert(this->netlist.isFinalized());
+  macros = MacroSet::recognize(this->netlist);
+}
+
+Subcircuit::Subcircuit(SubcircuitDefinition_ptr definition)
+  : Component(portBuses(definition->getInputs()), portBuses(definition->getOutputs()),
+              definition->getName()),
+    definition(std::move(definition)),
+    simulator(this->definition->getNetlist(), this->definition->getMacros())
+{
+  this->setAction([this] {
+    const auto& def = *this->definition;
+
+    for (size_t i = 0; i < this->inputs.size(); i++) {
+      const auto& nets = def.getInputs()[i].nets;
+      for (size_t bit = 0; bit < nets.size() && bit < this->inputs[i].size(); bit++)
+        simulator.setState(nets[bit], Wire::safeGetCurrentState(this->inputs[i][bit]));
+    }
+
+    simulator.settle();
+
+    for (size_t i = 0; i < this->outputs.size(); i++) {
+      const auto& nets = def.getOutputs()[i].nets;
+      for (size_t bit = 0; bit < nets.size() && bit < this->outputs[i].size(); bit++)
+        Wire::safeSetCurrentState(this->outputs[i][bit], simulator.getState(nets[bit]),
+                                  driverId);
+    }
+  });
+}
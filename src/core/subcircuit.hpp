@@ -0,0 +1,81 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <core/component.hpp>
+#include <core/macros.hpp>
+#include <core/netlist.hpp>
+#include <core/simulator.hpp>
+#include <core/wire.hpp>
+
+/* A block of logic reused as a single component.
+ *
+ * The gates of a subcircuit are compiled once into a SubcircuitDefinition, which is
+ * immutable and shared by every instance: an instance only owns the state of the nets
+ * (its Simulator), so placing the same block hundreds of times doesn't copy its gates.
+ * The word-level macros of the netlist are recognized once as well. */
+
+class SubcircuitDefinition {
+public:
+  // The nets of a port, least significant bit first
+  struct Port {
+    std::string        name;
+    std::vector<NetId> nets;
+  };
+
+  // `netlist` must be finalized
+  SubcircuitDefinition(std::string name, Netlist netlist, std::vector<Port> inputs,
+                       std::vector<Port> outputs);
+
+  [[nodiscard]] const std::string&       getName() const { return name; }
+  [[nodiscard]] const Netlist&           getNetlist() const { return netlist; }
+  [[nodiscard]] const std::vector<Port>& getInputs() const { return inputs; }
+  [[nodiscard]] const std::vector<Port>& getOutputs() const { return outputs; }
+  [[nodiscard]] const MacroSet&          getMacros() const { return macros; }
+
+private:
+  std::string       name;
+  Netlist           netlist;
+  std::vector<Port> inputs;
+  std::vector<Port> outputs;
+  MacroSet          macros;
+};
+
+using SubcircuitDefinition_ptr = std::shared_ptr<const SubcircuitDefinition>;
+
+// Every input and output bus has the width of the corresponding port of the definition.
+// The outputs are updated as soon as an input changes, DFFs inside the definition keep
+// their initial state.
+class Subcircuit : public Component {
+public:
+  explicit Subcircuit(SubcircuitDefinition_ptr definition);
+
+  [[nodiscard]] const SubcircuitDefinition_ptr& getDefinition() const
+  {
+    return definition;
+  }
+
+private:
+  // Declared before the simulator, which refers to the netlist of the definition
+  SubcircuitDefinition_ptr definition;
+  Simulator                simulator;
+};
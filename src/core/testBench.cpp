@@ -0,0 +1,557 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "testBench.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <thread>
+
+#include <core/logicAnalysis.hpp>
+#include <core/simulator.hpp>
+
+namespace {
+using Unexpected = std::unexpected<std::string>;
+
+// Vectors taken at a time by a thread
+constexpr uint64_t CHUNK_SIZE = 256;
+
+constexpr uint64_t NO_MISMATCH = UINT64_MAX;
+
+uint64_t widthMask(const size_t width)
+{
+  return width >= 64 ? ~uint64_t{0} : (uint64_t{1} << width) - 1;
+}
+
+// SplitMix64: a different value for every counter, whatever the previous ones
+uint64_t mix(uint64_t x)
+{
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EB;
+  return x ^ (x >> 31);
+}
+}  // namespace
+
+TestBench::TestBench(const Netlist& netlist, std::vector<Port> inputs,
+                     std::vector<Port> outputs)
+  : netlist(&netlist), inputs(std::move(inputs)), outputs(std::move(outputs))
+{
+  assert(netlist.isFinalized());
+  initPorts();
+}
+
+TestBench::TestBench(const SubcircuitDefinition& definition)
+  : netlist(&definition.getNetlist()), macros(&definition.getMacros()),
+    inputs(definition.getInputs()), outputs(definition.getOutputs())
+{
+  initPorts();
+}
+
+TestBench::TestBench(std::vector<BusPort> inputs, std::vector<BusPort> outputs)
+  : inputBuses(std::move(inputs)), outputBuses(std::move(outputs))
+{
+  initPorts();
+}
+
+void TestBench::initPorts()
+{
+  for (const auto& port : inputs) {
+    inputNames.push_back(port.name);
+    inputWidths.push_back(port.nets.size());
+  }
+  for (const auto& port : outputs) {
+    outputNames.push_back(port.name);
+    outputWidths.push_back(port.nets.size());
+  }
+  for (const auto& port : inputBuses) {
+    inputNames.push_back(port.name);
+    inputWidths.push_back(port.bus.size());
+  }
+  for (const auto& port : outputBuses) {
+    outputNames.push_back(port.name);
+    outputWidths.push_back(port.bus.size());
+  }
+
+  if (!netlist || !LogicAnalysis::checkCombinational(*netlist))
+    return;
+
+  // Every primary input must be a bit of exactly one input port, as the words of the
+  // other nets are computed
+  std::vector<uint8_t> bound(netlist->getNetCount(), false);
+  for (const auto& port : inputs) {
+    for (const NetId n : port.nets) {
+      if (bound[n])
+        return;
+      bound[n] = true;
+    }
+  }
+
+  const auto primaryInputs = netlist->getPrimaryInputs();
+
+  size_t boundCount = 0;
+  for (const auto& port : inputs)
+    boundCount += port.nets.size();
+
+  const bool allBound =
+      boundCount == primaryInputs.size()
+      && std::ranges::all_of(primaryInputs, [&](const NetId n) { return bound[n]; });
+
+  if (allBound)
+    evaluator.emplace(*netlist);
+}
+
+TestBench::Result<void> TestBench::checkPorts() const
+{
+  const size_t maxWidth = netlist ? 64 : 31;
+
+  for (const auto& [names, widths] : {std::pair(&inputNames, &inputWidths),
+                                      std::pair(&outputNames, &outputWidths)})
+    for (size_t p = 0; p < names->size(); p++)
+      if ((*widths)[p] > maxWidth)
+        return Unexpected("Port " + (*names)[p] + " is wider than "
+                          + std::to_string(maxWidth) + " bits");
+
+  return {};
+}
+
+/* ENGINE */
+
+// The state of the circuit for a thread
+class TestBench::Engine {
+public:
+  Engine(const TestBench& bench, bool bitParallel,
+         const Simulator::Snapshot* initialState);
+
+  // Vector v of `count` (at most LANES) has the value of port p at v * ports + p. The
+  // ports of the outputs in the ERROR state are marked in `error`.
+  void evaluate(size_t count, std::span<const uint64_t> in, std::span<uint64_t> out,
+                std::span<uint8_t> error, unsigned cycles);
+
+private:
+  void evaluateWords(size_t count, std::span<const uint64_t> in, std::span<uint64_t> out);
+
+  void restart();
+
+  const TestBench&           bench;
+  bool                       bitParallel;
+  const Simulator::Snapshot* initialState;
+
+  std::optional<Simulator> simulator;
+  std::vector<uint64_t>    words;
+  std::vector<Bus>         inputBuses;
+  std::vector<Bus>         outputBuses;
+};
+
+TestBench::Engine::Engine(const TestBench& bench, const bool bitParallel,
+                          const Simulator::Snapshot* initialState)
+  : bench(bench), bitParallel(bitParallel), initialState(initialState)
+{
+  if (bitParallel)
+    words.resize(bench.evaluator->getNetCount());
+  else if (bench.netlist && bench.macros)
+    simulator.emplace(*bench.netlist, *bench.macros);
+  else if (bench.netlist)
+    simulator.emplace(*bench.netlist);
+
+  if (simulator && initialState)
+    restart();
+
+  for (const auto& port : bench.inputBuses)
+    inputBuses.push_back(port.bus);
+  for (const auto& port : bench.outputBuses)
+    outputBuses.push_back(port.bus);
+}
+
+void TestBench::Engine::evaluate(const size_t count, const std::span<const uint64_t> in,
+                                 const std::span<uint64_t> out,
+                                 const std::span<uint8_t> error, const unsigned cycles)
+{
+  const auto inputCount  = bench.getInputCount();
+  const auto outputCount = bench.getOutputCount();
+
+  std::ranges::fill(error, false);
+
+  if (bitParallel) {
+    evaluateWords(count, in, out);
+    return;
+  }
+
+  for (size_t v = 0; v < count; v++) {
+    const auto values  = in.subspan(v * inputCount, inputCount);
+    const auto results = out.subspan(v * outputCount, outputCount);
+    const auto errors  = error.subspan(v * outputCount, outputCount);
+
+    if (simulator) {
+      if (cycles > 0)
+        restart();
+
+      for (size_t p = 0; p < inputCount; p++)
+        simulator->setValue(bench.inputs[p].nets, values[p]);
+      simulator->settle();
+
+      for (unsigned c = 0; c < cycles; c++)
+        simulator->clock();
+
+      for (size_t p = 0; p < outputCount; p++) {
+        results[p] = simulator->getValue(bench.outputs[p].nets);
+        errors[p]  = simulator->isInErrorState(bench.outputs[p].nets);
+      }
+    } else {
+      for (size_t p = 0; p < inputCount; p++)
+        inputBuses[p].forceSetCurrentValue(values[p]);
+
+      for (size_t p = 0; p < outputCount; p++) {
+        errors[p]  = outputBuses[p].isInErrorState();
+        results[p] = errors[p] ? 0 : outputBuses[p].getCurrentValue();
+      }
+    }
+  }
+}
+
+void TestBench::Engine::restart()
+{
+  if (!initialState) {
+    simulator->reset();
+    return;
+  }
+
+  [[maybe_unused]] const bool restored = simulator->restore(*initialState);
+  assert(restored);
+}
+
+void TestBench::Engine::evaluateWords(const size_t                    count,
+                                      const std::span<const uint64_t> in,
+                                      const std::span<uint64_t>       out)
+{
+  const auto inputCount  = bench.getInputCount();
+  const auto outputCount = bench.getOutputCount();
+
+  // Bit v of the word of a net is its value in vector v
+  for (size_t p = 0; p < inputCount; p++) {
+    for (const auto [bit, net] : bench.inputs[p].nets | silicon::views::enumerate) {
+      uint64_t word = 0;
+      for (size_t v = 0; v < count; v++)
+        word |= ((in[v * inputCount + p] >> bit) & 1) << v;
+      words[net] = word;
+    }
+  }
+
+  bench.evaluator->evaluate(words);
+
+  for (size_t v = 0; v < count; v++) {
+    for (size_t p = 0; p < outputCount; p++) {
+      uint64_t value = 0;
+      for (const auto [bit, net] : bench.outputs[p].nets | silicon::views::enumerate)
+        value |= ((words[net] >> v) & 1) << bit;
+      out[v * outputCount + p] = value;
+    }
+  }
+}
+
+TestBench::Result<TestBench::Report> TestBench::exhaustive(const Model&   model,
+                                                           const Options& options) const
+{
+  size_t bits = 0;
+  for (const auto width : inputWidths)
+    bits += width;
+
+  if (bits > options.maxExhaustiveBits || bits >= 64)
+    return Unexpected("Too many input bits for an exhaustive test ("
+                      + std::to_string(bits) + ", at most "
+                      + std::to_string(options.maxExhaustiveBits) + ")");
+
+  const auto stimulus = [this](uint64_t index, const std::span<uint64_t> values) {
+    for (size_t p = 0; p < inputWidths.size(); p++) {
+      const auto width = inputWidths[p];
+      values[p]        = index & widthMask(width);
+      index            = width >= 64 ? 0 : index >> width;
+    }
+  };
+
+  const auto expectation = [&model](uint64_t, const std::span<const uint64_t> in,
+                                    const std::span<uint64_t> out) {
+    model(in, out);
+    return true;
+  };
+
+  return run(uint64_t{1} << bits, stimulus, expectation, {}, options);
+}
+
+TestBench::Result<TestBench::Report> TestBench::random(const uint64_t count,
+                                                       const uint64_t seed,
+                                                       const Model&   model,
+                                                       const Options& options) const
+{
+  const auto stimulus = [this, seed](const uint64_t index,
+                                     const std::span<uint64_t> values) {
+    for (size_t p = 0; p < inputWidths.size(); p++) {
+      const uint64_t counter = index * inputWidths.size() + p + 1;
+      const uint64_t value   = mix(seed + counter * 0x9E3779B97F4A7C15);
+      values[p]              = value & widthMask(inputWidths[p]);
+    }
+  };
+
+  const auto expectation = [&model](uint64_t, const std::span<const uint64_t> in,
+                                    const std::span<uint64_t> out) {
+    model(in, out);
+    return true;
+  };
+
+  return run(count, stimulus, expectation, {}, options);
+}
+
+TestBench::Result<TestBench::Report> TestBench::golden(const TestVectors& vectors,
+                                                       const Options&     options) const
+{
+  const auto inputCount  = vectors.inputNames.size();
+  const auto outputCount = vectors.outputNames.size();
+
+  if (inputCount != getInputCount() || outputCount != getOutputCount())
+    return Unexpected("The vectors have " + std::to_string(inputCount) + " inputs and "
+                      + std::to_string(outputCount) + " outputs, the circuit "
+                      + std::to_string(getInputCount()) + " and "
+                      + std::to_string(getOutputCount()));
+
+  // Column of the vectors for every port
+  using Columns = Result<std::vector<size_t>>;
+
+  const auto match = [](const std::vector<std::string>& ports,
+                        const std::vector<std::string>& names) -> Columns {
+    std::vector<size_t> res{};
+    for (const auto& port : ports) {
+      const auto it = std::ranges::find(names, port);
+      if (it == names.end())
+        return Unexpected("Port " + port + " is not in the vectors");
+      res.push_back(it - names.begin());
+    }
+    return res;
+  };
+
+  const auto inputColumns = match(inputNames, vectors.inputNames);
+  if (!inputColumns)
+    return Unexpected(inputColumns.error());
+
+  const auto outputColumns = match(outputNames, vectors.outputNames);
+  if (!outputColumns)
+    return Unexpected(outputColumns.error());
+
+  const auto stimulus = [&](const uint64_t index, const std::span<uint64_t> values) {
+    for (size_t p = 0; p < inputCount; p++)
+      values[p] = vectors.inputs[index * inputCount + (*inputColumns)[p]];
+  };
+
+  const auto expectation = [&](const uint64_t index, std::span<const uint64_t>,
+                               const std::span<uint64_t> out) {
+    for (size_t p = 0; p < outputCount; p++)
+      out[p] = vectors.outputs[index * outputCount + (*outputColumns)[p]];
+    return true;
+  };
+
+  return run(vectors.size(), stimulus, expectation, {}, options);
+}
+
+TestBench::Result<TestVectors> TestBench::record(const std::span<const uint64_t> stimuli,
+                                                 const Options& options) const
+{
+  const auto inputCount  = getInputCount();
+  const auto outputCount = getOutputCount();
+
+  assert(inputCount == 0 || stimuli.size() % inputCount == 0);
+
+  TestVectors res{};
+  res.inputNames  = inputNames;
+  res.outputNames = outputNames;
+
+  const auto count = inputCount == 0 ? 0 : stimuli.size() / inputCount;
+  res.inputs.assign(stimuli.begin(), stimuli.end());
+  res.outputs.resize(count * outputCount);
+
+  const auto stimulus = [&](const uint64_t index, const std::span<uint64_t> values) {
+    std::ranges::copy(stimuli.subspan(index * inputCount, inputCount), values.begin());
+  };
+
+  // Every vector has its own slice of the outputs, threads never write the same one
+  const auto recorder = [&](const uint64_t index, const std::span<const uint64_t> out) {
+    std::ranges::copy(out, res.outputs.begin() + index * outputCount);
+  };
+
+  const auto report = run(count, stimulus, {}, recorder, options);
+  if (!report)
+    return Unexpected(report.error());
+
+  return res;
+}
+
+TestBench::Result<TestBench::Report> TestBench::run(const uint64_t     count,
+                                                    const Stimulus&    stimulus,
+                                                    const Expectation& expectation,
+                                                    const Recorder&    record,
+                                                    const Options&     options) const
+{
+  if (const auto res = checkPorts(); !res)
+    return Unexpected(res.error());
+
+  const auto start = std::chrono::steady_clock::now();
+
+  const auto inputCount  = getInputCount();
+  const auto outputCount = getOutputCount();
+
+  // The buses of a component circuit can't be driven by several threads
+  unsigned threads = netlist ? options.threads : 1;
+  if (threads == 0)
+    threads = std::max(1u, std::thread::hardware_concurrency());
+
+  const auto chunks = (count + CHUNK_SIZE - 1) / CHUNK_SIZE;
+  threads           = std::max<uint64_t>(1, std::min<uint64_t>(threads, chunks));
+
+  const auto initialState = options.initialState;
+  if (initialState && (!netlist || initialState->states.size() != netlist->getNetCount()))
+    return Unexpected("The initial state doesn't belong to the circuit");
+
+  const bool bitParallel = evaluator && options.bitParallel && !initialState;
+
+  std::atomic<uint64_t> nextChunk{0};
+  std::atomic<uint64_t> vectorsRun{0};
+  std::atomic<uint64_t> mismatchCount{0};
+
+  // Index of the first mismatch found so far: the vectors after it are skipped if the
+  // run stops at the first mismatch
+  std::atomic<uint64_t> firstIndex{NO_MISMATCH};
+
+  std::vector<std::optional<Mismatch>> found(threads);
+
+  const auto worker = [&](const unsigned thread) {
+    Engine engine(*this, bitParallel, initialState);
+
+    // A batch of vectors, evaluated together
+    const auto            lanes = BitParallelEvaluator::LANES;
+    std::vector<uint64_t> in(lanes * inputCount);
+    std::vector<uint64_t> actual(lanes * outputCount);
+    std::vector<uint8_t>  error(lanes * outputCount);
+    std::vector<uint64_t> expected(outputCount);
+
+    uint64_t localRun = 0, localMismatches = 0;
+
+    const auto stopped = [&](const uint64_t index) {
+      return options.stopAtFirstMismatch && index > firstIndex.load();
+    };
+
+    for (uint64_t chunk; (chunk = nextChunk.fetch_add(1)) < chunks;) {
+      const auto first = chunk * CHUNK_SIZE;
+      const auto last  = std::min(count, first + CHUNK_SIZE);
+
+      for (auto batch = first; batch < last && !stopped(batch); batch += lanes) {
+        const auto size = std::min<uint64_t>(lanes, last - batch);
+
+        for (size_t v = 0; v < size; v++)
+          stimulus(batch + v, std::span(in).subspan(v * inputCount, inputCount));
+
+        engine.evaluate(size, in, actual, error, options.cycles);
+
+        for (size_t v = 0; v < size && !stopped(batch + v); v++) {
+          const auto i       = batch + v;
+          const auto values  = std::span(in).subspan(v * inputCount, inputCount);
+          const auto results = std::span(actual).subspan(v * outputCount, outputCount);
+          const auto errors  = std::span(error).subspan(v * outputCount, outputCount);
+
+          localRun++;
+
+          if (record)
+            record(i, results);
+
+          if (!expectation || !expectation(i, values, expected))
+            continue;
+
+          // Bits of the expected values past the width of the port are ignored, so that
+          // models can use plain arithmetic
+          for (size_t p = 0; p < outputCount; p++)
+            expected[p] &= widthMask(outputWidths[p]);
+
+          // First output port that differs
+          size_t differing = 0;
+          while (differing < outputCount && !errors[differing]
+                 && results[differing] == expected[differing])
+            differing++;
+
+          if (differing == outputCount)
+            continue;
+
+          localMismatches++;
+
+          auto& best = found[thread];
+          if (!best || i < best->index) {
+            best = Mismatch{i,
+                            static_cast<uint32_t>(differing),
+                            {values.begin(), values.end()},
+                            expected,
+                            {results.begin(), results.end()},
+                            bool(errors[differing])};
+          }
+
+          // Lowers the first index, unless another thread found an earlier mismatch
+          auto current = firstIndex.load();
+          while (i < current && !firstIndex.compare_exchange_weak(current, i)) {}
+        }
+      }
+    }
+
+    vectorsRun += localRun;
+    mismatchCount += localMismatches;
+  };
+
+  if (threads == 1) {
+    worker(0);
+  } else {
+    std::vector<std::jthread> pool{};
+    for (unsigned t = 0; t < threads; t++)
+      pool.emplace_back(worker, t);
+  }
+
+  Report report{};
+  report.vectors     = vectorsRun;
+  report.mismatches  = mismatchCount;
+  report.threads     = threads;
+  report.bitParallel = bitParallel;
+  report.seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  for (auto& m : found)
+    if (m && (!report.firstMismatch || m->index < report.firstMismatch->index))
+      report.firstMismatch = std::move(m);
+
+  return report;
+}
+
+std::string to_str(const TestBench::Report& report)
+{
+  auto res = std::to_string(report.vectors) + " vectors, "
+             + std::to_string(report.mismatches) + " mismatches, "
+             + std::to_string(static_cast<uint64_t>(report.getVectorsPerSecond()))
+             + " vectors/s on " + std::to_string(report.threads) + " threads";
+
+  if (const auto& m = report.firstMismatch) {
+    res += ". First mismatch: vector " + std::to_string(m->index) + ", output "
+           + std::to_string(m->output) + " is "
+           + (m->error ? "ERROR" : std::to_string(m->actual[m->output])) + " instead of "
+           + std::to_string(m->expected[m->output]);
+  }
+
+  return res;
+}
@@ -0,0 +1,204 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <core/bitParallel.hpp>
+#include <core/simulator.hpp>
+#include <core/subcircuit.hpp>
+#include <core/wire.hpp>
+
+/* Regression testing of a circuit against a reference.
+ *
+ * A TestBench applies input vectors to the ports of a circuit and compares the outputs
+ * with a reference model (a C++ function computing the same thing), or with the outputs
+ * recorded in a set of TestVectors. The circuit is either:
+ * - a netlist: the vectors are split in chunks that are run by several threads, each one
+ *   with its own copy of the state of the (shared, read-only) netlist. If the netlist is
+ *   combinational and its primary inputs are exactly the bits of the input ports, 64
+ *   vectors at a time are evaluated by a BitParallelEvaluator, otherwise every vector is
+ *   simulated by a Simulator;
+ * - buses of a circuit made of Components, which are driven one vector at a time by the
+ *   calling thread.
+ *
+ * Every port is a word of at most 64 bits, the value of port i of vector k is
+ * inputs[k * inputCount + i]. Vector k only depends on k (and on the seed for random
+ * vectors), so the first mismatch is the same whatever the number of threads. */
+
+// Vectors with their expected outputs, e.g. read from a golden file
+struct TestVectors {
+  std::vector<std::string> inputNames;
+  std::vector<std::string> outputNames;
+
+  std::vector<uint64_t> inputs;
+  std::vector<uint64_t> outputs;
+
+  [[nodiscard]] size_t size() const
+  {
+    return inputNames.empty() ? 0 : inputs.size() / inputNames.size();
+  }
+};
+
+class TestBench {
+public:
+  using Port = SubcircuitDefinition::Port;
+
+  // At most 31 bits
+  struct BusPort {
+    std::string name;
+    Bus         bus;
+  };
+
+  // Computes the expected outputs of the inputs, it is called by several threads at once
+  using Model =
+      std::function<void(std::span<const uint64_t> inputs, std::span<uint64_t> outputs)>;
+
+  struct Options {
+    unsigned threads = 0;  // 0: one for each core
+
+    // Clock cycles after applying a vector. If not 0 the circuit is reset before every
+    // vector, otherwise it's only settled and DFFs keep their state.
+    unsigned cycles = 0;
+
+    bool stopAtFirstMismatch = true;
+
+    // Whether combinational netlists can be evaluated 64 vectors at a time
+    bool bitParallel = true;
+
+    // exhaustive() refuses to run more than 2^maxExhaustiveBits vectors
+    unsigned maxExhaustiveBits = 24;
+
+    // Netlists only: the state the simulators start from (and go back to instead of
+    // resetting), e.g. a checkpoint saved after a warm-up. The vectors are then never
+    // evaluated 64 at a time.
+    const Simulator::Snapshot* initialState = nullptr;
+  };
+
+  struct Mismatch {
+    uint64_t index  = 0;  // Of the vector
+    uint32_t output = 0;  // First output port that differs
+
+    std::vector<uint64_t> inputs;
+    std::vector<uint64_t> expected;
+    std::vector<uint64_t> actual;
+
+    bool error = false;  // Some bits of the output were in the ERROR state
+  };
+
+  struct Report {
+    uint64_t vectors    = 0;  // Run, less than requested if it stopped at a mismatch
+    uint64_t mismatches = 0;
+    unsigned threads    = 0;
+    double   seconds    = 0;
+
+    bool bitParallel = false;  // Whether the vectors were evaluated 64 at a time
+
+    std::optional<Mismatch> firstMismatch;
+
+    [[nodiscard]] double getVectorsPerSecond() const
+    {
+      return seconds > 0 ? vectors / seconds : 0;
+    }
+  };
+
+  template <typename T>
+  using Result = std::expected<T, std::string>;
+
+  // `netlist` must be finalized and outlive the TestBench
+  TestBench(const Netlist& netlist, std::vector<Port> inputs, std::vector<Port> outputs);
+
+  // The word-level macros of the definition are used by the simulators
+  explicit TestBench(const SubcircuitDefinition& definition);
+
+  // The buses are forced to the values of the inputs, the circuit must not be changed
+  // while the TestBench runs
+  TestBench(std::vector<BusPort> inputs, std::vector<BusPort> outputs);
+
+  [[nodiscard]] size_t getInputCount() const { return inputNames.size(); }
+  [[nodiscard]] size_t getOutputCount() const { return outputNames.size(); }
+
+  // Whether the vectors can be evaluated 64 at a time
+  [[nodiscard]] bool isBitParallel() const { return evaluator.has_value(); }
+
+  // Every combination of the inputs: the bits of the index of a vector are assigned to
+  // the ports in order, starting from the least significant one
+  Result<Report> exhaustive(const Model& model, const Options& options) const;
+  Result<Report> exhaustive(const Model& model) const { return exhaustive(model, {}); }
+
+  Result<Report> random(uint64_t count, uint64_t seed, const Model& model,
+                        const Options& options) const;
+  Result<Report> random(uint64_t count, uint64_t seed, const Model& model) const
+  {
+    return random(count, seed, model, {});
+  }
+
+  // Ports are matched by name if the vectors have names, by position otherwise
+  Result<Report> golden(const TestVectors& vectors, const Options& options) const;
+  Result<Report> golden(const TestVectors& vectors) const { return golden(vectors, {}); }
+
+  // The outputs of the circuit for `stimuli`, to be saved as golden vectors
+  Result<TestVectors> record(std::span<const uint64_t> stimuli,
+                             const Options&            options) const;
+
+private:
+  // Input vector `index`
+  using Stimulus = std::function<void(uint64_t index, std::span<uint64_t> inputs)>;
+
+  // Expected outputs of vector `index`. Returns false if the vector must not be checked.
+  using Expectation = std::function<bool(uint64_t index, std::span<const uint64_t> inputs,
+                                         std::span<uint64_t> outputs)>;
+
+  // `record` is called with the outputs of every vector, instead of comparing them
+  using Recorder = std::function<void(uint64_t index, std::span<const uint64_t> outputs)>;
+
+  class Engine;
+
+  Result<Report> run(uint64_t count, const Stimulus& stimulus,
+                     const Expectation& expectation, const Recorder& record,
+                     const Options& options) const;
+
+  Result<void> checkPorts() const;
+
+  void initPorts();
+
+  // Netlist
+  const Netlist*                      netlist = nullptr;
+  const MacroSet*                     macros  = nullptr;
+  std::vector<Port>                   inputs;
+  std::vector<Port>                   outputs;
+  std::optional<BitParallelEvaluator> evaluator;
+
+  // Component circuit
+  std::vector<BusPort> inputBuses;
+  std::vector<BusPort> outputBuses;
+
+  std::vector<std::string> inputNames;
+  std::vector<std::string> outputNames;
+  std::vector<size_t>      inputWidths;
+  std::vector<size_t>      outputWidths;
+};
+
+std::string to_str(const TestBench::Report& report);
@@ -18,6 +18,9 @@
 
 #include "wire.hpp"
 
+#include <core/activityProfiler.hpp>
+#include <core/diagnostics.hpp>
+
 State operator&&(const State& a, const State& b)
 {
   if (a == State::ERROR || b == State::ERROR)
@@ -74,9 +77,8 @@ std::string to_str(State s)
 
 Wire::Wire()
 {
-  this->currentState        = State::ERROR;
-  this->updateActions       = {};
-  this->authorizedComponent = {};
+  this->currentState  = State::ERROR;
+  this->updateActions = {};
 }
 
 Wire::Wire(State s)
@@ -89,74 +91,115 @@ State Wire::getCurrentState() const
   return this->currentState;
 }
 
-void Wire::forceSetCurrentState(const State newState)
+unsigned Wire::oscillationLimit = Wire::DEFAULT_OSCILLATION_LIMIT;
+
+namespace {
+// Changes of wires whose update actions are running on this thread, nested
+thread_local unsigned propagationDepth = 0;
+}  // namespace
+
+void Wire::setOscillationLimit(const unsigned limit)
+{
+  assert(limit > 0);
+  oscillationLimit = limit;
+}
+
+void Wire::forceSetCurrentState(State newState)
 {
   if (this->currentState == newState)
     return;
 
+  const bool isOscillating =
+      this->propagatingChanges >= oscillationLimit
+      || (this->propagatingChanges > 0 && propagationDepth >= MAX_LOOP_DEPTH);
+  if (isOscillating) [[unlikely]] {
+    newState = State::ERROR;
+    if (this->currentState == newState)
+      return;
+  }
+
   this->currentState = newState;
+  this->oscillating  = isOscillating;
+
+  this->propagatingChanges++;
+  propagationDepth++;
 
-  for (const action_ptr& a : this->updateActions)
-    if (a)
-      (*a)();
+  if (const auto profiler = ActivityProfiler::current()) [[unlikely]] {
+    profiler->propagate(this, this->updateActions);
+  } else {
+    for (const auto& a : this->updateActions)
+      if (a.action)
+        (*a.action)();
+  }
+
+  propagationDepth--;
+  this->propagatingChanges--;
 }
 
-void Wire::setCurrentState(const State newState, const Component_weakPtr& requestedBy)
+void Wire::setCurrentState(const State newState, const DriverId requestedBy)
 {
   // Every wire has a mechanism to detect graphs error: the component that
-  // controls the wire can be only one at a time and it's stored in the
-  // authorizedComponent pointer. If another component tries to modify its
-  // status then the wire go into the ERROR state, since the graph is malformed.
+  // controls the wire can be only one at a time and its ID is stored in the
+  // driver field. If another component tries to modify its status then the
+  // wire go into the ERROR state, since the graph is malformed.
 
-  if (!this->authorizedComponent.lock())
-    this->authorizedComponent = requestedBy;
+  if (this->driver == NO_DRIVER)
+    this->driver = requestedBy;
 
-  const bool changeIsAuthorized = this->authorizedComponent.lock() == requestedBy.lock();
+  const bool changeIsAuthorized = this->driver == requestedBy;
 
-  if (!changeIsAuthorized)
-    std::cout << "Change not authorized";
+  if (!changeIsAuthorized) [[unlikely]] {
+    Diagnostics::report(Severity::WARNING, DiagnosticCode::CONFLICTING_DRIVERS, [&] {
+      return "component " + std::to_string(requestedBy)
+             + " changed a wire driven by component " + std::to_string(this->driver);
+    });
+  }
 
   State s = changeIsAuthorized ? newState : State::ERROR;
 
   this->forceSetCurrentState(s);
 }
 
+void Wire::releaseDriver(const DriverId d)
+{
+  if (this->driver == d)
+    this->driver = NO_DRIVER;
+}
+
 void Wire::deleteUpdateAction(const action_ptr& a)
 {
-  const auto b   = this->updateActions.begin();
-  const auto e   = this->updateActions.end();
-  const auto pos = std::find(b, e, a);
+  const auto pos = std::ranges::find(this->updateActions, a, &UpdateAction::action);
 
-  if (pos != e)
+  if (pos != this->updateActions.end())
     this->updateActions.erase(pos);
 }
-void Wire::safeSetCurrentState(const std::weak_ptr<Wire>& w, State newState,
-                               const Component_weakPtr& requestedBy)
+void Wire::safeSetCurrentState(const std::shared_ptr<Wire>& w, State newState,
+                               const DriverId requestedBy)
 {
   // Little hack necessary because the component's action logic doesn't know if its output
   // is connected. Without this, each action would need to check for the output wire's
   // existence every time it runs.
 
-  const auto lockedWire = w.lock();
-  if (!lockedWire) {
-    std::cout << "Wire not found";
+  if (!w) {
+    Diagnostics::report(Severity::DEBUG, DiagnosticCode::MISSING_WIRE, [&] {
+      return "component " + std::to_string(requestedBy) + " has an unconnected output";
+    });
     return;
   }
 
-  lockedWire->setCurrentState(newState, requestedBy);
+  w->setCurrentState(newState, requestedBy);
 }
 
-State Wire::safeGetCurrentState(const std::weak_ptr<Wire>& w)
+State Wire::safeGetCurrentState(const std::shared_ptr<Wire>& w)
 {
-  const auto lockedWire = w.lock();
-  return lockedWire ? lockedWire->getCurrentState() : State::ERROR;
+  return w ? w->getCurrentState() : State::ERROR;
 }
 
-void Wire::addUpdateAction(const action_ptr& a)
+void Wire::addUpdateAction(const action_ptr& a, const Component* owner)
 {
   assert(a);
 
-  this->updateActions.push_back(a);
+  this->updateActions.push_back({a, owner});
 
   // When I add the action I need to run it right away in order to make it work
   // when the state of the inputs is changed before the component is created!
@@ -167,7 +210,7 @@ Bus::Bus(const unsigned short size)
 {
   this->busData.reserve(size);
   for (unsigned short i = 0; i < size; i++)
-    this->busData.push_back(std::make_shared<Wire>(State::ERROR));
+    this->busData.push_back(CircuitArena::make<Wire>(State::ERROR));
 }
 
 void Bus::setSize(const unsigned short size)
@@ -178,35 +221,22 @@ void Bus::setSize(const unsigned short size)
 
   // `resize` adds nullpointers if the new size is greater, so we need to fill them up
   for (size_t i = oldSize; i < size; i++)
-    this->busData[i] = std::make_shared<Wire>(State::ERROR);
+    this->busData[i] = CircuitArena::make<Wire>(State::ERROR);
 }
 
-Bus::Bus(std::vector<Wire_ptr> busData)
-{
-  this->busData = busData;
-
-  for (Wire_ptr& w : busData)
-    if (!w)
-      w = std::make_shared<Wire>(State::LOW);
-}
+Bus::Bus(std::vector<Wire_ptr> busData) : busData(std::move(busData)) {}
 
-Bus::Bus(std::initializer_list<Wire_ptr> initList) : busData(initList.size())
-{
-  size_t i = 0;
-  for (const auto& val : initList) {
-    busData[i++] = val;
-  }
-}
+Bus::Bus(std::initializer_list<Wire_ptr> initList) : busData(initList) {}
 
 Bus::Bus(std::initializer_list<Wire> initList) : busData(initList.size())
 {
   size_t i = 0;
   for (const auto& val : initList) {
-    busData[i++] = std::make_shared<Wire>(val);
+    busData[i++] = CircuitArena::make<Wire>(val);
   }
 }
 
-int Bus::forceSetCurrentValue(const unsigned int value)
+int Bus::forceSetCurrentValue(const unsigned int value) const
 {
   for (unsigned short i = 0; i < this->size(); i++) {
     if (!this->busData[i])
@@ -220,7 +250,7 @@ int Bus::forceSetCurrentValue(const unsigned int value)
   return (value >= (1u << this->size()));
 }
 
-int Bus::setCurrentValue(const unsigned int value, const Component_weakPtr& requestedBy)
+int Bus::setCurrentValue(const unsigned int value, const DriverId requestedBy) const
 {
   for (unsigned short i = 0; i < this->size(); i++) {
     if (!this->busData[i])
@@ -19,15 +19,19 @@
 #pragma once
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <format>
 #include <functional>
 #include <initializer_list>
 #include <iostream>
 #include <iterator>
 #include <memory>
+#include <memory_resource>
 #include <string>
 #include <vector>
 
+#include <core/arena.hpp>
+
 // Each wire could hold one of three states
 enum class State {
   LOW,
@@ -51,27 +55,69 @@ class Component;
 using Component_weakPtr = std::weak_ptr<Component>;
 using Component_ptr     = std::shared_ptr<Component>;
 
+// Every component gets a compact ID when it's created: wires compare it with the one of
+// their driver instead of locking weak pointers on every change
+using DriverId = uint32_t;
+
+inline constexpr DriverId NO_DRIVER = 0;
+
+// An action run when a wire changes, together with the component it belongs to (if any)
+struct UpdateAction {
+  action_ptr       action;
+  const Component* owner = nullptr;
+};
+
 class Wire {
 private:
-  State                   currentState;
-  std::vector<action_ptr> updateActions;
-  Component_weakPtr       authorizedComponent;
+  State                          currentState;
+  std::pmr::vector<UpdateAction> updateActions{CircuitArena::resource()};
+  DriverId                       driver = NO_DRIVER;
+
+  // Changes of the wire whose update actions are still running: there's more than one
+  // only if the wire is in a loop
+  uint16_t propagatingChanges = 0;
+  bool     oscillating        = false;
+
+  static unsigned oscillationLimit;
 
 public:
+  // A wire that changes this many times while its first change is still propagating is
+  // oscillating: it's stuck in the ERROR state, which every component propagates, so the
+  // loop settles instead of recursing until the stack overflows
+  static constexpr unsigned DEFAULT_OSCILLATION_LIMIT = 16;
+
+  // Every turn of a loop takes the propagation as many changes deeper as the loop is
+  // long: past this depth a wire changed again while its change is propagating is
+  // oscillating at once, so long loops can't overflow the stack either
+  static constexpr unsigned MAX_LOOP_DEPTH = 1024;
+
+  static void setOscillationLimit(unsigned limit);
+
   Wire();
   explicit Wire(State s);
 
   State getCurrentState() const;
-  void  forceSetCurrentState(const State newState);
+  void  forceSetCurrentState(State newState);
+
+  // Whether the wire was stuck in the ERROR state by an oscillation
+  [[nodiscard]] bool isOscillating() const { return oscillating; }
+  void               clearOscillation() { oscillating = false; }
+
+  void setCurrentState(State newState, DriverId requestedBy);
+
+  // Sets the state without running the update actions, to bring back a whole state of
+  // the circuit recorded by a StateHistory
+  void restoreState(State s) { currentState = s; }
 
-  void setCurrentState(State newState, const Component_weakPtr& requestedBy);
+  // The wire can be driven by another component: called when `d` is disconnected
+  void releaseDriver(DriverId d);
 
-  void addUpdateAction(const action_ptr& a);
+  void addUpdateAction(const action_ptr& a, const Component* owner = nullptr);
   void deleteUpdateAction(const action_ptr& a);
 
-  static void  safeSetCurrentState(const std::weak_ptr<Wire>& w, State newState,
-                                   const Component_weakPtr& requestedBy);
-  static State safeGetCurrentState(const std::weak_ptr<Wire>& w);
+  static void  safeSetCurrentState(const std::shared_ptr<Wire>& w, State newState,
+                                   DriverId requestedBy);
+  static State safeGetCurrentState(const std::shared_ptr<Wire>& w);
 };
 
 using Wire_ptr = std::shared_ptr<Wire>;
@@ -89,20 +135,27 @@ public:
 
   void setSize(unsigned short size);
 
-  int forceSetCurrentValue(const unsigned int value);
+  // The bus only refers to its wires: setting them doesn't change it
+  int forceSetCurrentValue(unsigned int value) const;
 
-  int setCurrentValue(unsigned int value, const Component_weakPtr& requestedBy);
+  int setCurrentValue(unsigned int value, DriverId requestedBy) const;
 
   [[nodiscard]] unsigned int getCurrentValue() const;
 
   [[nodiscard]] bool isInErrorState() const;
 
   Wire_ptr& operator[](unsigned short index) { return this->busData.at(index); }
+  const Wire_ptr& operator[](unsigned short index) const
+  {
+    return this->busData.at(index);
+  }
   explicit  operator std::vector<Wire_ptr>() const { return this->busData; }
   explicit  operator std::vector<Wire_ptr>() { return this->busData; }
 
   auto begin() { return this->busData.begin(); }
   auto end() { return this->busData.end(); }
+  auto begin() const { return this->busData.begin(); }
+  auto end() const { return this->busData.end(); }
 
   [[nodiscard]] auto size() { return this->busData.size(); }
   [[nodiscard]] auto size() const { return this->busData.size(); }
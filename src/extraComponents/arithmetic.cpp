@@ -34,8 +34,8 @@ HalfAdder::HalfAdder(std::array<Wire_ptr, 2> inputs, Wire_ptr sum, Wire_ptr cout
     State sum =
         this->inputs[0][0]->getCurrentState() ^ this->inputs[1][0]->getCurrentState();
 
-    this->outputs[0][0]->setCurrentState(sum, weak_from_this());
-    this->outputs[1][0]->setCurrentState(cout, weak_from_this());
+    this->outputs[0][0]->setCurrentState(sum, driverId);
+    this->outputs[1][0]->setCurrentState(cout, driverId);
   });
 }
 
@@ -51,20 +51,16 @@ FullAdder::FullAdder(std::array<Wire_ptr, 2> inputs, Wire_ptr cin, Wire_ptr sum,
      cout = outputs[1][0]; */
 
   this->setAction([this] {
-    auto partialSum1   = std::make_shared<Wire>();
-    auto partialCarry1 = std::make_shared<Wire>();
-    auto partialCarry2 = std::make_shared<Wire>();
+    const State a   = this->inputs[0][0]->getCurrentState();
+    const State b   = this->inputs[1][0]->getCurrentState();
+    const State cin = this->inputs[2][0]->getCurrentState();
 
-    auto h1 = std::make_shared<HalfAdder>(
-        std::array<Wire_ptr, 2>{this->inputs[0][0], this->inputs[1][0]}, partialSum1,
-        partialCarry1);
+    // Two half adders, their carries are ORed
+    const State partialSum = a ^ b;
+    const State cout       = (a && b) || (partialSum && cin);
 
-    auto h2 = std::make_shared<HalfAdder>(
-        std::array<Wire_ptr, 2>{partialSum1, this->inputs[2][0]}, this->outputs[0][0],
-        partialCarry2);
-
-    auto og = std::make_shared<OrGate>(
-        std::vector<Wire_ptr>{partialCarry1, partialCarry2}, this->outputs[1][0]);
+    this->outputs[0][0]->setCurrentState(partialSum ^ cin, driverId);
+    this->outputs[1][0]->setCurrentState(cout, driverId);
   });
 }
 
@@ -84,8 +80,8 @@ AdderNBits::AdderNBits(std::array<Bus, 2> inputs, Bus sum, Wire_ptr cout)
     int a = this->inputs[0].getCurrentValue();
     int b = this->inputs[1].getCurrentValue();
 
-    int overflow = this->outputs[0].setCurrentValue(a + b, weak_from_this());
+    int overflow = this->outputs[0].setCurrentValue(a + b, driverId);
 
-    this->outputs[1].setCurrentValue(overflow, weak_from_this());
+    this->outputs[1].setCurrentValue(overflow, driverId);
   });
 }
@@ -16,21 +16,31 @@
 
 #include "utils.hpp"
 
+#include <cassert>
+#include <string>
+
+#include <core/diagnostics.hpp>
+
 WireSplitter::WireSplitter(Bus input, const std::vector<Bus>& outputs)
   : Component({input}, outputs, "WireSplitter")
 {
   this->setAction([this] {
-    const unsigned int N = this->outputs.size();
-    std::cout << "N: " << N << std::endl;
+    const unsigned int N    = this->outputs.size();
+    const bool         fits = this->inputs[0].size() == N;
+
+    if (!fits) [[unlikely]] {
+      Diagnostics::report(Severity::WARNING, DiagnosticCode::WIDTH_MISMATCH, [&] {
+        return "splitter of " + std::to_string(this->inputs[0].size()) + " bits with "
+               + std::to_string(N) + " outputs";
+      });
+    }
+
     for (unsigned int i = 0; i < N; i++) {
       // Get the value of input bit i
-      const State s = (this->inputs[0].size() == N)
-                          ? Wire::safeGetCurrentState(this->inputs[0][i])
-                          : State::ERROR;
+      const State s = fits ? Wire::safeGetCurrentState(this->inputs[0][i]) : State::ERROR;
       // Set the value of ith output
-      std::cout << this->outputs[i].size() << std::endl;
       if (this->outputs[i].size() != 0)
-        Wire::safeSetCurrentState(this->outputs[i][0], s, weak_from_this());
+        Wire::safeSetCurrentState(this->outputs[i][0], s, driverId);
     }
   });
 }
@@ -40,14 +50,35 @@ WireMerger::WireMerger(const std::vector<Bus>& inputs, Bus output)
 {
   this->setAction([this] {
     const unsigned int N = this->inputs.size();
-    std::cout << "N: " << N << std::endl;
     for (unsigned int i = 0; i < N; i++) {
       // Get the value of ith input
       const State s = (this->inputs[i].size() != 0)
                           ? Wire::safeGetCurrentState(this->inputs[i][0])
                           : State::ERROR;
       // Set the value of output bit i
-      Wire::safeSetCurrentState(this->outputs[0][i], s, weak_from_this());
+      Wire::safeSetCurrentState(this->outputs[0][i], s, driverId);
     }
   });
-}
\ No newline at end of file
+}
+
+std::vector<Bus> WireSplitter::aliasOutputs(const Bus& input, const Bus& errors)
+{
+  const bool fits = input.size() == errors.size();
+
+  std::vector<Bus> res(errors.size());
+  for (size_t i = 0; i < errors.size(); i++)
+    res[i] = Bus({fits && input[i] ? input[i] : errors[i]});
+
+  return res;
+}
+
+Bus WireMerger::aliasOutput(const std::span<const Bus> inputs, const Bus& errors)
+{
+  assert(errors.size() == inputs.size());
+
+  std::vector<Wire_ptr> bits(inputs.size());
+  for (size_t i = 0; i < inputs.size(); i++)
+    bits[i] = inputs[i].size() != 0 && inputs[i][0] ? inputs[i][0] : errors[i];
+
+  return Bus(std::move(bits));
+}
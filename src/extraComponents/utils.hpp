@@ -17,15 +17,31 @@
 
 #pragma once
 
+#include <span>
+#include <vector>
+
 #include <core/component.hpp>
 #include <core/wire.hpp>
 
+/* Splitters and mergers only rename bits. As components they copy every bit whenever
+ * one changes; when a circuit is compiled for simulation their wires are aliased instead,
+ * i.e. the bits on both sides are the same Wire objects, and they're never evaluated. */
+
 class WireSplitter : public Component {
 public:
   WireSplitter(Bus input, const std::vector<Bus>& outputs);
+
+  // Buses of one bit made of the bits of `input`. If it doesn't have a bit for every
+  // output they're made of the bits of `errors` instead, which must be in the ERROR
+  // state, like the outputs of a splitter that doesn't fit.
+  [[nodiscard]] static std::vector<Bus> aliasOutputs(const Bus& input, const Bus& errors);
 };
 
 class WireMerger : public Component {
 public:
   WireMerger(const std::vector<Bus>& inputs, Bus output);
+
+  // A bus made of the first bit of every input. The bits of the unconnected inputs are
+  // the ones of `errors`, which must be in the ERROR state.
+  [[nodiscard]] static Bus aliasOutput(std::span<const Bus> inputs, const Bus& errors);
 };
@@ -0,0 +1,346 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "circuitCompiler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <utility>
+
+#include <core/netlistOptimizer.hpp>
+#include <utils/ranges_wrapper.hpp>
+
+namespace {
+using Unexpected = std::unexpected<std::string>;
+using Port       = SubcircuitDefinition::Port;
+
+constexpr std::array<std::pair<std::string_view, GateType>, 7> GATE_TYPES = {{
+    {"AND_GATE", GateType::AND},
+    {"NAND_GATE", GateType::NAND},
+    {"OR_GATE", GateType::OR},
+    {"NOR_GATE", GateType::NOR},
+    {"XOR_GATE", GateType::XOR},
+    {"NOT_GATE", GateType::NOT},
+    {"DFF", GateType::DFF},
+}};
+
+std::optional<GateType> gateType(const std::string_view typeName)
+{
+  for (const auto& [name, type] : GATE_TYPES)
+    if (name == typeName)
+      return type;
+
+  return std::nullopt;
+}
+
+class DisjointSets {
+public:
+  explicit DisjointSets(const size_t size) : parent(size)
+  {
+    std::iota(parent.begin(), parent.end(), 0);
+  }
+
+  size_t find(size_t i)
+  {
+    while (parent[i] != i)
+      i = parent[i] = parent[parent[i]];
+    return i;
+  }
+
+  void unite(const size_t a, const size_t b) { parent[find(a)] = find(b); }
+
+private:
+  std::vector<size_t> parent;
+};
+
+// Copies the gates of `def` into `netlist`: the input ports become the given nets, the
+// output ports drive them through a buffer
+void inlineDefinition(Netlist& netlist, const SubcircuitDefinition& def,
+                      const std::vector<std::vector<NetId>>& inputs,
+                      const std::vector<std::vector<NetId>>& outputs)
+{
+  const auto& inner = def.getNetlist();
+
+  std::vector<NetId> map(inner.getNetCount());
+  for (NetId n = 0; n < inner.getNetCount(); n++) {
+    map[n] = netlist.addNet();
+    netlist.setInitialState(map[n], inner.getInitialState(n));
+  }
+
+  for (size_t i = 0; i < inputs.size(); i++) {
+    const auto& port = def.getInputs()[i].nets;
+    for (size_t bit = 0; bit < port.size() && bit < inputs[i].size(); bit++)
+      map[port[bit]] = inputs[i][bit];
+  }
+
+  std::vector<NetId> gateInputs{};
+  for (GateId g = 0; g < inner.getGateCount(); g++) {
+    gateInputs.clear();
+    for (const NetId n : inner.getGateInputs(g))
+      gateInputs.push_back(map[n]);
+
+    netlist.addGate(inner.getGateType(g), gateInputs, map[inner.getGateOutput(g)]);
+  }
+
+  for (size_t i = 0; i < outputs.size(); i++) {
+    const auto& port = def.getOutputs()[i].nets;
+    for (size_t bit = 0; bit < port.size() && bit < outputs[i].size(); bit++)
+      netlist.addGate(GateType::BUF, std::array{map[port[bit]]}, outputs[i][bit]);
+  }
+}
+}  // namespace
+
+CircuitCompiler::Result CircuitCompiler::compile(const CircuitDocument& doc,
+                                                 std::string             name)
+{
+  // Nested definitions, compiled once no matter how many instances they have
+  std::vector<SubcircuitDefinition_ptr> definitions(doc.subcircuits.size());
+
+  for (const auto& c : doc.components) {
+    if (doc.getTypeName(c) != CircuitDocument::SUBCIRCUIT_TYPE || definitions[c.variant])
+      continue;
+
+    const auto& source = doc.subcircuits[c.variant];
+
+    auto def = compile(source, source.name);
+    if (!def)
+      return Unexpected(source.name + ": " + def.error());
+
+    definitions[c.variant] = std::move(*def);
+  }
+
+  // The width of a net isn't reliable until the circuit is simulated: it's the widest of
+  // its ports
+  const auto portWidth = [&](const CircuitDocument::ComponentRecord& c, const bool output,
+                             const size_t index) -> uint32_t {
+    const auto type = doc.getTypeName(c);
+
+    if (type == CircuitDocument::SUBCIRCUIT_TYPE) {
+      const auto& def   = *definitions[c.variant];
+      const auto& ports = output ? def.getOutputs() : def.getInputs();
+      return index < ports.size() ? ports[index].nets.size() : 1;
+    }
+
+    if ((type == "WIRE_SPLITTER" && !output) || (type == "WIRE_MERGER" && output))
+      return c.variant;
+
+    return 1;
+  };
+
+  std::vector<uint32_t> widths(doc.nets.size());
+  for (size_t n = 0; n < doc.nets.size(); n++)
+    widths[n] = std::max(doc.nets[n].width, 1u);
+
+  for (const auto& c : doc.components) {
+    for (const auto [i, net] : doc.getInputs(c) | silicon::views::enumerate)
+      if (net != CircuitDocument::NO_NET)
+        widths[net] = std::max(widths[net], portWidth(c, false, i));
+
+    for (const auto [i, net] : doc.getOutputs(c) | silicon::views::enumerate)
+      if (net != CircuitDocument::NO_NET)
+        widths[net] = std::max(widths[net], portWidth(c, true, i));
+  }
+
+  // Every bit of every net is a slot, the bits connected by splitters and mergers are
+  // merged into a single netlist net
+  std::vector<size_t> firstSlot(doc.nets.size() + 1, 0);
+  for (size_t n = 0; n < doc.nets.size(); n++)
+    firstSlot[n + 1] = firstSlot[n] + widths[n];
+
+  DisjointSets slots(firstSlot.back());
+
+  const auto alias = [&](const uint32_t wide, const uint32_t bit, const uint32_t narrow) {
+    if (wide != CircuitDocument::NO_NET && narrow != CircuitDocument::NO_NET
+        && bit < widths[wide])
+      slots.unite(firstSlot[wide] + bit, firstSlot[narrow]);
+  };
+
+  for (const auto& c : doc.components) {
+    const auto type    = doc.getTypeName(c);
+    const auto inputs  = doc.getInputs(c);
+    const auto outputs = doc.getOutputs(c);
+
+    if (type == "WIRE_SPLITTER" && !inputs.empty())
+      for (const auto [bit, out] : outputs | silicon::views::enumerate)
+        alias(inputs[0], bit, out);
+
+    if (type == "WIRE_MERGER" && !outputs.empty())
+      for (const auto [bit, in] : inputs | silicon::views::enumerate)
+        alias(outputs[0], bit, in);
+  }
+
+  Netlist netlist;
+
+  std::vector<NetId> slotNets(firstSlot.back(), Netlist::NO_NET);
+  for (size_t s = 0; s < slotNets.size(); s++) {
+    auto& root = slotNets[slots.find(s)];
+    if (root == Netlist::NO_NET)
+      root = netlist.addNet();
+    slotNets[s] = root;
+  }
+
+  // Nets of the bits of a port, unconnected ports get nets of their own
+  const auto bits = [&](const uint32_t net, const uint32_t width) {
+    std::vector<NetId> res{};
+    for (uint32_t bit = 0; bit < width; bit++)
+      res.push_back(net != CircuitDocument::NO_NET && bit < widths[net]
+                        ? slotNets[firstSlot[net] + bit]
+                        : netlist.addNet());
+    return res;
+  };
+
+  const auto bit = [&](const uint32_t net) { return bits(net, 1)[0]; };
+
+  const auto nets = [&](const std::span<const uint32_t> ports) {
+    std::vector<NetId> res{};
+    for (const auto net : ports)
+      res.push_back(bit(net));
+    return res;
+  };
+
+  std::vector<Port> inputPorts, outputPorts;
+
+  for (const auto& c : doc.components) {
+    const auto type    = doc.getTypeName(c);
+    const auto inputs  = doc.getInputs(c);
+    const auto outputs = doc.getOutputs(c);
+
+    if (const auto gate = gateType(type)) {
+      if (inputs.empty() || outputs.size() != 1)
+        return Unexpected("Malformed " + std::string(type));
+
+      netlist.addGate(*gate, nets(inputs), bit(outputs[0]));
+
+    } else if (type == "SINGLE_INPUT" || type == "SINGLE_OUTPUT") {
+      const bool isInput = type == "SINGLE_INPUT";
+      const auto ports   = isInput ? outputs : inputs;
+      auto&      list    = isInput ? inputPorts : outputPorts;
+
+      if (ports.size() != 1)
+        return Unexpected("Malformed " + std::string(type));
+
+      const auto net   = ports[0];
+      const auto width = net == CircuitDocument::NO_NET ? 1 : widths[net];
+
+      std::string portName(doc.getString(c.name));
+      if (portName.empty())
+        portName = (isInput ? "in" : "out") + std::to_string(list.size());
+
+      list.push_back({std::move(portName), bits(net, width)});
+
+      for (const auto n : list.back().nets) {
+        if (isInput)
+          netlist.addPrimaryInput(n);
+        else
+          netlist.addPrimaryOutput(n);
+      }
+
+    } else if (type == "HALF_ADDER" || type == "FULL_ADDER") {
+      const bool full = type == "FULL_ADDER";
+      if (inputs.size() != (full ? 3 : 2) || outputs.size() != 2)
+        return Unexpected("Malformed " + std::string(type));
+
+      const auto in = nets(inputs);
+      netlist.addGate(GateType::XOR, in, bit(outputs[0]));
+
+      if (!full) {
+        netlist.addGate(GateType::AND, in, bit(outputs[1]));
+        continue;
+      }
+
+      // Majority of the three inputs
+      std::array<NetId, 3> products{};
+      for (size_t i = 0; i < 3; i++) {
+        products[i] = netlist.addNet();
+        netlist.addGate(GateType::AND, std::array{in[i], in[(i + 1) % 3]}, products[i]);
+      }
+      netlist.addGate(GateType::OR, products, bit(outputs[1]));
+
+    } else if (type == CircuitDocument::SUBCIRCUIT_TYPE) {
+      const auto& def = *definitions[c.variant];
+
+      if (inputs.size() != def.getInputs().size()
+          || outputs.size() != def.getOutputs().size())
+        return Unexpected("Ports of " + def.getName() + " don't match its definition");
+
+      std::vector<std::vector<NetId>> inputNets, outputNets;
+      for (const auto [i, net] : inputs | silicon::views::enumerate)
+        inputNets.push_back(bits(net, def.getInputs()[i].nets.size()));
+      for (const auto [i, net] : outputs | silicon::views::enumerate)
+        outputNets.push_back(bits(net, def.getOutputs()[i].nets.size()));
+
+      inlineDefinition(netlist, def, inputNets, outputNets);
+
+    } else if (type != "WIRE_SPLITTER" && type != "WIRE_MERGER") {
+      return Unexpected(std::string(type) + " can't be part of a subcircuit");
+    }
+  }
+
+  if (const auto res = netlist.finalize(); !res)
+    return Unexpected(res.error());
+
+  // Inlined subcircuits leave their buffers behind, and drawn circuits often have unused
+  // gates: every instance would simulate them
+  auto optimized = NetlistOptimizer::optimize(netlist);
+
+  for (auto* ports : {&inputPorts, &outputPorts})
+    for (auto& port : *ports)
+      for (auto& n : port.nets)
+        n = optimized.netMap[n];
+
+  return std::make_shared<const SubcircuitDefinition>(std::move(name),
+                                                      std::move(optimized.netlist),
+                                                      std::move(inputPorts),
+                                                      std::move(outputPorts));
+}
+
+CircuitCompiler::PackageResult CircuitCompiler::package(CircuitDocument source)
+{
+  static std::mutex mutex;
+  static std::map<std::vector<std::byte>, std::weak_ptr<const SubcircuitPackage>> cache;
+
+  auto key = CircuitFile::encodeBinary(source);
+
+  {
+    const std::lock_guard lock(mutex);
+    if (const auto it = cache.find(key); it != cache.end())
+      if (auto cached = it->second.lock())
+        return cached;
+  }
+
+  auto definition = compile(source, source.name);
+  if (!definition)
+    return Unexpected(definition.error());
+
+  auto res = std::make_shared<const SubcircuitPackage>(
+      SubcircuitPackage{std::move(source), std::move(*definition)});
+
+  const std::lock_guard lock(mutex);
+  std::erase_if(cache, [](const auto& entry) { return entry.second.expired(); });
+
+  // Another thread could have compiled the same source in the meantime
+  auto& entry = cache[std::move(key)];
+  if (auto cached = entry.lock())
+    return cached;
+
+  entry = res;
+  return res;
+}
@@ -0,0 +1,55 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <expected>
+#include <memory>
+#include <string>
+
+#include <core/subcircuit.hpp>
+#include <io/circuitFile.hpp>
+
+/* Compilation of a drawn circuit into a flat netlist.
+ *
+ * Every SINGLE_INPUT and SINGLE_OUTPUT becomes a port named after the component, in the
+ * order of the document. Splitters and mergers don't become gates: the bits they connect
+ * are the same net. Nested subcircuits are compiled once and then inlined in each of
+ * their instances. */
+
+// A subcircuit definition together with the document it was compiled from, which is
+// what gets saved along with its instances
+struct SubcircuitPackage {
+  CircuitDocument          source;
+  SubcircuitDefinition_ptr definition;
+};
+
+using SubcircuitPackage_ptr = std::shared_ptr<const SubcircuitPackage>;
+
+class CircuitCompiler {
+public:
+  using Result = std::expected<SubcircuitDefinition_ptr, std::string>;
+
+  static Result compile(const CircuitDocument& doc, std::string name);
+
+  // Identical sources (e.g. the same definition pasted or loaded twice) share the same
+  // package for as long as one of its instances is alive. The name of the package is
+  // the name of `source`.
+  using PackageResult = std::expected<SubcircuitPackage_ptr, std::string>;
+
+  static PackageResult package(CircuitDocument source);
+};
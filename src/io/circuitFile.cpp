@@ -0,0 +1,763 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "circuitFile.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+#include <utils/ranges_wrapper.hpp>
+
+// The binary format is stored in little endian, which is also the native byte order on
+// every supported platform: sections can then be copied without conversions.
+static_assert(std::endian::native == std::endian::little);
+
+static_assert(sizeof(CircuitDocument::ComponentRecord) == 24);
+static_assert(sizeof(CircuitDocument::NetRecord) == 8);
+static_assert(sizeof(CircuitDocument::PlacementRecord) == 16);
+static_assert(sizeof(CircuitDocument::SegmentRecord) == 16);
+static_assert(sizeof(CircuitDocument::PointRecord) == 8);
+
+/* BINARY LAYOUT:
+   [Header][Section directory][Section 0][Section 1]...
+
+   Each section starts at an offset multiple of 8. Unknown sections are skipped, so
+   newer files with extra sections can still be read.
+
+   The SUBCIRCUITS section is a sequence of [uint64 size][nested file], each nested file
+   padded to a multiple of 8. */
+
+namespace {
+
+constexpr std::array<char, 4> MAGIC        = {'S', 'L', 'C', 'N'};
+constexpr std::string_view    TEXT_MAGIC   = "SILICON-CIRCUIT";
+constexpr size_t              ALIGNMENT    = 8;
+constexpr uint16_t            SECTION_LAST = 10;
+
+enum Section : uint32_t {
+  STRINGS = 1,
+  TYPES,
+  COMPONENTS,
+  PORTS,
+  NETS,
+  PLACEMENTS,
+  SEGMENTS,
+  POINTS,
+  NAME,
+  SUBCIRCUITS,
+};
+
+struct Header {
+  std::array<char, 4> magic;
+  uint16_t            version;
+  uint16_t            sectionCount;
+  uint64_t            reserved;
+};
+
+struct SectionEntry {
+  uint32_t id;
+  uint32_t reserved;
+  uint64_t offset;
+  uint64_t size;
+};
+
+static_assert(sizeof(Header) == 16);
+static_assert(sizeof(SectionEntry) == 24);
+
+bool isGeometrySection(const uint32_t id)
+{
+  return id == PLACEMENTS || id == SEGMENTS || id == POINTS;
+}
+
+size_t align(const size_t n)
+{
+  return (n + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+bool readSubcircuits(std::vector<CircuitDocument>& out, std::span<const std::byte> bytes,
+                     const bool loadGeometry)
+{
+  while (!bytes.empty()) {
+    uint64_t size = 0;
+    if (bytes.size() < sizeof(size))
+      return false;
+
+    std::memcpy(&size, bytes.data(), sizeof(size));
+    bytes = bytes.subspan(sizeof(size));
+
+    if (size > bytes.size())
+      return false;
+
+    auto doc = CircuitFile::decodeBinary(bytes.first(size), loadGeometry);
+    if (!doc)
+      return false;
+
+    out.push_back(std::move(*doc));
+    bytes = bytes.subspan(std::min<size_t>(align(size), bytes.size()));
+  }
+
+  return true;
+}
+
+template <typename T>
+bool readSection(std::vector<T>& out, const std::span<const std::byte> bytes)
+{
+  if (bytes.size() % sizeof(T) != 0)
+    return false;
+
+  out.resize(bytes.size() / sizeof(T));
+  if (!bytes.empty())
+    std::memcpy(out.data(), bytes.data(), bytes.size());
+
+  return true;
+}
+
+// Checks that every reference inside the document points to an existing record
+std::expected<void, std::string> validate(const CircuitDocument& doc)
+{
+  using Unexpected = std::unexpected<std::string>;
+
+  const auto validString = [&doc](const uint32_t offset) {
+    return offset < doc.strings.size();
+  };
+
+  if (!doc.strings.empty() && doc.strings.back() != '\0')
+    return Unexpected("String table is not terminated");
+
+  for (const auto type : doc.types)
+    if (!validString(type))
+      return Unexpected("Invalid type name");
+
+  for (const auto& c : doc.components) {
+    if (c.type >= doc.types.size())
+      return Unexpected("Invalid component type");
+
+    if (doc.getTypeName(c) == CircuitDocument::SUBCIRCUIT_TYPE
+        && c.variant >= doc.subcircuits.size())
+      return Unexpected("Invalid subcircuit definition");
+
+    if (!validString(c.name))
+      return Unexpected("Invalid component name");
+
+    const uint64_t lastPort = uint64_t{c.firstPort} + c.inputCount + c.outputCount;
+    if (lastPort > doc.ports.size())
+      return Unexpected("Component ports out of range");
+  }
+
+  for (const auto net : doc.ports)
+    if (net != CircuitDocument::NO_NET && net >= doc.nets.size())
+      return Unexpected("Port connected to an invalid net");
+
+  for (const auto& n : doc.nets)
+    if (!validString(n.name))
+      return Unexpected("Invalid net name");
+
+  if (!doc.placements.empty() && doc.placements.size() != doc.components.size())
+    return Unexpected("Placements don't match components");
+
+  for (const auto& s : doc.segments) {
+    if (s.net >= doc.nets.size())
+      return Unexpected("Segment belongs to an invalid net");
+
+    if (uint64_t{s.firstPoint} + s.pointCount > doc.points.size())
+      return Unexpected("Segment points out of range");
+  }
+
+  return {};
+}
+
+/* TEXT FORMAT HELPERS */
+
+std::string quote(const std::string_view str)
+{
+  std::string res = "\"";
+  for (const char c : str) {
+    if (c == '"' || c == '\\')
+      res += '\\';
+    res += c;
+  }
+  res += '"';
+  return res;
+}
+
+class Tokenizer {
+public:
+  explicit Tokenizer(const std::string_view line) : line(line) {}
+
+  bool next(std::string& token)
+  {
+    while (pos < line.size() && (line[pos] == ' ' || line[pos] == '\t'))
+      pos++;
+
+    if (pos >= line.size())
+      return false;
+
+    token.clear();
+
+    if (line[pos] != '"') {
+      while (pos < line.size() && line[pos] != ' ' && line[pos] != '\t')
+        token += line[pos++];
+      return true;
+    }
+
+    // Quoted string
+    pos++;
+    while (pos < line.size() && line[pos] != '"') {
+      if (line[pos] == '\\' && pos + 1 < line.size())
+        pos++;
+      token += line[pos++];
+    }
+
+    if (pos >= line.size())
+      return false;  // Unterminated string
+
+    pos++;
+    return true;
+  }
+
+private:
+  std::string_view line;
+  size_t           pos = 0;
+};
+
+template <typename T>
+bool parseNumber(const std::string_view str, T& value)
+{
+  const auto end      = str.data() + str.size();
+  const auto [ptr, e] = std::from_chars(str.data(), end, value);
+  return e == std::errc{} && ptr == end;
+}
+
+bool parseNet(const std::string_view str, uint32_t& net)
+{
+  if (str == "-") {
+    net = CircuitDocument::NO_NET;
+    return true;
+  }
+  return parseNumber(str, net);
+}
+
+bool parsePoint(const std::string_view str, CircuitDocument::PointRecord& point)
+{
+  const auto comma = str.find(',');
+  if (comma == std::string_view::npos)
+    return false;
+
+  return parseNumber(str.substr(0, comma), point.x)
+         && parseNumber(str.substr(comma + 1), point.y);
+}
+
+}  // namespace
+
+/* DOCUMENT */
+
+uint32_t CircuitDocument::addString(const std::string_view str)
+{
+  const auto it = stringOffsets.find(std::string(str));
+  if (it != stringOffsets.end())
+    return it->second;
+
+  const auto offset = static_cast<uint32_t>(strings.size());
+  strings.insert(strings.end(), str.begin(), str.end());
+  strings.push_back('\0');
+
+  stringOffsets.emplace(str, offset);
+  return offset;
+}
+
+uint32_t CircuitDocument::addType(const std::string_view typeName)
+{
+  const auto offset = addString(typeName);
+
+  const auto it = typeIndices.find(offset);
+  if (it != typeIndices.end())
+    return it->second;
+
+  const auto index = static_cast<uint32_t>(types.size());
+  types.push_back(offset);
+
+  typeIndices.emplace(offset, index);
+  return index;
+}
+
+uint32_t CircuitDocument::addNet(const uint32_t width, const std::string_view name)
+{
+  nets.push_back({width, addString(name)});
+  return nets.size() - 1;
+}
+
+uint32_t CircuitDocument::addComponent(const std::string_view    type,
+                                       const std::string_view    name,
+                                       const uint32_t            variant,
+                                       const std::span<const uint32_t> inputs,
+                                       const std::span<const uint32_t> outputs)
+{
+  assert(inputs.size() <= UINT16_MAX && outputs.size() <= UINT16_MAX);
+
+  ComponentRecord c{};
+  c.type        = addType(type);
+  c.name        = addString(name);
+  c.variant     = variant;
+  c.firstPort   = ports.size();
+  c.inputCount  = inputs.size();
+  c.outputCount = outputs.size();
+
+  ports.insert(ports.end(), inputs.begin(), inputs.end());
+  ports.insert(ports.end(), outputs.begin(), outputs.end());
+
+  components.push_back(c);
+  return components.size() - 1;
+}
+
+void CircuitDocument::setPlacement(const uint32_t component, PlacementRecord placement)
+{
+  assert(component < components.size());
+
+  if (placements.size() < components.size())
+    placements.resize(components.size(), PlacementRecord{});
+
+  placements[component] = placement;
+}
+
+void CircuitDocument::addSegment(const uint32_t                     net,
+                                 const std::span<const PointRecord> segmentPoints)
+{
+  assert(net < nets.size());
+
+  segments.push_back({net, static_cast<uint32_t>(points.size()),
+                      static_cast<uint32_t>(segmentPoints.size()), 0});
+  points.insert(points.end(), segmentPoints.begin(), segmentPoints.end());
+}
+
+std::string_view CircuitDocument::getString(const uint32_t offset) const
+{
+  assert(offset < strings.size());
+  return {strings.data() + offset};
+}
+
+std::string_view CircuitDocument::getTypeName(const ComponentRecord& c) const
+{
+  return getString(types[c.type]);
+}
+
+std::span<const uint32_t> CircuitDocument::getInputs(const ComponentRecord& c) const
+{
+  return std::span(ports).subspan(c.firstPort, c.inputCount);
+}
+
+std::span<const uint32_t> CircuitDocument::getOutputs(const ComponentRecord& c) const
+{
+  return std::span(ports).subspan(c.firstPort + c.inputCount, c.outputCount);
+}
+
+std::span<const CircuitDocument::PointRecord>
+CircuitDocument::getPoints(const SegmentRecord& s) const
+{
+  return std::span(points).subspan(s.firstPoint, s.pointCount);
+}
+
+/* BINARY FORMAT */
+
+std::vector<std::byte> CircuitFile::encodeBinary(const CircuitDocument& doc)
+{
+  using SectionData = std::pair<uint32_t, std::span<const std::byte>>;
+
+  std::vector<std::byte> subcircuits{};
+  for (const auto& definition : doc.subcircuits) {
+    const auto     nested = encodeBinary(definition);
+    const uint64_t size   = nested.size();
+
+    const auto sizeBytes = std::as_bytes(std::span(&size, 1));
+    subcircuits.insert(subcircuits.end(), sizeBytes.begin(), sizeBytes.end());
+    subcircuits.insert(subcircuits.end(), nested.begin(), nested.end());
+    subcircuits.resize(align(subcircuits.size()));
+  }
+
+  const std::array<SectionData, SECTION_LAST> data = {{
+      {STRINGS, std::as_bytes(std::span(doc.strings))},
+      {TYPES, std::as_bytes(std::span(doc.types))},
+      {COMPONENTS, std::as_bytes(std::span(doc.components))},
+      {PORTS, std::as_bytes(std::span(doc.ports))},
+      {NETS, std::as_bytes(std::span(doc.nets))},
+      {PLACEMENTS, std::as_bytes(std::span(doc.placements))},
+      {SEGMENTS, std::as_bytes(std::span(doc.segments))},
+      {POINTS, std::as_bytes(std::span(doc.points))},
+      {NAME, std::as_bytes(std::span(doc.name))},
+      {SUBCIRCUITS, std::span<const std::byte>(subcircuits)},
+  }};
+
+  Header header{};
+  header.magic        = MAGIC;
+  header.version      = VERSION;
+  header.sectionCount = data.size();
+
+  std::vector<SectionEntry> directory;
+  directory.reserve(data.size());
+
+  size_t offset = align(sizeof(Header) + data.size() * sizeof(SectionEntry));
+
+  for (const auto& [id, bytes] : data) {
+    directory.push_back({id, 0, offset, bytes.size()});
+    offset = align(offset + bytes.size());
+  }
+
+  std::vector<std::byte> res(offset);
+  std::memcpy(res.data(), &header, sizeof(Header));
+  std::memcpy(res.data() + sizeof(Header), directory.data(),
+              directory.size() * sizeof(SectionEntry));
+
+  for (size_t i = 0; i < data.size(); i++)
+    if (!data[i].second.empty())
+      std::memcpy(res.data() + directory[i].offset, data[i].second.data(),
+                  directory[i].size);
+
+  return res;
+}
+
+bool CircuitFile::isBinary(const std::span<const std::byte> data)
+{
+  return data.size() >= sizeof(Header)
+         && std::memcmp(data.data(), MAGIC.data(), MAGIC.size()) == 0;
+}
+
+CircuitFile::Result CircuitFile::decodeBinary(const std::span<const std::byte> data,
+                                              const bool loadGeometry)
+{
+  using Unexpected = std::unexpected<std::string>;
+
+  if (!isBinary(data))
+    return Unexpected("Not a Silicon circuit file");
+
+  Header header{};
+  std::memcpy(&header, data.data(), sizeof(Header));
+
+  if (header.version > VERSION)
+    return Unexpected("The file was created by a newer version of Silicon");
+
+  const size_t directorySize = header.sectionCount * sizeof(SectionEntry);
+  if (data.size() < sizeof(Header) + directorySize)
+    return Unexpected("Truncated section directory");
+
+  std::vector<SectionEntry> directory(header.sectionCount);
+  std::memcpy(directory.data(), data.data() + sizeof(Header), directorySize);
+
+  CircuitDocument doc{};
+
+  for (const auto& entry : directory) {
+    if (entry.offset > data.size() || entry.size > data.size() - entry.offset)
+      return Unexpected("Section out of range");
+
+    if (!loadGeometry && isGeometrySection(entry.id))
+      continue;
+
+    const auto bytes = data.subspan(entry.offset, entry.size);
+
+    bool ok = true;
+    switch (entry.id) {
+      case STRINGS: ok = readSection(doc.strings, bytes); break;
+      case TYPES: ok = readSection(doc.types, bytes); break;
+      case COMPONENTS: ok = readSection(doc.components, bytes); break;
+      case PORTS: ok = readSection(doc.ports, bytes); break;
+      case NETS: ok = readSection(doc.nets, bytes); break;
+      case PLACEMENTS: ok = readSection(doc.placements, bytes); break;
+      case SEGMENTS: ok = readSection(doc.segments, bytes); break;
+      case POINTS: ok = readSection(doc.points, bytes); break;
+      case NAME:
+        doc.name.assign(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+        break;
+      case SUBCIRCUITS: ok = readSubcircuits(doc.subcircuits, bytes, loadGeometry); break;
+      default: break;  // Unknown section
+    }
+
+    if (!ok)
+      return Unexpected("Malformed section");
+  }
+
+  if (const auto valid = validate(doc); !valid)
+    return Unexpected(valid.error());
+
+  return doc;
+}
+
+/* TEXT FORMAT
+   SILICON-CIRCUIT <version>
+   net <id> <width> "<name>"
+   component <id> <type> <variant> "<name>" in <net|->... out <net|->...
+             [at <x> <y> <rotation>]
+   segment <net> <x>,<y> <x>,<y>...
+   name "<name>"
+   subcircuit <id> <line count>
+   <line count lines: the definition, a whole nested file>
+
+   Lines starting with '#' are comments. */
+
+std::string CircuitFile::encodeText(const CircuitDocument& doc)
+{
+  std::ostringstream out;
+  out << TEXT_MAGIC << ' ' << VERSION << '\n';
+
+  if (!doc.name.empty())
+    out << "name " << quote(doc.name) << '\n';
+
+  for (const auto& [id, definition] : doc.subcircuits | silicon::views::enumerate) {
+    const auto nested = encodeText(definition);
+    out << "subcircuit " << id << ' ' << std::ranges::count(nested, '\n') << '\n'
+        << nested;
+  }
+
+  for (const auto& [id, net] : doc.nets | silicon::views::enumerate)
+    out << "net " << id << ' ' << net.width << ' ' << quote(doc.getString(net.name))
+        << '\n';
+
+  const auto printNet = [&out](const uint32_t net) {
+    if (net == CircuitDocument::NO_NET)
+      out << " -";
+    else
+      out << ' ' << net;
+  };
+
+  for (const auto& [id, c] : doc.components | silicon::views::enumerate) {
+    out << "component " << id << ' ' << doc.getTypeName(c) << ' ' << c.variant << ' '
+        << quote(doc.getString(c.name)) << " in";
+
+    std::ranges::for_each(doc.getInputs(c), printNet);
+    out << " out";
+    std::ranges::for_each(doc.getOutputs(c), printNet);
+
+    if (doc.hasGeometry()) {
+      const auto& p = doc.placements[id];
+      out << " at " << p.x << ' ' << p.y << ' ' << p.rotation;
+    }
+    out << '\n';
+  }
+
+  for (const auto& s : doc.segments) {
+    out << "segment " << s.net;
+    for (const auto& p : doc.getPoints(s))
+      out << ' ' << p.x << ',' << p.y;
+    out << '\n';
+  }
+
+  return out.str();
+}
+
+CircuitFile::Result CircuitFile::decodeText(const std::string_view text,
+                                            const bool             loadGeometry)
+{
+  using Unexpected = std::unexpected<std::string>;
+
+  CircuitDocument doc{};
+
+  std::string token;
+  size_t      lineNumber = 0;
+  size_t      pos        = 0;
+  bool        headerRead = false;
+
+  const auto error = [&lineNumber](const std::string_view msg) {
+    return Unexpected("Line " + std::to_string(lineNumber) + ": " + std::string(msg));
+  };
+
+  while (pos < text.size()) {
+    auto end = text.find('\n', pos);
+    if (end == std::string_view::npos)
+      end = text.size();
+
+    std::string_view line = text.substr(pos, end - pos);
+    pos                   = end + 1;
+    lineNumber++;
+
+    if (!line.empty() && line.back() == '\r')
+      line.remove_suffix(1);
+
+    Tokenizer tk(line);
+    if (!tk.next(token) || token.starts_with('#'))
+      continue;
+
+    if (!headerRead) {
+      uint16_t version = 0;
+      if (token != TEXT_MAGIC || !tk.next(token) || !parseNumber(token, version))
+        return error("Not a Silicon circuit file");
+      if (version > VERSION)
+        return error("The file was created by a newer version of Silicon");
+
+      headerRead = true;
+      continue;
+    }
+
+    if (token == "net") {
+      uint32_t id = 0, width = 0;
+      if (!tk.next(token) || !parseNumber(token, id) || id != doc.nets.size())
+        return error("Invalid net id");
+      if (!tk.next(token) || !parseNumber(token, width))
+        return error("Invalid net width");
+
+      std::string name{};
+      tk.next(name);
+      doc.addNet(width, name);
+
+    } else if (token == "component") {
+      uint32_t id = 0, variant = 0;
+      if (!tk.next(token) || !parseNumber(token, id) || id != doc.components.size())
+        return error("Invalid component id");
+
+      std::string type, name;
+      if (!tk.next(type) || !tk.next(token) || !parseNumber(token, variant)
+          || !tk.next(name))
+        return error("Invalid component");
+
+      if (!tk.next(token) || token != "in")
+        return error("Expected 'in'");
+
+      std::vector<uint32_t> inputs, outputs;
+      auto*                 current = &inputs;
+
+      bool                             hasPlacement = false;
+      CircuitDocument::PlacementRecord placement{};
+
+      while (tk.next(token)) {
+        if (token == "out") {
+          current = &outputs;
+        } else if (token == "at") {
+          std::string x, y, r;
+          if (!tk.next(x) || !tk.next(y) || !tk.next(r) || !parseNumber(x, placement.x)
+              || !parseNumber(y, placement.y) || !parseNumber(r, placement.rotation))
+            return error("Invalid placement");
+          hasPlacement = true;
+        } else {
+          uint32_t net = 0;
+          if (!parseNet(token, net))
+            return error("Invalid net reference");
+          current->push_back(net);
+        }
+      }
+
+      const auto c = doc.addComponent(type, name, variant, inputs, outputs);
+      if (hasPlacement && loadGeometry)
+        doc.setPlacement(c, placement);
+
+    } else if (token == "name") {
+      if (!tk.next(doc.name))
+        return error("Invalid name");
+
+    } else if (token == "subcircuit") {
+      uint32_t id        = 0;
+      size_t   lineCount = 0;
+      if (!tk.next(token) || !parseNumber(token, id) || id != doc.subcircuits.size())
+        return error("Invalid subcircuit id");
+      if (!tk.next(token) || !parseNumber(token, lineCount))
+        return error("Invalid subcircuit size");
+
+      // The definition spans the next `lineCount` lines
+      const size_t begin = std::min(pos, text.size());
+      for (size_t i = 0; i < lineCount; i++) {
+        end = text.find('\n', pos);
+        if (end == std::string_view::npos)
+          return error("Truncated subcircuit");
+        pos = end + 1;
+      }
+
+      auto definition = decodeText(text.substr(begin, pos - begin), loadGeometry);
+      if (!definition)
+        return error("Subcircuit " + std::to_string(id) + ": " + definition.error());
+
+      lineNumber += lineCount;
+      doc.subcircuits.push_back(std::move(*definition));
+
+    } else if (token == "segment") {
+      uint32_t net = 0;
+      if (!tk.next(token) || !parseNumber(token, net) || net >= doc.nets.size())
+        return error("Invalid segment net");
+
+      std::vector<CircuitDocument::PointRecord> points;
+      while (tk.next(token)) {
+        CircuitDocument::PointRecord p{};
+        if (!parsePoint(token, p))
+          return error("Invalid point");
+        points.push_back(p);
+      }
+
+      if (loadGeometry)
+        doc.addSegment(net, points);
+
+    } else {
+      return error("Unknown record '" + token + "'");
+    }
+  }
+
+  if (!headerRead)
+    return Unexpected("Empty file");
+
+  // Components declared without placement before others with placement
+  if (doc.hasGeometry())
+    doc.placements.resize(doc.components.size(), CircuitDocument::PlacementRecord{});
+
+  if (const auto valid = validate(doc); !valid)
+    return Unexpected(valid.error());
+
+  return doc;
+}
+
+CircuitFile::Result CircuitFile::decode(const std::span<const std::byte> data,
+                                        const bool                       loadGeometry)
+{
+  if (isBinary(data))
+    return decodeBinary(data, loadGeometry);
+
+  const std::string_view text(reinterpret_cast<const char*>(data.data()), data.size());
+  return decodeText(text, loadGeometry);
+}
+
+CircuitFile::Result CircuitFile::load(const std::string& path, const bool loadGeometry)
+{
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if (!file)
+    return std::unexpected("Unable to open " + path);
+
+  // Read the whole file at once, the parsing is then done in memory
+  const auto             size = static_cast<size_t>(file.tellg());
+  std::vector<std::byte> data(size);
+
+  file.seekg(0);
+  if (!file.read(reinterpret_cast<char*>(data.data()), size))
+    return std::unexpected("Unable to read " + path);
+
+  return decode(data, loadGeometry);
+}
+
+bool CircuitFile::save(const std::string& path, const CircuitDocument& doc,
+                       const Format format)
+{
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file)
+    return false;
+
+  if (format == Format::BINARY) {
+    const auto data = encodeBinary(doc);
+    file.write(reinterpret_cast<const char*>(data.data()), data.size());
+  } else {
+    file << encodeText(doc);
+  }
+
+  return static_cast<bool>(file);
+}
@@ -0,0 +1,148 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/* A circuit as it's stored on disk.
+ *
+ * Every table is a flat array of fixed-size records, so the binary file can be loaded
+ * by copying each section as a whole. Strings (type names, component and net names) are
+ * stored once in a string table and referenced by their offset.
+ *
+ * The netlist part (types, components, ports and nets) doesn't depend on the geometry
+ * part (placements, segments and points): a headless runner can skip the latter.
+ *
+ * The definitions of the SUBCIRCUIT components are nested documents, stored once no
+ * matter how many instances refer to them. */
+
+struct CircuitDocument {
+  static constexpr uint32_t         NO_NET          = UINT32_MAX;
+  static constexpr std::string_view SUBCIRCUIT_TYPE = "SUBCIRCUIT";
+
+  struct ComponentRecord {
+    uint32_t type;       // Index in the types table
+    uint32_t name;       // Offset in the string table
+    uint32_t variant;    // Size for variable-sized components, index of the definition
+                         // for subcircuits, 0 otherwise
+    uint32_t firstPort;  // Index in the ports table, inputs come before outputs
+    uint16_t inputCount;
+    uint16_t outputCount;
+    uint32_t reserved;
+  };
+
+  struct NetRecord {
+    uint32_t width;
+    uint32_t name;
+  };
+
+  struct PlacementRecord {
+    int32_t  x;
+    int32_t  y;
+    int32_t  rotation;
+    uint32_t reserved;
+  };
+
+  struct SegmentRecord {
+    uint32_t net;
+    uint32_t firstPoint;
+    uint32_t pointCount;
+    uint32_t reserved;
+  };
+
+  struct PointRecord {
+    int32_t x;
+    int32_t y;
+
+    bool operator==(const PointRecord& other) const = default;
+  };
+
+  std::vector<char>            strings;
+  std::vector<uint32_t>        types;
+  std::vector<ComponentRecord> components;
+  std::vector<uint32_t>        ports;
+  std::vector<NetRecord>       nets;
+
+  // Geometry: either empty or with a placement for every component
+  std::vector<PlacementRecord> placements;
+  std::vector<SegmentRecord>   segments;
+  std::vector<PointRecord>     points;
+
+  // Definitions of the subcircuits, each one is referenced by the variant of its
+  // instances. The name of a document is only used by the definitions.
+  std::vector<CircuitDocument> subcircuits;
+  std::string                  name;
+
+  uint32_t addString(std::string_view str);
+  uint32_t addType(std::string_view typeName);
+  uint32_t addNet(uint32_t width, std::string_view name = {});
+  uint32_t addComponent(std::string_view type, std::string_view name, uint32_t variant,
+                        std::span<const uint32_t> inputs,
+                        std::span<const uint32_t> outputs);
+
+  void setPlacement(uint32_t component, PlacementRecord placement);
+  void addSegment(uint32_t net, std::span<const PointRecord> segmentPoints);
+
+  [[nodiscard]] std::string_view getString(uint32_t offset) const;
+  [[nodiscard]] std::string_view getTypeName(const ComponentRecord& c) const;
+
+  [[nodiscard]] std::span<const uint32_t>    getInputs(const ComponentRecord& c) const;
+  [[nodiscard]] std::span<const uint32_t>    getOutputs(const ComponentRecord& c) const;
+  [[nodiscard]] std::span<const PointRecord> getPoints(const SegmentRecord& s) const;
+
+  [[nodiscard]] bool hasGeometry() const { return !placements.empty(); }
+
+private:
+  // Used to avoid storing the same string (or type) twice, not serialized
+  std::unordered_map<std::string, uint32_t> stringOffsets;
+  std::unordered_map<uint32_t, uint32_t>    typeIndices;
+};
+
+class CircuitFile {
+public:
+  enum class Format {
+    BINARY,
+    TEXT,
+  };
+
+  using Result = std::expected<CircuitDocument, std::string>;
+
+  static constexpr uint16_t VERSION = 1;
+
+  static std::vector<std::byte> encodeBinary(const CircuitDocument& doc);
+  static std::string            encodeText(const CircuitDocument& doc);
+
+  // When `loadGeometry` is false only the netlist sections are read
+  static Result decodeBinary(std::span<const std::byte> data, bool loadGeometry = true);
+  static Result decodeText(std::string_view text, bool loadGeometry = true);
+
+  // Detects the format from the content of the file
+  static Result decode(std::span<const std::byte> data, bool loadGeometry = true);
+
+  static Result load(const std::string& path, bool loadGeometry = true);
+  static bool   save(const std::string& path, const CircuitDocument& doc, Format format);
+
+  static bool isBinary(std::span<const std::byte> data);
+};
@@ -0,0 +1,764 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "circuitLayout.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <climits>
+#include <cmath>
+#include <functional>
+#include <map>
+#include <numeric>
+#include <queue>
+
+#include <utils/ranges_wrapper.hpp>
+
+namespace {
+
+constexpr uint32_t NONE = UINT32_MAX;
+
+using Point = CircuitDocument::PointRecord;
+
+int32_t floorTo(const int32_t value, const int32_t grid)
+{
+  return value >= 0 ? value / grid * grid : -((-value + grid - 1) / grid) * grid;
+}
+
+int32_t ceilTo(const int32_t value, const int32_t grid)
+{
+  return -floorTo(-value, grid);
+}
+
+int32_t roundTo(const double value, const int32_t grid)
+{
+  return static_cast<int32_t>(std::lround(value / grid)) * grid;
+}
+
+// Compressed adjacency lists
+class Adjacency {
+public:
+  Adjacency(const size_t                                     nodeCount,
+            const std::vector<std::pair<uint32_t, uint32_t>>& edges)
+    : offsets(nodeCount + 1, 0), values(edges.size())
+  {
+    for (const auto& [from, to] : edges)
+      offsets[from + 1]++;
+
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    std::vector<uint32_t> next(offsets.begin(), offsets.end() - 1);
+    for (const auto& [from, to] : edges)
+      values[next[from]++] = to;
+  }
+
+  [[nodiscard]] std::span<const uint32_t> of(const uint32_t node) const
+  {
+    return std::span(values).subspan(offsets[node], offsets[node + 1] - offsets[node]);
+  }
+
+  // Index of the first edge of `node`, edges are numbered in order
+  [[nodiscard]] uint32_t firstEdge(const uint32_t node) const { return offsets[node]; }
+
+private:
+  std::vector<uint32_t> offsets;
+  std::vector<uint32_t> values;
+};
+
+CircuitLayout::Footprint normalize(CircuitLayout::Footprint f,
+                                   const CircuitDocument::ComponentRecord& c,
+                                   const int32_t grid)
+{
+  // Components unknown to the UI get a plain box, with the ports on its sides
+  if (f.inputs.size() < c.inputCount || f.outputs.size() < c.outputCount) {
+    const int32_t rows = std::max(c.inputCount, c.outputCount) + 1;
+
+    f = {0, 0, 4 * grid, rows * grid, {}, {}};
+    for (int32_t i = 0; i < c.inputCount; i++)
+      f.inputs.push_back({0, (i + 1) * grid});
+    for (int32_t i = 0; i < c.outputCount; i++)
+      f.outputs.push_back({4 * grid, (i + 1) * grid});
+  }
+
+  for (const auto& p : f.inputs) {
+    f.left   = std::min(f.left, p.x);
+    f.top    = std::min(f.top, p.y);
+    f.bottom = std::max(f.bottom, p.y);
+  }
+
+  for (const auto& p : f.outputs) {
+    f.right  = std::max(f.right, p.x);
+    f.top    = std::min(f.top, p.y);
+    f.bottom = std::max(f.bottom, p.y);
+  }
+
+  f.left   = floorTo(f.left, grid);
+  f.top    = floorTo(f.top, grid);
+  f.right  = ceilTo(f.right, grid);
+  f.bottom = ceilTo(f.bottom, grid);
+
+  return f;
+}
+
+}  // namespace
+
+bool CircuitLayout::layout(CircuitDocument& doc, const FootprintProvider& footprintOf,
+                           const ProgressCallback& progress)
+{
+  return layout(doc, footprintOf, progress, Options{});
+}
+
+bool CircuitLayout::layout(CircuitDocument& doc, const FootprintProvider& footprintOf,
+                           const ProgressCallback& progress, const Options& options)
+{
+  const auto report = [&progress](const int percent) {
+    return !progress || progress(percent);
+  };
+
+  const int32_t g = options.grid;
+
+  const auto componentCount = static_cast<uint32_t>(doc.components.size());
+  const auto netCount       = static_cast<uint32_t>(doc.nets.size());
+
+  /* FOOTPRINTS */
+
+  std::map<std::pair<uint32_t, uint32_t>, Footprint> footprints{};
+  std::vector<const Footprint*>                       fp(componentCount);
+
+  for (uint32_t c = 0; c < componentCount; c++) {
+    const auto& component = doc.components[c];
+    const auto  key       = std::pair(component.type, component.variant);
+
+    auto it = footprints.find(key);
+    if (it == footprints.end()) {
+      auto f = footprintOf(doc.getTypeName(component), component.variant);
+      it     = footprints.emplace(key, normalize(std::move(f), component, g)).first;
+    }
+
+    fp[c] = &it->second;
+  }
+
+  /* NETS */
+
+  std::vector<uint32_t> driver(netCount, NONE);
+  std::vector<uint32_t> driverPort(netCount, 0);
+
+  // (component, input port) of every net, grouped by net
+  std::vector<std::pair<uint32_t, uint32_t>> sinkList{};
+  std::vector<std::pair<uint32_t, uint32_t>> componentEdges{};
+
+  for (uint32_t c = 0; c < componentCount; c++) {
+    const auto outputs = doc.getOutputs(doc.components[c]);
+    for (const auto [i, net] : outputs | silicon::views::enumerate) {
+      if (net != CircuitDocument::NO_NET && driver[net] == NONE) {
+        driver[net]     = c;
+        driverPort[net] = static_cast<uint32_t>(i);
+      }
+    }
+  }
+
+  std::vector<std::pair<uint32_t, uint32_t>> netSinkEdges{};
+  std::vector<uint32_t>                      sinkPortOf{};
+
+  for (uint32_t c = 0; c < componentCount; c++) {
+    const auto inputs = doc.getInputs(doc.components[c]);
+    for (const auto [i, net] : inputs | silicon::views::enumerate) {
+      if (net == CircuitDocument::NO_NET)
+        continue;
+
+      netSinkEdges.emplace_back(net, static_cast<uint32_t>(sinkPortOf.size()));
+      sinkPortOf.push_back(static_cast<uint32_t>(i));
+      sinkList.emplace_back(c, static_cast<uint32_t>(i));
+
+      if (driver[net] != NONE)
+        componentEdges.emplace_back(driver[net], c);
+    }
+  }
+
+  // Indices in `sinkList` of the sinks of every net
+  const Adjacency sinks(netCount, netSinkEdges);
+  const Adjacency successors(componentCount, componentEdges);
+
+  if (!report(5))
+    return false;
+
+  /* CYCLE REMOVAL */
+
+  // Iterative DFS: the edges closing a cycle are ignored by the layering
+  std::vector<uint8_t> visit(componentCount, 0);  // 0 new, 1 on the stack, 2 done
+  std::vector<bool>    isBackEdge(componentEdges.size(), false);
+  std::vector<uint32_t> inDegree(componentCount, 0);
+
+  for (const auto& [from, to] : componentEdges)
+    inDegree[to]++;
+
+  std::vector<uint32_t> roots(componentCount);
+  std::iota(roots.begin(), roots.end(), 0);
+  std::ranges::stable_partition(roots, [&](uint32_t c) { return inDegree[c] == 0; });
+
+  std::vector<std::pair<uint32_t, uint32_t>> stack{};
+
+  for (const uint32_t root : roots) {
+    if (visit[root] != 0)
+      continue;
+
+    stack.emplace_back(root, 0);
+    visit[root] = 1;
+
+    while (!stack.empty()) {
+      auto& [node, next] = stack.back();
+      const auto out     = successors.of(node);
+
+      if (next == out.size()) {
+        visit[node] = 2;
+        stack.pop_back();
+        continue;
+      }
+
+      const auto edge = successors.firstEdge(node) + next++;
+      const auto to   = out[edge - successors.firstEdge(node)];
+
+      if (visit[to] == 1)
+        isBackEdge[edge] = true;
+      else if (visit[to] == 0) {
+        visit[to] = 1;
+        stack.emplace_back(to, 0);
+      }
+    }
+  }
+
+  /* LAYERING */
+
+  // Longest path from the sources, on the graph without the back edges
+  std::vector<int32_t> layer(componentCount, 0);
+  std::ranges::fill(inDegree, 0);
+
+  for (uint32_t c = 0; c < componentCount; c++)
+    for (uint32_t e = successors.firstEdge(c); e < successors.firstEdge(c + 1); e++)
+      if (!isBackEdge[e])
+        inDegree[successors.of(c)[e - successors.firstEdge(c)]]++;
+
+  std::vector<uint32_t> queue{};
+  for (uint32_t c = 0; c < componentCount; c++)
+    if (inDegree[c] == 0)
+      queue.push_back(c);
+
+  for (size_t head = 0; head < queue.size(); head++) {
+    const auto c = queue[head];
+
+    for (uint32_t e = successors.firstEdge(c); e < successors.firstEdge(c + 1); e++) {
+      if (isBackEdge[e])
+        continue;
+
+      const auto to = successors.of(c)[e - successors.firstEdge(c)];
+      layer[to]     = std::max(layer[to], layer[c] + 1);
+      if (--inDegree[to] == 0)
+        queue.push_back(to);
+    }
+  }
+
+  int32_t layerCount = 1;
+  for (uint32_t c = 0; c < componentCount; c++)
+    layerCount = std::max(layerCount, layer[c] + 1);
+
+  // Components without outputs (like the output pins) go in the last column
+  for (uint32_t c = 0; c < componentCount; c++)
+    if (doc.components[c].outputCount == 0 && doc.components[c].inputCount > 0)
+      layer[c] = layerCount - 1;
+
+  if (!report(10))
+    return false;
+
+  /* DUMMY NODES */
+
+  // Forward nets crossing a column get a node in it, so they have a row of their own
+  std::vector<int32_t>  lastForwardLayer(netCount, -1);
+  std::vector<uint32_t> firstDummy(netCount, NONE);
+  std::vector<uint32_t> dummyNet{};
+  std::vector<int32_t>  nodeLayer(layer.begin(), layer.end());
+
+  for (uint32_t net = 0; net < netCount; net++) {
+    if (driver[net] == NONE)
+      continue;
+
+    const auto from = layer[driver[net]];
+    for (const auto s : sinks.of(net))
+      if (layer[sinkList[s].first] > from)
+        lastForwardLayer[net] = std::max(lastForwardLayer[net], layer[sinkList[s].first]);
+
+    firstDummy[net] = componentCount + static_cast<uint32_t>(dummyNet.size());
+    for (int32_t l = from + 1; l < lastForwardLayer[net]; l++) {
+      dummyNet.push_back(net);
+      nodeLayer.push_back(l);
+    }
+  }
+
+  const auto nodeCount = static_cast<uint32_t>(nodeLayer.size());
+
+  const auto dummyOf = [&](const uint32_t net, const int32_t l) {
+    return firstDummy[net] + static_cast<uint32_t>(l - layer[driver[net]] - 1);
+  };
+
+  // The node in column `l` the net comes from
+  const auto sourceOf = [&](const uint32_t net, const int32_t l) {
+    return l == layer[driver[net]] ? driver[net] : dummyOf(net, l);
+  };
+
+  std::vector<std::pair<uint32_t, uint32_t>> forwardEdges{};
+
+  for (uint32_t net = 0; net < netCount; net++) {
+    if (driver[net] == NONE)
+      continue;
+
+    const auto from = layer[driver[net]];
+
+    for (int32_t l = from + 1; l < lastForwardLayer[net]; l++)
+      forwardEdges.emplace_back(sourceOf(net, l - 1), dummyOf(net, l));
+
+    for (const auto s : sinks.of(net)) {
+      const auto to = layer[sinkList[s].first];
+      if (to > from)
+        forwardEdges.emplace_back(sourceOf(net, to - 1), sinkList[s].first);
+    }
+  }
+
+  const Adjacency nodeSuccessors(nodeCount, forwardEdges);
+
+  for (auto& [from, to] : forwardEdges)
+    std::swap(from, to);
+  const Adjacency nodePredecessors(nodeCount, forwardEdges);
+
+  /* ORDERING */
+
+  std::vector<std::vector<uint32_t>> columns(layerCount);
+  for (uint32_t n = 0; n < nodeCount; n++)
+    columns[nodeLayer[n]].push_back(n);
+
+  std::vector<double> position(nodeCount);
+  std::vector<double> key(nodeCount);
+
+  const auto updatePositions = [&](const std::vector<uint32_t>& column) {
+    for (size_t i = 0; i < column.size(); i++)
+      position[column[i]] = static_cast<double>(i);
+  };
+
+  for (const auto& column : columns)
+    updatePositions(column);
+
+  const auto sortByBarycenter = [&](std::vector<uint32_t>& column, const Adjacency& adj) {
+    for (const auto n : column) {
+      const auto neighbours = adj.of(n);
+      if (neighbours.empty()) {
+        key[n] = position[n];
+        continue;
+      }
+
+      double sum = 0;
+      for (const auto m : neighbours)
+        sum += position[m];
+      key[n] = sum / static_cast<double>(neighbours.size());
+    }
+
+    std::ranges::stable_sort(column,
+                             [&](uint32_t a, uint32_t b) { return key[a] < key[b]; });
+    updatePositions(column);
+  };
+
+  for (int sweep = 0; sweep < options.orderingSweeps; sweep++) {
+    for (int32_t l = 1; l < layerCount; l++)
+      sortByBarycenter(columns[l], nodePredecessors);
+
+    for (int32_t l = layerCount - 2; l >= 0; l--)
+      sortByBarycenter(columns[l], nodeSuccessors);
+
+    if (!report(10 + 40 * (sweep + 1) / std::max(options.orderingSweeps, 1)))
+      return false;
+  }
+
+  /* ROWS */
+
+  std::vector<int32_t> top(nodeCount, 0);
+
+  // Position of a component, from the top of its footprint
+  const auto positionY = [&](const uint32_t c) { return top[c] - fp[c]->top; };
+
+  // Row where the net leaves column `l`
+  const auto rowOf = [&](const uint32_t net, const int32_t l) {
+    const auto d = driver[net];
+    if (l == layer[d])
+      return positionY(d) + fp[d]->outputs[driverPort[net]].y;
+    return top[dummyOf(net, l)];
+  };
+
+  int32_t bottom = 0;
+
+  for (int32_t l = 0; l < layerCount; l++) {
+    int32_t previousBottom = INT32_MIN;
+    bool    previousIsReal = false;
+
+    for (const auto n : columns[l]) {
+      const bool isReal = n < componentCount;
+
+      double sum   = 0;
+      int    count = 0;
+
+      if (isReal) {
+        const auto inputs = doc.getInputs(doc.components[n]);
+        for (size_t i = 0; i < inputs.size(); i++) {
+          const auto net = inputs[i];
+          if (net == CircuitDocument::NO_NET || driver[net] == NONE
+              || layer[driver[net]] >= l)
+            continue;
+
+          sum += rowOf(net, l - 1) - (fp[n]->inputs[i].y - fp[n]->top);
+          count++;
+        }
+      } else {
+        sum   = rowOf(dummyNet[n - componentCount], l - 1);
+        count = 1;
+      }
+
+      const int32_t gap = isReal && previousIsReal ? options.rowSpacing * g : g;
+      const int32_t min = previousBottom == INT32_MIN ? 0 : previousBottom + gap;
+
+      top[n] = count > 0 ? std::max(roundTo(sum / count, g), min) : min;
+
+      const int32_t height = isReal ? fp[n]->bottom - fp[n]->top : 0;
+      previousBottom       = top[n] + height;
+      previousIsReal       = isReal;
+      bottom               = std::max(bottom, previousBottom);
+    }
+  }
+
+  if (!report(60))
+    return false;
+
+  /* CHANNELS */
+
+  // Channel c is on the left of column c, the last one is on the right of the last column
+  struct Entry {
+    uint32_t net;
+    int32_t  channel;
+    int32_t  yMin;
+    int32_t  yMax;
+    uint32_t track;
+  };
+
+  std::vector<Entry>    entries{};
+  std::vector<uint32_t> firstEntry(netCount + 1, 0);
+  std::vector<int32_t>  lane(netCount, 0);
+  int32_t               laneCount = 0;
+
+  std::vector<int32_t> backLayers{};
+
+  for (uint32_t net = 0; net < netCount; net++) {
+    firstEntry[net] = static_cast<uint32_t>(entries.size());
+
+    if (driver[net] == NONE || sinks.of(net).empty())
+      continue;
+
+    const auto from = layer[driver[net]];
+
+    backLayers.clear();
+    for (const auto s : sinks.of(net))
+      if (layer[sinkList[s].first] <= from)
+        backLayers.push_back(layer[sinkList[s].first]);
+
+    std::ranges::sort(backLayers);
+    const auto [last, end] = std::ranges::unique(backLayers);
+    backLayers.erase(last, end);
+
+    if (!backLayers.empty())
+      lane[net] = bottom + (2 + laneCount++) * g;
+
+    const auto addEntry = [&](const int32_t channel, const int32_t y) {
+      if (entries.size() == firstEntry[net] || entries.back().channel != channel)
+        entries.push_back({net, channel, y, y, 0});
+
+      auto& e = entries.back();
+      e.yMin  = std::min(e.yMin, y);
+      e.yMax  = std::max(e.yMax, y);
+    };
+
+    // Back sinks: up from the lane, in the channel on their left
+    for (const auto l : backLayers) {
+      addEntry(l, lane[net]);
+      for (const auto s : sinks.of(net)) {
+        const auto [c, port] = sinkList[s];
+        if (layer[c] == l)
+          addEntry(l, positionY(c) + fp[c]->inputs[port].y);
+      }
+    }
+
+    // Forward part, the driver channel also goes down to the lane
+    const auto lastLayer = std::max(lastForwardLayer[net], from + 1);
+
+    for (int32_t l = from; l < lastLayer; l++) {
+      addEntry(l + 1, rowOf(net, l));
+
+      if (l == from && !backLayers.empty())
+        addEntry(l + 1, lane[net]);
+
+      if (l + 1 < lastForwardLayer[net])
+        addEntry(l + 1, top[dummyOf(net, l + 1)]);
+
+      for (const auto s : sinks.of(net)) {
+        const auto [c, port] = sinkList[s];
+        if (layer[c] == l + 1)
+          addEntry(l + 1, positionY(c) + fp[c]->inputs[port].y);
+      }
+    }
+  }
+  firstEntry[netCount] = static_cast<uint32_t>(entries.size());
+
+  // Left-edge track assignment: two nets share a track if their rows don't overlap
+  const int32_t         channelCount = layerCount + 1;
+  std::vector<uint32_t> trackCount(channelCount, 0);
+
+  std::vector<uint32_t> byChannel(entries.size());
+  std::iota(byChannel.begin(), byChannel.end(), 0);
+  std::ranges::sort(byChannel, [&](uint32_t a, uint32_t b) {
+    return std::pair(entries[a].channel, entries[a].yMin)
+           < std::pair(entries[b].channel, entries[b].yMin);
+  });
+
+  using Track = std::pair<int32_t, uint32_t>;  // (last row used, track)
+  std::priority_queue<Track, std::vector<Track>, std::greater<>> tracks{};
+
+  for (size_t i = 0; i < byChannel.size(); i++) {
+    auto& e = entries[byChannel[i]];
+
+    if (i == 0 || entries[byChannel[i - 1]].channel != e.channel)
+      tracks = {};
+
+    if (!tracks.empty() && tracks.top().first < e.yMin) {
+      e.track = tracks.top().second;
+      tracks.pop();
+    } else {
+      e.track = trackCount[e.channel]++;
+    }
+
+    tracks.emplace(e.yMax, e.track);
+  }
+
+  if (!report(75))
+    return false;
+
+  /* COLUMNS */
+
+  std::vector<int32_t> channelX(channelCount);
+  std::vector<int32_t> columnX(layerCount);
+
+  int32_t x = 0;
+  for (int32_t l = 0; l < layerCount; l++) {
+    channelX[l] = x;
+    x += static_cast<int32_t>(trackCount[l] + 1) * g;
+
+    int32_t width = 0;
+    for (const auto n : columns[l])
+      if (n < componentCount)
+        width = std::max(width, fp[n]->right - fp[n]->left);
+
+    columnX[l] = x;
+    x += width;
+  }
+  channelX[layerCount] = x;
+
+  const auto positionX = [&](const uint32_t c) {
+    return columnX[layer[c]] - fp[c]->left;
+  };
+  const auto trackX    = [&](const Entry& e) {
+    return channelX[e.channel] + static_cast<int32_t>(e.track + 1) * g;
+  };
+
+  /* GEOMETRY */
+
+  doc.placements.clear();
+  doc.segments.clear();
+  doc.points.clear();
+
+  for (uint32_t c = 0; c < componentCount; c++)
+    doc.setPlacement(c, {positionX(c), positionY(c), 0, 0});
+
+  const auto addLine = [&doc](const uint32_t net, const Point a, const Point b) {
+    if (a != b)
+      doc.addSegment(net, std::array{a, b});
+  };
+
+  for (uint32_t net = 0; net < netCount; net++) {
+    const auto netEntries = std::span(entries).subspan(
+        firstEntry[net], firstEntry[net + 1] - firstEntry[net]);
+
+    if (netEntries.empty())
+      continue;
+
+    const auto d    = driver[net];
+    const auto from = layer[d];
+
+    const Entry* driverEntry = nullptr;
+    const Entry* leftmost    = nullptr;
+
+    for (const auto& e : netEntries) {
+      const auto xt = trackX(e);
+      addLine(net, {xt, e.yMin}, {xt, e.yMax});
+
+      const int32_t l = e.channel;  // The column on the right of the channel
+
+      if (l == from + 1) {
+        driverEntry = &e;
+        const auto p = fp[d]->outputs[driverPort[net]];
+        addLine(net, {positionX(d) + p.x, positionY(d) + p.y}, {xt, rowOf(net, from)});
+      } else if (l > from + 1) {
+        // Row crossing the previous column
+        const auto y = top[dummyOf(net, l - 1)];
+        addLine(net, {trackX(*(&e - 1)), y}, {xt, y});
+      } else if (!leftmost) {
+        leftmost = &e;
+      }
+
+      for (const auto s : sinks.of(net)) {
+        const auto [c, port] = sinkList[s];
+        if (layer[c] != l)
+          continue;
+
+        const auto p = fp[c]->inputs[port];
+        addLine(net, {xt, positionY(c) + p.y}, {positionX(c) + p.x, positionY(c) + p.y});
+      }
+    }
+
+    if (leftmost && driverEntry)
+      addLine(net, {trackX(*leftmost), lane[net]}, {trackX(*driverEntry), lane[net]});
+  }
+
+  return report(100);
+}
+
+CircuitDocument CircuitLayout::fromNetlist(const Netlist& netlist)
+{
+  CircuitDocument doc{};
+
+  const auto netCount = netlist.getNetCount();
+
+  // Buffers are removed by merging their output with their input
+  std::vector<NetId> alias(netCount);
+  std::iota(alias.begin(), alias.end(), 0);
+
+  const auto find = [&alias](NetId n) {
+    while (alias[n] != n)
+      n = alias[n] = alias[alias[n]];
+    return n;
+  };
+
+  const auto isBuffer = [&netlist](const GateId g) {
+    const auto type = netlist.getGateType(g);
+    return netlist.getGateInputs(g).size() == 1
+           && (type == GateType::BUF || type == GateType::AND || type == GateType::OR
+               || type == GateType::XOR);
+  };
+
+  for (GateId g = 0; g < netlist.getGateCount(); g++)
+    if (isBuffer(g))
+      alias[find(netlist.getGateOutput(g))] = find(netlist.getGateInputs(g)[0]);
+
+  std::vector<uint32_t> docNets(netCount, CircuitDocument::NO_NET);
+
+  const auto net = [&](const NetId n) {
+    const auto r = find(n);
+    if (docNets[r] == CircuitDocument::NO_NET)
+      docNets[r] = doc.addNet(1, netlist.getNetName(r));
+    return docNets[r];
+  };
+
+  const auto add = [&doc](const std::string_view type, const std::string_view name,
+                          const std::vector<uint32_t>& inputs, const uint32_t output) {
+    if (output == CircuitDocument::NO_NET)
+      doc.addComponent(type, name, 0, inputs, {});
+    else
+      doc.addComponent(type, name, 0, inputs, std::array{output});
+  };
+
+  for (const NetId input : netlist.getPrimaryInputs())
+    add("SINGLE_INPUT", netlist.getNetName(input), {}, net(input));
+
+  std::vector<uint32_t> level{};
+  std::vector<uint32_t> next{};
+
+  for (GateId g = 0; g < netlist.getGateCount(); g++) {
+    if (isBuffer(g))
+      continue;
+
+    const auto type   = netlist.getGateType(g);
+    const auto output = net(netlist.getGateOutput(g));
+
+    level.clear();
+    for (const NetId input : netlist.getGateInputs(g))
+      level.push_back(net(input));
+
+    switch (type) {
+      case GateType::CONST0: add("SINGLE_INPUT", "0", {}, output); continue;
+      case GateType::CONST1: add("SINGLE_INPUT", "1", {}, output); continue;
+      case GateType::DFF: add("DFF", "Dff", level, output); continue;
+      case GateType::BUF: continue;
+      default: break;
+    }
+
+    if (level.size() == 1) {
+      // Single input NAND, NOR and XNOR
+      add("NOT_GATE", "Not", level, output);
+      continue;
+    }
+
+    // Balanced tree of two-input gates, the root has the type of the gate
+    const bool isAnd = type == GateType::AND || type == GateType::NAND;
+    const bool isOr  = type == GateType::OR || type == GateType::NOR;
+
+    const auto [treeType, treeName] = isAnd  ? std::pair("AND_GATE", "And")
+                                      : isOr ? std::pair("OR_GATE", "Or")
+                                             : std::pair("XOR_GATE", "Xor");
+
+    while (level.size() > 2) {
+      next.clear();
+      for (size_t i = 0; i + 1 < level.size(); i += 2) {
+        const auto o = doc.addNet(1);
+        add(treeType, treeName, {level[i], level[i + 1]}, o);
+        next.push_back(o);
+      }
+      if (level.size() % 2 == 1)
+        next.push_back(level.back());
+      std::swap(level, next);
+    }
+
+    switch (type) {
+      case GateType::NAND: add("NAND_GATE", "Nand", level, output); break;
+      case GateType::NOR: add("NOR_GATE", "Nor", level, output); break;
+      case GateType::XNOR: {
+        const auto o = doc.addNet(1);
+        add("XOR_GATE", "Xor", level, o);
+        add("NOT_GATE", "Not", {o}, output);
+        break;
+      }
+      default: add(treeType, treeName, level, output); break;
+    }
+  }
+
+  for (const NetId output : netlist.getPrimaryOutputs())
+    add("SINGLE_OUTPUT", netlist.getNetName(output), {net(output)},
+        CircuitDocument::NO_NET);
+
+  return doc;
+}
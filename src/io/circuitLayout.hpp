@@ -0,0 +1,78 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <functional>
+#include <string_view>
+#include <vector>
+
+#include <core/netlist.hpp>
+#include <io/circuitFile.hpp>
+
+/* Automatic schematic generation for circuits without a geometry.
+ *
+ * The placement is layered (Sugiyama): feedback edges are ignored, components are
+ * assigned to columns by longest path, the order inside each column is chosen with the
+ * barycenter heuristic and the rows are packed top to bottom. Nets crossing more than a
+ * column get a row of their own in every column they cross.
+ *
+ * The routing is orthogonal and aligned to the grid: every net gets a vertical track in
+ * the channel between two columns, and tracks are shared by nets whose rows don't
+ * overlap. Feedback nets run below the whole circuit.
+ *
+ * Nothing here depends on the UI, so the layout can run on a worker thread. */
+
+class CircuitLayout {
+public:
+  // The shape of a component, relative to its position: ports included
+  struct Footprint {
+    int32_t left   = 0;
+    int32_t top    = 0;
+    int32_t right  = 0;
+    int32_t bottom = 0;
+
+    std::vector<CircuitDocument::PointRecord> inputs{};
+    std::vector<CircuitDocument::PointRecord> outputs{};
+  };
+
+  struct Options {
+    int32_t grid = 10;
+
+    // Space between two components of the same column, in grid units
+    int32_t rowSpacing = 2;
+
+    int orderingSweeps = 4;
+  };
+
+  using FootprintProvider =
+      std::function<Footprint(std::string_view type, uint32_t variant)>;
+
+  // Called with a percentage, the layout stops when it returns false
+  using ProgressCallback = std::function<bool(int)>;
+
+  // Replaces the geometry of `doc`. Returns false if it was cancelled.
+  static bool layout(CircuitDocument& doc, const FootprintProvider& footprintOf,
+                     const ProgressCallback& progress, const Options& options);
+  static bool layout(CircuitDocument& doc, const FootprintProvider& footprintOf,
+                     const ProgressCallback& progress = {});
+
+  // Builds a document from an imported netlist, using only the components available in
+  // LogiFlow: wide gates become trees of two-input gates and buffers are removed.
+  // Registers are kept as DFF components, unknown to LogiFlow.
+  static CircuitDocument fromNetlist(const Netlist& netlist);
+};
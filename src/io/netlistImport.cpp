@@ -0,0 +1,1274 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "netlistImport.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <unordered_map>
+
+namespace {
+
+std::unexpected<std::string> error(const size_t line, const std::string_view message)
+{
+  return std::unexpected("line " + std::to_string(line) + ": " + std::string(message));
+}
+
+bool isSpace(const char c)
+{
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\f' || c == '\v';
+}
+
+/* BLIF */
+
+class BlifReader {
+public:
+  explicit BlifReader(std::istream& in) : in(in) {}
+
+  NetlistImporter::Result read();
+
+private:
+  // Reads the next non-empty line, joining the continued ones and removing the comments
+  bool nextLine();
+  void split();
+
+  void addCover();
+
+  std::istream& in;
+  Netlist       netlist{};
+
+  std::string                   line{};
+  std::string                   physicalLine{};
+  std::vector<std::string_view> tokens{};
+  size_t                        lineNumber = 0;
+  size_t                        nextLineNumber = 0;
+
+  // The .names being read: its cubes are stored one after the other in `cubes`
+  bool               inCover = false;
+  std::vector<NetId> coverInputs{};
+  NetId              coverOutput = Netlist::NO_NET;
+  std::string        cubes{};
+  size_t             cubeCount = 0;
+  char               outputValue = '1';
+};
+
+bool BlifReader::nextLine()
+{
+  line.clear();
+
+  while (std::getline(in, physicalLine)) {
+    nextLineNumber++;
+
+    if (const auto comment = physicalLine.find('#'); comment != std::string::npos)
+      physicalLine.resize(comment);
+
+    if (line.empty())
+      lineNumber = nextLineNumber;
+
+    const bool continued = physicalLine.ends_with('\\');
+    if (continued)
+      physicalLine.pop_back();
+
+    line += physicalLine;
+    line += ' ';
+
+    if (continued)
+      continue;
+
+    if (std::ranges::any_of(line, [](char c) { return !isSpace(c); }))
+      return true;
+
+    line.clear();
+  }
+
+  return std::ranges::any_of(line, [](char c) { return !isSpace(c); });
+}
+
+void BlifReader::split()
+{
+  tokens.clear();
+
+  const std::string_view view = line;
+  size_t                 pos  = 0;
+
+  while (true) {
+    while (pos < view.size() && isSpace(view[pos]))
+      pos++;
+    if (pos >= view.size())
+      return;
+
+    const auto start = pos;
+    while (pos < view.size() && !isSpace(view[pos]))
+      pos++;
+
+    tokens.push_back(view.substr(start, pos - start));
+  }
+}
+
+void BlifReader::addCover()
+{
+  inCover = false;
+
+  const auto n   = coverInputs.size();
+  const bool on  = outputValue == '1';
+  const auto out = coverOutput;
+
+  const auto cube = [this, n](const size_t i) {
+    return std::string_view(cubes).substr(i * n, n);
+  };
+
+  // Empty on-set: constant 0
+  if (cubeCount == 0) {
+    netlist.addGate(GateType::CONST0, {}, out);
+    return;
+  }
+
+  // A cube without literals covers everything
+  for (size_t i = 0; i < cubeCount; i++) {
+    if (std::ranges::all_of(cube(i), [](char c) { return c == '-'; })) {
+      netlist.addGate(on ? GateType::CONST1 : GateType::CONST0, {}, out);
+      return;
+    }
+  }
+
+  if (n == 2 && cubeCount == 2) {
+    auto a = cube(0), b = cube(1);
+    if (b < a)
+      std::swap(a, b);
+
+    const bool isXor  = a == "01" && b == "10";
+    const bool isXnor = a == "00" && b == "11";
+
+    if (isXor || isXnor) {
+      netlist.addGate(isXor == on ? GateType::XOR : GateType::XNOR, coverInputs, out);
+      return;
+    }
+  }
+
+  // Sum of products: the complemented literals share the same NOT gate
+  std::vector<NetId> inverted(n, Netlist::NO_NET);
+  std::vector<NetId> literals{};
+  std::vector<NetId> terms{};
+
+  const auto literal = [&](const size_t input, const char value) {
+    if (value == '1')
+      return coverInputs[input];
+
+    if (inverted[input] == Netlist::NO_NET) {
+      inverted[input] = netlist.addNet();
+      netlist.addGate(GateType::NOT, std::array{coverInputs[input]}, inverted[input]);
+    }
+    return inverted[input];
+  };
+
+  if (cubeCount == 1) {
+    const auto c = cube(0);
+
+    if (std::ranges::count(c, '-') == static_cast<long>(n) - 1) {
+      const auto i        = c.find_first_not_of('-');
+      const bool positive = (c[i] == '1') == on;
+      netlist.addGate(positive ? GateType::BUF : GateType::NOT,
+                      std::array{coverInputs[i]}, out);
+      return;
+    }
+
+    for (size_t i = 0; i < n; i++)
+      if (c[i] != '-')
+        literals.push_back(literal(i, c[i]));
+
+    netlist.addGate(on ? GateType::AND : GateType::NAND, literals, out);
+    return;
+  }
+
+  for (size_t k = 0; k < cubeCount; k++) {
+    const auto c = cube(k);
+
+    literals.clear();
+    for (size_t i = 0; i < n; i++)
+      if (c[i] != '-')
+        literals.push_back(literal(i, c[i]));
+
+    if (literals.size() == 1) {
+      terms.push_back(literals[0]);
+      continue;
+    }
+
+    const auto term = netlist.addNet();
+    netlist.addGate(GateType::AND, literals, term);
+    terms.push_back(term);
+  }
+
+  netlist.addGate(on ? GateType::OR : GateType::NOR, terms, out);
+}
+
+NetlistImporter::Result BlifReader::read()
+{
+  bool modelRead = false;
+
+  while (nextLine()) {
+    split();
+
+    const auto directive = tokens[0];
+
+    if (!directive.starts_with('.')) {
+      if (!inCover)
+        return error(lineNumber, "Unexpected line outside of a .names cover");
+
+      const auto n = coverInputs.size();
+
+      // Cube (only with inputs) followed by the output value
+      if (tokens.size() != (n == 0 ? 1 : 2))
+        return error(lineNumber, "Malformed cover row");
+
+      const auto plane = n == 0 ? std::string_view{} : tokens[0];
+      const auto value = tokens.back();
+
+      const auto isLiteral = [](char c) { return c == '0' || c == '1' || c == '-'; };
+
+      if (plane.size() != n || !std::ranges::all_of(plane, isLiteral))
+        return error(lineNumber, "Malformed cover row");
+
+      if (value != "0" && value != "1")
+        return error(lineNumber, "Malformed cover row");
+
+      if (cubeCount > 0 && value[0] != outputValue)
+        return error(lineNumber, "A cover can't mix its on-set and its off-set");
+
+      outputValue = value[0];
+      cubes += plane;
+      cubeCount++;
+      continue;
+    }
+
+    if (inCover)
+      addCover();
+
+    if (directive == ".model") {
+      if (modelRead)
+        return error(lineNumber, "Only one model per file is supported");
+      modelRead = true;
+
+    } else if (directive == ".inputs") {
+      for (const auto name : tokens | std::views::drop(1)) {
+        const auto net = netlist.getOrAddNet(name);
+        netlist.addPrimaryInput(net);
+        netlist.setInitialState(net, State::LOW);
+      }
+
+    } else if (directive == ".outputs") {
+      for (const auto name : tokens | std::views::drop(1))
+        netlist.addPrimaryOutput(netlist.getOrAddNet(name));
+
+    } else if (directive == ".names") {
+      if (tokens.size() < 2)
+        return error(lineNumber, ".names without output");
+
+      coverInputs.clear();
+      for (const auto name : std::span(tokens).subspan(1, tokens.size() - 2))
+        coverInputs.push_back(netlist.getOrAddNet(name));
+
+      coverOutput = netlist.getOrAddNet(tokens.back());
+      cubes.clear();
+      cubeCount   = 0;
+      outputValue = '1';
+      inCover     = true;
+
+    } else if (directive == ".latch") {
+      // .latch <input> <output> [<type> <control>] [<init>]
+      if (tokens.size() < 3 || tokens.size() > 6)
+        return error(lineNumber, "Malformed .latch");
+
+      const auto input  = netlist.getOrAddNet(tokens[1]);
+      const auto output = netlist.getOrAddNet(tokens[2]);
+
+      State init = State::ERROR;  // 2 (don't care) and 3 (unknown)
+      if (tokens.size() == 4 || tokens.size() == 6) {
+        if (tokens.back() == "0")
+          init = State::LOW;
+        else if (tokens.back() == "1")
+          init = State::HIGH;
+      }
+
+      netlist.addGate(GateType::DFF, std::array{input}, output);
+      netlist.setInitialState(output, init);
+
+    } else if (directive == ".end") {
+      break;
+
+    } else if (directive == ".subckt" || directive == ".gate" || directive == ".mlatch"
+               || directive == ".search") {
+      return error(lineNumber, std::string(directive) + " is not supported");
+    }
+
+    // Other directives (timing, attributes...) don't affect the logic
+  }
+
+  if (inCover)
+    addCover();
+
+  if (auto res = netlist.finalize(); !res)
+    return std::unexpected(res.error());
+
+  return std::move(netlist);
+}
+
+/* VERILOG */
+
+class VerilogLexer {
+public:
+  enum class Kind {
+    END,
+    IDENTIFIER,
+    NUMBER,
+    SYMBOL,
+  };
+
+  explicit VerilogLexer(std::istream& in) : buffer(*in.rdbuf()) { advance(); }
+
+  [[nodiscard]] Kind               kind() const { return currentKind; }
+  [[nodiscard]] const std::string& text() const { return currentText; }
+  [[nodiscard]] size_t             line() const { return currentLine; }
+
+  [[nodiscard]] bool is(const std::string_view token) const
+  {
+    return currentKind != Kind::END && currentText == token;
+  }
+
+  bool accept(const std::string_view token)
+  {
+    if (!is(token))
+      return false;
+    advance();
+    return true;
+  }
+
+  void advance();
+
+private:
+  int peek() { return buffer.sgetc(); }
+  int get()
+  {
+    const int c = buffer.sbumpc();
+    if (c == '\n')
+      lineNumber++;
+    return c;
+  }
+
+  void skipBlank();
+
+  std::streambuf& buffer;
+  size_t          lineNumber = 1;
+
+  Kind        currentKind = Kind::END;
+  std::string currentText{};
+  size_t      currentLine = 1;
+};
+
+void VerilogLexer::skipBlank()
+{
+  constexpr int eof = std::char_traits<char>::eof();
+
+  while (true) {
+    int c = peek();
+
+    if (c != eof && isSpace(static_cast<char>(c))) {
+      get();
+      continue;
+    }
+
+    // Compiler directives (`timescale...) are ignored
+    if (c == '`') {
+      while (c != eof && c != '\n')
+        c = get();
+      continue;
+    }
+
+    if (c == '/') {
+      get();
+      c = peek();
+
+      if (c == '/') {
+        while (c != eof && c != '\n')
+          c = get();
+        continue;
+      }
+
+      if (c == '*') {
+        get();
+        int previous = 0;
+        while ((c = get()) != eof && !(previous == '*' && c == '/'))
+          previous = c;
+        continue;
+      }
+
+      buffer.sungetc();
+      return;
+    }
+
+    // Attributes: (* ... *)
+    if (c == '(') {
+      get();
+      if (peek() != '*') {
+        buffer.sungetc();
+        return;
+      }
+
+      get();
+      int previous = 0;
+      while ((c = get()) != eof && !(previous == '*' && c == ')'))
+        previous = c;
+      continue;
+    }
+
+    return;
+  }
+}
+
+void VerilogLexer::advance()
+{
+  constexpr int eof = std::char_traits<char>::eof();
+
+  skipBlank();
+
+  currentText.clear();
+  currentLine = lineNumber;
+
+  const int c = peek();
+
+  if (c == eof) {
+    currentKind = Kind::END;
+    return;
+  }
+
+  const auto isIdentifierChar = [](const int ch) {
+    return std::isalnum(ch) || ch == '_' || ch == '$';
+  };
+
+  // Escaped identifiers end at the first blank
+  if (c == '\\') {
+    get();
+    while (peek() != eof && !isSpace(static_cast<char>(peek())))
+      currentText += static_cast<char>(get());
+    currentKind = Kind::IDENTIFIER;
+    return;
+  }
+
+  if (std::isalpha(c) || c == '_' || c == '$') {
+    while (isIdentifierChar(peek()))
+      currentText += static_cast<char>(get());
+    currentKind = Kind::IDENTIFIER;
+    return;
+  }
+
+  // Numbers: 12, 4'b1010, 'h3f, 1'bx
+  if (std::isdigit(c) || c == '\'') {
+    while (std::isdigit(peek()) || peek() == '_')
+      currentText += static_cast<char>(get());
+
+    skipBlank();
+    if (peek() == '\'') {
+      currentText += static_cast<char>(get());
+      if (peek() == 's' || peek() == 'S')
+        get();
+      if (std::isalpha(peek()))
+        currentText += static_cast<char>(std::tolower(get()));
+      skipBlank();
+      while (std::isalnum(peek()) || peek() == '_' || peek() == '?')
+        currentText += static_cast<char>(std::tolower(get()));
+    }
+
+    currentKind = Kind::NUMBER;
+    return;
+  }
+
+  currentText += static_cast<char>(get());
+  currentKind = Kind::SYMBOL;
+}
+
+class VerilogReader {
+public:
+  explicit VerilogReader(std::istream& in) : lexer(in) {}
+
+  NetlistImporter::Result read();
+
+private:
+  // Bits of a signal or of an expression, the least significant first
+  using Bits = std::vector<NetId>;
+
+  // Vectors and numbers wider than this are rejected instead of allocating their bits
+  static constexpr size_t MAX_WIDTH = size_t{1} << 20;
+
+  struct Range {
+    int msb;
+    int lsb;
+
+    [[nodiscard]] size_t width() const
+    {
+      return static_cast<size_t>(std::abs(int64_t{msb} - lsb)) + 1;
+    }
+
+    // The i-th bit from the least significant one, between lsb and msb so that it can't
+    // overflow
+    [[nodiscard]] int bit(const size_t i) const
+    {
+      const auto offset = static_cast<int>(i);
+      return msb >= lsb ? lsb + offset : lsb - offset;
+    }
+  };
+
+  bool fail(std::string_view message);
+  bool expect(std::string_view token);
+
+  bool parseModule();
+  bool parsePortList();
+  bool parseDeclaration(bool isInput, bool isOutput);
+  bool parseAssign();
+  bool parseInstance();
+  bool skipStatement();
+
+  std::optional<Range> parseRange();
+  bool                 checkWidth(size_t width);
+  std::optional<int>   parseInteger();
+  std::optional<Bits>  parseExpression();
+  std::optional<Bits>  parseOr();
+  std::optional<Bits>  parseXor();
+  std::optional<Bits>  parseAnd();
+  std::optional<Bits>  parseUnary();
+  std::optional<Bits>  parsePrimary();
+  std::optional<Bits>  parseNumber(const std::string& text);
+  std::optional<Bits>  parseReference(const std::string& name);
+
+  Bits  bitwise(GateType type, const Bits& a, const Bits& b);
+  NetId constant(bool value);
+  NetId gate(GateType type, std::span<const NetId> inputs);
+
+  VerilogLexer lexer;
+  Netlist      netlist{};
+  std::string  errorMessage{};
+
+  std::unordered_map<std::string, Range> vectors{};
+  std::array<NetId, 2>                   constants = {Netlist::NO_NET, Netlist::NO_NET};
+
+  // Reused by the bit names
+  std::string name{};
+};
+
+bool VerilogReader::fail(const std::string_view message)
+{
+  if (errorMessage.empty())
+    errorMessage = "line " + std::to_string(lexer.line()) + ": " + std::string(message);
+  return false;
+}
+
+bool VerilogReader::expect(const std::string_view token)
+{
+  if (lexer.accept(token))
+    return true;
+
+  return fail("Expected '" + std::string(token) + "', found '" + lexer.text() + "'");
+}
+
+NetId VerilogReader::constant(const bool value)
+{
+  auto& net = constants[value];
+
+  if (net == Netlist::NO_NET) {
+    net = netlist.addNet();
+    netlist.addGate(value ? GateType::CONST1 : GateType::CONST0, {}, net);
+  }
+
+  return net;
+}
+
+NetId VerilogReader::gate(const GateType type, const std::span<const NetId> inputs)
+{
+  const auto output = netlist.addNet();
+  netlist.addGate(type, inputs, output);
+  return output;
+}
+
+VerilogReader::Bits VerilogReader::bitwise(const GateType type, const Bits& a,
+                                           const Bits& b)
+{
+  Bits res(std::max(a.size(), b.size()));
+
+  for (size_t i = 0; i < res.size(); i++) {
+    const auto x = i < a.size() ? a[i] : constant(false);
+    const auto y = i < b.size() ? b[i] : constant(false);
+    res[i]       = gate(type, std::array{x, y});
+  }
+
+  return res;
+}
+
+std::optional<int> VerilogReader::parseInteger()
+{
+  int value = 0;
+
+  const auto& text = lexer.text();
+  const auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+
+  if (lexer.kind() != VerilogLexer::Kind::NUMBER || ec != std::errc{}
+      || ptr != text.data() + text.size()) {
+    fail("Expected an integer, found '" + text + "'");
+    return std::nullopt;
+  }
+
+  lexer.advance();
+  return value;
+}
+
+std::optional<VerilogReader::Range> VerilogReader::parseRange()
+{
+  // The opening bracket has already been read
+  const auto msb = parseInteger();
+  if (!msb || !expect(":"))
+    return std::nullopt;
+
+  const auto lsb = parseInteger();
+  if (!lsb || !expect("]"))
+    return std::nullopt;
+
+  const Range range{*msb, *lsb};
+  if (!checkWidth(range.width()))
+    return std::nullopt;
+
+  return range;
+}
+
+bool VerilogReader::checkWidth(const size_t width)
+{
+  if (width <= MAX_WIDTH)
+    return true;
+
+  return fail("Width of " + std::to_string(width) + " bits is larger than the maximum of "
+              + std::to_string(MAX_WIDTH));
+}
+
+std::optional<VerilogReader::Bits> VerilogReader::parseNumber(const std::string& text)
+{
+  const auto quote = text.find('\'');
+
+  // Plain decimal numbers are 32 bits wide
+  if (quote == std::string::npos) {
+    uint64_t value = 0;
+    std::from_chars(text.data(), text.data() + text.size(), value);
+
+    Bits bits(32);
+    for (size_t i = 0; i < bits.size(); i++)
+      bits[i] = constant((value >> i) & 1);
+    return bits;
+  }
+
+  size_t width = 32;
+  if (quote > 0) {
+    const auto [ptr, ec] = std::from_chars(text.data(), text.data() + quote, width);
+    if (ec != std::errc{} || ptr != text.data() + quote) {
+      fail("Malformed number '" + text + "'");
+      return std::nullopt;
+    }
+  }
+
+  if (!checkWidth(width))
+    return std::nullopt;
+
+  if (quote + 1 >= text.size()) {
+    fail("Malformed number '" + text + "'");
+    return std::nullopt;
+  }
+
+  const char base   = text[quote + 1];
+  auto       digits = std::string_view(text).substr(quote + 2);
+
+  int bitsPerDigit = 0;
+  switch (base) {
+    case 'b': bitsPerDigit = 1; break;
+    case 'o': bitsPerDigit = 3; break;
+    case 'h': bitsPerDigit = 4; break;
+    case 'd': bitsPerDigit = 0; break;
+    default: fail("Malformed number '" + text + "'"); return std::nullopt;
+  }
+
+  Bits bits{};
+
+  if (bitsPerDigit == 0) {
+    uint64_t value = 0;
+    std::from_chars(digits.data(), digits.data() + digits.size(), value);
+    for (size_t i = 0; i < width; i++)
+      bits.push_back(constant(i < 64 && ((value >> i) & 1)));
+    return bits;
+  }
+
+  // Unknown and floating bits are left undriven: they stay in the ERROR state
+  NetId unknown = Netlist::NO_NET;
+
+  for (auto it = digits.rbegin(); it != digits.rend(); ++it) {
+    const char c = *it;
+    if (c == '_')
+      continue;
+
+    if (c == 'x' || c == 'z' || c == '?') {
+      if (unknown == Netlist::NO_NET)
+        unknown = netlist.addNet();
+      bits.insert(bits.end(), bitsPerDigit, unknown);
+      continue;
+    }
+
+    int digit = 0;
+    std::from_chars(&c, &c + 1, digit, 16);
+    if (digit >= (1 << bitsPerDigit)) {
+      fail("Malformed number '" + text + "'");
+      return std::nullopt;
+    }
+
+    for (int i = 0; i < bitsPerDigit; i++)
+      bits.push_back(constant((digit >> i) & 1));
+  }
+
+  bits.resize(width, constant(false));
+  return bits;
+}
+
+std::optional<VerilogReader::Bits> VerilogReader::parseReference(const std::string& id)
+{
+  const auto vector = vectors.find(id);
+
+  const auto bitNet = [&](const int index) {
+    name = id;
+    name += '[';
+    name += std::to_string(index);
+    name += ']';
+    return netlist.getOrAddNet(name);
+  };
+
+  if (!lexer.accept("[")) {
+    if (vector == vectors.end())
+      return Bits{netlist.getOrAddNet(id)};
+
+    const auto& range = vector->second;
+
+    Bits bits{};
+    for (size_t i = 0; i < range.width(); i++)
+      bits.push_back(bitNet(range.bit(i)));
+    return bits;
+  }
+
+  if (vector == vectors.end()) {
+    fail("'" + id + "' is not a vector");
+    return std::nullopt;
+  }
+
+  const auto first = parseInteger();
+  if (!first)
+    return std::nullopt;
+
+  int last = *first;
+  if (lexer.accept(":")) {
+    const auto l = parseInteger();
+    if (!l)
+      return std::nullopt;
+    last = *l;
+  }
+
+  if (!expect("]"))
+    return std::nullopt;
+
+  // [first:last] with first being the most significant bit
+  const Range range{*first, last};
+  if (!checkWidth(range.width()))
+    return std::nullopt;
+
+  Bits bits{};
+  for (size_t i = 0; i < range.width(); i++)
+    bits.push_back(bitNet(range.bit(i)));
+  return bits;
+}
+
+std::optional<VerilogReader::Bits> VerilogReader::parsePrimary()
+{
+  using Kind = VerilogLexer::Kind;
+
+  if (lexer.kind() == Kind::NUMBER) {
+    const auto text = lexer.text();
+    lexer.advance();
+    return parseNumber(text);
+  }
+
+  if (lexer.kind() == Kind::IDENTIFIER) {
+    const auto id = lexer.text();
+    lexer.advance();
+    return parseReference(id);
+  }
+
+  // Concatenation: the last element holds the least significant bits
+  if (lexer.accept("{")) {
+    std::vector<Bits> elements{};
+
+    do {
+      auto element = parseExpression();
+      if (!element)
+        return std::nullopt;
+      elements.push_back(std::move(*element));
+    } while (lexer.accept(","));
+
+    if (!expect("}"))
+      return std::nullopt;
+
+    Bits bits{};
+    for (auto& element : elements | std::views::reverse)
+      bits.insert(bits.end(), element.begin(), element.end());
+    return bits;
+  }
+
+  fail("Unexpected '" + lexer.text() + "' in expression");
+  return std::nullopt;
+}
+
+std::optional<VerilogReader::Bits> VerilogReader::parseUnary()
+{
+  if (lexer.accept("~")) {
+    auto operand = parseUnary();
+    if (!operand)
+      return std::nullopt;
+
+    for (auto& bit : *operand)
+      bit = gate(GateType::NOT, std::array{bit});
+    return operand;
+  }
+
+  if (lexer.accept("(")) {
+    auto inner = parseExpression();
+    if (!inner || !expect(")"))
+      return std::nullopt;
+    return inner;
+  }
+
+  return parsePrimary();
+}
+
+std::optional<VerilogReader::Bits> VerilogReader::parseAnd()
+{
+  auto lhs = parseUnary();
+
+  while (lhs && lexer.accept("&")) {
+    const auto rhs = parseUnary();
+    if (!rhs)
+      return std::nullopt;
+    lhs = bitwise(GateType::AND, *lhs, *rhs);
+  }
+
+  return lhs;
+}
+
+std::optional<VerilogReader::Bits> VerilogReader::parseXor()
+{
+  auto lhs = parseAnd();
+
+  while (lhs && lexer.accept("^")) {
+    const auto rhs = parseAnd();
+    if (!rhs)
+      return std::nullopt;
+    lhs = bitwise(GateType::XOR, *lhs, *rhs);
+  }
+
+  return lhs;
+}
+
+std::optional<VerilogReader::Bits> VerilogReader::parseOr()
+{
+  auto lhs = parseXor();
+
+  while (lhs && lexer.accept("|")) {
+    const auto rhs = parseXor();
+    if (!rhs)
+      return std::nullopt;
+    lhs = bitwise(GateType::OR, *lhs, *rhs);
+  }
+
+  return lhs;
+}
+
+std::optional<VerilogReader::Bits> VerilogReader::parseExpression()
+{
+  return parseOr();
+}
+
+bool VerilogReader::skipStatement()
+{
+  while (lexer.kind() != VerilogLexer::Kind::END && !lexer.is(";"))
+    lexer.advance();
+  return expect(";");
+}
+
+bool VerilogReader::parseDeclaration(const bool isInput, const bool isOutput)
+{
+  // The direction keyword has already been read
+  lexer.accept("wire");
+  lexer.accept("reg");
+  lexer.accept("signed");
+
+  std::optional<Range> range{};
+  if (lexer.accept("[")) {
+    range = parseRange();
+    if (!range)
+      return false;
+  }
+
+  do {
+    // In the port list of the module the declarations end with the direction keywords
+    if (lexer.kind() != VerilogLexer::Kind::IDENTIFIER || lexer.is("input")
+        || lexer.is("output") || lexer.is("inout"))
+      break;
+
+    const auto id = lexer.text();
+    lexer.advance();
+
+    if (range)
+      vectors[id] = *range;
+
+    Bits bits{};
+    if (range) {
+      for (size_t i = 0; i < range->width(); i++) {
+        name = id + "[" + std::to_string(range->bit(i)) + "]";
+        bits.push_back(netlist.getOrAddNet(name));
+      }
+    } else {
+      bits.push_back(netlist.getOrAddNet(id));
+    }
+
+    for (const NetId bit : bits) {
+      if (isInput) {
+        netlist.addPrimaryInput(bit);
+        netlist.setInitialState(bit, State::LOW);
+      }
+      if (isOutput)
+        netlist.addPrimaryOutput(bit);
+    }
+  } while (lexer.accept(","));
+
+  return true;
+}
+
+bool VerilogReader::parsePortList()
+{
+  if (lexer.accept(")"))
+    return true;
+
+  do {
+    if (lexer.accept("input")) {
+      if (!parseDeclaration(true, false))
+        return false;
+    } else if (lexer.accept("output")) {
+      if (!parseDeclaration(false, true))
+        return false;
+    } else if (lexer.is("inout")) {
+      return fail("inout ports are not supported");
+    } else if (lexer.kind() == VerilogLexer::Kind::IDENTIFIER) {
+      // Non-ANSI port list: the directions are declared in the body
+      lexer.advance();
+      if (!lexer.accept(","))
+        break;
+    } else {
+      return fail("Unexpected '" + lexer.text() + "' in port list");
+    }
+  } while (!lexer.is(")"));
+
+  return expect(")");
+}
+
+bool VerilogReader::parseAssign()
+{
+  do {
+    const auto lhs = parsePrimary();
+    if (!lhs || !expect("="))
+      return false;
+
+    const auto rhs = parseExpression();
+    if (!rhs)
+      return false;
+
+    for (size_t i = 0; i < lhs->size(); i++) {
+      const auto source = i < rhs->size() ? (*rhs)[i] : constant(false);
+      netlist.addGate(GateType::BUF, std::array{source}, (*lhs)[i]);
+    }
+  } while (lexer.accept(","));
+
+  return expect(";");
+}
+
+bool VerilogReader::parseInstance()
+{
+  const auto cell = lexer.text();
+  lexer.advance();
+
+  static const std::unordered_map<std::string_view, GateType> PRIMITIVES = {
+      {"and", GateType::AND}, {"nand", GateType::NAND}, {"or", GateType::OR},
+      {"nor", GateType::NOR}, {"xor", GateType::XOR},   {"xnor", GateType::XNOR},
+      {"not", GateType::NOT}, {"buf", GateType::BUF},
+  };
+
+  // Yosys internal cells, the output is always the last port
+  static const std::unordered_map<std::string_view, GateType> CELLS = {
+      {"$_BUF_", GateType::BUF},   {"$_NOT_", GateType::NOT},   {"$_AND_", GateType::AND},
+      {"$_NAND_", GateType::NAND}, {"$_OR_", GateType::OR},     {"$_NOR_", GateType::NOR},
+      {"$_XOR_", GateType::XOR},   {"$_XNOR_", GateType::XNOR},
+  };
+
+  const bool isPrimitive = PRIMITIVES.contains(cell);
+  const bool isDff       = cell == "$_DFF_P_" || cell == "$_DFF_N_";
+  const bool isCell = CELLS.contains(cell) || isDff || cell == "$_ANDNOT_"
+                      || cell == "$_ORNOT_" || cell == "$_MUX_";
+
+  if (!isPrimitive && !isCell)
+    return fail("Unknown cell '" + cell + "': only flat netlists are supported");
+
+  // Parameters and delays are ignored
+  if (lexer.accept("#")) {
+    if (lexer.accept("(")) {
+      int depth = 1;
+      while (depth > 0 && lexer.kind() != VerilogLexer::Kind::END) {
+        if (lexer.is("("))
+          depth++;
+        else if (lexer.is(")"))
+          depth--;
+        lexer.advance();
+      }
+    } else {
+      lexer.advance();
+    }
+  }
+
+  std::vector<NetId>                                ports{};
+  std::unordered_map<std::string, NetId>            namedPorts{};
+
+  do {
+    // The instance name is optional for the primitives
+    if (lexer.kind() == VerilogLexer::Kind::IDENTIFIER) {
+      lexer.advance();
+      if (lexer.accept("[") && !parseRange())
+        return false;
+    }
+
+    if (!expect("("))
+      return false;
+
+    ports.clear();
+    namedPorts.clear();
+
+    if (!lexer.is(")")) {
+      do {
+        std::string port{};
+
+        if (lexer.accept(".")) {
+          port = lexer.text();
+          lexer.advance();
+          if (!expect("("))
+            return false;
+
+          if (lexer.accept(")"))
+            continue;  // Unconnected
+        }
+
+        const auto bits = parseExpression();
+        if (!bits)
+          return false;
+        if (bits->size() != 1)
+          return fail("The ports of '" + cell + "' must be one bit wide");
+
+        if (port.empty())
+          ports.push_back((*bits)[0]);
+        else {
+          namedPorts[port] = (*bits)[0];
+          if (!expect(")"))
+            return false;
+        }
+      } while (lexer.accept(","));
+    }
+
+    if (!expect(")"))
+      return false;
+
+    if (isPrimitive) {
+      if (ports.size() < 2)
+        return fail("'" + cell + "' needs an output and at least an input");
+
+      const auto type = PRIMITIVES.at(cell);
+
+      // not and buf can drive many outputs from the last port
+      if (type == GateType::NOT || type == GateType::BUF) {
+        for (const NetId output : std::span(ports).first(ports.size() - 1))
+          netlist.addGate(type, std::array{ports.back()}, output);
+      } else {
+        netlist.addGate(type, std::span(ports).subspan(1), ports[0]);
+      }
+      continue;
+    }
+
+    const auto port = [&](const char* portName) {
+      const auto it = namedPorts.find(portName);
+      return it == namedPorts.end() ? Netlist::NO_NET : it->second;
+    };
+
+    const auto a = port("A"), b = port("B"), s = port("S"), y = port("Y");
+    const auto d = port("D"), q = port("Q");
+
+    // Clocks are ignored: every register is clocked by the simulator at the same time
+    if (isDff) {
+      if (d == Netlist::NO_NET || q == Netlist::NO_NET)
+        return fail("Unconnected port in '" + cell + "'");
+      netlist.addGate(GateType::DFF, std::array{d}, q);
+      continue;
+    }
+
+    const bool isUnary = cell == "$_BUF_" || cell == "$_NOT_";
+    if (a == Netlist::NO_NET || y == Netlist::NO_NET || (!isUnary && b == Netlist::NO_NET)
+        || (cell == "$_MUX_" && s == Netlist::NO_NET))
+      return fail("Unconnected port in '" + cell + "'");
+
+    if (cell == "$_ANDNOT_" || cell == "$_ORNOT_") {
+      const auto notB = gate(GateType::NOT, std::array{b});
+      netlist.addGate(cell == "$_ANDNOT_" ? GateType::AND : GateType::OR,
+                      std::array{a, notB}, y);
+    } else if (cell == "$_MUX_") {
+      // Y = S ? B : A
+      const auto notS = gate(GateType::NOT, std::array{s});
+      const auto lhs  = gate(GateType::AND, std::array{a, notS});
+      const auto rhs  = gate(GateType::AND, std::array{b, s});
+      netlist.addGate(GateType::OR, std::array{lhs, rhs}, y);
+    } else if (isUnary) {
+      netlist.addGate(CELLS.at(cell), std::array{a}, y);
+    } else {
+      netlist.addGate(CELLS.at(cell), std::array{a, b}, y);
+    }
+  } while (lexer.accept(","));
+
+  return expect(";");
+}
+
+bool VerilogReader::parseModule()
+{
+  if (!expect("module"))
+    return false;
+
+  if (lexer.kind() != VerilogLexer::Kind::IDENTIFIER)
+    return fail("Expected the module name");
+  lexer.advance();
+
+  if (lexer.accept("#")) {
+    if (!expect("(") || !skipStatement())
+      return false;
+    return fail("Parametric modules are not supported");
+  }
+
+  if (lexer.accept("(") && !parsePortList())
+    return false;
+
+  if (!expect(";"))
+    return false;
+
+  while (!lexer.accept("endmodule")) {
+    if (lexer.kind() == VerilogLexer::Kind::END)
+      return fail("Missing endmodule");
+
+    bool ok = true;
+
+    if (lexer.accept("input"))
+      ok = parseDeclaration(true, false) && expect(";");
+    else if (lexer.accept("output"))
+      ok = parseDeclaration(false, true) && expect(";");
+    else if (lexer.is("inout"))
+      ok = fail("inout ports are not supported");
+    else if (lexer.accept("wire") || lexer.accept("reg") || lexer.accept("tri"))
+      ok = parseDeclaration(false, false) && expect(";");
+    else if (lexer.accept("assign"))
+      ok = parseAssign();
+    else if (lexer.is("parameter") || lexer.is("localparam") || lexer.is("genvar"))
+      ok = skipStatement();
+    else if (lexer.kind() == VerilogLexer::Kind::IDENTIFIER)
+      ok = parseInstance();
+    else
+      ok = fail("Unexpected '" + lexer.text() + "'");
+
+    if (!ok)
+      return false;
+  }
+
+  return true;
+}
+
+NetlistImporter::Result VerilogReader::read()
+{
+  if (!parseModule())
+    return std::unexpected(errorMessage);
+
+  if (lexer.kind() != VerilogLexer::Kind::END)
+    return error(lexer.line(), "Only one module per file is supported");
+
+  if (auto res = netlist.finalize(); !res)
+    return std::unexpected(res.error());
+
+  return std::move(netlist);
+}
+
+}  // namespace
+
+NetlistImporter::Result NetlistImporter::readBlif(std::istream& in)
+{
+  return BlifReader(in).read();
+}
+
+NetlistImporter::Result NetlistImporter::readVerilog(std::istream& in)
+{
+  return VerilogReader(in).read();
+}
+
+NetlistImporter::Result NetlistImporter::read(std::istream& in, const Format format)
+{
+  switch (format) {
+    case Format::BLIF: return readBlif(in);
+    case Format::VERILOG: return readVerilog(in);
+  }
+  return std::unexpected("Unknown format");
+}
+
+NetlistImporter::Result NetlistImporter::load(const std::string& path)
+{
+  auto extension = std::filesystem::path(path).extension().string();
+  std::ranges::transform(extension, extension.begin(),
+                         [](unsigned char c) { return std::tolower(c); });
+
+  Format format{};
+  if (extension == ".blif")
+    format = Format::BLIF;
+  else if (extension == ".v" || extension == ".sv")
+    format = Format::VERILOG;
+  else
+    return std::unexpected("Unknown netlist format: " + extension);
+
+  std::ifstream in(path, std::ios::binary);
+  if (!in)
+    return std::unexpected("Cannot open " + path);
+
+  return read(in, format);
+}
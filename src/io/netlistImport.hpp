@@ -0,0 +1,53 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <expected>
+#include <istream>
+#include <string>
+
+#include <core/netlist.hpp>
+
+/* Import of gate-level netlists written by synthesis tools.
+ *
+ * Both parsers read the stream once, a statement at a time, and add the gates straight
+ * into a Netlist: the memory used only depends on the size of the circuit.
+ *
+ * BLIF: .model, .inputs, .outputs, .names (any single-output cover) and .latch.
+ *
+ * Verilog: a single flat module with input/output/wire declarations (vectors included),
+ * the gate primitives (and, nand, or, nor, xor, xnor, not, buf), the Yosys internal gate
+ * cells ($_AND_, $_NOT_, $_DFF_P_...) and continuous assignments of bitwise expressions.
+ * Clocks are ignored: every register is clocked by Simulator::clock(). */
+
+class NetlistImporter {
+public:
+  enum class Format {
+    BLIF,
+    VERILOG,
+  };
+
+  using Result = std::expected<Netlist, std::string>;
+
+  static Result readBlif(std::istream& in);
+  static Result readVerilog(std::istream& in);
+  static Result read(std::istream& in, Format format);
+
+  // The format is chosen from the extension (.blif, .v, .sv)
+  static Result load(const std::string& path);
+};
@@ -0,0 +1,221 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "simulationCheckpoint.hpp"
+
+#include <array>
+#include <bit>
+#include <cstring>
+#include <fstream>
+
+// Stored in little endian like the circuit files
+static_assert(std::endian::native == std::endian::little);
+
+/* BINARY LAYOUT:
+   [Header][States, padded to 8 bytes][Pending gates][Pending macros][Oscillations] */
+
+namespace {
+
+constexpr std::array<char, 4> MAGIC = {'S', 'L', 'S', 'M'};
+
+struct Header {
+  std::array<char, 4> magic;
+  uint16_t            version;
+  uint16_t            reserved;
+  uint64_t            fingerprint;
+  uint64_t            cycle;
+  uint32_t            netCount;
+  uint32_t            pendingCount;
+  uint32_t            pendingMacroCount;
+  uint32_t            oscillationCount;
+};
+
+static_assert(sizeof(Header) == 40);
+
+constexpr unsigned STATES_PER_BYTE = 4;
+
+size_t packedSize(const size_t states)
+{
+  return (states + STATES_PER_BYTE * 8 - 1) / (STATES_PER_BYTE * 8) * 8;
+}
+
+void write(std::vector<std::byte>& out, const std::span<const uint32_t> indices)
+{
+  const auto bytes = std::as_bytes(indices);
+  out.insert(out.end(), bytes.begin(), bytes.end());
+}
+
+bool read(std::vector<uint32_t>& out, std::span<const std::byte>& data,
+          const size_t count)
+{
+  if (data.size() / sizeof(uint32_t) < count)
+    return false;
+
+  out.resize(count);
+  if (count > 0)
+    std::memcpy(out.data(), data.data(), count * sizeof(uint32_t));
+
+  data = data.subspan(count * sizeof(uint32_t));
+  return true;
+}
+
+// FNV-1a
+class Hash {
+public:
+  void add(const uint64_t value)
+  {
+    for (int i = 0; i < 8; i++) {
+      hash ^= (value >> (i * 8)) & 0xFF;
+      hash *= 0x100000001B3;
+    }
+  }
+
+  [[nodiscard]] uint64_t get() const { return hash; }
+
+private:
+  uint64_t hash = 0xCBF29CE484222325;
+};
+
+}  // namespace
+
+uint64_t SimulationCheckpoint::fingerprint(const Netlist& netlist)
+{
+  Hash h;
+  h.add(netlist.getNetCount());
+  h.add(netlist.getGateCount());
+
+  for (GateId g = 0; g < netlist.getGateCount(); g++) {
+    h.add(static_cast<uint64_t>(netlist.getGateType(g)));
+    h.add(netlist.getGateOutput(g));
+
+    const auto inputs = netlist.getGateInputs(g);
+    h.add(inputs.size());
+    for (const NetId n : inputs)
+      h.add(n);
+  }
+
+  return h.get();
+}
+
+std::vector<std::byte> SimulationCheckpoint::encode(const Simulator& sim)
+{
+  const auto snapshot = sim.save();
+
+  Header header{};
+  header.magic             = MAGIC;
+  header.version           = VERSION;
+  header.fingerprint       = fingerprint(sim.getNetlist());
+  header.cycle             = snapshot.cycle;
+  header.netCount          = snapshot.states.size();
+  header.pendingCount      = snapshot.pending.size();
+  header.pendingMacroCount = snapshot.pendingMacros.size();
+  header.oscillationCount  = snapshot.oscillations.size();
+
+  std::vector<std::byte> res(sizeof(Header) + packedSize(snapshot.states.size()));
+  std::memcpy(res.data(), &header, sizeof(Header));
+
+  const auto packed = std::span(res).subspan(sizeof(Header));
+  for (size_t i = 0; i < snapshot.states.size(); i++) {
+    const auto bits = static_cast<unsigned>(snapshot.states[i]);
+    const auto byte = i / STATES_PER_BYTE, shift = i % STATES_PER_BYTE * 2;
+    packed[byte] |= static_cast<std::byte>(bits << shift);
+  }
+
+  write(res, snapshot.pending);
+  write(res, snapshot.pendingMacros);
+  write(res, snapshot.oscillations);
+
+  return res;
+}
+
+SimulationCheckpoint::Result
+SimulationCheckpoint::decode(std::span<const std::byte> data, const Netlist& netlist)
+{
+  using Unexpected = std::unexpected<std::string>;
+
+  Header header{};
+  if (data.size() < sizeof(Header)
+      || std::memcmp(data.data(), MAGIC.data(), MAGIC.size()) != 0)
+    return Unexpected("Not a Silicon simulation checkpoint");
+
+  std::memcpy(&header, data.data(), sizeof(Header));
+  data = data.subspan(sizeof(Header));
+
+  if (header.version > VERSION)
+    return Unexpected("The checkpoint was created by a newer version of Silicon");
+
+  if (header.netCount != netlist.getNetCount()
+      || header.fingerprint != fingerprint(netlist))
+    return Unexpected("The checkpoint was saved from a different circuit");
+
+  const auto packedStates = packedSize(header.netCount);
+  if (data.size() < packedStates)
+    return Unexpected("Truncated states");
+
+  Simulator::Snapshot snapshot{};
+  snapshot.cycle = header.cycle;
+  snapshot.states.resize(header.netCount);
+
+  for (size_t i = 0; i < snapshot.states.size(); i++) {
+    const auto byte = std::to_integer<unsigned>(data[i / STATES_PER_BYTE]);
+    const auto bits = (byte >> (i % STATES_PER_BYTE * 2)) & 0b11;
+
+    if (bits > static_cast<unsigned>(State::ERROR))
+      return Unexpected("Invalid state of net " + std::to_string(i));
+
+    snapshot.states[i] = static_cast<State>(bits);
+  }
+
+  data = data.subspan(packedStates);
+
+  if (!read(snapshot.pending, data, header.pendingCount)
+      || !read(snapshot.pendingMacros, data, header.pendingMacroCount)
+      || !read(snapshot.oscillations, data, header.oscillationCount))
+    return Unexpected("Truncated schedule");
+
+  return snapshot;
+}
+
+bool SimulationCheckpoint::save(const std::string& path, const Simulator& sim)
+{
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file)
+    return false;
+
+  const auto data = encode(sim);
+  file.write(reinterpret_cast<const char*>(data.data()), data.size());
+
+  return static_cast<bool>(file);
+}
+
+SimulationCheckpoint::Result SimulationCheckpoint::load(const std::string& path,
+                                                        const Netlist&     netlist)
+{
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if (!file)
+    return std::unexpected("Unable to open " + path);
+
+  const auto             size = static_cast<size_t>(file.tellg());
+  std::vector<std::byte> data(size);
+
+  file.seekg(0);
+  if (!file.read(reinterpret_cast<char*>(data.data()), size))
+    return std::unexpected("Unable to read " + path);
+
+  return decode(data, netlist);
+}
@@ -0,0 +1,58 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <core/netlist.hpp>
+#include <core/simulator.hpp>
+
+/* Checkpoints of a Simulator on disk.
+ *
+ * A checkpoint is a Simulator::Snapshot: the state of every net (so also the contents of
+ * the DFFs), the gates and macros still scheduled, the loops that oscillated and the
+ * clock cycle. The states are packed 4 per byte, then the scheduled gates, macros and
+ * loops follow as arrays of 32 bit indices.
+ *
+ * A checkpoint can only be restored in a simulator of the netlist it was saved from,
+ * which is checked with a fingerprint of the gates. Many simulations can be started from
+ * the same decoded snapshot, e.g. after an expensive warm-up. */
+
+class SimulationCheckpoint {
+public:
+  using Result = std::expected<Simulator::Snapshot, std::string>;
+
+  static constexpr uint16_t VERSION = 1;
+
+  static std::vector<std::byte> encode(const Simulator& sim);
+
+  // Fails if the data was saved from a different netlist
+  static Result decode(std::span<const std::byte> data, const Netlist& netlist);
+
+  static bool   save(const std::string& path, const Simulator& sim);
+  static Result load(const std::string& path, const Netlist& netlist);
+
+  // The nets, the types and the connections of the gates, ignoring names
+  [[nodiscard]] static uint64_t fingerprint(const Netlist& netlist);
+};
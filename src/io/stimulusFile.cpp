@@ -0,0 +1,172 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "stimulusFile.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <fstream>
+#include <optional>
+#include <sstream>
+
+namespace {
+std::unexpected<std::string> error(const size_t line, const std::string_view message)
+{
+  return std::unexpected("line " + std::to_string(line) + ": " + std::string(message));
+}
+
+std::optional<uint64_t> parseValue(std::string_view token)
+{
+  int base = 10;
+  if (token.starts_with("0x") || token.starts_with("0X"))
+    base = 16;
+  else if (token.starts_with("0b") || token.starts_with("0B"))
+    base = 2;
+
+  if (base != 10)
+    token.remove_prefix(2);
+
+  uint64_t   value = 0;
+  const auto end   = token.data() + token.size();
+  const auto [ptr, ec] = std::from_chars(token.data(), end, value, base);
+
+  if (token.empty() || ec != std::errc{} || ptr != end)
+    return std::nullopt;
+
+  return value;
+}
+}  // namespace
+
+StimulusFile::Result StimulusFile::read(std::istream& in)
+{
+  Stimulus res{};
+  uint64_t time = 0;
+
+  std::string line{};
+  for (size_t number = 1; std::getline(in, line); number++) {
+    if (const auto comment = line.find('#'); comment != std::string::npos)
+      line.resize(comment);
+
+    std::istringstream tokens(line);
+    bool               first = true;
+    for (std::string word; tokens >> word; first = false) {
+      std::string_view token = word;
+
+      if (token.starts_with('@') || token.starts_with('+')) {
+        if (!first)
+          return error(number, "The time must be at the beginning of the line");
+
+        const auto t = parseValue(token.substr(1));
+        if (!t)
+          return error(number, "Invalid time " + word);
+
+        time = token[0] == '@' ? *t : time + *t;
+        continue;
+      }
+
+      const auto equal = token.find('=');
+      if (equal == std::string_view::npos || equal == 0)
+        return error(number, "Expected name=value instead of " + word);
+
+      std::string_view name  = token.substr(0, equal);
+      std::string_view value = token.substr(equal + 1);
+
+      // Single bit
+      std::optional<uint64_t> bit{};
+      if (name.ends_with(']')) {
+        const auto open = name.rfind('[');
+        if (open == std::string_view::npos || open == 0)
+          return error(number, "Invalid name " + std::string(name));
+
+        bit = parseValue(name.substr(open + 1, name.size() - open - 2));
+        if (!bit || *bit >= 64)
+          return error(number, "Invalid bit " + std::string(name));
+
+        name = name.substr(0, open);
+      }
+
+      const bool isError = value == "x" || value == "X";
+      const auto v       = isError ? std::optional<uint64_t>(0) : parseValue(value);
+      if (!v)
+        return error(number, "Invalid value " + std::string(value));
+
+      if (!bit) {
+        if (isError)
+          res.add({time, std::string(name), ~uint64_t{0}, 0, true});
+        else
+          res.set(time, std::string(name), *v);
+        continue;
+      }
+
+      if (*v > 1)
+        return error(number, "Invalid value of a bit " + std::string(value));
+
+      const auto state = isError ? State::ERROR : *v ? State::HIGH : State::LOW;
+      res.setBit(time, std::string(name), static_cast<unsigned>(*bit), state);
+    }
+  }
+
+  return res;
+}
+
+StimulusFile::Result StimulusFile::load(const std::string& path)
+{
+  std::ifstream in(path);
+  if (!in)
+    return std::unexpected("Cannot open " + path);
+
+  return read(in);
+}
+
+void StimulusFile::write(std::ostream& out, const Stimulus& stimulus)
+{
+  auto assignments = stimulus.getAssignments();
+  std::ranges::stable_sort(assignments, {}, &Stimulus::Assignment::time);
+
+  out << std::hex;
+  for (size_t i = 0; i < assignments.size(); i++) {
+    const auto& [time, input, mask, value, error] = assignments[i];
+
+    if (i == 0 || assignments[i - 1].time != time)
+      out << (i == 0 ? "" : "\n") << '@' << std::dec << time << std::hex;
+
+    // Whole inputs, or one bit at a time
+    if (mask == ~uint64_t{0}) {
+      out << ' ' << input << '=';
+      if (error)
+        out << 'x';
+      else
+        out << "0x" << value;
+      continue;
+    }
+
+    for (uint64_t b = mask; b != 0; b &= b - 1) {
+      const auto bit = std::countr_zero(b);
+      out << ' ' << input << '[' << std::dec << bit << std::hex << "]=";
+      if (error)
+        out << 'x';
+      else
+        out << ((value >> bit) & 1);
+    }
+  }
+
+  if (!assignments.empty())
+    out << '\n';
+  out << std::dec;
+}
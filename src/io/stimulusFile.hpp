@@ -0,0 +1,51 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <expected>
+#include <istream>
+#include <ostream>
+#include <string>
+
+#include <core/stimulus.hpp>
+
+/* Stimulus scripts.
+ *
+ *   # Counter with synchronous reset
+ *   @0   rst=1 en=0 clk=0
+ *   @10  rst=0 clk=1
+ *   +10  en=1 d=0x5 clk=0
+ *        d[3]=x
+ *
+ * Every line assigns some inputs at a time: `@t` is an absolute time, `+t` is relative to
+ * the previous line, a line without a time has the same time as the previous one. An
+ * assignment is `name=value`, or `name[bit]=value` for a single bit; values are decimal,
+ * or hexadecimal and binary with the 0x and 0b prefixes, `x` is the ERROR state.
+ * Everything after a '#' is a comment. */
+
+class StimulusFile {
+public:
+  using Result = std::expected<Stimulus, std::string>;
+
+  static Result read(std::istream& in);
+  static Result load(const std::string& path);
+
+  // Values are written in hexadecimal, one line for every time
+  static void write(std::ostream& out, const Stimulus& stimulus);
+};
@@ -0,0 +1,139 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "testVectorFile.hpp"
+
+#include <charconv>
+#include <fstream>
+#include <sstream>
+
+namespace {
+std::unexpected<std::string> error(const size_t line, const std::string_view message)
+{
+  return std::unexpected("line " + std::to_string(line) + ": " + std::string(message));
+}
+
+std::optional<uint64_t> parseValue(std::string_view token)
+{
+  int base = 10;
+  if (token.starts_with("0x") || token.starts_with("0X"))
+    base = 16;
+  else if (token.starts_with("0b") || token.starts_with("0B"))
+    base = 2;
+
+  if (base != 10)
+    token.remove_prefix(2);
+
+  uint64_t   value = 0;
+  const auto end   = token.data() + token.size();
+  const auto [ptr, ec] = std::from_chars(token.data(), end, value, base);
+
+  if (token.empty() || ec != std::errc{} || ptr != end)
+    return std::nullopt;
+
+  return value;
+}
+}  // namespace
+
+TestVectorFile::Result TestVectorFile::read(std::istream& in)
+{
+  TestVectors res{};
+
+  bool hasInputs = false, hasOutputs = false;
+
+  std::string line{};
+  for (size_t number = 1; std::getline(in, line); number++) {
+    if (const auto comment = line.find('#'); comment != std::string::npos)
+      line.resize(comment);
+
+    std::istringstream       tokens(line);
+    std::vector<std::string> words{};
+    for (std::string word; tokens >> word;)
+      words.push_back(std::move(word));
+
+    if (words.empty())
+      continue;
+
+    if (words[0] == ".inputs" || words[0] == ".outputs") {
+      const bool inputs = words[0] == ".inputs";
+      if ((inputs ? hasInputs : hasOutputs) || res.size() > 0)
+        return error(number, "Unexpected " + words[0]);
+
+      auto& names = inputs ? res.inputNames : res.outputNames;
+      names.assign(words.begin() + 1, words.end());
+      (inputs ? hasInputs : hasOutputs) = true;
+      continue;
+    }
+
+    if (!hasInputs || !hasOutputs)
+      return error(number, "Vector before the .inputs and .outputs lines");
+
+    const auto inputCount = res.inputNames.size();
+    if (words.size() != inputCount + res.outputNames.size())
+      return error(number, "Expected " + std::to_string(inputCount) + " inputs and "
+                               + std::to_string(res.outputNames.size()) + " outputs");
+
+    for (size_t i = 0; i < words.size(); i++) {
+      const auto value = parseValue(words[i]);
+      if (!value)
+        return error(number, "Invalid value " + words[i]);
+
+      (i < inputCount ? res.inputs : res.outputs).push_back(*value);
+    }
+  }
+
+  if (!hasInputs || !hasOutputs)
+    return std::unexpected("Missing .inputs or .outputs");
+
+  return res;
+}
+
+TestVectorFile::Result TestVectorFile::load(const std::string& path)
+{
+  std::ifstream in(path);
+  if (!in)
+    return std::unexpected("Cannot open " + path);
+
+  return read(in);
+}
+
+void TestVectorFile::write(std::ostream& out, const TestVectors& vectors)
+{
+  const auto writeNames = [&out](const char* keyword, const auto& names) {
+    out << keyword;
+    for (const auto& name : names)
+      out << ' ' << name;
+    out << '\n';
+  };
+
+  writeNames(".inputs", vectors.inputNames);
+  writeNames(".outputs", vectors.outputNames);
+
+  const auto inputCount  = vectors.inputNames.size();
+  const auto outputCount = vectors.outputNames.size();
+
+  out << std::hex;
+  for (size_t v = 0; v < vectors.size(); v++) {
+    for (size_t i = 0; i < inputCount; i++)
+      out << "0x" << vectors.inputs[v * inputCount + i] << ' ';
+    for (size_t i = 0; i < outputCount; i++)
+      out << (i == 0 ? "" : " ") << "0x" << vectors.outputs[v * outputCount + i];
+    out << '\n';
+  }
+  out << std::dec;
+}
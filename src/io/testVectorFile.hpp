@@ -0,0 +1,48 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <expected>
+#include <istream>
+#include <ostream>
+#include <string>
+
+#include <core/testBench.hpp>
+
+/* Golden files of TestVectors.
+ *
+ *   # 4 bit adder
+ *   .inputs a b cin
+ *   .outputs s cout
+ *   0x3 0x5 0 0x8 0
+ *
+ * The .inputs and .outputs lines name the ports, then every line is a vector: the values
+ * of the inputs followed by the values of the outputs. Values are decimal, or hexadecimal
+ * and binary with the 0x and 0b prefixes. Everything after a '#' is a comment. */
+
+class TestVectorFile {
+public:
+  using Result = std::expected<TestVectors, std::string>;
+
+  static Result read(std::istream& in);
+  static Result load(const std::string& path);
+
+  // Values are written in hexadecimal
+  static void write(std::ostream& out, const TestVectors& vectors);
+};
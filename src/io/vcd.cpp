@@ -0,0 +1,544 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "vcd.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cctype>
+#include <charconv>
+#include <fstream>
+#include <unordered_map>
+
+namespace {
+char toChar(const State s)
+{
+  switch (s) {
+    case State::LOW: return '0';
+    case State::HIGH: return '1';
+    default: return 'x';
+  }
+}
+
+State toState(const char c)
+{
+  switch (c) {
+    case '0': return State::LOW;
+    case '1': return State::HIGH;
+    default: return State::ERROR;
+  }
+}
+
+// Identifier codes are numbers in base 94, written with the printable characters
+std::string identifierCode(uint32_t index)
+{
+  std::string res{};
+  do {
+    res += static_cast<char>('!' + index % 94);
+    index /= 94;
+  } while (index > 0);
+
+  return res;
+}
+
+std::vector<std::string_view> splitScopes(const std::string_view name)
+{
+  std::vector<std::string_view> res{};
+
+  size_t start = 0;
+  for (size_t dot = name.find('.'); dot != std::string_view::npos;
+       dot        = name.find('.', start)) {
+    res.push_back(name.substr(start, dot - start));
+    start = dot + 1;
+  }
+
+  res.push_back(name.substr(start));
+  return res;
+}
+
+bool isSpace(const char c)
+{
+  return std::isspace(static_cast<unsigned char>(c));
+}
+
+// The whitespace separated tokens of a stream, read one block at a time
+class Tokenizer {
+public:
+  explicit Tokenizer(std::istream& in) : in(in), block(BLOCK_SIZE) {}
+
+  // Empty at the end of the stream. The token is valid until the next call.
+  std::string_view next()
+  {
+    while (true) {
+      while (pos < size && isSpace(block[pos]))
+        pos++;
+      if (pos < size)
+        break;
+      if (!refill())
+        return {};
+    }
+
+    const size_t start = pos;
+    while (pos < size && !isSpace(block[pos]))
+      pos++;
+
+    if (pos < size)
+      return {block.data() + start, pos - start};
+
+    // The token continues in the next block
+    carry.assign(block.data() + start, size - start);
+    while (refill()) {
+      while (pos < size && !isSpace(block[pos]))
+        pos++;
+      carry.append(block.data(), pos);
+      if (pos < size)
+        break;
+    }
+
+    return carry;
+  }
+
+private:
+  static constexpr size_t BLOCK_SIZE = 1 << 16;
+
+  bool refill()
+  {
+    in.read(block.data(), static_cast<std::streamsize>(block.size()));
+    size = static_cast<size_t>(in.gcount());
+    pos  = 0;
+    return size > 0;
+  }
+
+  std::istream&     in;
+  std::vector<char> block;
+  size_t            pos  = 0;
+  size_t            size = 0;
+  std::string       carry;
+};
+
+// Identifier codes are looked up without copying the tokens
+struct CodeHash {
+  using is_transparent = void;
+  size_t operator()(const std::string_view s) const
+  {
+    return std::hash<std::string_view>{}(s);
+  }
+};
+
+using CodeMap =
+    std::unordered_map<std::string, std::vector<uint32_t>, CodeHash, std::equal_to<>>;
+}  // namespace
+
+/* WRITER */
+
+VcdWriter::VcdWriter(std::ostream& out, const std::string_view timescale)
+  : out(out), timescale(timescale)
+{
+  buffer.reserve(BUFFER_SIZE + 4096);
+}
+
+VcdWriter::~VcdWriter()
+{
+  flush();
+}
+
+uint32_t VcdWriter::addSignal(const std::string_view name, const uint32_t width)
+{
+  assert(!headerWritten && width > 0);
+
+  const auto index = static_cast<uint32_t>(variables.size());
+  variables.push_back({std::string(name), width});
+  codes.push_back(identifierCode(index));
+  values.emplace_back();
+
+  return index;
+}
+
+void VcdWriter::writeHeader()
+{
+  buffer += "$timescale " + timescale + " $end\n";
+
+  std::vector<std::string_view> open{};
+  for (size_t i = 0; i < variables.size(); i++) {
+    const auto parts  = splitScopes(variables[i].name);
+    const auto scopes = std::span(parts).first(parts.size() - 1);
+
+    const auto [common, _] = std::ranges::mismatch(open, scopes);
+    const auto kept        = static_cast<size_t>(common - open.begin());
+
+    for (; open.size() > kept; open.pop_back())
+      buffer += "$upscope $end\n";
+
+    for (const auto scope : scopes.subspan(kept)) {
+      buffer += "$scope module ";
+      buffer += scope;
+      buffer += " $end\n";
+      open.push_back(scope);
+    }
+
+    buffer += "$var wire " + std::to_string(variables[i].width) + ' ' + codes[i] + ' ';
+    buffer += parts.back();
+    buffer += " $end\n";
+  }
+
+  for (; !open.empty(); open.pop_back())
+    buffer += "$upscope $end\n";
+
+  buffer += "$enddefinitions $end\n";
+  headerWritten = true;
+}
+
+void VcdWriter::setTime(const uint64_t newTime)
+{
+  assert(newTime >= time || !headerWritten);
+
+  if (!headerWritten)
+    writeHeader();
+
+  if (newTime != time)
+    timeWritten = false;
+  time = newTime;
+}
+
+std::pair<size_t, size_t> VcdWriter::beginValue()
+{
+  if (!headerWritten)
+    writeHeader();
+
+  const size_t start = buffer.size();
+  if (!timeWritten) {
+    char       digits[24];
+    const auto end = std::to_chars(std::begin(digits), std::end(digits), time).ptr;
+
+    buffer += '#';
+    buffer.append(digits, end);
+    buffer += '\n';
+    timeWritten = true;
+  }
+
+  return {start, buffer.size()};
+}
+
+void VcdWriter::endValue(const uint32_t signal, const size_t start,
+                         const size_t valueStart)
+{
+  const std::string_view value(buffer.data() + valueStart, buffer.size() - valueStart);
+
+  if (value == values[signal]) {
+    // The time is written again by the next change
+    if (valueStart != start)
+      timeWritten = false;
+
+    buffer.resize(start);
+    return;
+  }
+
+  values[signal].assign(value);
+
+  buffer += codes[signal];
+  buffer += '\n';
+
+  if (buffer.size() >= BUFFER_SIZE) {
+    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    buffer.clear();
+  }
+}
+
+void VcdWriter::sample(const uint32_t signal, const std::span<const State> bits)
+{
+  assert(signal < variables.size() && bits.size() == variables[signal].width);
+
+  const auto [start, valueStart] = beginValue();
+
+  if (bits.size() == 1) {
+    buffer += toChar(bits[0]);
+  } else {
+    buffer += 'b';
+    for (size_t i = bits.size(); i-- > 0;)
+      buffer += toChar(bits[i]);
+    buffer += ' ';
+  }
+
+  endValue(signal, start, valueStart);
+}
+
+void VcdWriter::sample(const uint32_t signal, const std::string_view value)
+{
+  assert(signal < variables.size() && !value.empty());
+
+  const auto [start, valueStart] = beginValue();
+
+  if (variables[signal].width == 1) {
+    buffer += value.back();
+  } else {
+    buffer += 'b';
+    buffer += value;
+    buffer += ' ';
+  }
+
+  endValue(signal, start, valueStart);
+}
+
+void VcdWriter::flush()
+{
+  if (!headerWritten)
+    writeHeader();
+
+  out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+  out.flush();
+  buffer.clear();
+}
+
+/* READER */
+
+std::expected<void, std::string>
+VcdReader::read(std::istream& in, SignalsCallback onSignals, ChangeCallback onChange)
+{
+  Tokenizer tokens(in);
+
+  std::vector<WaveformSignal> signals{};
+  std::vector<std::string>    scopes{};
+  CodeMap                     signalsOf{};
+
+  // The tokens of a command up to its $end
+  const auto skipCommand = [&] {
+    for (auto t = tokens.next(); t != "$end"; t = tokens.next())
+      if (t.empty())
+        return false;
+    return true;
+  };
+
+  const auto truncated = std::unexpected<std::string>("Unexpected end of file");
+
+  while (true) {
+    const auto t = tokens.next();
+    if (t.empty())
+      return std::unexpected("Missing $enddefinitions");
+
+    if (t == "$scope") {
+      tokens.next();
+      scopes.emplace_back(tokens.next());
+    } else if (t == "$upscope") {
+      if (!scopes.empty())
+        scopes.pop_back();
+    } else if (t == "$var") {
+      tokens.next();
+
+      const auto widthToken = tokens.next();
+      uint32_t   width      = 0;
+      std::from_chars(widthToken.data(), widthToken.data() + widthToken.size(), width);
+      if (width == 0)
+        return std::unexpected("Invalid width " + std::string(widthToken));
+
+      const std::string code(tokens.next());
+
+      std::string name{};
+      for (const auto& scope : scopes)
+        name += scope + '.';
+      name += tokens.next();
+
+      signalsOf[code].push_back(signals.size());
+      signals.push_back({std::move(name), width});
+    } else if (t == "$enddefinitions") {
+      if (!skipCommand())
+        return truncated;
+      break;
+    } else if (!t.starts_with('$')) {
+      return std::unexpected("Unexpected " + std::string(t) + " in the header");
+    }
+
+    if (!skipCommand())
+      return truncated;
+  }
+
+  onSignals(signals);
+
+  uint64_t    time = 0;
+  std::string value{};
+  std::string padded{};
+
+  // A value can be shorter than its signal, it's extended with 0s or with its first
+  // character if it's x or z
+  const auto change = [&](const std::string_view code) -> bool {
+    const auto it = signalsOf.find(code);
+    if (it == signalsOf.end())
+      return false;
+
+    std::ranges::transform(value, value.begin(), [](const char c) {
+      return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    });
+
+    for (const uint32_t s : it->second) {
+      const uint32_t width = signals[s].width;
+      if (value.size() == width) {
+        onChange(time, s, value);
+        continue;
+      }
+
+      if (value.size() > width) {
+        onChange(time, s, std::string_view(value).substr(value.size() - width));
+        continue;
+      }
+
+      const char fill = value[0] == 'x' || value[0] == 'z' ? value[0] : '0';
+      padded.assign(width - value.size(), fill);
+      padded += value;
+      onChange(time, s, padded);
+    }
+
+    return true;
+  };
+
+  for (auto t = tokens.next(); !t.empty(); t = tokens.next()) {
+    switch (t[0]) {
+      case '#': {
+        const auto [end, ec] = std::from_chars(t.data() + 1, t.data() + t.size(), time);
+        if (ec != std::errc{} || end != t.data() + t.size())
+          return std::unexpected("Invalid time " + std::string(t));
+        break;
+      }
+      case '$': {
+        // $dumpvars and the similar commands only contain value changes
+        if (t == "$comment" && !skipCommand())
+          return truncated;
+        break;
+      }
+      case 'b':
+      case 'B': {
+        value.assign(t.substr(1));
+
+        const auto code = tokens.next();
+        if (value.empty() || !change(code))
+          return std::unexpected("Invalid change " + std::string(t) + " "
+                                 + std::string(code));
+        break;
+      }
+      case 'r':
+      case 'R': {
+        // Real values can't be States
+        tokens.next();
+        break;
+      }
+      case '0':
+      case '1':
+      case 'x':
+      case 'X':
+      case 'z':
+      case 'Z': {
+        value.assign(t.substr(0, 1));
+        if (!change(t.substr(1)))
+          return std::unexpected("Unknown identifier code in " + std::string(t));
+        break;
+      }
+      default: return std::unexpected("Invalid change " + std::string(t));
+    }
+  }
+
+  return {};
+}
+
+/* STIMULUS */
+
+VcdStimulus::Result VcdStimulus::read(std::istream&                      in,
+                                      const std::span<const std::string> inputs)
+{
+  VcdStimulus res{};
+  res.driven.assign(inputs.size(), false);
+
+  // The inputs driven by every signal, and the bits they were last set to
+  constexpr uint8_t                  UNKNOWN = 0xFF;
+  std::vector<std::vector<uint32_t>> inputsOf{};
+  std::vector<std::vector<uint8_t>>  current(inputs.size());
+
+  const auto onSignals = [&](const std::span<const WaveformSignal> signals) {
+    inputsOf.resize(signals.size());
+
+    for (size_t i = 0; i < inputs.size(); i++) {
+      const auto& name = inputs[i];
+
+      auto it = std::ranges::find(signals, name, &WaveformSignal::name);
+      if (it == signals.end()) {
+        it = std::ranges::find_if(signals, [&](const WaveformSignal& s) {
+          return s.name.size() > name.size() && s.name.ends_with(name)
+                 && s.name[s.name.size() - name.size() - 1] == '.';
+        });
+      }
+
+      if (it == signals.end())
+        continue;
+
+      inputsOf[it - signals.begin()].push_back(i);
+      current[i].assign(it->width, UNKNOWN);
+      res.driven[i] = true;
+    }
+  };
+
+  const auto onChange = [&](const uint64_t time, const uint32_t signal,
+                            const std::string_view value) {
+    for (const uint32_t input : inputsOf[signal]) {
+      auto& bits = current[input];
+
+      for (size_t i = 0; i < value.size(); i++) {
+        const auto bit   = static_cast<uint32_t>(value.size() - 1 - i);
+        const auto state = toState(value[i]);
+        if (bits[bit] == static_cast<uint8_t>(state))
+          continue;
+
+        bits[bit] = static_cast<uint8_t>(state);
+
+        if (res.times.empty() || res.times.back() != time) {
+          res.times.push_back(time);
+          res.stepStarts.push_back(res.changes.size());
+        }
+
+        res.changes.push_back({input, bit, state});
+      }
+    }
+  };
+
+  if (const auto read = VcdReader::read(in, onSignals, onChange); !read)
+    return std::unexpected(read.error());
+
+  if (std::ranges::find(res.driven, true) == res.driven.end())
+    return std::unexpected("None of the inputs is in the file");
+
+  return res;
+}
+
+VcdStimulus::Result VcdStimulus::load(const std::string&                 path,
+                                      const std::span<const std::string> inputs)
+{
+  std::ifstream in(path, std::ios::binary);
+  if (!in)
+    return std::unexpected("Cannot open " + path);
+
+  return read(in, inputs);
+}
+
+std::span<const VcdStimulus::Change> VcdStimulus::getChanges(const size_t step) const
+{
+  const size_t end = step + 1 < stepStarts.size() ? stepStarts[step + 1] : changes.size();
+  return std::span(changes).subspan(stepStarts[step], end - stepStarts[step]);
+}
+
+void VcdStimulus::apply(const size_t step, const std::span<const Bus> inputs) const
+{
+  for (const auto& [input, bit, state] : getChanges(step))
+    if (input < inputs.size() && bit < inputs[input].size())
+      inputs[input][bit]->forceSetCurrentState(state);
+}
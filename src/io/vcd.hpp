@@ -0,0 +1,140 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <core/wire.hpp>
+#include <io/waveform.hpp>
+
+/* Value Change Dump files (IEEE 1364), for the tools that don't read FST.
+ *
+ * A VcdWriter formats the changes in a buffer that is written to the stream in large
+ * blocks, with no allocation per change. VcdReader parses a stream one block at a time
+ * and passes every change to a callback, so files of any size are read in constant
+ * memory. In both, dots in the names of the signals separate their scopes. */
+
+class VcdWriter {
+public:
+  explicit VcdWriter(std::ostream& out, std::string_view timescale = "1ns");
+  ~VcdWriter();
+
+  VcdWriter(const VcdWriter&)            = delete;
+  VcdWriter& operator=(const VcdWriter&) = delete;
+
+  // Signals must be added before the first sample
+  uint32_t addSignal(std::string_view name, uint32_t width = 1);
+
+  // Times can't decrease
+  void setTime(uint64_t time);
+
+  // bits[0] is the least significant bit, ERROR is stored as 'x'
+  void sample(uint32_t signal, std::span<const State> bits);
+  void sample(uint32_t signal, State bit) { sample(signal, std::span(&bit, 1)); }
+
+  // A VCD value, the most significant bit first
+  void sample(uint32_t signal, std::string_view value);
+
+  // Writes the buffer to the stream
+  void flush();
+
+private:
+  static constexpr size_t BUFFER_SIZE = 1 << 20;
+
+  void writeHeader();
+
+  // A value is formatted at the end of the buffer, after the time if it's the first
+  // change at that time. It's removed if it's the same as the previous one.
+  [[nodiscard]] std::pair<size_t, size_t> beginValue();
+  void endValue(uint32_t signal, size_t start, size_t valueStart);
+
+  std::ostream& out;
+  std::string   timescale;
+  std::string   buffer;
+
+  std::vector<WaveformSignal> variables;
+  std::vector<std::string>    codes;
+  std::vector<std::string>    values;
+
+  bool     headerWritten = false;
+  bool     timeWritten   = false;
+  uint64_t time          = 0;
+};
+
+class VcdReader {
+public:
+  // Called once with all the signals, before the first change
+  using SignalsCallback = std::function<void(std::span<const WaveformSignal> signals)>;
+
+  // A value of `width` characters, the most significant bit first
+  using ChangeCallback =
+      std::function<void(uint64_t time, uint32_t signal, std::string_view value)>;
+
+  static std::expected<void, std::string>
+  read(std::istream& in, SignalsCallback onSignals, ChangeCallback onChange);
+};
+
+/* Input values recorded in a VCD file, to be applied to a circuit.
+ *
+ * The inputs are given by name: each one is driven by the first signal with the same
+ * scoped name, or with the same name in any scope. A step is a time at which some inputs
+ * change, it only stores the bits that changed. */
+
+class VcdStimulus {
+public:
+  struct Change {
+    uint32_t input = 0;
+    uint32_t bit   = 0;  // 0 is the least significant
+    State    state = State::LOW;
+  };
+
+  using Result = std::expected<VcdStimulus, std::string>;
+
+  static Result read(std::istream& in, std::span<const std::string> inputs);
+  static Result load(const std::string& path, std::span<const std::string> inputs);
+
+  [[nodiscard]] size_t size() const { return times.size(); }
+
+  [[nodiscard]] uint64_t getTime(size_t step) const { return times[step]; }
+
+  [[nodiscard]] std::span<const Change> getChanges(size_t step) const;
+
+  // Whether some signal of the file drives the input
+  [[nodiscard]] bool isDriven(uint32_t input) const { return driven[input]; }
+
+  // Forces the wires of the inputs that change at a step: inputs[i] is the bus of the
+  // i-th input. Applying the steps in order gives the values of the file, bits beyond the
+  // size of a bus are ignored.
+  void apply(size_t step, std::span<const Bus> inputs) const;
+
+private:
+  std::vector<uint64_t> times;
+  std::vector<uint32_t> stepStarts;
+  std::vector<Change>   changes;
+  std::vector<bool>     driven;
+};
@@ -0,0 +1,392 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "waveform.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <optional>
+#include <unordered_map>
+
+#include <fstapi.h>
+
+#include <io/vcd.hpp>
+
+namespace {
+char toChar(const State s)
+{
+  switch (s) {
+    case State::LOW: return '0';
+    case State::HIGH: return '1';
+    default: return 'x';
+  }
+}
+}  // namespace
+
+/* WRITER */
+
+WaveformWriter::WaveformWriter(const std::string& path)
+  : writer(fstWriterCreate(path.c_str(), 1))
+{
+  if (writer)
+    fstWriterSetPackType(writer, FST_WR_PT_LZ4);
+}
+
+WaveformWriter::~WaveformWriter()
+{
+  close();
+}
+
+uint32_t WaveformWriter::addSignal(const std::string_view name, const uint32_t width)
+{
+  assert(isOpen() && width > 0);
+
+  std::vector<std::string> parts{};
+  for (size_t start = 0;;) {
+    const size_t dot = name.find('.', start);
+    parts.emplace_back(name.substr(start, dot - start));
+    if (dot == std::string_view::npos)
+      break;
+    start = dot + 1;
+  }
+
+  const std::string variable = std::move(parts.back());
+  parts.pop_back();
+
+  // Only the scopes that differ from the ones of the previous signal are changed
+  const auto [common, _] = std::ranges::mismatch(scopes, parts);
+  for (auto n = scopes.end() - common; n > 0; n--)
+    fstWriterSetUpscope(writer);
+  for (auto it = parts.begin() + (common - scopes.begin()); it != parts.end(); ++it)
+    fstWriterSetScope(writer, FST_ST_VCD_MODULE, it->c_str(), nullptr);
+  scopes = std::move(parts);
+
+  handles.push_back(fstWriterCreateVar(writer, FST_VT_VCD_WIRE, FST_VD_IMPLICIT, width,
+                                       variable.c_str(), 0));
+
+  // Nothing was written yet, so the first sample is always stored
+  values.emplace_back();
+  return handles.size() - 1;
+}
+
+void WaveformWriter::setTime(const uint64_t time)
+{
+  assert(isOpen());
+  fstWriterEmitTimeChange(writer, time);
+}
+
+void WaveformWriter::sample(const uint32_t signal, const std::span<const State> bits)
+{
+  assert(isOpen() && signal < handles.size());
+
+  buffer.resize(bits.size());
+  for (size_t i = 0; i < bits.size(); i++)
+    buffer[bits.size() - 1 - i] = toChar(bits[i]);
+
+  if (buffer == values[signal])
+    return;
+
+  values[signal] = buffer;
+  fstWriterEmitValueChange(writer, handles[signal], buffer.c_str());
+}
+
+void WaveformWriter::sample(const uint32_t signal, const std::string_view value)
+{
+  assert(isOpen() && signal < handles.size());
+
+  if (value == values[signal])
+    return;
+
+  values[signal] = value;
+  fstWriterEmitValueChange(writer, handles[signal], values[signal].c_str());
+}
+
+void WaveformWriter::close()
+{
+  if (!writer)
+    return;
+
+  fstWriterClose(writer);
+  writer = nullptr;
+}
+
+/* READER */
+
+WaveformReader::WaveformReader(const std::string& path)
+  : reader(fstReaderOpen(path.c_str()))
+{
+  if (!reader)
+    return;
+
+  std::vector<std::string> scopes{};
+
+  fstReaderIterateHierRewind(reader);
+  while (const fstHier* h = fstReaderIterateHier(reader)) {
+    switch (h->htyp) {
+      case FST_HT_SCOPE: scopes.emplace_back(h->u.scope.name); break;
+      case FST_HT_UPSCOPE: {
+        if (!scopes.empty())
+          scopes.pop_back();
+        break;
+      }
+      case FST_HT_VAR: {
+        std::string name{};
+        for (const auto& scope : scopes)
+          name += scope + '.';
+        name += h->u.var.name;
+
+        variables.push_back({std::move(name), h->u.var.length});
+        handles.push_back(h->u.var.handle);
+        break;
+      }
+      default: break;
+    }
+  }
+}
+
+WaveformReader::~WaveformReader()
+{
+  if (reader)
+    fstReaderClose(reader);
+}
+
+uint64_t WaveformReader::getStartTime() const
+{
+  return reader ? fstReaderGetStartTime(reader) : 0;
+}
+
+uint64_t WaveformReader::getEndTime() const
+{
+  return reader ? fstReaderGetEndTime(reader) : 0;
+}
+
+std::string WaveformReader::getValue(const uint32_t signal, const uint64_t time)
+{
+  assert(isOpen() && signal < variables.size());
+
+  std::string buffer(variables[signal].width + 1, '\0');
+  if (!fstReaderGetValueFromHandleAtTime(reader, time, handles[signal], buffer.data()))
+    return std::string(variables[signal].width, 'x');
+
+  buffer.resize(std::char_traits<char>::length(buffer.c_str()));
+  return buffer;
+}
+
+namespace {
+struct Trace {
+  std::vector<WaveformReader::Segment> segments;
+  std::string                          current;
+};
+
+struct LoadContext {
+  uint64_t start;
+  uint64_t end;
+  uint64_t resolution;
+
+  std::vector<Trace>                                   traces;
+  std::unordered_map<fstHandle, std::vector<uint32_t>> tracesOf;
+
+  [[nodiscard]] uint64_t slotStart(const uint64_t time) const
+  {
+    return start + (time - start) / resolution * resolution;
+  }
+
+  // The busy segment at the end of `t` is over at the end of its slot, then the signal
+  // holds its last value
+  void closeBusy(Trace& t, const uint64_t until) const
+  {
+    auto& last = t.segments.back();
+    last.end   = std::min(until, slotStart(last.start) + resolution);
+
+    if (last.end < until)
+      t.segments.push_back({last.end, until, t.current});
+  }
+
+  void change(Trace& t, const uint64_t time, const std::string_view value) const
+  {
+    if (time < start || time >= end || value == t.current)
+      return;
+
+    auto& last = t.segments.back();
+    if (last.start >= slotStart(time)) {
+      last.value.clear();
+    } else {
+      if (last.value.empty())
+        closeBusy(t, time);
+      else
+        last.end = time;
+
+      t.segments.push_back({time, end, std::string(value)});
+    }
+
+    t.current = value;
+  }
+};
+
+void onValueChange(void* user, const uint64_t time, const fstHandle handle,
+                   const unsigned char* value)
+{
+  auto&      ctx = *static_cast<LoadContext*>(user);
+  const auto it  = ctx.tracesOf.find(handle);
+  if (it == ctx.tracesOf.end())
+    return;
+
+  const std::string_view v(reinterpret_cast<const char*>(value));
+  for (const uint32_t i : it->second)
+    ctx.change(ctx.traces[i], time, v);
+}
+
+void onVarLengthValueChange(void* user, const uint64_t time, const fstHandle handle,
+                            const unsigned char* value, uint32_t)
+{
+  onValueChange(user, time, handle, value);
+}
+}  // namespace
+
+namespace {
+struct ChangeContext {
+  std::unordered_map<fstHandle, std::vector<uint32_t>> signalsOf;
+
+  const std::function<void(uint64_t, uint32_t, std::string_view)>& onChange;
+};
+
+void onEveryChange(void* user, const uint64_t time, const fstHandle handle,
+                   const unsigned char* value)
+{
+  const auto& ctx = *static_cast<ChangeContext*>(user);
+  const auto  it  = ctx.signalsOf.find(handle);
+  if (it == ctx.signalsOf.end())
+    return;
+
+  const std::string_view v(reinterpret_cast<const char*>(value));
+  for (const uint32_t signal : it->second)
+    ctx.onChange(time, signal, v);
+}
+
+void onEveryVarLengthChange(void* user, const uint64_t time, const fstHandle handle,
+                            const unsigned char* value, uint32_t)
+{
+  onEveryChange(user, time, handle, value);
+}
+}  // namespace
+
+void WaveformReader::forEachChange(
+    const std::function<void(uint64_t, uint32_t, std::string_view)>& onChange)
+{
+  assert(isOpen());
+
+  ChangeContext ctx{{}, onChange};
+  for (uint32_t i = 0; i < handles.size(); i++)
+    ctx.signalsOf[handles[i]].push_back(i);
+
+  fstReaderSetFacProcessMaskAll(reader);
+  fstReaderIterBlocks2(reader, onEveryChange, onEveryVarLengthChange, &ctx, nullptr);
+}
+
+std::vector<std::vector<WaveformReader::Segment>>
+WaveformReader::load(const std::span<const uint32_t> selected, const uint64_t start,
+                     const uint64_t end, const uint64_t resolution)
+{
+  assert(isOpen() && resolution > 0);
+
+  if (selected.empty() || start >= end)
+    return std::vector<std::vector<Segment>>(selected.size());
+
+  LoadContext ctx{start, end, resolution, {}, {}};
+  ctx.traces.resize(selected.size());
+
+  for (size_t i = 0; i < selected.size(); i++) {
+    auto& t   = ctx.traces[i];
+    t.current = getValue(selected[i], start);
+    t.segments.push_back({start, end, t.current});
+
+    ctx.tracesOf[handles[selected[i]]].push_back(i);
+  }
+
+  fstReaderClrFacProcessMaskAll(reader);
+  for (const uint32_t s : selected)
+    fstReaderSetFacProcessMask(reader, handles[s]);
+
+  fstReaderSetLimitTimeRange(reader, start, end - 1);
+  fstReaderIterBlocks2(reader, onValueChange, onVarLengthValueChange, &ctx, nullptr);
+  fstReaderSetUnlimitedTimeRange(reader);
+
+  std::vector<std::vector<Segment>> res{};
+  res.reserve(selected.size());
+
+  for (auto& t : ctx.traces) {
+    if (t.segments.back().value.empty())
+      ctx.closeBusy(t, end);
+    res.push_back(std::move(t.segments));
+  }
+
+  return res;
+}
+
+/* CONVERTER */
+
+WaveformConverter::Result WaveformConverter::fstToVcd(const std::string& fstPath,
+                                                      std::ostream&      vcd)
+{
+  WaveformReader reader(fstPath);
+  if (!reader.isOpen())
+    return std::unexpected("Cannot open " + fstPath);
+
+  VcdWriter writer(vcd);
+  for (const auto& [name, width] : reader.getSignals())
+    writer.addSignal(name, width);
+
+  reader.forEachChange([&](const uint64_t time, const uint32_t signal,
+                           const std::string_view value) {
+    writer.setTime(time);
+    writer.sample(signal, value);
+  });
+
+  writer.flush();
+  if (!vcd)
+    return std::unexpected("Cannot write the VCD file");
+
+  return {};
+}
+
+WaveformConverter::Result WaveformConverter::vcdToFst(std::istream&      vcd,
+                                                      const std::string& fstPath)
+{
+  WaveformWriter writer(fstPath);
+  if (!writer.isOpen())
+    return std::unexpected("Cannot create " + fstPath);
+
+  // FST stores a time once, however many signals change at it
+  std::optional<uint64_t> last{};
+
+  const auto read = VcdReader::read(
+      vcd,
+      [&](const std::span<const WaveformSignal> signals) {
+        for (const auto& [name, width] : signals)
+          writer.addSignal(name, width);
+      },
+      [&](const uint64_t time, const uint32_t signal, const std::string_view value) {
+        if (last != time)
+          writer.setTime(time);
+        last = time;
+        writer.sample(signal, value);
+      });
+
+  writer.close();
+  return read;
+}
@@ -0,0 +1,147 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <core/wire.hpp>
+
+/* Waveforms stored in FST files, see libfst.
+ *
+ * A WaveformWriter stores the changes of some signals over time, each one a word of
+ * States. A sample equal to the previous value of the signal isn't written.
+ *
+ * A WaveformReader loads the changes of some signals in a window of time. An FST file is
+ * made of blocks covering consecutive intervals of time: only the blocks overlapping the
+ * window are decompressed. The window is split in slots of `resolution` units of time
+ * (e.g. the time covered by a pixel): a signal changing more than once in a slot is shown
+ * as busy for the whole slot, so the memory used only depends on the number of slots and
+ * not on the number of changes.
+ *
+ * Dots in the names of the signals separate their scopes. */
+
+struct fstWriterContext;
+struct fstReaderContext;
+
+struct WaveformSignal {
+  std::string name;
+  uint32_t    width = 1;
+};
+
+class WaveformWriter {
+public:
+  explicit WaveformWriter(const std::string& path);
+  ~WaveformWriter();
+
+  WaveformWriter(const WaveformWriter&)            = delete;
+  WaveformWriter& operator=(const WaveformWriter&) = delete;
+
+  [[nodiscard]] bool isOpen() const { return writer != nullptr; }
+
+  // Signals must be added before the first sample
+  uint32_t addSignal(std::string_view name, uint32_t width = 1);
+
+  // Times can't decrease
+  void setTime(uint64_t time);
+
+  // bits[0] is the least significant bit, ERROR is stored as 'x'
+  void sample(uint32_t signal, std::span<const State> bits);
+  void sample(uint32_t signal, State bit) { sample(signal, std::span(&bit, 1)); }
+
+  // A VCD value, the most significant bit first
+  void sample(uint32_t signal, std::string_view value);
+
+  // Flushes the file, it can then be read
+  void close();
+
+private:
+  fstWriterContext* writer = nullptr;
+
+  std::vector<uint32_t>    handles;
+  std::vector<std::string> values;
+  std::string              buffer;
+
+  // Of the last signal that was added
+  std::vector<std::string> scopes;
+};
+
+class WaveformReader {
+public:
+  // A value is a string of '0', '1' and 'x' (or other VCD characters), the most
+  // significant bit first
+  struct Segment {
+    uint64_t    start = 0;
+    uint64_t    end   = 0;  // Excluded
+    std::string value;      // Empty if the signal is busy
+  };
+
+  explicit WaveformReader(const std::string& path);
+  ~WaveformReader();
+
+  WaveformReader(const WaveformReader&)            = delete;
+  WaveformReader& operator=(const WaveformReader&) = delete;
+
+  [[nodiscard]] bool isOpen() const { return reader != nullptr; }
+
+  // Scoped names are joined by dots
+  [[nodiscard]] const std::vector<WaveformSignal>& getSignals() const
+  {
+    return variables;
+  }
+
+  [[nodiscard]] uint64_t getStartTime() const;
+  [[nodiscard]] uint64_t getEndTime() const;
+
+  // The value of a signal at a time
+  [[nodiscard]] std::string getValue(uint32_t signal, uint64_t time);
+
+  // Every change of every signal, in order of time
+  void forEachChange(
+      const std::function<void(uint64_t time, uint32_t signal, std::string_view value)>&
+          onChange);
+
+  // The segments of every signal covering [start, end), at most 3 per slot
+  [[nodiscard]] std::vector<std::vector<Segment>>
+  load(std::span<const uint32_t> selected, uint64_t start, uint64_t end,
+       uint64_t resolution);
+
+private:
+  fstReaderContext* reader = nullptr;
+
+  std::vector<WaveformSignal> variables;
+  std::vector<uint32_t>       handles;
+};
+
+// Conversions between FST and VCD files. Times are copied as they are, the signals keep
+// their scoped names.
+class WaveformConverter {
+public:
+  using Result = std::expected<void, std::string>;
+
+  static Result fstToVcd(const std::string& fstPath, std::ostream& vcd);
+  static Result vcdToFst(std::istream& vcd, const std::string& fstPath);
+};
@@ -23,6 +23,13 @@
 #include "ui/logiFlow/components/graphicalIO.hpp"
 #include "ui/logiFlow/components/graphicalUtils.hpp"
 
+#include <ui/common/sceneCommands.hpp>
+
+#include <string>
+#include <unordered_set>
+
+#include <core/diagnostics.hpp>
+
 DiagramScene::DiagramScene(QObject* parent) : QGraphicsScene(parent)
 {
   setInteractionMode(InteractionMode::NORMAL_MODE, true);
@@ -31,7 +38,7 @@ DiagramScene::DiagramScene(QObject* parent) : QGraphicsScene(parent)
   csb->setParent(this);
   connect(csb, &ComponentSearchBox::requestHide, this, &DiagramScene::hideCSB);
   connect(csb, &ComponentSearchBox::selectedComponent, this,
-          &DiagramScene::placeComponent);
+          qOverload<SiliconTypes>(&DiagramScene::placeComponent));
 }
 
 QPointF DiagramScene::snapToGrid(const QPointF point)
@@ -76,22 +83,33 @@ void DiagramScene::setInteractionMode(const InteractionMode newMode, bool force)
     return;
 
   if (wireSegmentToBeDrawn && newMode != InteractionMode::WIRE_CREATION_MODE) {
+    GraphicalWireSegment* drawnSegment = nullptr;
+    bool                  isNewWire    = false;
+
     // Remove the wireSegment if it's invisible
     if (wireSegmentToBeDrawn->empty()) {
       removeItem(wireSegmentToBeDrawn);
       delete wireSegmentToBeDrawn;
       wireSegmentToBeDrawn = nullptr;
-    } else if (!wireSegmentToBeDrawn->getGraphicalWire()) {  // Create the wire for
-                                                             // orphans
-      // Create the bus. Size 1 is the default, it will change if needed during simulation
-      const auto b = Bus(1);
-      auto*      w = new GraphicalWire();
-      w->setBus(b);
-
-      wireSegmentToBeDrawn->setGraphicalWire(w);
-      addItem(w);
+    } else {
+      if (!wireSegmentToBeDrawn->getGraphicalWire()) {  // Create the wire for orphans
+        // Create the bus. Size 1 is the default, it will change if needed during
+        // simulation
+        const auto b = Bus(1);
+        auto*      w = new GraphicalWire();
+        w->setBus(b);
+
+        wireSegmentToBeDrawn->setGraphicalWire(w);
+        addItem(w);
+        isNewWire = true;
+      }
+      drawnSegment = wireSegmentToBeDrawn;
     }
     clearWireShadow();
+
+    if (drawnSegment)
+      pushCommand(new WireSegmentCommand(this, drawnSegment,
+                                         drawnSegment->getGraphicalWire(), isNewWire));
   }
 
   if (currentMode == InteractionMode::COMPONENT_PLACING_MODE) {
@@ -137,41 +155,33 @@ void DiagramScene::setInteractionMode(const InteractionMode newMode, bool force)
     showCSB(view->mapToScene(posForCSB));
   }
 
-  if (newMode == InteractionMode::SIMULATION_MODE
-      || currentMode == InteractionMode::SIMULATION_MODE) {
-    // If we are goint to simulation mode then calculate the wires
-    if (newMode == InteractionMode::SIMULATION_MODE) {
-      calculateWiresForComponents();
-    }
-
-    // RESTORE INPUTS TO NEUTRAL STATE
-
-    // TODO: Make a parent IO class with virtual reset method
+  const bool resume = newMode == InteractionMode::SIMULATION_MODE && simulationSuspended;
+  int        patched = 0;
 
-    const auto inputComponents = items() | std::views::filter([](auto item) {
-                                   return item->type() == SiliconTypes::SINGLE_INPUT;
-                                 })
-                                 | std::ranges::to<std::vector>();
+  if (newMode == InteractionMode::SIMULATION_MODE) {
+    // If we are going to simulation mode then calculate the wires
+    patched = calculateWiresForComponents(resume);
 
-    for (const auto inputComponent : inputComponents) {
-      qgraphicsitem_cast<GraphicalInput*>(inputComponent)->setState(State::LOW);
+    // RESTORE INPUTS TO NEUTRAL STATE, unless the simulation goes on
+    if (resume) {
+      simulationSuspended = false;
+      checkOscillations();
+      showSimulatedStates();
+    } else {
+      resetIO(false);
     }
-
+  } else if (currentMode == InteractionMode::SIMULATION_MODE) {
     // If we are exiting SIMULATION_MODE then restore outputs as well
-    if (currentMode == InteractionMode::SIMULATION_MODE) {
-      const auto outputComponents = items() | std::views::filter([](auto item) {
-                                      return item->type() == SiliconTypes::SINGLE_OUTPUT;
-                                    })
-                                    | std::ranges::to<std::vector>();
-
-      for (const auto outputComponent : outputComponents) {
-        qgraphicsitem_cast<GraphicalOutputSingle*>(outputComponent)->setState(State::LOW);
-      }
-    }
+    simulationSuspended = liveEditing;
+    if (!simulationSuspended)
+      resetIO(true);
   }
 
   this->currentInteractionMode = newMode;
   emit DiagramScene::modeChanged(newMode);
+
+  if (resume)
+    emit simulationResumed(patched);
 }
 
 void DiagramScene::mouseMoveEvent(QGraphicsSceneMouseEvent* mouseEvent)
@@ -226,13 +236,16 @@ void DiagramScene::mousePressEvent(QGraphicsSceneMouseEvent* mouseEvent)
     case InteractionMode::COMPONENT_PLACING_MODE: {
       if (componentToBeDrawn) {
         // Next components should inherit the type and rotation of the previous one
-        const auto type     = static_cast<SiliconTypes>(componentToBeDrawn->type());
         const auto rotation = componentToBeDrawn->rotation();
 
+        GraphicalComponent* placed = componentToBeDrawn;
         clearComponentShadow();
 
+        pushCommand(new ItemsCommand(this, ItemsCommand::Kind::ADD, {placed},
+                                     tr("Place component")));
+
         // Propose the placing of the next component
-        placeComponent(type);
+        placeComponent(componentFactory);
         componentToBeDrawn->setRotation(rotation);
       }
       break;
@@ -268,11 +281,40 @@ void DiagramScene::mousePressEvent(QGraphicsSceneMouseEvent* mouseEvent)
           input->toggle();
         }
       }
+
+      endSimulationStep();
       break;
     }
     default: assert(false);
   }
   QGraphicsScene::mousePressEvent(mouseEvent);
+
+  // The selection is updated by QGraphicsScene, so the components that may be dragged are
+  // known only now
+  if (currentInteractionMode == InteractionMode::NORMAL_MODE) {
+    moveStartPositions.clear();
+
+    for (QGraphicsItem* item : selectedItems())
+      if (item->type() >= COMPONENT)
+        moveStartPositions.emplace_back(qgraphicsitem_cast<GraphicalComponent*>(item),
+                                        item->pos());
+  }
+}
+
+void DiagramScene::mouseReleaseEvent(QGraphicsSceneMouseEvent* mouseEvent)
+{
+  QGraphicsScene::mouseReleaseEvent(mouseEvent);
+
+  std::vector<MoveCommand::Delta> deltas{};
+
+  for (const auto& [component, startPos] : moveStartPositions)
+    if (component->scene() == this && component->pos() != startPos)
+      deltas.push_back({component, startPos, component->pos()});
+
+  moveStartPositions.clear();
+
+  if (!deltas.empty())
+    pushCommand(new MoveCommand(this, std::move(deltas)));
 }
 
 void DiagramScene::keyPressEvent(QKeyEvent* event)
@@ -337,73 +379,385 @@ void DiagramScene::hideCSB()
     removeItem(csb);
 }
 
-void DiagramScene::calculateWiresForComponents() const
+void DiagramScene::checkOscillations()
 {
-  const auto wires = items()
-                     | std::views::filter([](auto item) { return item->type() == WIRE; })
-                     | std::views::transform([](auto item) {
-                         return qgraphicsitem_cast<GraphicalWire*>(item);
-                       })
-                     | std::ranges::to<std::vector>();
+  int oscillating = 0;
 
-  // Set wires to initial state
-  for (GraphicalWire* wire : wires) {
-    wire->clearBusState();
+  for (QGraphicsItem* item : items()) {
+    if (item->type() != WIRE)
+      continue;
+
+    auto       bus     = qgraphicsitem_cast<GraphicalWire*>(item)->getBus();
+    const auto isStuck = [](const Wire_ptr& w) { return w && w->isOscillating(); };
+
+    if (std::ranges::any_of(bus, isStuck)) {
+      oscillating++;
+      item->update();
+    }
+  }
+
+  if (oscillating)
+    emit oscillationDetected(oscillating);
+}
+
+std::vector<Wire_ptr> DiagramScene::getSimulatedWires() const
+{
+  std::vector<Wire_ptr>     res{};
+  std::unordered_set<Wire*> seen{};
+
+  const auto add = [&](const Bus& bus) {
+    for (const auto& w : bus)
+      if (w && seen.insert(w.get()).second)
+        res.push_back(w);
+  };
+
+  for (QGraphicsItem* item : items()) {
+    if (item->type() == WIRE) {
+      add(qgraphicsitem_cast<GraphicalWire*>(item)->getBus());
+      continue;
+    }
+
+    if (item->type() < COMPONENT)
+      continue;
+
+    const auto component =
+        qgraphicsitem_cast<GraphicalLogicComponent*>(item)->getComponent();
+
+    for (const auto& bus : component->getInputs())
+      add(bus);
+    for (const auto& bus : component->getOutputs())
+      add(bus);
   }
 
+  return res;
+}
+
+void DiagramScene::showSimulatedStates()
+{
+  for (QGraphicsItem* item : items()) {
+    switch (item->type()) {
+      case SINGLE_INPUT: {
+        qgraphicsitem_cast<GraphicalInput*>(item)->showOutputState();
+        break;
+      }
+      case SINGLE_OUTPUT: {
+        // An output that isn't wired has no wire on its input
+        const auto output = qgraphicsitem_cast<GraphicalOutputSingle*>(item);
+        output->setState(
+            Wire::safeGetCurrentState(output->getComponent()->getInputs()[0][0]));
+        break;
+      }
+      case WIRE: item->update(); break;
+      default: break;
+    }
+  }
+}
+
+void DiagramScene::endSimulationStep()
+{
+  checkOscillations();
+  emit simulationStepped();
+}
+
+void DiagramScene::setLiveEditing(const bool enabled)
+{
+  liveEditing = enabled;
+
+  // The suspended simulation is dropped: the next one starts from scratch
+  if (!enabled && simulationSuspended) {
+    simulationSuspended = false;
+    resetIO(true);
+  }
+}
+
+void DiagramScene::resetIO(const bool outputs)
+{
+  // TODO: Make a parent IO class with virtual reset method
+
+  for (QGraphicsItem* item : items()) {
+    if (item->type() == SiliconTypes::SINGLE_INPUT)
+      qgraphicsitem_cast<GraphicalInput*>(item)->setState(State::LOW);
+    else if (outputs && item->type() == SiliconTypes::SINGLE_OUTPUT)
+      qgraphicsitem_cast<GraphicalOutputSingle*>(item)->setState(State::LOW);
+  }
+}
+
+int DiagramScene::calculateWiresForComponents(const bool resume)
+{
+  auto wires = items()
+               | std::views::filter([](auto item) { return item->type() == WIRE; })
+               | std::views::transform(
+                   [](auto item) { return qgraphicsitem_cast<GraphicalWire*>(item); })
+               | std::ranges::to<std::vector>();
+
   auto components =
       items() | std::views::filter([](auto item) { return item->type() >= COMPONENT; })
       | std::views::transform(
           [](auto item) { return qgraphicsitem_cast<GraphicalLogicComponent*>(item); })
       | std::ranges::to<std::vector>();
 
-  for (const GraphicalLogicComponent* graphicalComponent : components) {
+  using Connections = std::pair<GraphicalLogicComponent*, std::vector<PortConnection>>;
+
+  std::vector<Connections> connected{};
+  std::vector<Connections> aliases{};
+
+  for (GraphicalLogicComponent* graphicalComponent : components) {
     assert(graphicalComponent);
 
-    // Disconnect the component from all wires (TODO: Make more efficient)
-    graphicalComponent->getComponent()->clearWires();
-
-    // Wires colliding with the component
-    auto collidingWires =
-        collidingItems(graphicalComponent)
-        | std::views::filter([](auto el) { return el->type() == SiliconTypes::WIRE; })
-        | std::views::transform(
-            [](auto el) { return qgraphicsitem_cast<GraphicalWire*>(el); })
-        | std::ranges::to<std::vector>();
-
-    // For each wire that collides with the component we need to find the port the wire
-    // is connected to
-
-    for (GraphicalWire* wire : collidingWires) {
-      const auto vertices = wire->getVertices();
-
-      // Check for collision with input ports
-      for (const auto [index, p] : graphicalComponent->getInputPorts() | silicon::views::enumerate) {
-        const auto portPositionInScene = graphicalComponent->mapToScene(p->getPosition());
-        const auto findResult          = std::ranges::find(vertices, portPositionInScene);
-        if (findResult != vertices.end()) {
-          // If it collides with an input port then we need to set the corresponding input
-          // to the wire's bus itself
-          graphicalComponent->getComponent()->setInput(index, wire->getBus());
-        }
+    auto connections = getPortConnections(graphicalComponent);
+
+    const auto type = graphicalComponent->type();
+    if (type == WIRE_SPLITTER || type == WIRE_MERGER) {
+      graphicalComponent->getComponent()->clearWires();
+      aliases.emplace_back(graphicalComponent, std::move(connections));
+    } else {
+      connected.emplace_back(graphicalComponent, std::move(connections));
+    }
+  }
+
+  // Bits that were aliased by a splitter or a merger are replaced by new wires: if they
+  // still are, they're aliased again to the same bits. The wires that aren't on the
+  // outputs of a splitter or a merger keep theirs, so an unchanged circuit keeps all of
+  // its buses.
+  std::unordered_set<GraphicalWire*> aliased{};
+  for (const auto& [graphicalComponent, connections] : aliases)
+    for (const auto& [isOutput, index, wire] : connections)
+      if (isOutput)
+        aliased.insert(wire);
+
+  std::ranges::stable_partition(
+      wires, [&](GraphicalWire* wire) { return !aliased.contains(wire); });
+
+  std::unordered_set<Wire*> seen{};
+  for (GraphicalWire* wire : wires) {
+    auto bus    = wire->getBus();
+    bool shared = false;
+
+    for (auto& w : bus) {
+      if (w && !seen.insert(w.get()).second) {
+        w      = CircuitArena::make<Wire>(State::ERROR);
+        shared = true;
       }
+    }
 
-      for (const auto [index, p] :
-	     graphicalComponent->getOutputPorts() | silicon::views::enumerate) {
-        const auto portPositionInScene = graphicalComponent->mapToScene(p->getPosition());
-        const auto findResult          = std::ranges::find(vertices, portPositionInScene);
-        if (findResult != vertices.end()) {
-          // If it collides with an output port then we need to set the wire dimension to
-          // match the output dimension and set the corresponding output to the wire's bus
-          // itself
-          auto outputSize =
-              graphicalComponent->getComponent()->getOutputs()[index].size();
-          wire->setBusSize(outputSize);
-          graphicalComponent->getComponent()->setOutput(index, wire->getBus());
-        }
+    if (shared)
+      wire->setBus(std::move(bus));
+  }
+
+  // Set wires to initial state
+  if (!resume) {
+    for (GraphicalWire* wire : wires) {
+      wire->clearBusState();
+    }
+  }
+
+  // If a wire collides with an output port then we need to set the wire dimension to
+  // match the output dimension
+  for (const auto& [graphicalComponent, connections] : connected) {
+    for (const auto& [isOutput, index, wire] : connections) {
+      if (isOutput)
+        wire->setBusSize(graphicalComponent->getComponent()->getOutputs()[index].size());
+    }
+  }
+
+  // Splitters and mergers aren't simulated: the bits on their outputs are the same Wire
+  // objects of their inputs. A chain of them settles after one pass for each of them.
+  // The bits they can't alias, because the splitter doesn't fit or an input of the
+  // merger isn't connected, are new ERROR wires, the same ones for every pass.
+  const auto errors =
+      aliases | std::views::transform([](const Connections& alias) {
+        const auto component = alias.first;
+        if (component->type() == WIRE_SPLITTER)
+          return Bus(qgraphicsitem_cast<GraphicalWireSplitter*>(component)->getSize());
+
+        return Bus(qgraphicsitem_cast<GraphicalWireMerger*>(component)->getSize());
+      })
+      | std::ranges::to<std::vector>();
+
+  for (size_t pass = 0; pass <= aliases.size(); pass++) {
+    bool changed = false;
+
+    const auto setBus = [&](GraphicalWire* wire, Bus bus) {
+      if (wire->getBus() == bus)
+        return;
+
+      wire->setBus(std::move(bus));
+      changed = true;
+    };
+
+    for (size_t i = 0; i < aliases.size(); i++) {
+      const auto& [graphicalComponent, connections] = aliases[i];
+
+      if (graphicalComponent->type() == WIRE_SPLITTER) {
+        // An unconnected splitter doesn't fit, so all of its outputs are ERROR
+        const auto input =
+            std::ranges::find(connections, false, &PortConnection::isOutput);
+        const Bus inputBus = input != connections.end() ? input->wire->getBus() : Bus();
+
+        const auto outputs = WireSplitter::aliasOutputs(inputBus, errors[i]);
+        for (const auto& [isOutput, index, wire] : connections)
+          if (isOutput)
+            setBus(wire, outputs[index]);
+      } else {
+        std::vector<Bus> inputs(errors[i].size());
+        for (const auto& [isOutput, index, wire] : connections)
+          if (!isOutput)
+            inputs[index] = wire->getBus();
+
+        for (const auto& [isOutput, index, wire] : connections)
+          if (isOutput)
+            setBus(wire, WireMerger::aliasOutput(inputs, errors[i]));
       }
     }
+
+    if (!changed)
+      break;
   }
+
+  for (const auto& [graphicalComponent, connections] : aliases) {
+    if (graphicalComponent->type() != WIRE_SPLITTER)
+      continue;
+
+    const auto size =
+        qgraphicsitem_cast<GraphicalWireSplitter*>(graphicalComponent)->getSize();
+
+    for (const auto& [isOutput, index, wire] : connections) {
+      if (isOutput || wire->getBus().size() == size)
+        continue;
+
+      Diagnostics::report(Severity::WARNING, DiagnosticCode::WIDTH_MISMATCH, [&] {
+        return "splitter of " + std::to_string(wire->getBus().size()) + " bits with "
+               + std::to_string(size) + " outputs";
+      });
+    }
+  }
+
+  const std::unordered_set<Component*> wasWired =
+      wiredComponents
+      | std::views::transform([](const Component_ptr& c) { return c.get(); })
+      | std::ranges::to<std::unordered_set>();
+
+  // The outputs of the reconnected and of the removed components: if nothing drives
+  // them anymore they go back to the ERROR state
+  std::vector<Wire_ptr> released{};
+  const auto            disconnect = [&](const Component_ptr& component) {
+    for (const auto& bus : component->getOutputs())
+      for (const auto& w : bus)
+        if (w)
+          released.push_back(w);
+
+    component->clearWires();
+  };
+
+  std::unordered_set<Component*> present{};
+  int                            patched = 0;
+
+  for (const auto& [graphicalComponent, connections] : connected) {
+    const auto component = graphicalComponent->getComponent();
+    present.insert(component.get());
+
+    // Buses of the same size, without any wire, for the unconnected ports
+    auto inputs = component->getInputs()
+                  | std::views::transform([](const Bus& bus) {
+                      return Bus(std::vector<Wire_ptr>(bus.size()));
+                    })
+                  | std::ranges::to<std::vector>();
+    auto outputs = component->getOutputs()
+                   | std::views::transform([](const Bus& bus) {
+                       return Bus(std::vector<Wire_ptr>(bus.size()));
+                     })
+                   | std::ranges::to<std::vector>();
+
+    // The corresponding port is set to the wire's bus itself
+    for (const auto& [isOutput, index, wire] : connections)
+      (isOutput ? outputs : inputs)[index] = wire->getBus();
+
+    const bool unchanged = resume && wasWired.contains(component.get())
+                           && std::ranges::equal(component->getInputs(), inputs)
+                           && std::ranges::equal(component->getOutputs(), outputs);
+    if (unchanged)
+      continue;
+
+    // An input keeps its state if it was only moved to another wire, a new one is LOW
+    const bool isInput    = graphicalComponent->type() == SINGLE_INPUT && resume;
+    const auto inputState = isInput && wasWired.contains(component.get())
+                                ? qgraphicsitem_cast<GraphicalInput*>(graphicalComponent)
+                                      ->getState()
+                                : State::LOW;
+
+    // The outputs first: setting the inputs runs the component's action
+    disconnect(component);
+    for (const auto [index, bus] : outputs | silicon::views::enumerate)
+      component->setOutput(index, bus);
+    for (const auto [index, bus] : inputs | silicon::views::enumerate)
+      component->setInput(index, bus);
+
+    if (isInput)
+      qgraphicsitem_cast<GraphicalInput*>(graphicalComponent)->setState(inputState);
+
+    patched++;
+  }
+
+  for (const auto& component : wiredComponents)
+    if (!present.contains(component.get()))
+      disconnect(component);
+
+  wiredComponents = connected
+                    | std::views::transform([](const Connections& c) {
+                        return c.first->getComponent();
+                      })
+                    | std::ranges::to<std::vector>();
+
+  if (resume) {
+    std::unordered_set<Wire*> driven{};
+    for (const auto& component : wiredComponents)
+      for (const auto& bus : component->getOutputs())
+        for (const auto& w : bus)
+          if (w)
+            driven.insert(w.get());
+
+    for (const auto& w : released)
+      if (!driven.contains(w.get()))
+        w->forceSetCurrentState(State::ERROR);
+  }
+
+  return patched;
+}
+
+std::vector<DiagramScene::PortConnection>
+DiagramScene::getPortConnections(const GraphicalComponent* component) const
+{
+  std::vector<PortConnection> connections{};
+
+  // Wires colliding with the component
+  auto collidingWires =
+      collidingItems(component)
+      | std::views::filter([](auto el) { return el->type() == SiliconTypes::WIRE; })
+      | std::views::transform(
+          [](auto el) { return qgraphicsitem_cast<GraphicalWire*>(el); })
+      | std::ranges::to<std::vector>();
+
+  // For each wire that collides with the component we need to find the port the wire
+  // is connected to
+
+  for (GraphicalWire* wire : collidingWires) {
+    const auto vertices = wire->getVertices();
+
+    const auto isConnected = [&](const Port* p) {
+      const auto portPositionInScene = component->mapToScene(p->getPosition());
+      return std::ranges::find(vertices, portPositionInScene) != vertices.end();
+    };
+
+    for (const auto [index, p] : component->getInputPorts() | silicon::views::enumerate)
+      if (isConnected(p))
+        connections.push_back({false, static_cast<unsigned int>(index), wire});
+
+    for (const auto [index, p] : component->getOutputPorts() | silicon::views::enumerate)
+      if (isConnected(p))
+        connections.push_back({true, static_cast<unsigned int>(index), wire});
+  }
+
+  return connections;
 }
 
 bool DiagramScene::wireAlreadyPresentAtPos(const QPointF cursorPos) const
@@ -437,34 +791,113 @@ void DiagramScene::addComponent(GraphicalComponent* component, QPointF pos)
 }
 
 // TODO: Switch to auto memory management!
-void DiagramScene::placeComponent(const SiliconTypes type)
+GraphicalComponent* DiagramScene::createComponent(const SiliconTypes  type,
+                                                  const unsigned int variant)
 {
-  assert(!componentToBeDrawn);
+  const unsigned int size = std::max(variant, 2u);
+
   switch (type) {
     case UNKNOWN: assert(false && "Unknown component");
-    case SINGLE_INPUT: componentToBeDrawn = new GraphicalInput(); break;
-    case SINGLE_OUTPUT: componentToBeDrawn = new GraphicalOutputSingle(); break;
-    case AND_GATE: componentToBeDrawn = new GraphicalAnd(); break;
-    case NAND_GATE: componentToBeDrawn = new GraphicalNand(); break;
-    case OR_GATE: componentToBeDrawn = new GraphicalOr(); break;
-    case NOR_GATE: componentToBeDrawn = new GraphicalNor(); break;
-    case NOT_GATE: componentToBeDrawn = new GraphicalNot(); break;
-    case XOR_GATE: componentToBeDrawn = new GraphicalXor(); break;
-    case WIRE_SPLITTER: componentToBeDrawn = new GraphicalWireSplitter(); break;
-    case WIRE_MERGER: componentToBeDrawn = new GraphicalWireMerger(); break;
+    case SINGLE_INPUT: return new GraphicalInput();
+    case SINGLE_OUTPUT: return new GraphicalOutputSingle();
+    case AND_GATE: return new GraphicalAnd();
+    case NAND_GATE: return new GraphicalNand();
+    case OR_GATE: return new GraphicalOr();
+    case NOR_GATE: return new GraphicalNor();
+    case NOT_GATE: return new GraphicalNot();
+    case XOR_GATE: return new GraphicalXor();
+    case WIRE_SPLITTER: return new GraphicalWireSplitter(size);
+    case WIRE_MERGER: return new GraphicalWireMerger(size);
+    case SUBCIRCUIT: assert(false && "Subcircuits need their package");
     case HALF_ADDER:
     case FULL_ADDER:
     default: assert(false && "Component not implemented");
   }
+  return nullptr;
+}
+
+void DiagramScene::placeComponent(const SiliconTypes type)
+{
+  placeComponent([type] { return createComponent(type); });
+}
+
+void DiagramScene::placeComponent(ComponentFactory factory)
+{
+  assert(!componentToBeDrawn);
+
+  componentFactory   = std::move(factory);
+  componentToBeDrawn = componentFactory();
 
   // TODO: IMPLEMENT COMPONENT SHADOW TO BE SHOWN WHILE DRAGGING
   setInteractionMode(InteractionMode::COMPONENT_PLACING_MODE);
   setComponentShadow();
   hideCSB();
+
+  // Every time the component is placed we should set its properties
+  componentToBeDrawn->showPropertiesDialog();
+}
+
+void DiagramScene::pushCommand(QUndoCommand* command)
+{
+  if (undoStack) {
+    undoStack->push(command);
+    return;
+  }
+
+  command->redo();
+  delete command;
+}
+
+void DiagramScene::cancelEditing()
+{
+  if (!wireSegmentToBeDrawn && !componentToBeDrawn)
+    return;
+
+  if (wireSegmentToBeDrawn) {
+    wireSegmentToBeDrawn->setGraphicalWire(nullptr);
+    removeItem(wireSegmentToBeDrawn);
+    delete wireSegmentToBeDrawn;
+    wireSegmentToBeDrawn = nullptr;
+  }
+
+  // Leaving COMPONENT_PLACING_MODE deletes the component shadow
+  setInteractionMode(InteractionMode::NORMAL_MODE);
+}
+
+void DiagramScene::clearCircuit()
+{
+  setInteractionMode(InteractionMode::NORMAL_MODE);
+  hideCSB();
+
+  // A new circuit is never resumed
+  simulationSuspended = false;
+  wiredComponents.clear();
+
+  // The commands refer to the items that are going to be deleted
+  if (undoStack)
+    undoStack->clear();
+
+  moveStartPositions.clear();
+
+  // Deleting the top level items deletes their children (ports, segments...) as well
+  const auto topLevelItems = items()
+                             | std::views::filter([](const QGraphicsItem* item) {
+                                 return !item->parentItem();
+                               })
+                             | std::ranges::to<std::vector>();
+
+  for (QGraphicsItem* item : topLevelItems) {
+    removeItem(item);
+    delete item;
+  }
 }
 
 DiagramScene::~DiagramScene()
 {
+  // The undone insertions and the deletions own their items
+  if (undoStack)
+    undoStack->clear();
+
   // Clean up any remaining wire segment being drawn
   if (wireSegmentToBeDrawn) {
     removeItem(wireSegmentToBeDrawn);
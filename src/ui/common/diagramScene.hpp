@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <functional>
 #include <ranges>
 
 #include <QCursor>
@@ -26,13 +27,16 @@
 #include <QGraphicsView>
 #include <QKeyEvent>
 #include <QPainter>
+#include <QPointer>
 #include <QRect>
+#include <QUndoStack>
 
 #include <ui/common/componentSearchBox.hpp>
 #include <ui/common/enums.hpp>
 #include <ui/common/graphicalWire.hpp>
 
 class GraphicalComponent;
+class Port;
 
 class DiagramScene : public QGraphicsScene {
   Q_OBJECT
@@ -45,6 +49,13 @@ public:
     SIMULATION_MODE,
   };
 
+  // A wire connected to one of the ports of a component
+  struct PortConnection {
+    bool           isOutput;
+    unsigned int   index;
+    GraphicalWire* wire;
+  };
+
   explicit DiagramScene(QObject* parent = nullptr);
 
   void                          setInteractionMode(InteractionMode mode);
@@ -66,6 +77,48 @@ public:
 
   void placeComponent(SiliconTypes type);
 
+  // Places the components made by `factory`, one after the other: used for components
+  // that can't be created from their type alone, like subcircuits
+  using ComponentFactory = std::function<GraphicalComponent*()>;
+  void placeComponent(ComponentFactory factory);
+
+  // Removes every component and wire from the scene
+  void clearCircuit();
+
+  // Every edit made in the scene is pushed on `stack`
+  void                      setUndoStack(QUndoStack* stack) { undoStack = stack; }
+  [[nodiscard]] QUndoStack* getUndoStack() const { return undoStack; }
+
+  // Without an undo stack the command is just executed
+  void pushCommand(QUndoCommand* command);
+
+  // Discards the wire segment or the component being drawn, if any
+  void cancelEditing();
+
+  [[nodiscard]] std::vector<PortConnection>
+  getPortConnections(const GraphicalComponent* component) const;
+
+  // The wires being simulated, the ones drawn and the ones of the components, each once
+  [[nodiscard]] std::vector<Wire_ptr> getSimulatedWires() const;
+
+  // Redraws the inputs, the outputs and the wires after their states were restored
+  void showSimulatedStates();
+
+  // Some inputs were changed in SIMULATION_MODE, by the user or by a stimulus: reports
+  // the oscillations and emits simulationStepped()
+  void endSimulationStep();
+
+  // With live editing, leaving SIMULATION_MODE only suspends the simulation: when it's
+  // resumed the components whose connections were edited are reconnected, the others
+  // keep their wires and the whole circuit keeps its state. Without it, every
+  // simulation starts from scratch with the inputs set to LOW.
+  void               setLiveEditing(bool enabled);
+  [[nodiscard]] bool isLiveEditing() const { return liveEditing; }
+
+  // `variant` is the size of variable-sized components (splitters and mergers).
+  // Subcircuits are created from their package instead.
+  static GraphicalComponent* createComponent(SiliconTypes type, unsigned int variant = 0);
+
   static QPointF snapToGrid(QPointF point);
 
   static constexpr int GRID_SIZE = 10;
@@ -78,26 +131,60 @@ public slots:
 signals:
   void modeChanged(InteractionMode mode);
 
+  // Some wires were stuck in the ERROR state because they kept changing
+  void oscillationDetected(int wires);
+
+  // Some inputs were changed in SIMULATION_MODE and the circuit settled
+  void simulationStepped();
+
+  // A suspended simulation was resumed by reconnecting `components` edited components
+  void simulationResumed(int components);
+
 private:
   void drawBackground(QPainter* painter, const QRectF& rect) override;
 
-  void calculateWiresForComponents() const;
+  // Connects the components to the wires. If `resume` only the components whose
+  // connections changed are reconnected: returns how many they are.
+  int calculateWiresForComponents(bool resume);
+
+  // Sets the inputs (and the outputs, if `outputs`) to LOW
+  void resetIO(bool outputs);
+
+  // Emits oscillationDetected() if the last input change made some wires oscillate
+  void checkOscillations();
 
   void setInteractionMode(InteractionMode newMode, bool force);
 
   void mouseMoveEvent(QGraphicsSceneMouseEvent* mouseEvent) override;
   void mousePressEvent(QGraphicsSceneMouseEvent* mouseEvent) override;
+  void mouseReleaseEvent(QGraphicsSceneMouseEvent* mouseEvent) override;
   void keyPressEvent(QKeyEvent* event) override;
 
   InteractionMode currentInteractionMode = InteractionMode::NORMAL_MODE;
 
+  bool liveEditing         = true;
+  bool simulationSuspended = false;
+
+  // The components connected in SIMULATION_MODE, to disconnect the ones removed from the
+  // scene
+  std::vector<Component_ptr> wiredComponents{};
+
   // Wire and component shadows to be used in `WIRE_CREATION_MODE` and
   // `COMPONENT_PLACING_MODE`
   GraphicalComponent*   componentToBeDrawn   = nullptr;
   GraphicalWireSegment* wireSegmentToBeDrawn = nullptr;
 
+  // Creates the next component to be placed in `COMPONENT_PLACING_MODE`
+  ComponentFactory componentFactory{};
+
   ComponentSearchBox* csb = nullptr;
 
+  QPointer<QUndoStack> undoStack = nullptr;
+
+  // Position of the selected components when the mouse was pressed, in order to detect
+  // the moves
+  std::vector<std::pair<GraphicalComponent*, QPointF>> moveStartPositions{};
+
   // Completion map to be used with ComponentSearchBox
   static const inline ComponentSearchBox::SearchMap completionMap = {
       {"INPUT", SiliconTypes::SINGLE_INPUT},
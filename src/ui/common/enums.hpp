@@ -45,6 +45,8 @@ enum SiliconTypes {
   HALF_ADDER,
   FULL_ADDER,
 
+  SUBCIRCUIT,
+
   LOGIFLOW_END,
 };
 
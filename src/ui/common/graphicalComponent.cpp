@@ -102,11 +102,20 @@ void GraphicalComponent::rotate()
   update();
 }
 
+void GraphicalComponent::restorePos(const QPointF pos)
+{
+  checkCollisions = false;
+  setPos(pos);
+  checkCollisions = true;
+
+  collidingStatus = NOT_COLLIDING;
+}
+
 QVariant GraphicalComponent::itemChange(GraphicsItemChange change, const QVariant& value)
 {
   // TODO: Implement with QGraphicsItem::ItemRotationChange for rotations
 
-  if (!scene())
+  if (!scene() || !checkCollisions)
     return QGraphicsItem::itemChange(change, value);
 
   if (change == ItemPositionChange) {
@@ -277,7 +286,14 @@ QPoint GraphicalComponent::scanImage(const QImage& image, const QPoint& initialP
   return initialPoint;
 }
 
-void GraphicalComponent::setPortLine(Port* port)
+void GraphicalComponent::setGeometryKey(const SiliconTypes type,
+                                        const unsigned int variant)
+{
+  this->geometryType    = type;
+  this->geometryVariant = variant;
+}
+
+QPoint GraphicalComponent::projectPortOnShape(const QPoint portPos) const
 {
   assert(itemShape);
 
@@ -288,12 +304,14 @@ void GraphicalComponent::setPortLine(Port* port)
   const auto shapeSize = shapeRect.size().toSize();
   assert(shapeSize.width() > 0 && shapeSize.height() > 0);
 
-  // Create an image that supports transparency in order to alpha-scan
-  auto image = QImage(shapeSize, QImage::Format_ARGB32);
+  // Paint the shape on an image that supports transparency in order to alpha-scan it.
+  // Components that don't need scanning skip the (expensive) rasterization entirely.
+  QImage image{};
 
-  // Paint the shape on the image
   if (this->scanShape) {
+    image = QImage(shapeSize, QImage::Format_ARGB32);
     image.fill(Qt::transparent);
+
     QPainter painter(&image);
     painter.setRenderHint(QPainter::Antialiasing);
     painter.translate(-shapeRect.topLeft());
@@ -309,35 +327,71 @@ void GraphicalComponent::setPortLine(Port* port)
   const auto bottomRightY = shapeRect.bottomRight().y();
 
   // Get port position
-  const auto portPos = port->getPosition();
-  const auto portX   = portPos.x();
-  const auto portY   = portPos.y();
-
-  // Find the projection of the port on the shape
-  QPoint projectionOnShape{};
+  const auto portX = portPos.x();
+  const auto portY = portPos.y();
 
   // Left side
-  if (portX < topLeftX) {
-    projectionOnShape = scanImage(image, QPoint(topLeftX, portY), true, true);
-  }
+  if (portX < topLeftX)
+    return scanImage(image, QPoint(topLeftX, portY), true, true);
+
   // Right side
-  else if (portX > bottomRightX) {
-    projectionOnShape = scanImage(image, QPoint(bottomRightX, portY), true, false);
-  }
+  if (portX > bottomRightX)
+    return scanImage(image, QPoint(bottomRightX, portY), true, false);
+
   // Up side
-  else if (portY < topLeftY) {
-    projectionOnShape = scanImage(image, QPoint(portX, topLeftY), false, true);
-  }
+  if (portY < topLeftY)
+    return scanImage(image, QPoint(portX, topLeftY), false, true);
+
   // Down side
-  else if (portY > bottomRightY) {
-    projectionOnShape = scanImage(image, QPoint(portX, bottomRightY), false, false);
-  } else
-    assert(false);
+  if (portY > bottomRightY)
+    return scanImage(image, QPoint(portX, bottomRightY), false, false);
+
+  assert(false);
+  return portPos;
+}
+
+void GraphicalComponent::setPortLine(Port* port)
+{
+  const auto portPos = port->getPosition();
+
+  // Find the projection of the port on the shape. Components that registered a geometry
+  // key share the projection with every other instance of the same kind.
+  QPoint projectionOnShape{};
+
+  if (this->geometryType == UNKNOWN) {
+    projectionOnShape = projectPortOnShape(portPos);
+  } else {
+    const PortGeometryRegistry::Key key{this->geometryType, this->geometryVariant,
+                                        portPos.x(), portPos.y()};
+
+    if (const auto cached = PortGeometryRegistry::find(key)) {
+      projectionOnShape = *cached;
+    } else {
+      projectionOnShape = projectPortOnShape(portPos);
+      PortGeometryRegistry::insert(key, projectionOnShape);
+    }
+  }
 
   // Create the line from port position to the projection
   port->setLine(new QGraphicsLineItem(QLineF(portPos, projectionOnShape), this));
 }
 
+std::optional<QPoint> PortGeometryRegistry::find(const Key& key)
+{
+  const auto& registry = getRegistry();
+  const auto  it       = registry.find(key);
+
+  if (it == registry.end())
+    return std::nullopt;
+
+  return it->second;
+}
+
+void PortGeometryRegistry::insert(const Key& key, const QPoint projection)
+{
+  getRegistry().insert_or_assign(key, projection);
+}
+
 Port::Port(const unsigned int index, const QPoint position, std::string name,
            QGraphicsItem* parent)
   : QGraphicsItem(parent)
@@ -29,6 +29,10 @@
 #include <QPushButton>
 #include <QVBoxLayout>
 
+#include <map>
+#include <optional>
+#include <tuple>
+
 #include <core/component.hpp>
 #include <ui/common/diagramScene.hpp>
 
@@ -64,6 +68,26 @@ public:
   [[nodiscard]] QRectF collisionRect() const;
 };
 
+// The port lines only depend on the shape of the component and on the position of the
+// port, so they are computed once for each kind of component (and size, for components
+// like splitters and mergers) and then shared by every instance.
+class PortGeometryRegistry {
+public:
+  // (Component type, size variant, port x, port y)
+  using Key = std::tuple<int, unsigned int, int, int>;
+
+  static std::optional<QPoint> find(const Key& key);
+  static void                  insert(const Key& key, QPoint projection);
+
+private:
+  // Little hack to prevent static initialization order issues
+  static std::map<Key, QPoint>& getRegistry()
+  {
+    static std::map<Key, QPoint> registry{};
+    return registry;
+  }
+};
+
 class PropertiesDialog : public QDialog {
 public:
   explicit PropertiesDialog(const QList<QWidget*>& widgets, QWidget* parent = nullptr);
@@ -92,6 +116,10 @@ protected:
 
   void setPortLine(Port* port);
 
+  // Must be called before `setPorts` in order to share the port geometry with the other
+  // components of the same kind
+  void setGeometryKey(SiliconTypes type, unsigned int variant = 0);
+
   bool scanShape = false;
 
   PropertiesDialog* propertiesDialog = nullptr;
@@ -109,6 +137,10 @@ public:
   void               rotate();
   [[nodiscard]] bool isColliding() const { return collidingStatus != NOT_COLLIDING; }
 
+  // Moves the component without checking for collisions: used when undoing a move, since
+  // the previous position was valid when the components were moved away from it
+  void restorePos(QPointF pos);
+
   virtual void
   setPorts(const std::vector<std::pair<std::string, QPoint>>& busToPortInputs,
            const std::vector<std::pair<std::string, QPoint>>& busToPortOutputs);
@@ -121,5 +153,12 @@ public:
 private:
   QPoint scanImage(const QImage& image, const QPoint& initialPoint, bool coordinate,
                    bool direction) const;
+  QPoint projectPortOnShape(QPoint portPos) const;
+
   QGraphicsItem* itemShape = nullptr;
+
+  SiliconTypes geometryType    = UNKNOWN;
+  unsigned int geometryVariant = 0;
+
+  bool checkCollisions = true;
 };
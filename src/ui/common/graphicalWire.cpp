@@ -79,6 +79,10 @@ QPainterPath GraphicalWire::shape() const
 }
 QColor GraphicalWire::getColor()
 {
+  // The wire was stuck in the ERROR state by an oscillation
+  if (std::ranges::any_of(bus, [](const Wire_ptr& w) { return w && w->isOscillating(); }))
+    return AppColors::VIOLET;
+
   return bus.size() > 1 ? AppColors::GREEN : AppColors::BLUE;
 }
 
@@ -109,9 +113,12 @@ void GraphicalWire::paint(QPainter* painter, const QStyleOptionGraphicsItem* opt
 
 void GraphicalWire::clearBusState()
 {
-  for (unsigned int i = 0; i < this->bus.size(); i++)
-    if (bus[i])
+  for (unsigned int i = 0; i < this->bus.size(); i++) {
+    if (bus[i]) {
       bus[i]->forceSetCurrentState(State::ERROR);
+      bus[i]->clearOscillation();
+    }
+  }
 }
 GraphicalWireSegment* GraphicalWire::segmentAtPoint(const QPointF point) const
 {
@@ -202,10 +209,32 @@ GraphicalWireSegment::GraphicalWireSegment(QPointF firstPoint, QGraphicsItem* pa
   updatePath();
 }
 
+GraphicalWireSegment::GraphicalWireSegment(const std::vector<QPointF>& points,
+                                           QGraphicsItem*              parent)
+  : QGraphicsItem(parent)
+{
+  assert(!points.empty());
+
+  setFlag(QGraphicsItem::ItemSendsGeometryChanges);
+  setFlag(QGraphicsItem::ItemIsSelectable, false);
+
+  this->points = points;
+  updatePath();
+}
+
 void GraphicalWireSegment::setGraphicalWire(GraphicalWire* graphicalWire)
 {
+  // A segment belongs to a single wire
+  if (this->graphicalWire && this->graphicalWire != graphicalWire)
+    this->graphicalWire->removeSegment(this);
+
   setParentItem(graphicalWire);
 
+  if (!graphicalWire) {
+    this->graphicalWire = nullptr;
+    return;
+  }
+
   // The flag is deleted by QGraphicsItem::setParentItem()
   graphicalWire->setFlag(QGraphicsItem::ItemIsSelectable);
   graphicalWire->setFlag(QGraphicsItem::ItemSendsGeometryChanges);
@@ -20,6 +20,7 @@
 
 #include <cassert>
 #include <ranges>
+#include <unordered_set>
 #include <vector>
 
 #include <QGraphicsItem>
@@ -54,6 +55,8 @@ class GraphicalWire;
 class GraphicalWireSegment : public QGraphicsItem {
 public:
   explicit GraphicalWireSegment(QPointF firstPoint, QGraphicsItem* parent = nullptr);
+  explicit GraphicalWireSegment(const std::vector<QPointF>& points,
+                                QGraphicsItem*              parent = nullptr);
   int type() const override { return SiliconTypes::WIRE_SEGMENT; }
 
   void paint(QPainter* painter, const QStyleOptionGraphicsItem* option,
@@ -69,6 +72,8 @@ public:
   void                 setShowPoints(const std::vector<QPointF>& showPoints);
   std::vector<QPointF> getShowPoints() { return showPoints; }
 
+  [[nodiscard]] const std::vector<QPointF>& getPoints() const { return points; }
+
   QPointF lastPoint() const { return points[points.size() - 1]; }
   QPointF firstPoint() const { return points[0]; }
   QPointF lastShowPoint() const { return points[showPoints.size() - 1]; }
@@ -76,7 +81,9 @@ public:
   bool empty() const { return points.size() == 1; }
 
   GraphicalWire* getGraphicalWire() const { return graphicalWire; }
-  void           setGraphicalWire(GraphicalWire* graphicalWire);
+
+  // nullptr detaches the segment from its wire
+  void setGraphicalWire(GraphicalWire* graphicalWire);
 
   QRectF boundingRect() const override;
 
@@ -121,6 +128,11 @@ public:
   void paint(QPainter* painter, const QStyleOptionGraphicsItem* option,
              QWidget* widget) override;
 
+  [[nodiscard]] const std::unordered_set<GraphicalWireSegment*>& getSegments() const
+  {
+    return segments;
+  }
+
   [[nodiscard]] GraphicalWireSegment* segmentAtPoint(QPointF point) const;
   [[nodiscard]] std::vector<QPointF>  getJunctions() const;
   [[nodiscard]] std::vector<QPointF>  getVertices() const;
@@ -0,0 +1,204 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "sceneCommands.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+SceneCommand::SceneCommand(DiagramScene* scene, const QString& text)
+  : QUndoCommand(text), scene(scene)
+{}
+
+void SceneCommand::undo()
+{
+  // A wire or a component being drawn could refer to the items of the command
+  scene->cancelEditing();
+
+  revert();
+  applied = false;
+}
+
+void SceneCommand::redo()
+{
+  // The first redo() happens when the command is pushed, during the edit itself
+  if (pushed)
+    scene->cancelEditing();
+
+  pushed = true;
+
+  apply();
+  applied = true;
+}
+
+/* ITEMS */
+
+ItemsCommand::ItemsCommand(DiagramScene* scene, const Kind kind,
+                           const QList<QGraphicsItem*>& items, const QString& text)
+  : SceneCommand(scene, text), kind(kind), items(items)
+{}
+
+ItemsCommand::~ItemsCommand()
+{
+  if (ownsItems())
+    qDeleteAll(items);
+}
+
+void ItemsCommand::apply()
+{
+  if (kind == Kind::ADD)
+    insertItems();
+  else
+    removeItems();
+}
+
+void ItemsCommand::revert()
+{
+  if (kind == Kind::ADD)
+    removeItems();
+  else
+    insertItems();
+}
+
+void ItemsCommand::insertItems()
+{
+  for (QGraphicsItem* item : items)
+    if (item->scene() != scene)
+      scene->addItem(item);
+}
+
+void ItemsCommand::removeItems()
+{
+  for (QGraphicsItem* item : items) {
+    if (item->scene() != scene)
+      continue;
+
+    item->setSelected(false);
+    scene->removeItem(item);
+  }
+}
+
+/* WIRE SEGMENT */
+
+WireSegmentCommand::WireSegmentCommand(DiagramScene* scene, GraphicalWireSegment* segment,
+                                       GraphicalWire* wire, const bool isNewWire)
+  : SceneCommand(scene, QObject::tr("Draw wire")), segment(segment), wire(wire),
+    isNewWire(isNewWire)
+{}
+
+WireSegmentCommand::~WireSegmentCommand()
+{
+  if (isApplied())
+    return;
+
+  // The segment is detached, so it can be deleted before the wire
+  delete segment;
+  if (isNewWire)
+    delete wire;
+}
+
+void WireSegmentCommand::apply()
+{
+  if (isNewWire && wire->scene() != scene)
+    scene->addItem(wire);
+
+  if (segment->getGraphicalWire() != wire)
+    segment->setGraphicalWire(wire);
+}
+
+void WireSegmentCommand::revert()
+{
+  segment->setGraphicalWire(nullptr);
+  if (segment->scene())
+    scene->removeItem(segment);
+
+  if (isNewWire && wire->scene()) {
+    wire->setSelected(false);
+    scene->removeItem(wire);
+  }
+}
+
+/* MOVE */
+
+MoveCommand::MoveCommand(DiagramScene* scene, std::vector<Delta> deltas)
+  : SceneCommand(scene, QObject::tr("Move")), deltas(std::move(deltas))
+{}
+
+bool MoveCommand::mergeWith(const QUndoCommand* other)
+{
+  const auto& next = static_cast<const MoveCommand*>(other)->deltas;
+
+  const bool sameComponents = std::ranges::equal(
+      deltas, next, {}, &Delta::component, &Delta::component);
+
+  if (!sameComponents)
+    return false;
+
+  for (size_t i = 0; i < deltas.size(); i++)
+    deltas[i].newPos = next[i].newPos;
+
+  setObsolete(std::ranges::all_of(deltas, [](const Delta& d) {
+    return d.oldPos == d.newPos;
+  }));
+
+  return true;
+}
+
+void MoveCommand::apply()
+{
+  for (const auto& [component, oldPos, newPos] : deltas)
+    if (component->pos() != newPos)
+      component->restorePos(newPos);
+}
+
+void MoveCommand::revert()
+{
+  for (const auto& [component, oldPos, newPos] : deltas)
+    component->restorePos(oldPos);
+}
+
+/* ROTATE */
+
+RotateCommand::RotateCommand(DiagramScene* scene, GraphicalComponent* component,
+                             const qreal oldRotation, const qreal newRotation)
+  : SceneCommand(scene, QObject::tr("Rotate")), component(component),
+    oldRotation(oldRotation), newRotation(newRotation)
+{}
+
+bool RotateCommand::mergeWith(const QUndoCommand* other)
+{
+  const auto next = static_cast<const RotateCommand*>(other);
+  if (next->component != component)
+    return false;
+
+  newRotation = next->newRotation;
+  setObsolete(std::fmod(newRotation - oldRotation, 360) == 0);
+
+  return true;
+}
+
+void RotateCommand::apply()
+{
+  component->setRotation(newRotation);
+  component->update();
+}
+
+void RotateCommand::revert()
+{
+  component->setRotation(oldRotation);
+  component->update();
+}
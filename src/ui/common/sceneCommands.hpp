@@ -0,0 +1,150 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <vector>
+
+#include <QGraphicsItem>
+#include <QList>
+#include <QPointF>
+#include <QUndoCommand>
+
+#include <ui/common/diagramScene.hpp>
+#include <ui/common/graphicalComponent.hpp>
+#include <ui/common/graphicalWire.hpp>
+
+/* The edits of a DiagramScene, as QUndoCommands.
+ *
+ * Commands only store what changes: the affected items and their old and new positions
+ * or rotations, never a copy of the scene. Items removed from the scene are kept alive by
+ * the command that removed them (or by the undone command that added them) and deleted
+ * together with it.
+ *
+ * redo() can be called on a change that was already made by the user (e.g. an item
+ * dragged by the mouse): every command checks the current state first. */
+
+class SceneCommand : public QUndoCommand {
+public:
+  enum Id {
+    MOVE = 1,
+    ROTATE,
+  };
+
+  SceneCommand(DiagramScene* scene, const QString& text);
+
+  void undo() final;
+  void redo() final;
+
+protected:
+  virtual void apply()  = 0;
+  virtual void revert() = 0;
+
+  [[nodiscard]] bool isApplied() const { return applied; }
+
+  DiagramScene* scene;
+
+private:
+  bool applied = false;
+  bool pushed  = false;
+};
+
+// Placing, pasting and deleting components and wires
+class ItemsCommand : public SceneCommand {
+public:
+  enum class Kind {
+    ADD,
+    REMOVE,
+  };
+
+  ItemsCommand(DiagramScene* scene, Kind kind, const QList<QGraphicsItem*>& items,
+               const QString& text);
+  ~ItemsCommand() override;
+
+protected:
+  void apply() override;
+  void revert() override;
+
+private:
+  void insertItems();
+  void removeItems();
+
+  // Whether the command currently owns the items
+  [[nodiscard]] bool ownsItems() const { return isApplied() == (kind == Kind::REMOVE); }
+
+  Kind                  kind;
+  QList<QGraphicsItem*> items;
+};
+
+// A segment drawn in WIRE_CREATION_MODE. `isNewWire` is true if the wire was created for
+// the segment, in that case it's removed along with it.
+class WireSegmentCommand : public SceneCommand {
+public:
+  WireSegmentCommand(DiagramScene* scene, GraphicalWireSegment* segment,
+                     GraphicalWire* wire, bool isNewWire);
+  ~WireSegmentCommand() override;
+
+protected:
+  void apply() override;
+  void revert() override;
+
+private:
+  GraphicalWireSegment* segment;
+  GraphicalWire*        wire;
+  bool                  isNewWire;
+};
+
+// Consecutive moves of the same components are merged
+class MoveCommand : public SceneCommand {
+public:
+  struct Delta {
+    GraphicalComponent* component;
+    QPointF             oldPos;
+    QPointF             newPos;
+  };
+
+  MoveCommand(DiagramScene* scene, std::vector<Delta> deltas);
+
+  [[nodiscard]] int id() const override { return MOVE; }
+  bool              mergeWith(const QUndoCommand* other) override;
+
+protected:
+  void apply() override;
+  void revert() override;
+
+private:
+  std::vector<Delta> deltas;
+};
+
+// Consecutive rotations of the same component are merged
+class RotateCommand : public SceneCommand {
+public:
+  RotateCommand(DiagramScene* scene, GraphicalComponent* component, qreal oldRotation,
+                qreal newRotation);
+
+  [[nodiscard]] int id() const override { return ROTATE; }
+  bool              mergeWith(const QUndoCommand* other) override;
+
+protected:
+  void apply() override;
+  void revert() override;
+
+private:
+  GraphicalComponent* component;
+  qreal               oldRotation;
+  qreal               newRotation;
+};
@@ -0,0 +1,446 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "sceneSerializer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <map>
+#include <memory>
+#include <set>
+#include <unordered_map>
+
+#include <QSet>
+#include <QtMath>
+
+#include <ui/common/graphicalWire.hpp>
+#include <ui/logiFlow/components/graphicalLogicComponent.hpp>
+#include <ui/logiFlow/components/graphicalSubcircuit.hpp>
+#include <ui/logiFlow/components/graphicalUtils.hpp>
+
+namespace {
+
+// The names stored in the files: they must never change, even if the enum does
+// Adders can't be created in a scene yet, so they aren't listed: they're loaded as
+// UNKNOWN components and skipped
+constexpr std::array<std::pair<SiliconTypes, std::string_view>, 11> TYPE_NAMES = {{
+    {SINGLE_INPUT, "SINGLE_INPUT"},
+    {SINGLE_OUTPUT, "SINGLE_OUTPUT"},
+    {WIRE_SPLITTER, "WIRE_SPLITTER"},
+    {WIRE_MERGER, "WIRE_MERGER"},
+    {AND_GATE, "AND_GATE"},
+    {NAND_GATE, "NAND_GATE"},
+    {OR_GATE, "OR_GATE"},
+    {NOR_GATE, "NOR_GATE"},
+    {NOT_GATE, "NOT_GATE"},
+    {XOR_GATE, "XOR_GATE"},
+    {SUBCIRCUIT, CircuitDocument::SUBCIRCUIT_TYPE},
+}};
+
+std::pair<qreal, qreal> toPair(const QPointF p)
+{
+  return {p.x(), p.y()};
+}
+
+CircuitDocument::PointRecord toRecord(const QPointF p)
+{
+  return {qRound(p.x()), qRound(p.y())};
+}
+
+// Used to sort items by position, in order to get the same file for the same circuit
+bool before(const QPointF a, const QPointF b)
+{
+  return std::pair(a.y(), a.x()) < std::pair(b.y(), b.x());
+}
+
+QPointF firstPoint(const GraphicalWire* wire)
+{
+  QPointF res{};
+  bool    first = true;
+
+  for (const auto segment : wire->getSegments()) {
+    if (first || before(segment->firstPoint(), res))
+      res = segment->firstPoint();
+    first = false;
+  }
+
+  return res;
+}
+
+CircuitLayout::Footprint measure(const GraphicalComponent& component)
+{
+  // The component is never added to a scene, so its scene coordinates are the local ones
+  const auto rect = component.sceneBoundingRect();
+
+  CircuitLayout::Footprint res{};
+  res.left   = qFloor(rect.left());
+  res.top    = qFloor(rect.top());
+  res.right  = qCeil(rect.right());
+  res.bottom = qCeil(rect.bottom());
+
+  for (const Port* port : component.getInputPorts())
+    res.inputs.push_back(toRecord(port->getPosition()));
+
+  for (const Port* port : component.getOutputPorts())
+    res.outputs.push_back(toRecord(port->getPosition()));
+
+  return res;
+}
+
+// Packages of the definitions in `doc`, nullptr for the ones that can't be compiled
+std::vector<SubcircuitPackage_ptr> packagesOf(const CircuitDocument& doc)
+{
+  std::vector<SubcircuitPackage_ptr> res{};
+  res.reserve(doc.subcircuits.size());
+
+  for (const auto& source : doc.subcircuits) {
+    auto package = CircuitCompiler::package(source);
+    res.push_back(package ? std::move(*package) : nullptr);
+  }
+
+  return res;
+}
+
+unsigned int variantOf(const GraphicalComponent* component)
+{
+  switch (component->type()) {
+    case WIRE_SPLITTER:
+      return static_cast<const GraphicalWireSplitter*>(component)->getSize();
+    case WIRE_MERGER:
+      return static_cast<const GraphicalWireMerger*>(component)->getSize();
+    default: return 0;
+  }
+}
+
+}  // namespace
+
+std::string_view SceneSerializer::typeName(const SiliconTypes type)
+{
+  for (const auto& [t, name] : TYPE_NAMES)
+    if (t == type)
+      return name;
+
+  return "UNKNOWN";
+}
+
+SiliconTypes SceneSerializer::typeFromName(const std::string_view name)
+{
+  for (const auto& [type, n] : TYPE_NAMES)
+    if (n == name)
+      return type;
+
+  return UNKNOWN;
+}
+
+CircuitLayout::Footprint SceneSerializer::footprint(const SiliconTypes  type,
+                                                    const unsigned int variant)
+{
+  const std::unique_ptr<GraphicalComponent> component(
+      DiagramScene::createComponent(type, variant));
+
+  return measure(*component);
+}
+
+CircuitLayout::FootprintProvider
+SceneSerializer::footprintProvider(const CircuitDocument& doc)
+{
+  using Key = std::pair<std::string, uint32_t>;
+
+  std::map<Key, CircuitLayout::Footprint> footprints{};
+
+  const auto packages = packagesOf(doc);
+
+  const auto add = [&](const std::string_view name, const uint32_t variant) {
+    const auto type = typeFromName(name);
+
+    if (type == SUBCIRCUIT) {
+      if (variant < packages.size() && packages[variant]
+          && !footprints.contains(Key(name, variant)))
+        footprints.emplace(Key(name, variant),
+                           measure(GraphicalSubcircuit(packages[variant])));
+      return;
+    }
+
+    // Adders can't be created yet, the layout gives them a default shape
+    if (type == UNKNOWN)
+      return;
+
+    if (!footprints.contains(Key(name, variant)))
+      footprints.emplace(Key(name, variant), footprint(type, variant));
+  };
+
+  // The ones generated by CircuitLayout::fromNetlist
+  for (const auto type : {SINGLE_INPUT, SINGLE_OUTPUT, AND_GATE, NAND_GATE, OR_GATE,
+                          NOR_GATE, NOT_GATE, XOR_GATE})
+    add(typeName(type), 0);
+
+  for (const auto& c : doc.components)
+    add(doc.getTypeName(c), c.variant);
+
+  return [footprints = std::move(footprints)](const std::string_view name,
+                                              const uint32_t         variant) {
+    const auto it = footprints.find(Key(name, variant));
+    return it != footprints.end() ? it->second : CircuitLayout::Footprint{};
+  };
+}
+
+CircuitDocument SceneSerializer::serialize(const DiagramScene*          scene,
+                                           const QList<QGraphicsItem*>& items)
+{
+  CircuitDocument doc{};
+
+  auto components = items | std::views::filter([scene](const QGraphicsItem* item) {
+                      return item->type() >= COMPONENT
+                             && item != scene->getComponentToBeDrawn();
+                    })
+                    | std::views::transform([](QGraphicsItem* item) {
+                        return qgraphicsitem_cast<GraphicalLogicComponent*>(item);
+                      })
+                    | std::ranges::to<std::vector>();
+
+  auto wires = items
+               | std::views::filter([](const QGraphicsItem* item) {
+                   return item->type() == WIRE;
+                 })
+               | std::views::transform([](QGraphicsItem* item) {
+                   return qgraphicsitem_cast<GraphicalWire*>(item);
+                 })
+               | std::ranges::to<std::vector>();
+
+  std::ranges::sort(components, [](const auto a, const auto b) {
+    return before(a->pos(), b->pos());
+  });
+
+  std::ranges::sort(wires, [](const auto a, const auto b) {
+    return before(firstPoint(a), firstPoint(b));
+  });
+
+  /* NETLIST */
+
+  std::unordered_map<const GraphicalWire*, uint32_t>     netIds{};
+  std::unordered_map<const SubcircuitPackage*, uint32_t> definitionIds{};
+
+  for (const GraphicalWire* wire : wires)
+    netIds.emplace(wire, doc.addNet(wire->getBus().size()));
+
+  for (const GraphicalLogicComponent* component : components) {
+    std::vector inputs(component->getInputPorts().size(), CircuitDocument::NO_NET);
+    std::vector outputs(component->getOutputPorts().size(), CircuitDocument::NO_NET);
+
+    for (const auto& [isOutput, index, wire] : scene->getPortConnections(component)) {
+      const auto it = netIds.find(wire);
+      if (it == netIds.end())
+        continue;  // The wire is not part of the items to be serialized
+
+      (isOutput ? outputs : inputs)[index] = it->second;
+    }
+
+    const auto name = component->getComponent() ? component->getComponent()->getName()
+                                                : std::string{};
+
+    uint32_t variant = variantOf(component);
+
+    // Every package is stored once, its instances refer to it by index
+    if (component->type() == SUBCIRCUIT) {
+      const auto subcircuit = static_cast<const GraphicalSubcircuit*>(component);
+      const auto& package   = subcircuit->getPackage();
+
+      const auto [it, inserted] =
+          definitionIds.try_emplace(package.get(), doc.subcircuits.size());
+      if (inserted)
+        doc.subcircuits.push_back(package->source);
+
+      variant = it->second;
+    }
+
+    const auto id =
+        doc.addComponent(typeName(static_cast<SiliconTypes>(component->type())), name,
+                         variant, inputs, outputs);
+
+    /* GEOMETRY */
+
+    const auto pos = toRecord(component->pos());
+    doc.setPlacement(id, {pos.x, pos.y, qRound(component->rotation()), 0});
+  }
+
+  for (const GraphicalWire* wire : wires) {
+    auto segments = wire->getSegments() | std::ranges::to<std::vector>();
+
+    std::ranges::sort(segments, [](const auto a, const auto b) {
+      return before(a->firstPoint(), b->firstPoint());
+    });
+
+    for (const GraphicalWireSegment* segment : segments) {
+      const auto points = segment->getPoints()
+                          | std::views::transform([segment](const QPointF p) {
+                              return toRecord(segment->mapToScene(p));
+                            })
+                          | std::ranges::to<std::vector>();
+
+      doc.addSegment(netIds.at(wire), points);
+    }
+  }
+
+  return doc;
+}
+
+QList<QGraphicsItem*> SceneSerializer::deserialize(DiagramScene*          scene,
+                                                   const CircuitDocument& doc,
+                                                   const QPointF          offset)
+{
+  return deserialize(scene, doc, std::span(&offset, 1));
+}
+
+QList<QGraphicsItem*> SceneSerializer::deserialize(DiagramScene*                  scene,
+                                                   const CircuitDocument&         doc,
+                                                   const std::span<const QPointF> offsets)
+{
+  assert(doc.hasGeometry() || doc.components.empty());
+
+  QList<QGraphicsItem*> created{};
+  created.reserve(offsets.size() * (doc.components.size() + doc.nets.size()));
+
+  // Inserting many items would update the scene index each time: it's rebuilt once at the
+  // end instead
+  const auto indexMethod = scene->itemIndexMethod();
+  scene->setItemIndexMethod(QGraphicsScene::NoIndex);
+
+  // Every copy shares the same definitions
+  const auto packages = packagesOf(doc);
+
+  for (const QPointF offset : offsets)
+    addCopy(scene, doc, packages, offset, created);
+
+  scene->setItemIndexMethod(indexMethod);
+  return created;
+}
+
+std::map<std::string, size_t>
+SceneSerializer::skippedComponents(const CircuitDocument& doc)
+{
+  std::map<std::string, size_t> res{};
+
+  for (const auto& c : doc.components) {
+    const auto name = doc.getTypeName(c);
+    if (typeFromName(name) == UNKNOWN)
+      res[std::string(name)]++;
+  }
+
+  return res;
+}
+
+void SceneSerializer::addCopy(DiagramScene* scene, const CircuitDocument& doc,
+                              const std::span<const SubcircuitPackage_ptr> packages,
+                              const QPointF offset, QList<QGraphicsItem*>& created)
+{
+  for (const auto& [index, c] : doc.components | silicon::views::enumerate) {
+    const auto type = typeFromName(doc.getTypeName(c));
+
+    // Components unknown to this version of Silicon are skipped
+    if (type == UNKNOWN)
+      continue;
+
+    if (type == SUBCIRCUIT && !packages[c.variant])
+      continue;
+
+    GraphicalComponent* component =
+        type == SUBCIRCUIT ? new GraphicalSubcircuit(packages[c.variant])
+                           : DiagramScene::createComponent(type, c.variant);
+
+    const auto logicComponent = dynamic_cast<GraphicalLogicComponent*>(component);
+    if (logicComponent && logicComponent->getComponent())
+      logicComponent->getComponent()->setName(doc.getString(c.name));
+
+    const auto& placement = doc.placements[index];
+    component->setRotation(placement.rotation);
+    scene->addComponent(component, QPointF(placement.x, placement.y) + offset);
+
+    created.push_back(component);
+  }
+
+  std::vector<GraphicalWire*> wires(doc.nets.size(), nullptr);
+
+  for (const auto& s : doc.segments) {
+    if (s.pointCount == 0)
+      continue;
+
+    auto& wire = wires[s.net];
+    if (!wire) {
+      wire = new GraphicalWire();
+      wire->setBus(Bus(std::max(doc.nets[s.net].width, 1u)));
+    }
+
+    const auto points = doc.getPoints(s)
+                        | std::views::transform([offset](const auto p) {
+                            return QPointF(p.x, p.y) + offset;
+                          })
+                        | std::ranges::to<std::vector>();
+
+    const auto segment = new GraphicalWireSegment(points);
+    segment->setGraphicalWire(wire);
+  }
+
+  for (GraphicalWire* wire : wires) {
+    if (!wire)
+      continue;
+
+    scene->addItem(wire);
+    created.push_back(wire);
+  }
+}
+
+QList<QGraphicsItem*>
+SceneSerializer::selectionWithInternalWires(const DiagramScene* scene)
+{
+  QList<QGraphicsItem*> res = scene->selectedItems();
+
+  const auto components = res | std::views::filter([scene](const QGraphicsItem* item) {
+                            return item->type() >= COMPONENT
+                                   && item != scene->getComponentToBeDrawn();
+                          })
+                          | std::views::transform([](QGraphicsItem* item) {
+                              return qgraphicsitem_cast<GraphicalComponent*>(item);
+                            })
+                          | std::ranges::to<std::vector>();
+
+  // Ports of the selected components, and the wires connected to them
+  std::set<std::pair<qreal, qreal>> ports{};
+  QSet<GraphicalWire*>              candidates{};
+
+  for (const GraphicalComponent* component : components) {
+    for (const Port* port : component->getInputPorts())
+      ports.insert(toPair(component->mapToScene(port->getPosition())));
+    for (const Port* port : component->getOutputPorts())
+      ports.insert(toPair(component->mapToScene(port->getPosition())));
+
+    for (const auto& connection : scene->getPortConnections(component))
+      candidates.insert(connection.wire);
+  }
+
+  for (GraphicalWire* wire : candidates) {
+    if (wire->isSelected())
+      continue;
+
+    const auto vertices = wire->getVertices();
+    if (std::ranges::all_of(vertices, [&ports](const QPointF p) {
+          return ports.contains(toPair(p));
+        }))
+      res.push_back(wire);
+  }
+
+  return res;
+}
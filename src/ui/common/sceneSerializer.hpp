@@ -0,0 +1,80 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <map>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include <QGraphicsItem>
+#include <QList>
+#include <QPointF>
+
+#include <io/circuitCompiler.hpp>
+#include <io/circuitFile.hpp>
+#include <io/circuitLayout.hpp>
+#include <ui/common/diagramScene.hpp>
+#include <ui/common/enums.hpp>
+
+/* Conversion between the items of a DiagramScene and a CircuitDocument.
+ * Only the wires contained in `items` are part of the netlist: ports connected to other
+ * wires are stored as unconnected.
+ *
+ * The package of every subcircuit is stored once in the document, and each definition
+ * is compiled once when the document is added to a scene. */
+
+class SceneSerializer {
+public:
+  static CircuitDocument serialize(const DiagramScene*          scene,
+                                   const QList<QGraphicsItem*>& items);
+
+  // Adds the circuit to the scene (translated by `offset`) and returns the created items.
+  // The document must have a geometry. Subcircuits whose definition can't be compiled
+  // are skipped.
+  static QList<QGraphicsItem*> deserialize(DiagramScene*          scene,
+                                           const CircuitDocument& doc,
+                                           QPointF                offset = {});
+
+  // The type names of the components that deserialize() skips because they can't be
+  // created in a scene (e.g. the DFFs of an imported netlist), with how many there are
+  static std::map<std::string, size_t> skippedComponents(const CircuitDocument& doc);
+
+  // Adds a copy of the circuit for each offset, updating the scene index only once
+  static QList<QGraphicsItem*> deserialize(DiagramScene*            scene,
+                                           const CircuitDocument&   doc,
+                                           std::span<const QPointF> offsets);
+
+  // The selected items, together with the wires connecting only the selected components
+  static QList<QGraphicsItem*> selectionWithInternalWires(const DiagramScene* scene);
+
+  // The shape of a component as drawn by LogiFlow, used by the automatic layout
+  static CircuitLayout::Footprint footprint(SiliconTypes type, unsigned int variant = 0);
+
+  // Footprints of the components in `doc` and of the basic gates. They are measured
+  // here, so the returned provider can be used by a worker thread.
+  static CircuitLayout::FootprintProvider footprintProvider(const CircuitDocument& doc);
+
+  static std::string_view typeName(SiliconTypes type);
+  static SiliconTypes     typeFromName(std::string_view name);
+
+private:
+  static void addCopy(DiagramScene* scene, const CircuitDocument& doc,
+                      std::span<const SubcircuitPackage_ptr> packages, QPointF offset,
+                      QList<QGraphicsItem*>& created);
+};
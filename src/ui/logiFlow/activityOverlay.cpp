@@ -0,0 +1,108 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "activityOverlay.hpp"
+
+#include <algorithm>
+
+#include <QGraphicsScene>
+#include <QPainter>
+#include <QPolygonF>
+
+#include <ui/common/graphicalWire.hpp>
+#include <ui/logiFlow/components/graphicalLogicComponent.hpp>
+
+ActivityOverlay::ActivityOverlay(const ActivityProfiler* profiler, QGraphicsItem* parent)
+  : QGraphicsObject(parent), profiler(profiler)
+{
+  setZValue(50);
+  setAcceptedMouseButtons(Qt::NoButton);
+  setAcceptHoverEvents(false);
+
+  connect(&timer, &QTimer::timeout, this, &ActivityOverlay::refresh);
+  timer.start(REFRESH_INTERVAL);
+}
+
+void ActivityOverlay::refresh()
+{
+  if (!scene())
+    return;
+
+  const auto newArea = scene()->itemsBoundingRect();
+  if (newArea != area) {
+    prepareGeometryChange();
+    area = newArea;
+  }
+
+  update();
+}
+
+QColor ActivityOverlay::heat(const uint64_t count, const uint64_t max)
+{
+  const double ratio = max ? static_cast<double>(count) / max : 0;
+
+  // From a transparent blue for the idle parts to an opaque red for the busiest ones
+  QColor color = QColor::fromHsvF(0.66 * (1 - ratio), 1, 1);
+  color.setAlphaF(0.2 + 0.5 * ratio);
+  return color;
+}
+
+void ActivityOverlay::paint(QPainter* painter, const QStyleOptionGraphicsItem*, QWidget*)
+{
+  if (!scene())
+    return;
+
+  const auto maxEvaluations = profiler->getMaxEvaluations();
+  const auto maxToggles     = profiler->getMaxToggles();
+
+  painter->setRenderHint(QPainter::Antialiasing);
+
+  for (const auto item : scene()->items()) {
+    if (item == this || item->parentItem())
+      continue;
+
+    if (item->type() == WIRE) {
+      auto bus = static_cast<GraphicalWire*>(item)->getBus();
+
+      uint64_t toggles = 0;
+      for (const auto& wire : bus)
+        toggles = std::max(toggles, profiler->getToggles(wire.get()));
+
+      painter->setPen(QPen(heat(toggles, maxToggles), 10, Qt::SolidLine, Qt::RoundCap,
+                           Qt::RoundJoin));
+      painter->setBrush(Qt::NoBrush);
+      for (const auto segment : static_cast<GraphicalWire*>(item)->getSegments()) {
+        QPolygonF line{};
+        for (const auto point : segment->getPoints())
+          line << segment->mapToScene(point);
+        painter->drawPolyline(line);
+      }
+      continue;
+    }
+
+    const auto component = dynamic_cast<GraphicalLogicComponent*>(item);
+    if (!component || !component->getComponent())
+      continue;
+
+    const auto evaluations = profiler->getEvaluations(component->getComponent().get());
+
+    painter->setPen(Qt::NoPen);
+    painter->setBrush(heat(evaluations, maxEvaluations));
+    painter->drawRect(component->sceneBoundingRect());
+  }
+}
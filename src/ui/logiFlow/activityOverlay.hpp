@@ -0,0 +1,53 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <QGraphicsObject>
+#include <QTimer>
+
+#include <core/activityProfiler.hpp>
+
+// Heat map of an ActivityProfiler drawn over the whole scene: every logic component is
+// tinted by the number of times it was evaluated and every wire by the number of times
+// it toggled, relative to the busiest ones. The overlay ignores the mouse and repaints
+// itself periodically while the simulation runs.
+class ActivityOverlay : public QGraphicsObject {
+  Q_OBJECT
+
+public:
+  static constexpr int REFRESH_INTERVAL = 250;  // ms
+
+  explicit ActivityOverlay(const ActivityProfiler* profiler,
+                           QGraphicsItem*          parent = nullptr);
+
+  [[nodiscard]] QRectF boundingRect() const override { return area; }
+
+  void paint(QPainter* painter, const QStyleOptionGraphicsItem* option,
+             QWidget* widget) override;
+
+private:
+  void refresh();
+
+  static QColor heat(uint64_t count, uint64_t max);
+
+  const ActivityProfiler* profiler;
+
+  QTimer timer;
+  QRectF area;
+};
@@ -17,7 +17,8 @@
 
 #include "graphicalGates.hpp"
 
-GraphicalGate::GraphicalGate(const std::shared_ptr<Gate> gate, QGraphicsItem* shape,
+GraphicalGate::GraphicalGate(const SiliconTypes gateType,
+                             const std::shared_ptr<Gate> gate, QGraphicsItem* shape,
                              QGraphicsItem* parent, bool scanShape)
   : GraphicalLogicComponent(gate, shape, parent, scanShape)
 {
@@ -26,6 +27,8 @@ GraphicalGate::GraphicalGate(const std::shared_ptr<Gate> gate, QGraphicsItem* sh
 
   isEditable = false;
 
+  setGeometryKey(gateType);
+
   std::vector<std::pair<std::string, QPoint>> inputVec;
   inputVec.reserve(2);
 
@@ -44,6 +47,7 @@ GraphicalNot::GraphicalNot(QGraphicsItem* parent)
 {
   isEditable = false;
 
+  setGeometryKey(SiliconTypes::NOT_GATE);
   setPorts({std::pair<std::string, QPoint>{"i", QPoint(-20, 20)}},
            {std::pair<std::string, QPoint>{"o", QPoint(80, 20)}});
 }
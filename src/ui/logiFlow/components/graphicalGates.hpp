@@ -26,8 +26,9 @@
 class GraphicalGate : public GraphicalLogicComponent {
   Q_OBJECT
 protected:
-  GraphicalGate(const std::shared_ptr<Gate> gate, QGraphicsItem* shape,
-                QGraphicsItem* parent = nullptr, bool scanShape = false);
+  GraphicalGate(SiliconTypes gateType, const std::shared_ptr<Gate> gate,
+                QGraphicsItem* shape, QGraphicsItem* parent = nullptr,
+                bool scanShape = false);
 
   int type() const override { return SiliconTypes::UNKNOWN; }
 };
@@ -37,6 +38,7 @@ class GraphicalAnd : public GraphicalGate {
 public:
   explicit GraphicalAnd(QGraphicsItem* parent = nullptr)
     : GraphicalGate(
+          SiliconTypes::AND_GATE,
           std::make_shared<AndGate>(std::vector<Wire_ptr>{nullptr, nullptr}, nullptr),
           new QGraphicsSvgItem(":/gates/AND_ANSI.svg"), parent)
   {
@@ -50,6 +52,7 @@ class GraphicalOr : public GraphicalGate {
 public:
   explicit GraphicalOr(QGraphicsItem* parent = nullptr)
     : GraphicalGate(
+          SiliconTypes::OR_GATE,
           std::make_shared<OrGate>(std::vector<Wire_ptr>{nullptr, nullptr}, nullptr),
           new QGraphicsSvgItem(":/gates/OR_ANSI.svg"), parent)
   {
@@ -70,6 +73,7 @@ class GraphicalNand : public GraphicalGate {
 public:
   explicit GraphicalNand(QGraphicsItem* parent = nullptr)
     : GraphicalGate(
+          SiliconTypes::NAND_GATE,
           std::make_shared<NandGate>(std::vector<Wire_ptr>{nullptr, nullptr}, nullptr),
           new QGraphicsSvgItem(":/gates/NAND_ANSI.svg"), parent)
   {
@@ -83,6 +87,7 @@ class GraphicalNor : public GraphicalGate {
 public:
   explicit GraphicalNor(QGraphicsItem* parent = nullptr)
     : GraphicalGate(
+          SiliconTypes::NOR_GATE,
           std::make_shared<NorGate>(std::vector<Wire_ptr>{nullptr, nullptr}, nullptr),
           new QGraphicsSvgItem(":/gates/NOR_ANSI.svg"), parent)
   {
@@ -97,6 +102,7 @@ public:
   explicit GraphicalXor(QGraphicsItem* parent = nullptr)
 
     : GraphicalGate(
+          SiliconTypes::XOR_GATE,
           std::make_shared<XorGate>(std::array<Wire_ptr, 2>{nullptr, nullptr}, nullptr),
           new QGraphicsSvgItem(":/gates/XOR_ANSI.svg"), parent, true)
   {
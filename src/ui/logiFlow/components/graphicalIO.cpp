@@ -44,9 +44,6 @@ GraphicalInput::GraphicalInput(std::string name, QGraphicsItem* parent)
 
   connect(this->propertiesDialog, &PropertiesDialog::rejected, this,
           &GraphicalInput::propertiesDialogRejected);
-
-  // Every time the component is placed we should set its properties
-  GraphicalInput::showPropertiesDialog();
 }
 
 void GraphicalInput::toggle()
@@ -58,11 +55,22 @@ void GraphicalInput::setState(State state)
 {
   this->skinState = state;
 
+  updateShape();
+  this->getComponent()->getOutputs()[0].setCurrentValue(state == State::HIGH,
+                                                        getComponent()->getDriverId());
+}
+
+void GraphicalInput::showOutputState()
+{
+  this->skinState = getState();
+  updateShape();
+}
+
+void GraphicalInput::updateShape()
+{
   const QString shapePath =
       (skinState == State::HIGH) ? getOnShapePath() : getOffShapePath();
   setItemShape(new QGraphicsSvgItem(shapePath));
-  this->getComponent()->getOutputs()[0].setCurrentValue(state == State::HIGH,
-                                                        getComponent()->weak_from_this());
 }
 void GraphicalInput::paint(QPainter* painter, const QStyleOptionGraphicsItem* option,
                            QWidget* widget)
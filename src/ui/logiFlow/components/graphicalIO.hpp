@@ -44,6 +44,9 @@ public:
 
   void setState(State state);
 
+  // Shows the state of the output wire, which was changed without toggling the input
+  void showOutputState();
+
   void paint(QPainter* painter, const QStyleOptionGraphicsItem* option,
              QWidget* widget) override;
 
@@ -55,6 +58,8 @@ private slots:
   void propertiesDialogAccepted() override;
 
 private:
+  void updateShape();
+
   State skinState = State::LOW;
 
   QLineEdit* nameInput = new QLineEdit();
@@ -77,7 +82,7 @@ private:
 class DummyInputComponent : public Component {
 public:
   DummyInputComponent(Bus bus, std::string name) : Component({}, {bus}, name) {}
-  void setState(int value) { this->outputs[0].setCurrentValue(value, weak_from_this()); };
+  void setState(int value) { this->outputs[0].setCurrentValue(value, driverId); };
 };
 
 class GraphicalOutputSingle : public GraphicalLogicComponent {
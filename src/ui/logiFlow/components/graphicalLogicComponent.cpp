@@ -30,8 +30,8 @@ void GraphicalLogicComponent::setPorts(
     const std::vector<std::pair<std::string, QPoint>>& busToPortOutputs)
 {
   if (associatedComponent) {
-    const std::vector<Bus> componentInputs  = associatedComponent->getInputs();
-    const std::vector<Bus> componentOutputs = associatedComponent->getOutputs();
+    const auto componentInputs  = associatedComponent->getInputs();
+    const auto componentOutputs = associatedComponent->getOutputs();
 
     assert(componentInputs.size() == busToPortInputs.size());
     assert(componentOutputs.size() == busToPortOutputs.size());
@@ -0,0 +1,73 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "graphicalSubcircuit.hpp"
+
+#include <algorithm>
+
+#include <QFont>
+#include <QGraphicsRectItem>
+#include <QGraphicsSimpleTextItem>
+#include <QPen>
+
+GraphicalSubcircuit::GraphicalSubcircuit(SubcircuitPackage_ptr package,
+                                         QGraphicsItem*        parent)
+  : GraphicalLogicComponent(std::make_shared<Subcircuit>(package->definition), nullptr,
+                            parent),
+    package(std::move(package))
+{
+  isEditable = false;
+
+  const auto& def = *this->package->definition;
+
+  const auto rows   = std::max(def.getInputs().size(), def.getOutputs().size());
+  const int  height = static_cast<int>(rows + 1) * PORT_SPACING;
+
+  auto shape = new QGraphicsRectItem(0, 0, WIDTH, height, this);
+  shape->setPen(QPen(Qt::black, 3));
+
+  const QFont font("NovaMono", 10);
+
+  const auto addLabel = [&](const std::string& text, const QPointF pos, bool right) {
+    auto label = new QGraphicsSimpleTextItem(QString::fromStdString(text), shape);
+    label->setFont(font);
+
+    const auto rect = label->boundingRect();
+    label->setPos(pos - QPointF(right ? rect.width() : 0, rect.height() / 2));
+  };
+
+  addLabel(def.getName(), QPointF(0, -PORT_SPACING / 2.0), false);
+
+  // Ports are PORT_SPACING apart, so they lie on the grid
+  std::vector<std::pair<std::string, QPoint>> inputs, outputs;
+
+  for (const auto& [i, port] : def.getInputs() | silicon::views::enumerate) {
+    const int y = static_cast<int>(i + 1) * PORT_SPACING;
+    inputs.emplace_back(port.name, QPoint(-20, y));
+    addLabel(port.name, QPointF(4, y), false);
+  }
+
+  for (const auto& [i, port] : def.getOutputs() | silicon::views::enumerate) {
+    const int y = static_cast<int>(i + 1) * PORT_SPACING;
+    outputs.emplace_back(port.name, QPoint(WIDTH + 20, y));
+    addLabel(port.name, QPointF(WIDTH - 4, y), true);
+  }
+
+  this->setItemShape(shape);
+  this->setGeometryKey(SiliconTypes::SUBCIRCUIT);
+  this->setPorts(inputs, outputs);
+}
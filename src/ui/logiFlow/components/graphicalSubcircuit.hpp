@@ -0,0 +1,41 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <QGraphicsItem>
+
+#include <io/circuitCompiler.hpp>
+#include <ui/logiFlow/components/graphicalLogicComponent.hpp>
+
+// An instance of a subcircuit: a box with the inputs on the left and the outputs on the
+// right. Every instance of the same package shares its compiled definition.
+class GraphicalSubcircuit : public GraphicalLogicComponent {
+  Q_OBJECT
+public:
+  explicit GraphicalSubcircuit(SubcircuitPackage_ptr package,
+                               QGraphicsItem*        parent = nullptr);
+  int type() const override { return SiliconTypes::SUBCIRCUIT; }
+
+  [[nodiscard]] const SubcircuitPackage_ptr& getPackage() const { return package; }
+
+private:
+  SubcircuitPackage_ptr package;
+
+  static constexpr int WIDTH        = 80;
+  static constexpr int PORT_SPACING = 20;
+};
@@ -31,6 +31,7 @@ void GraphicalWireSplitter::setSize(const unsigned int size)
   shape->setPen(QPen(Qt::black, 3));
 
   this->setItemShape(shape);
+  this->setGeometryKey(SiliconTypes::WIRE_SPLITTER, size);
   this->setPorts({std::pair<std::string, QPoint>{"b", QPoint(-20, 0)}}, outputPorts);
 }
 
@@ -66,5 +67,6 @@ void GraphicalWireMerger::setSize(const unsigned int size)
   shape->setPen(QPen(Qt::black, 3));
 
   this->setItemShape(shape);
+  this->setGeometryKey(SiliconTypes::WIRE_MERGER, size);
   this->setPorts(inputPorts, {std::pair<std::string, QPoint>{"b", QPoint(20, 0)}});
 }
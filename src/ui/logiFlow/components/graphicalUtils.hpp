@@ -32,6 +32,8 @@ public:
   int  type() const override { return SiliconTypes::WIRE_SPLITTER; }
   void setSize(const unsigned int size);
 
+  [[nodiscard]] unsigned int getSize() const { return size; }
+
 private:
   unsigned int size{};
 };
@@ -43,6 +45,8 @@ public:
   int  type() const override { return SiliconTypes::WIRE_MERGER; }
   void setSize(const unsigned int size);
 
+  [[nodiscard]] unsigned int getSize() const { return size; }
+
 private:
   unsigned int size;
 };
@@ -19,6 +19,54 @@
 #include "logiFlowWindow.hpp"
 #include "ui/common/diagramScene.hpp"
 
+#include <QClipboard>
+#include <QDir>
+#include <QFile>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QGuiApplication>
+#include <QInputDialog>
+#include <QMessageBox>
+#include <QMimeData>
+#include <QPointer>
+#include <QProgressDialog>
+#include <QThread>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <memory>
+#include <sstream>
+
+#include <core/logicAnalysis.hpp>
+#include <core/netlistOptimizer.hpp>
+#include <io/circuitCompiler.hpp>
+#include <io/circuitFile.hpp>
+#include <io/stimulusFile.hpp>
+#include <io/vcd.hpp>
+#include <io/netlistImport.hpp>
+#include <ui/common/sceneCommands.hpp>
+#include <ui/common/sceneSerializer.hpp>
+#include <ui/logiFlow/components/graphicalSubcircuit.hpp>
+#include <ui/logiFlow/truthTableDialog.hpp>
+
+namespace {
+QString fileFilter()
+{
+  return QObject::tr("Silicon circuit (*.slc);;Silicon circuit, text (*.slct)");
+}
+
+// The clipboard contains the circuit in the binary format, and in the text one for the
+// other applications
+constexpr auto CIRCUIT_MIME_TYPE = "application/x-silicon-circuit";
+
+QString netlistFilter()
+{
+  return QObject::tr("Netlist (*.blif *.v *.sv);;BLIF (*.blif);;Verilog (*.v *.sv)");
+}
+}
+
 LogiFlowWindow::LogiFlowWindow()
 {
   const auto centralWidget = new QWidget();
@@ -42,11 +90,23 @@ LogiFlowWindow::LogiFlowWindow()
 
   splitDockWidget(componentsDock, propertyDock, Qt::Vertical);
 
+#if SILICON_WAVEFORMS
+  waveformDock = new WaveformDock(this);
+  addDockWidget(Qt::BottomDockWidgetArea, waveformDock);
+  waveformDock->hide();
+#endif
+
   diagramScene = new DiagramScene(this);
   diagramView  = new DiagramView(this);
   diagramView->setScene(diagramScene);
 
   connect(diagramScene, &DiagramScene::modeChanged, this, &LogiFlowWindow::updateStatus);
+  connect(diagramScene, &DiagramScene::oscillationDetected, this,
+          &LogiFlowWindow::reportOscillation);
+  connect(diagramScene, &DiagramScene::simulationStepped, this,
+          &LogiFlowWindow::recordStep);
+  connect(diagramScene, &DiagramScene::simulationResumed, this,
+          &LogiFlowWindow::reportResumed);
   updateStatus();
 
   connect(diagramScene, &DiagramScene::selectionChanged, this,
@@ -57,15 +117,41 @@ LogiFlowWindow::LogiFlowWindow()
   aboutDialog = new AboutDialog("Silicon", this);
 
   undoStack = new QUndoStack(this);
+  diagramScene->setUndoStack(undoStack);
 
   createActions();
   createMenus();
   createToolBar();
 
-  setWindowTitle(tr("Silicon LogiFlow"));
+  // The actions must exist before the history is reset
+  connect(diagramScene, &DiagramScene::modeChanged, this, &LogiFlowWindow::resetHistory);
+
+  // Diagnostics can be reported by the worker threads. The message is shown later by the
+  // event loop, when the window may be gone.
+  statusSink = Diagnostics::addSink([window = QPointer(this)](const Diagnostic& d) {
+    if (!window)
+      return;
+
+    const auto text = QString::fromStdString(Diagnostics::format(d));
+    QMetaObject::invokeMethod(
+        window.data(),
+        [window, text] {
+          if (window)
+            window->statusBar()->showMessage(text, 5000);
+        },
+        Qt::QueuedConnection);
+  });
+
+  setCurrentFile({});
   setMinimumSize(160, 160);
 }
 
+LogiFlowWindow::~LogiFlowWindow()
+{
+  Diagnostics::removeSink(statusSink);
+  setLoggingDiagnostics(false);
+}
+
 void LogiFlowWindow::createActions()
 {
   newAct         = new QAction(Icon("file"), tr("&New"), this);
@@ -80,6 +166,42 @@ void LogiFlowWindow::createActions()
   deleteAct      = new QAction(Icon("delete"), tr("&Delete"), this);
   aboutAct       = new QAction(Icon("info"), tr("&About"), this);
 
+  importNetlistAct = new QAction(Icon("open"), tr("&Import netlist..."), this);
+  duplicateAct     = new QAction(Icon("copy"), tr("D&uplicate..."), this);
+  packageAct       = new QAction(Icon("plus"), tr("Package as &component..."), this);
+  truthTableAct    = new QAction(tr("&Truth table..."), this);
+  equivalenceAct   = new QAction(tr("Check &equivalence"), this);
+
+  profileAct        = new QAction(tr("&Profile activity"), this);
+  heatMapAct        = new QAction(tr("Activity &heat map"), this);
+  exportActivityAct = new QAction(tr("E&xport activity..."), this);
+  logDiagnosticsAct = new QAction(tr("&Log diagnostics..."), this);
+  logDiagnosticsAct->setCheckable(true);
+  profileAct->setCheckable(true);
+  heatMapAct->setCheckable(true);
+  heatMapAct->setEnabled(false);
+  exportActivityAct->setEnabled(false);
+
+  liveEditingAct = new QAction(tr("&Live editing"), this);
+  liveEditingAct->setCheckable(true);
+  liveEditingAct->setChecked(diagramScene->isLiveEditing());
+
+  stepBackAct      = new QAction(tr("Step &back"), this);
+  stepForwardAct   = new QAction(tr("Step &forward"), this);
+  jumpToStepAct    = new QAction(tr("&Go to step..."), this);
+  historyBudgetAct = new QAction(tr("History &memory..."), this);
+  stepBackAct->setEnabled(false);
+  stepForwardAct->setEnabled(false);
+  jumpToStepAct->setEnabled(false);
+
+  stimulusAct         = new QAction(tr("Apply &stimulus..."), this);
+  recordWaveformsAct  = new QAction(tr("&Record waveforms..."), this);
+  openWaveformAct     = new QAction(Icon("open"), tr("&Open waveforms..."), this);
+  convertWaveformsAct = new QAction(tr("&Convert waveforms..."), this);
+  stimulusAct->setEnabled(false);
+  recordWaveformsAct->setCheckable(true);
+  recordWaveformsAct->setEnabled(false);
+
   undoAct = undoStack->createUndoAction(this, tr("&Undo"));
   undoAct->setIcon(Icon("undo"));
 
@@ -92,6 +214,9 @@ void LogiFlowWindow::createActions()
   cutAct->setEnabled(false);
   copyAct->setEnabled(false);
   deleteAct->setEnabled(false);
+  packageAct->setEnabled(false);
+  truthTableAct->setEnabled(false);
+  equivalenceAct->setEnabled(false);
 
   setNormalModeAct       = new QAction(Icon("mouse-pointer"), "", this);
   setPanModeAct          = new QAction(Icon("pan"), "", this);
@@ -112,6 +237,9 @@ void LogiFlowWindow::createActions()
   rotateAct->setShortcut(Qt::AltModifier | Qt::Key_R);
   deleteAct->setShortcuts(QKeySequence::Delete);
   pasteAct->setShortcuts(QKeySequence::Paste);
+  duplicateAct->setShortcut(Qt::ControlModifier | Qt::Key_D);
+  stepBackAct->setShortcut(Qt::AltModifier | Qt::Key_Left);
+  stepForwardAct->setShortcut(Qt::AltModifier | Qt::Key_Right);
 
   setWireCreationModeAct->setShortcut(Qt::AltModifier | Qt::Key_W);
   setSimulationModeAct->setShortcut(Qt::AltModifier | Qt::ControlModifier | Qt::Key_S);
@@ -120,23 +248,74 @@ void LogiFlowWindow::createActions()
   newAct->setStatusTip(tr("Create a new file"));
   openAct->setStatusTip(tr("Open an existing logiFlow file"));
   saveAct->setStatusTip(tr("Save the circuit to disk"));
+  importNetlistAct->setStatusTip(tr("Import a BLIF or Verilog netlist"));
   exportImageAct->setStatusTip(tr("Export the circuit as an image"));
   exitAct->setStatusTip(tr("Exit the application"));
   undoAct->setStatusTip(tr("Undo the last operation"));
   redoAct->setStatusTip(tr("Redo the last operation"));
   cutAct->setStatusTip(tr("Cut the current selection's contents to the clipboard"));
   pasteAct->setStatusTip(tr("Paste the clipboard's contents into the current selection"));
+  duplicateAct->setStatusTip(tr("Place copies of the selection one below the other"));
+  packageAct->setStatusTip(tr("Turn the selection into a component that can be placed"));
+  truthTableAct->setStatusTip(tr("Show the truth table of the selection"));
+  equivalenceAct->setStatusTip(tr("Check that two selected components compute the same "
+                                  "function"));
+  profileAct->setStatusTip(tr("Count the evaluations of the components and the toggles "
+                              "of the wires while simulating"));
+  heatMapAct->setStatusTip(tr("Color the circuit by its activity"));
+  exportActivityAct->setStatusTip(tr("Save the activity as CSV or JSON"));
+  logDiagnosticsAct->setStatusTip(tr("Write the problems found while simulating to a "
+                                     "file"));
+  liveEditingAct->setStatusTip(tr("Keep the state of the simulation while the circuit "
+                                  "is edited"));
+  stepBackAct->setStatusTip(tr("Go back to the circuit before the last input change"));
+  stepForwardAct->setStatusTip(tr("Redo the input change that was stepped back"));
+  jumpToStepAct->setStatusTip(tr("Go to any input change of the simulation"));
+  historyBudgetAct->setStatusTip(tr("Set the memory used to remember the simulation"));
+  stimulusAct->setStatusTip(tr("Drive the inputs by name with a VCD file, one step for "
+                               "each time, or with a stimulus script"));
+  recordWaveformsAct->setStatusTip(tr("Save the named inputs and outputs at every step "
+                                      "to an FST file"));
+  openWaveformAct->setStatusTip(tr("Show the waveforms of an FST or VCD file"));
+  convertWaveformsAct->setStatusTip(tr("Convert waveforms between FST and VCD"));
   deleteAct->setStatusTip(tr("Delete selected components"));
   aboutAct->setStatusTip(tr("Show the application's about box"));
 
   connect(newAct, &QAction::triggered, this, &LogiFlowWindow::newFile);
   connect(openAct, &QAction::triggered, this, &LogiFlowWindow::open);
   connect(saveAct, &QAction::triggered, this, &LogiFlowWindow::save);
+  connect(importNetlistAct, &QAction::triggered, this, &LogiFlowWindow::importNetlist);
   connect(exportImageAct, &QAction::triggered, this, &LogiFlowWindow::exportImage);
   connect(exitAct, &QAction::triggered, this, &QWidget::close);
   connect(cutAct, &QAction::triggered, this, &LogiFlowWindow::cut);
   connect(copyAct, &QAction::triggered, this, &LogiFlowWindow::copy);
   connect(pasteAct, &QAction::triggered, this, &LogiFlowWindow::paste);
+  connect(duplicateAct, &QAction::triggered, this, &LogiFlowWindow::duplicate);
+  connect(packageAct, &QAction::triggered, this, &LogiFlowWindow::packageSelection);
+  connect(truthTableAct, &QAction::triggered, this, &LogiFlowWindow::showTruthTable);
+  connect(equivalenceAct, &QAction::triggered, this, &LogiFlowWindow::checkEquivalence);
+  connect(profileAct, &QAction::toggled, this, &LogiFlowWindow::setProfiling);
+  connect(heatMapAct, &QAction::toggled, this, &LogiFlowWindow::setHeatMap);
+  connect(exportActivityAct, &QAction::triggered, this, &LogiFlowWindow::exportActivity);
+  connect(logDiagnosticsAct, &QAction::toggled, this,
+          &LogiFlowWindow::setLoggingDiagnostics);
+  connect(liveEditingAct, &QAction::toggled, diagramScene, &DiagramScene::setLiveEditing);
+  connect(stepBackAct, &QAction::triggered, this, &LogiFlowWindow::stepBack);
+  connect(stepForwardAct, &QAction::triggered, this, &LogiFlowWindow::stepForward);
+  connect(jumpToStepAct, &QAction::triggered, this, &LogiFlowWindow::jumpToStep);
+  connect(historyBudgetAct, &QAction::triggered, this, &LogiFlowWindow::setHistoryBudget);
+  connect(stimulusAct, &QAction::triggered, this, &LogiFlowWindow::applyStimulus);
+#if SILICON_WAVEFORMS
+  connect(recordWaveformsAct, &QAction::toggled, this,
+          &LogiFlowWindow::setRecordingWaveforms);
+  connect(openWaveformAct, &QAction::triggered, this, &LogiFlowWindow::openWaveform);
+  connect(convertWaveformsAct, &QAction::triggered, this,
+          &LogiFlowWindow::convertWaveforms);
+#else
+  recordWaveformsAct->setVisible(false);
+  openWaveformAct->setVisible(false);
+  convertWaveformsAct->setVisible(false);
+#endif
   connect(rotateAct, &QAction::triggered, this, &LogiFlowWindow::rotate);
   connect(deleteAct, &QAction::triggered, this, &LogiFlowWindow::del);
   connect(aboutAct, &QAction::triggered, this, &LogiFlowWindow::about);
@@ -157,6 +336,7 @@ void LogiFlowWindow::createMenus()
   fileMenu->addAction(newAct);
   fileMenu->addAction(openAct);
   fileMenu->addAction(saveAct);
+  fileMenu->addAction(importNetlistAct);
   fileMenu->addAction(exportImageAct);
   fileMenu->addSeparator();
   fileMenu->addAction(exitAct);
@@ -168,10 +348,36 @@ void LogiFlowWindow::createMenus()
   editMenu->addAction(cutAct);
   editMenu->addAction(copyAct);
   editMenu->addAction(pasteAct);
+  editMenu->addAction(duplicateAct);
+  editMenu->addAction(packageAct);
   editMenu->addAction(rotateAct);
   editMenu->addAction(deleteAct);
   editMenu->addSeparator();
 
+  analysisMenu = menuBar()->addMenu(tr("&Analysis"));
+  analysisMenu->addAction(truthTableAct);
+  analysisMenu->addAction(equivalenceAct);
+  analysisMenu->addSeparator();
+  analysisMenu->addAction(profileAct);
+  analysisMenu->addAction(heatMapAct);
+  analysisMenu->addAction(exportActivityAct);
+  analysisMenu->addSeparator();
+  analysisMenu->addAction(logDiagnosticsAct);
+
+  simulationMenu = menuBar()->addMenu(tr("&Simulation"));
+  simulationMenu->addAction(liveEditingAct);
+  simulationMenu->addSeparator();
+  simulationMenu->addAction(stepBackAct);
+  simulationMenu->addAction(stepForwardAct);
+  simulationMenu->addAction(jumpToStepAct);
+  simulationMenu->addSeparator();
+  simulationMenu->addAction(historyBudgetAct);
+  simulationMenu->addSeparator();
+  simulationMenu->addAction(stimulusAct);
+  simulationMenu->addAction(recordWaveformsAct);
+  simulationMenu->addAction(openWaveformAct);
+  simulationMenu->addAction(convertWaveformsAct);
+
   helpMenu = menuBar()->addMenu(tr("&Help"));
   helpMenu->addAction(aboutAct);
 }
@@ -192,6 +398,8 @@ void LogiFlowWindow::createToolBar()
   toolBar->addAction(setPanModeAct);
   toolBar->addAction(setWireCreationModeAct);
   toolBar->addAction(setSimulationModeAct);
+  toolBar->addAction(stepBackAct);
+  toolBar->addAction(stepForwardAct);
 
   toolBar->addSeparator();
   toolBar->addAction(setComponentPlacingModeAct);
@@ -212,8 +420,800 @@ void LogiFlowWindow::contextMenuEvent(QContextMenuEvent* event)
 }
 #endif  // QT_NO_CONTEXTMENU
 
+void LogiFlowWindow::setCurrentFile(const QString& fileName)
+{
+  currentFile = fileName;
+
+  if (fileName.isEmpty())
+    setWindowTitle(tr("Silicon LogiFlow"));
+  else
+    setWindowTitle(tr("%1 - Silicon LogiFlow").arg(QFileInfo(fileName).fileName()));
+}
+
 /* ACTIONS IMPLEMENTATION */
 
+void LogiFlowWindow::newFile()
+{
+  diagramScene->clearCircuit();
+  clearActivity();
+  undoStack->clear();
+  setCurrentFile({});
+}
+
+void LogiFlowWindow::open()
+{
+  const auto fileName =
+      QFileDialog::getOpenFileName(this, tr("Open circuit"), {}, fileFilter());
+  if (fileName.isEmpty())
+    return;
+
+  QFile file(fileName);
+  if (!file.open(QIODevice::ReadOnly)) {
+    QMessageBox::warning(this, tr("Open circuit"), file.errorString());
+    return;
+  }
+
+  // Big circuits are decoded straight from the mapped file, without copying it
+  QByteArray                 content{};
+  std::span<const std::byte> data{};
+
+  if (const uchar* mapped = file.map(0, file.size()))
+    data = std::as_bytes(std::span(mapped, file.size()));
+  else {
+    content = file.readAll();
+    data    = std::as_bytes(std::span(content.constData(), content.size()));
+  }
+
+  auto doc = CircuitFile::decode(data);
+
+  if (!doc) {
+    QMessageBox::warning(this, tr("Open circuit"),
+                         tr("Cannot read %1: %2")
+                             .arg(QFileInfo(fileName).fileName(),
+                                  QString::fromStdString(doc.error())));
+    return;
+  }
+
+  // Files written by other tools may contain only the netlist: it's placed automatically
+  if (!doc->hasGeometry() && !doc->components.empty()) {
+    auto footprints = SceneSerializer::footprintProvider(*doc);
+
+    loadInBackground(
+        tr("Open circuit"), fileName, fileName,
+        [doc = std::move(*doc)]() -> std::expected<CircuitDocument, std::string> {
+          return doc;
+        },
+        std::move(footprints));
+    return;
+  }
+
+  diagramScene->clearCircuit();
+  clearActivity();
+  SceneSerializer::deserialize(diagramScene, *doc);
+  undoStack->clear();
+
+  setCurrentFile(fileName);
+}
+
+void LogiFlowWindow::save()
+{
+  auto fileName = currentFile;
+
+  if (fileName.isEmpty()) {
+    fileName = QFileDialog::getSaveFileName(this, tr("Save circuit"), {}, fileFilter());
+    if (fileName.isEmpty())
+      return;
+  }
+
+  const auto doc = SceneSerializer::serialize(diagramScene, diagramScene->items());
+
+  QByteArray content{};
+
+  if (fileName.endsWith(".slct", Qt::CaseInsensitive)) {
+    content = QByteArray::fromStdString(CircuitFile::encodeText(doc));
+  } else {
+    const auto data = CircuitFile::encodeBinary(doc);
+    content = QByteArray(reinterpret_cast<const char*>(data.data()), data.size());
+  }
+
+  QFile file(fileName);
+  if (!file.open(QIODevice::WriteOnly) || file.write(content) != content.size()) {
+    QMessageBox::warning(this, tr("Save circuit"), file.errorString());
+    return;
+  }
+
+  undoStack->setClean();
+  setCurrentFile(fileName);
+}
+
+void LogiFlowWindow::importNetlist()
+{
+  const auto fileName =
+      QFileDialog::getOpenFileName(this, tr("Import netlist"), {}, netlistFilter());
+  if (fileName.isEmpty())
+    return;
+
+  // The imported circuit has no file of its own until it's saved
+  loadInBackground(
+      tr("Import netlist"), fileName, {},
+      [path = fileName.toStdString()]() -> std::expected<CircuitDocument, std::string> {
+        const auto netlist = NetlistImporter::load(path);
+        if (!netlist)
+          return std::unexpected(netlist.error());
+
+        // Every gate becomes a component: the redundant ones are removed first
+        return CircuitLayout::fromNetlist(NetlistOptimizer::optimize(*netlist).netlist);
+      },
+      SceneSerializer::footprintProvider({}));
+}
+
+void LogiFlowWindow::loadInBackground(const QString& title, const QString& fileName,
+                                      const QString& newCurrentFile, DocumentLoader load,
+                                      CircuitLayout::FootprintProvider footprints)
+{
+  const auto progress =
+      new QProgressDialog(tr("Placing the components..."), tr("Cancel"), 0, 100, this);
+  progress->setWindowTitle(title);
+  progress->setWindowModality(Qt::WindowModal);
+  progress->setMinimumDuration(500);
+  progress->setValue(0);
+
+  const auto cancelled = std::make_shared<std::atomic<bool>>(false);
+  const auto result    = std::make_shared<std::expected<CircuitDocument, std::string>>();
+
+  connect(progress, &QProgressDialog::canceled, this, [cancelled] { *cancelled = true; });
+
+  // The worker only touches `result`: the progress is reported through queued calls
+  QThread* worker = QThread::create([=, load = std::move(load),
+                                     footprints = std::move(footprints)] {
+    *result = load();
+    if (!*result)
+      return;
+
+    const auto report = [progress, cancelled](const int percent) {
+      QMetaObject::invokeMethod(
+          progress, [progress, percent] { progress->setValue(percent); },
+          Qt::QueuedConnection);
+      return !*cancelled;
+    };
+
+    CircuitLayout::layout(**result, footprints, report);
+  });
+
+  connect(worker, &QThread::finished, this, [=, this] {
+    worker->deleteLater();
+    progress->deleteLater();
+
+    if (*cancelled)
+      return;
+
+    if (!*result) {
+      QMessageBox::warning(this, title,
+                           tr("Cannot read %1: %2")
+                               .arg(QFileInfo(fileName).fileName(),
+                                    QString::fromStdString(result->error())));
+      return;
+    }
+
+    diagramScene->clearCircuit();
+    clearActivity();
+    SceneSerializer::deserialize(diagramScene, **result);
+    undoStack->clear();
+
+    setCurrentFile(newCurrentFile);
+
+    // The circuit is incomplete without them, e.g. the registers of a sequential netlist
+    const auto skipped = SceneSerializer::skippedComponents(**result);
+    if (!skipped.empty()) {
+      QStringList components{};
+      for (const auto& [name, count] : skipped)
+        components.push_back(tr("%1 (%2)").arg(QString::fromStdString(name)).arg(count));
+
+      QMessageBox::warning(this, title,
+                           tr("These components of %1 can't be placed in a circuit "
+                              "and were left out: %2")
+                               .arg(QFileInfo(fileName).fileName(),
+                                    components.join(", ")));
+    }
+  });
+
+  worker->start();
+}
+
+void LogiFlowWindow::copy()
+{
+  const auto items = SceneSerializer::selectionWithInternalWires(diagramScene);
+  if (items.empty())
+    return;
+
+  const auto doc  = SceneSerializer::serialize(diagramScene, items);
+  const auto data = CircuitFile::encodeBinary(doc);
+
+  const auto mimeData = new QMimeData();
+  mimeData->setData(CIRCUIT_MIME_TYPE,
+                    QByteArray(reinterpret_cast<const char*>(data.data()), data.size()));
+  mimeData->setText(QString::fromStdString(CircuitFile::encodeText(doc)));
+
+  QGuiApplication::clipboard()->setMimeData(mimeData);
+  pasteCount = 0;
+}
+
+void LogiFlowWindow::paste()
+{
+  const QMimeData* mimeData = QGuiApplication::clipboard()->mimeData();
+  if (!mimeData || !mimeData->hasFormat(CIRCUIT_MIME_TYPE))
+    return;
+
+  const QByteArray content = mimeData->data(CIRCUIT_MIME_TYPE);
+  const auto       doc =
+      CircuitFile::decode(std::as_bytes(std::span(content.data(), content.size())));
+
+  if (!doc || !doc->hasGeometry() || doc->components.empty())
+    return;
+
+  diagramScene->setInteractionMode(InteractionMode::NORMAL_MODE);
+
+  // Every paste is shifted a bit more than the previous one
+  pasteCount++;
+  const auto shift  = DiagramScene::GRID_SIZE * 4 * pasteCount;
+  const auto offset = QPointF(shift, shift);
+
+  const auto created = SceneSerializer::deserialize(diagramScene, *doc, offset);
+
+  diagramScene->clearSelection();
+  for (QGraphicsItem* item : created)
+    item->setSelected(true);
+
+  undoStack->push(
+      new ItemsCommand(diagramScene, ItemsCommand::Kind::ADD, created, tr("Paste")));
+}
+
+void LogiFlowWindow::duplicate()
+{
+  const auto items = SceneSerializer::selectionWithInternalWires(diagramScene);
+  if (items.empty())
+    return;
+
+  bool      ok    = false;
+  const int count = QInputDialog::getInt(this, tr("Duplicate"), tr("Number of copies:"),
+                                         1, 1, 4096, 1, &ok);
+  if (!ok)
+    return;
+
+  // The selection is serialized once and placed `count` times, one copy below the other
+  const auto doc = SceneSerializer::serialize(diagramScene, items);
+
+  QRectF bounds{};
+  for (const QGraphicsItem* item : items)
+    bounds = bounds.united(item->sceneBoundingRect());
+
+  const auto step =
+      std::ceil(bounds.height() / DiagramScene::GRID_SIZE) * DiagramScene::GRID_SIZE
+      + DiagramScene::GRID_SIZE * 2;
+
+  std::vector<QPointF> offsets{};
+  offsets.reserve(count);
+  for (int i = 1; i <= count; i++)
+    offsets.emplace_back(0, step * i);
+
+  // The scene index is rebuilt once for all the copies, and the view is repainted at
+  // the end
+  diagramView->setUpdatesEnabled(false);
+  const auto created = SceneSerializer::deserialize(diagramScene, doc, offsets);
+  diagramView->setUpdatesEnabled(true);
+
+  undoStack->push(
+      new ItemsCommand(diagramScene, ItemsCommand::Kind::ADD, created, tr("Duplicate")));
+}
+
+void LogiFlowWindow::packageSelection()
+{
+  const auto items = SceneSerializer::selectionWithInternalWires(diagramScene);
+  if (items.empty())
+    return;
+
+  bool          ok    = false;
+  const QString title = tr("Package as component");
+  const QString name  = QInputDialog::getText(this, title, tr("Name:"), QLineEdit::Normal,
+                                              tr("Subcircuit"), &ok);
+  if (!ok || name.isEmpty())
+    return;
+
+  // The inputs and outputs of the selection become the ports of the component
+  auto source = SceneSerializer::serialize(diagramScene, items);
+  source.name = name.toStdString();
+
+  const auto package = CircuitCompiler::package(std::move(source));
+  if (!package) {
+    QMessageBox::warning(this, title,
+                         tr("Unable to package the selection: %1")
+                             .arg(QString::fromStdString(package.error())));
+    return;
+  }
+
+  // Every instance placed from now on shares the same definition
+  diagramScene->clearSelection();
+  diagramScene->placeComponent(
+      [package = *package] { return new GraphicalSubcircuit(package); });
+}
+
+void LogiFlowWindow::showTruthTable()
+{
+  const auto items = SceneSerializer::selectionWithInternalWires(diagramScene);
+  if (items.empty())
+    return;
+
+  const QString title = tr("Truth table");
+
+  // The inputs and outputs of the selection are the columns of the table
+  const auto definition = CircuitCompiler::compile(
+      SceneSerializer::serialize(diagramScene, items), "selection");
+
+  if (!definition) {
+    QMessageBox::warning(this, title,
+                         tr("Unable to compile the selection: %1")
+                             .arg(QString::fromStdString(definition.error())));
+    return;
+  }
+
+  const auto& netlist = (*definition)->getNetlist();
+  auto        table   = LogicAnalysis::truthTable(netlist);
+
+  if (!table) {
+    QMessageBox::warning(this, title,
+                         tr("Unable to analyze the selection: %1")
+                             .arg(QString::fromStdString(table.error())));
+    return;
+  }
+
+  (new TruthTableDialog(netlist, std::move(*table), this))->show();
+}
+
+void LogiFlowWindow::checkEquivalence()
+{
+  std::vector<GraphicalSubcircuit*> subcircuits{};
+  for (const auto item : diagramScene->selectedItems())
+    if (item->type() == SUBCIRCUIT)
+      subcircuits.push_back(static_cast<GraphicalSubcircuit*>(item));
+
+  const QString title = tr("Check equivalence");
+
+  if (subcircuits.size() != 2) {
+    QMessageBox::information(this, title, tr("Select the two components to compare"));
+    return;
+  }
+
+  const auto& a = subcircuits[0]->getPackage()->definition->getNetlist();
+  const auto& b = subcircuits[1]->getPackage()->definition->getNetlist();
+
+  const auto res = LogicAnalysis::checkEquivalence(a, b);
+
+  if (!res) {
+    QMessageBox::warning(this, title,
+                         tr("Unable to compare the components: %1")
+                             .arg(QString::fromStdString(res.error())));
+    return;
+  }
+
+  if (res->equivalent) {
+    QMessageBox::information(this, title, tr("The components are equivalent"));
+    return;
+  }
+
+  QStringList inputs{};
+  for (const auto [i, net] : a.getPrimaryInputs() | silicon::views::enumerate)
+    inputs.push_back(QString("%1 = %2")
+                         .arg(QString::fromUtf8(a.getNetName(net)))
+                         .arg(res->counterexample[i] ? 1 : 0));
+
+  const auto output = a.getPrimaryOutputs()[res->output];
+  QMessageBox::information(this, title,
+                           tr("The components differ on output %1 when:\n%2")
+                               .arg(QString::fromUtf8(a.getNetName(output)))
+                               .arg(inputs.join("\n")));
+}
+
+void LogiFlowWindow::setProfiling(const bool enabled)
+{
+  if (!enabled) {
+    if (profiler)
+      profiler->stop();
+    return;
+  }
+
+  if (!profiler)
+    profiler = std::make_unique<ActivityProfiler>();
+
+  profiler->start();
+  heatMapAct->setEnabled(true);
+  exportActivityAct->setEnabled(true);
+}
+
+void LogiFlowWindow::setHeatMap(const bool visible)
+{
+  if (!visible || !profiler) {
+    delete activityOverlay;
+    return;
+  }
+
+  if (!activityOverlay) {
+    activityOverlay = new ActivityOverlay(profiler.get());
+    diagramScene->addItem(activityOverlay);
+  }
+}
+
+void LogiFlowWindow::exportActivity()
+{
+  if (!profiler)
+    return;
+
+  const QString title    = tr("Export activity");
+  const QString fileName = QFileDialog::getSaveFileName(
+      this, title, {}, tr("CSV (*.csv);;JSON (*.json)"));
+  if (fileName.isEmpty())
+    return;
+
+  std::ostringstream out{};
+  if (fileName.endsWith(".json", Qt::CaseInsensitive))
+    profiler->writeJson(out);
+  else
+    profiler->writeCsv(out);
+
+  const auto content = QByteArray::fromStdString(out.str());
+
+  QFile file(fileName);
+  if (!file.open(QIODevice::WriteOnly) || file.write(content) != content.size())
+    QMessageBox::warning(this, title, file.errorString());
+}
+
+void LogiFlowWindow::setLoggingDiagnostics(const bool enabled)
+{
+  if (!enabled) {
+    if (logSink)
+      Diagnostics::removeSink(*logSink);
+    logSink.reset();
+    diagnosticsLog.close();
+    return;
+  }
+
+  const QString title    = tr("Log diagnostics");
+  const QString fileName = QFileDialog::getSaveFileName(
+      this, title, "diagnostics.log", tr("Log files (*.log *.txt)"));
+
+  if (!fileName.isEmpty())
+    diagnosticsLog.open(fileName.toStdString(), std::ios::app);
+
+  if (!diagnosticsLog.is_open()) {
+    if (!fileName.isEmpty())
+      QMessageBox::warning(this, title, tr("Can't write %1").arg(fileName));
+
+    const QSignalBlocker blocker(logDiagnosticsAct);
+    logDiagnosticsAct->setChecked(false);
+    return;
+  }
+
+  // The ones reported before logging are written too
+  for (const auto& d : Diagnostics::getRecent())
+    diagnosticsLog << Diagnostics::format(d) << '\n';
+
+  logSink = Diagnostics::addSink(Diagnostics::streamSink(diagnosticsLog));
+}
+
+void LogiFlowWindow::clearActivity()
+{
+  // The overlay was deleted along with the circuit
+  heatMapAct->setChecked(false);
+
+  if (profiler)
+    profiler->clear();
+
+  history.clear();
+  historyWires.clear();
+  stepBackAct->setEnabled(false);
+  stepForwardAct->setEnabled(false);
+
+  recordWaveformsAct->setChecked(false);
+}
+
+void LogiFlowWindow::recordStep()
+{
+#if SILICON_WAVEFORMS
+  if (waveformWriter)
+    sampleWaveforms();
+#endif
+
+  if (historyWires.empty())
+    return;
+
+  for (size_t i = 0; i < historyWires.size(); i++)
+    historyStates[i] = historyWires[i]->getCurrentState();
+
+  history.record(historyStates);
+  stepBackAct->setEnabled(true);
+  stepForwardAct->setEnabled(false);
+}
+
+void LogiFlowWindow::stepBack()
+{
+  if (history.stepBack())
+    showStep();
+}
+
+void LogiFlowWindow::stepForward()
+{
+  if (history.stepForward())
+    showStep();
+}
+
+void LogiFlowWindow::jumpToStep()
+{
+  if (history.empty())
+    return;
+
+  const auto current = static_cast<int>(history.getCurrentStep());
+  const auto first   = static_cast<int>(history.getFirstStep());
+  const auto last    = static_cast<int>(history.getLastStep());
+
+  bool       ok   = false;
+  const auto step = QInputDialog::getInt(this, tr("Go to step"), tr("Input change:"),
+                                         current, first, last, 1, &ok);
+
+  if (ok && history.jumpTo(step))
+    showStep();
+}
+
+void LogiFlowWindow::setHistoryBudget()
+{
+  constexpr size_t MB = 1 << 20;
+
+  bool       ok     = false;
+  const auto budget = QInputDialog::getInt(this, tr("History memory"), tr("Megabytes:"),
+                                           static_cast<int>(history.getBudget() / MB), 1,
+                                           4096, 1, &ok);
+  if (ok)
+    history.setBudget(budget * MB);
+}
+
+void LogiFlowWindow::resetHistory()
+{
+  history.clear();
+  historyWires.clear();
+
+  const bool simulating =
+      diagramScene->getInteractionMode() == InteractionMode::SIMULATION_MODE;
+
+  if (simulating) {
+    historyWires = diagramScene->getSimulatedWires();
+    historyStates.resize(historyWires.size());
+    recordStep();
+  }
+
+  stepBackAct->setEnabled(false);
+  stepForwardAct->setEnabled(false);
+  jumpToStepAct->setEnabled(simulating);
+
+  // The recorded wires only exist in SIMULATION_MODE
+  if (!simulating)
+    recordWaveformsAct->setChecked(false);
+  recordWaveformsAct->setEnabled(simulating);
+  stimulusAct->setEnabled(simulating);
+}
+
+void LogiFlowWindow::applyStimulus()
+{
+  const QString title = tr("Apply stimulus");
+  const QString fileName = QFileDialog::getOpenFileName(
+      this, title, {}, tr("VCD waveforms (*.vcd);;Stimulus scripts (*.stim)"));
+
+  if (fileName.isEmpty())
+    return;
+
+  // The inputs are matched by name
+  std::vector<GraphicalInput*> inputs{};
+  std::vector<std::string>     names{};
+  for (QGraphicsItem* item : diagramScene->items(Qt::AscendingOrder)) {
+    if (item->type() != SiliconTypes::SINGLE_INPUT)
+      continue;
+
+    inputs.push_back(qgraphicsitem_cast<GraphicalInput*>(item));
+    names.push_back(inputs.back()->getComponent()->getName());
+  }
+
+  // Scripts are run in batch: the scene is only updated at the end, as a single step
+  if (fileName.endsWith(".stim", Qt::CaseInsensitive)) {
+    const auto script = StimulusFile::load(fileName.toStdString());
+
+    // The inputs of a scene are either on or off, they can't drive ERROR
+    if (script) {
+      const auto& assignments = script->getAssignments();
+      const auto  unknown     = std::ranges::find_if(
+          assignments, [](const Stimulus::Assignment& a) { return a.error; });
+
+      if (unknown != assignments.end()) {
+        QMessageBox::warning(this, title,
+                             tr("Input %1 is set to x at time %2: the inputs of the "
+                                "circuit can only be set to 0 or 1")
+                                 .arg(QString::fromStdString(unknown->input))
+                                 .arg(unknown->time));
+        return;
+      }
+    }
+
+    std::vector<TestBench::BusPort> ports{};
+    for (const GraphicalInput* input : inputs)
+      ports.push_back({input->getComponent()->getName(),
+                       input->getComponent()->getOutputs()[0]});
+
+    const auto steps = script.and_then([&](const Stimulus& s) { return s.run(ports); });
+    if (!steps) {
+      QMessageBox::warning(this, title, QString::fromStdString(steps.error()));
+      return;
+    }
+
+    diagramScene->showSimulatedStates();
+    diagramScene->endSimulationStep();
+
+    statusBar()->showMessage(tr("Ran %1 steps").arg(*steps));
+    return;
+  }
+
+  const auto stimulus = VcdStimulus::load(fileName.toStdString(), names);
+  if (!stimulus) {
+    QMessageBox::warning(this, title, QString::fromStdString(stimulus.error()));
+    return;
+  }
+
+  // Every time of the file is a step of the history
+  for (size_t step = 0; step < stimulus->size(); step++) {
+    for (const auto& change : stimulus->getChanges(step))
+      inputs[change.input]->setState(change.state);
+
+    diagramScene->endSimulationStep();
+  }
+
+  statusBar()->showMessage(tr("Applied %1 steps").arg(stimulus->size()));
+}
+
+void LogiFlowWindow::showStep()
+{
+  const auto states = history.getStates();
+  for (const uint32_t i : history.getChanged())
+    historyWires[i]->restoreState(states[i]);
+
+  diagramScene->showSimulatedStates();
+
+  stepBackAct->setEnabled(history.getCurrentStep() > history.getFirstStep());
+  stepForwardAct->setEnabled(history.getCurrentStep() < history.getLastStep());
+
+  statusBar()->showMessage(tr("Step %1 of %2")
+                               .arg(history.getCurrentStep())
+                               .arg(history.getLastStep()));
+}
+
+#if SILICON_WAVEFORMS
+void LogiFlowWindow::setRecordingWaveforms(const bool enabled)
+{
+  const QString title = tr("Record waveforms");
+
+  if (!enabled) {
+    if (!waveformWriter)
+      return;
+
+    waveformWriter->close();
+    waveformWriter.reset();
+    waveformSignals.clear();
+
+    if (!waveformDock->open(waveformFile))
+      QMessageBox::warning(this, title, tr("Can't read %1").arg(waveformFile));
+    else
+      waveformDock->show();
+    return;
+  }
+
+  const QString fileName =
+      QFileDialog::getSaveFileName(this, title, {}, tr("FST waveforms (*.fst)"));
+
+  std::unique_ptr<WaveformWriter> writer{};
+  if (!fileName.isEmpty())
+    writer = std::make_unique<WaveformWriter>(fileName.toStdString());
+
+  if (!writer || !writer->isOpen()) {
+    if (writer)
+      QMessageBox::warning(this, title, tr("Can't write %1").arg(fileName));
+
+    const QSignalBlocker blocker(recordWaveformsAct);
+    recordWaveformsAct->setChecked(false);
+    return;
+  }
+
+  // Inputs first, then outputs, each one named after its component
+  for (const auto type : {SiliconTypes::SINGLE_INPUT, SiliconTypes::SINGLE_OUTPUT}) {
+    for (QGraphicsItem* item : diagramScene->items(Qt::AscendingOrder)) {
+      if (item->type() != type)
+        continue;
+
+      const auto component = static_cast<GraphicalLogicComponent*>(item)->getComponent();
+      const auto bus       = type == SiliconTypes::SINGLE_INPUT
+                                 ? component->getOutputs()[0]
+                                 : component->getInputs()[0];
+
+      waveformSignals.emplace_back(writer->addSignal(component->getName()), bus[0]);
+    }
+  }
+
+  waveformWriter = std::move(writer);
+  waveformFile   = fileName;
+  waveformTime   = 0;
+
+  sampleWaveforms();
+}
+
+void LogiFlowWindow::openWaveform()
+{
+  const QString title    = tr("Open waveforms");
+  const QString fileName = QFileDialog::getOpenFileName(
+      this, title, {}, tr("Waveforms (*.fst *.vcd)"));
+
+  if (fileName.isEmpty())
+    return;
+
+  // The dock reads FST files, VCD files are converted first
+  QString fstName = fileName;
+  if (fileName.endsWith(".vcd", Qt::CaseInsensitive)) {
+    fstName = QDir::temp().filePath(QFileInfo(fileName).completeBaseName() + ".fst");
+
+    std::ifstream vcd(fileName.toStdString(), std::ios::binary);
+    const auto converted = WaveformConverter::vcdToFst(vcd, fstName.toStdString());
+    if (!converted) {
+      QMessageBox::warning(this, title, QString::fromStdString(converted.error()));
+      return;
+    }
+  }
+
+  if (!waveformDock->open(fstName)) {
+    QMessageBox::warning(this, title, tr("Can't read %1").arg(fileName));
+    return;
+  }
+
+  waveformDock->show();
+}
+
+void LogiFlowWindow::convertWaveforms()
+{
+  const QString title = tr("Convert waveforms");
+  const QString input = QFileDialog::getOpenFileName(this, title, {},
+                                                     tr("Waveforms (*.fst *.vcd)"));
+  if (input.isEmpty())
+    return;
+
+  const bool    toVcd  = input.endsWith(".fst", Qt::CaseInsensitive);
+  const QString output = QFileDialog::getSaveFileName(
+      this, title, QFileInfo(input).completeBaseName() + (toVcd ? ".vcd" : ".fst"),
+      toVcd ? tr("VCD waveforms (*.vcd)") : tr("FST waveforms (*.fst)"));
+  if (output.isEmpty())
+    return;
+
+  WaveformConverter::Result converted{};
+  if (toVcd) {
+    std::ofstream vcd(output.toStdString(), std::ios::binary);
+    converted = WaveformConverter::fstToVcd(input.toStdString(), vcd);
+  } else {
+    std::ifstream vcd(input.toStdString(), std::ios::binary);
+    converted = WaveformConverter::vcdToFst(vcd, output.toStdString());
+  }
+
+  if (!converted)
+    QMessageBox::warning(this, title, QString::fromStdString(converted.error()));
+}
+
+void LogiFlowWindow::sampleWaveforms()
+{
+  waveformWriter->setTime(waveformTime++);
+  for (const auto& [signal, wire] : waveformSignals)
+    waveformWriter->sample(signal, wire->getCurrentState());
+}
+#endif
+
 void LogiFlowWindow::rotate()
 {
   auto selectedComponents =
@@ -227,7 +1227,8 @@ void LogiFlowWindow::rotate()
         return;
 
       auto component = qgraphicsitem_cast<GraphicalComponent*>(selectedComponents[0]);
-      component->rotate();
+      undoStack->push(new RotateCommand(diagramScene, component, component->rotation(),
+                                        component->rotation() + 90));
       break;
     }
     case InteractionMode::COMPONENT_PLACING_MODE: {
@@ -241,13 +1242,19 @@ void LogiFlowWindow::rotate()
 
 void LogiFlowWindow::del()
 {
+  QList<QGraphicsItem*> toBeDeleted{};
+
   for (auto selectedComponent : diagramScene->selectedItems()) {
     // Trying to remove non user-defined components leads to crash
-    if (selectedComponent->type() > UNKNOWN) {
-      diagramScene->removeItem(selectedComponent);
-      delete selectedComponent;
-    }
+    if (selectedComponent->type() > UNKNOWN)
+      toBeDeleted.push_back(selectedComponent);
   }
+
+  if (toBeDeleted.empty())
+    return;
+
+  undoStack->push(new ItemsCommand(diagramScene, ItemsCommand::Kind::REMOVE, toBeDeleted,
+                                   tr("Delete")));
 }
 
 void LogiFlowWindow::about() const
@@ -293,8 +1300,37 @@ void LogiFlowWindow::updateStatus() const
     default: assert(false);
   }
 
+  // The loops are found in advance, the oscillations only when they happen
+  if (diagramScene->getInteractionMode() == InteractionMode::SIMULATION_MODE) {
+    if (const auto loops = countLoops())
+      modeMsg += tr(" - %n combinational loop(s), the circuit may oscillate", "", loops);
+  }
+
   statusBar()->showMessage(modeMsg);
 }
+
+void LogiFlowWindow::reportOscillation(const int wires) const
+{
+  statusBar()->showMessage(
+      tr("Oscillation detected: %n wire(s) stuck in the ERROR state", "", wires));
+}
+
+void LogiFlowWindow::reportResumed(const int components) const
+{
+  statusBar()->showMessage(
+      tr("Simulation resumed: %n edited component(s) reconnected", "", components));
+}
+
+int LogiFlowWindow::countLoops() const
+{
+  const auto definition = CircuitCompiler::compile(
+      SceneSerializer::serialize(diagramScene, diagramScene->items()), "circuit");
+
+  if (!definition)
+    return 0;
+
+  return static_cast<int>((*definition)->getNetlist().getCombinationalLoops().size());
+}
 void LogiFlowWindow::selectionChanged() const
 {
   auto interactionMode = diagramScene->getInteractionMode();
@@ -313,4 +1349,8 @@ void LogiFlowWindow::selectionChanged() const
   cutAct->setEnabled(cutCopyDelete);
   copyAct->setEnabled(cutCopyDelete);
   deleteAct->setEnabled(cutCopyDelete);
+  packageAct->setEnabled(cutCopyDelete);
+  truthTableAct->setEnabled(cutCopyDelete);
+  equivalenceAct->setEnabled(interactionMode == InteractionMode::NORMAL_MODE
+                             && diagramScene->selectedItems().size() >= 2);
 }
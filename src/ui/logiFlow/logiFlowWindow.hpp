@@ -22,6 +22,13 @@
 
 #include <QBrush>
 #include <QColor>
+#include <expected>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+
 #include <QDockWidget>
 #include <QGraphicsScene>
 #include <QGraphicsSvgItem>
@@ -30,10 +37,15 @@
 #include <QMainWindow>
 #include <QMenu>
 #include <QMenuBar>
+#include <QPointer>
 #include <QStatusBar>
 #include <QToolBar>
 #include <QUndoStack>
 
+#include <core/activityProfiler.hpp>
+#include <core/diagnostics.hpp>
+#include <core/stateHistory.hpp>
+#include <io/circuitLayout.hpp>
 #include <ui/common/componentSearchBox.hpp>
 #include <ui/common/diagramScene.hpp>
 #include <ui/common/diagramView.hpp>
@@ -44,6 +56,13 @@
 #include <ui/logiFlow/components/graphicalGates.hpp>
 #include <ui/logiFlow/components/graphicalIO.hpp>
 
+#include <ui/logiFlow/activityOverlay.hpp>
+
+#if SILICON_WAVEFORMS
+#  include <io/waveform.hpp>
+#  include <ui/logiFlow/waveformDock.hpp>
+#endif
+
 #ifndef QT_NO_CONTEXTMENU
 #  include <QContextMenuEvent>
 #endif
@@ -53,6 +72,7 @@ class LogiFlowWindow : public QMainWindow {
 
 public:
   LogiFlowWindow();
+  ~LogiFlowWindow() override;
 
 protected:
 #ifndef QT_NO_CONTEXTMENU
@@ -60,17 +80,38 @@ protected:
 #endif  // QT_NO_CONTEXTMENU
 
 private slots:
-  void newFile() {}
-  void open() {}
-  void save() {}
+  void newFile();
+  void open();
+  void save();
+  void importNetlist();
   void exportImage() {}
   void cut()
   {
     copy();
     del();
   }
-  void copy() {}
-  void paste() {}
+  void copy();
+  void paste();
+  void duplicate();
+  void packageSelection();
+  void showTruthTable();
+  void checkEquivalence();
+  void setProfiling(bool enabled);
+  void setHeatMap(bool visible);
+  void exportActivity();
+  void setLoggingDiagnostics(bool enabled);
+  void recordStep();
+  void stepBack();
+  void stepForward();
+  void jumpToStep();
+  void setHistoryBudget();
+  void resetHistory();
+  void applyStimulus();
+#if SILICON_WAVEFORMS
+  void setRecordingWaveforms(bool enabled);
+  void openWaveform();
+  void convertWaveforms();
+#endif
   void rotate();
   void del();  // Delete is a CPP keyword
   void about() const;
@@ -82,6 +123,8 @@ private slots:
   void setComponentPlacingMode();
 
   void updateStatus() const;
+  void reportOscillation(int wires) const;
+  void reportResumed(int components) const;
   void selectionChanged() const;
 
 private:
@@ -89,6 +132,30 @@ private:
   void createMenus();
   void createToolBar();
 
+  void setCurrentFile(const QString& fileName);
+
+  // Combinational loops of the whole circuit, 0 if it can't be compiled
+  [[nodiscard]] int countLoops() const;
+
+  // The profiled and recorded components are about to be deleted
+  void clearActivity();
+
+  // Restores the wires changed by the last move in the history
+  void showStep();
+
+#if SILICON_WAVEFORMS
+  // Writes the recorded signals at the next unit of time
+  void sampleWaveforms();
+#endif
+
+  using DocumentLoader = std::function<std::expected<CircuitDocument, std::string>()>;
+
+  // Loads and lays out a circuit on a worker thread, showing the progress. When it's done
+  // the circuit replaces the current one and `newCurrentFile` becomes the current file.
+  void loadInBackground(const QString& title, const QString& fileName,
+                        const QString& newCurrentFile, DocumentLoader load,
+                        CircuitLayout::FootprintProvider footprints);
+
   QToolBar* toolBar;
 
   QDockWidget* componentsDock;
@@ -99,16 +166,36 @@ private:
 
   QMenu* fileMenu;
   QMenu* editMenu;
+  QMenu* analysisMenu;
+  QMenu* simulationMenu;
   QMenu* helpMenu;
 
   QAction* newAct;
   QAction* openAct;
   QAction* saveAct;
+  QAction* importNetlistAct;
   QAction* exportImageAct;
   QAction* exitAct;
   QAction* cutAct;
   QAction* copyAct;
   QAction* pasteAct;
+  QAction* duplicateAct;
+  QAction* packageAct;
+  QAction* truthTableAct;
+  QAction* equivalenceAct;
+  QAction* profileAct;
+  QAction* heatMapAct;
+  QAction* exportActivityAct;
+  QAction* logDiagnosticsAct;
+  QAction* liveEditingAct;
+  QAction* stepBackAct;
+  QAction* stepForwardAct;
+  QAction* jumpToStepAct;
+  QAction* historyBudgetAct;
+  QAction* stimulusAct;
+  QAction* recordWaveformsAct;
+  QAction* openWaveformAct;
+  QAction* convertWaveformsAct;
   QAction* rotateAct;
   QAction* deleteAct;
   QAction* aboutAct;
@@ -125,4 +212,35 @@ private:
   QUndoStack* undoStack;
 
   AboutDialog* aboutDialog;
+
+  QString currentFile;
+
+  // The simulation runs on the GUI thread, which is the one being profiled
+  std::unique_ptr<ActivityProfiler> profiler;
+  QPointer<ActivityOverlay>         activityOverlay;
+
+  // The diagnostics are shown in the status bar, and written to a file if logging
+  Diagnostics::SinkId                statusSink;
+  std::optional<Diagnostics::SinkId> logSink;
+  std::ofstream                      diagnosticsLog;
+
+  // Every input change in SIMULATION_MODE is a step, recorded over the wires that were
+  // simulated when the mode was entered
+  StateHistory          history;
+  std::vector<Wire_ptr> historyWires;
+  std::vector<State>    historyStates;
+
+#if SILICON_WAVEFORMS
+  WaveformDock* waveformDock;
+
+  // The named inputs and outputs are sampled at every step, one unit of time each. The
+  // file is shown in the dock when the recording stops.
+  std::unique_ptr<WaveformWriter>            waveformWriter;
+  std::vector<std::pair<uint32_t, Wire_ptr>> waveformSignals;
+  uint64_t                                   waveformTime = 0;
+  QString                                    waveformFile;
+#endif
+
+  // Consecutive pastes of the same circuit are shifted, so that they don't overlap
+  int pasteCount = 0;
 };
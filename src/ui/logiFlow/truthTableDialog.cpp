@@ -0,0 +1,126 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "truthTableDialog.hpp"
+
+#include <QDialogButtonBox>
+#include <QHeaderView>
+#include <QLabel>
+#include <QTableView>
+#include <QVBoxLayout>
+
+namespace {
+QStringList netNames(const Netlist& netlist, const std::span<const NetId> nets)
+{
+  QStringList res{};
+  for (const NetId n : nets)
+    res.push_back(QString::fromUtf8(netlist.getNetName(n)));
+  return res;
+}
+
+// Input i is bit i of the rows of a TruthTable, but the most significant one on screen
+uint64_t reverseBits(const uint64_t row, const uint32_t count)
+{
+  uint64_t res = 0;
+  for (uint32_t i = 0; i < count; i++)
+    res |= ((row >> i) & 1) << (count - 1 - i);
+  return res;
+}
+}  // namespace
+
+TruthTableModel::TruthTableModel(TruthTable table, QStringList inputNames,
+                                 QStringList outputNames, QObject* parent)
+  : QAbstractTableModel(parent), table(std::move(table)),
+    inputNames(std::move(inputNames)), outputNames(std::move(outputNames))
+{}
+
+int TruthTableModel::rowCount(const QModelIndex& parent) const
+{
+  return parent.isValid() ? 0 : static_cast<int>(table.getRowCount());
+}
+
+int TruthTableModel::columnCount(const QModelIndex& parent) const
+{
+  return parent.isValid() ? 0 : table.getInputCount() + table.getOutputCount();
+}
+
+QVariant TruthTableModel::data(const QModelIndex& index, const int role) const
+{
+  if (!index.isValid())
+    return {};
+
+  if (role == Qt::TextAlignmentRole)
+    return int(Qt::AlignCenter);
+
+  if (role != Qt::DisplayRole)
+    return {};
+
+  const auto     row    = static_cast<uint64_t>(index.row());
+  const uint32_t column = index.column();
+
+  // The first input is the most significant column, as in the tables written by hand
+  if (column < table.getInputCount())
+    return (row >> (table.getInputCount() - 1 - column)) & 1 ? 1 : 0;
+
+  const auto tableRow = reverseBits(row, table.getInputCount());
+  return table.get(column - table.getInputCount(), tableRow) ? 1 : 0;
+}
+
+QVariant TruthTableModel::headerData(const int section, const Qt::Orientation orientation,
+                                     const int role) const
+{
+  if (role != Qt::DisplayRole || orientation != Qt::Horizontal)
+    return QAbstractTableModel::headerData(section, orientation, role);
+
+  if (section < inputNames.size())
+    return inputNames[section];
+
+  return outputNames.value(section - inputNames.size());
+}
+
+TruthTableDialog::TruthTableDialog(const Netlist& netlist, TruthTable table,
+                                   QWidget* parent)
+  : QDialog(parent)
+{
+  setWindowTitle(tr("Truth table"));
+  setAttribute(Qt::WA_DeleteOnClose);
+  resize(500, 600);
+
+  const auto layout = new QVBoxLayout(this);
+
+  layout->addWidget(new QLabel(tr("%1 inputs, %2 outputs, %3 rows")
+                                   .arg(table.getInputCount())
+                                   .arg(table.getOutputCount())
+                                   .arg(table.getRowCount()),
+                               this));
+
+  const auto model =
+      new TruthTableModel(std::move(table), netNames(netlist, netlist.getPrimaryInputs()),
+                          netNames(netlist, netlist.getPrimaryOutputs()), this);
+
+  const auto view = new QTableView(this);
+  view->setModel(model);
+  view->setEditTriggers(QAbstractItemView::NoEditTriggers);
+  view->verticalHeader()->setVisible(false);
+  view->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+  layout->addWidget(view);
+
+  const auto buttons = new QDialogButtonBox(QDialogButtonBox::Close, this);
+  connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+  layout->addWidget(buttons);
+}
@@ -0,0 +1,55 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <QAbstractTableModel>
+#include <QDialog>
+#include <QStringList>
+
+#include <core/logicAnalysis.hpp>
+
+// Read-only view of a TruthTable. The rows are generated by the model when they are
+// shown, so the table of a 20-input block doesn't create a million items.
+class TruthTableModel : public QAbstractTableModel {
+  Q_OBJECT
+
+public:
+  TruthTableModel(TruthTable table, QStringList inputNames, QStringList outputNames,
+                  QObject* parent = nullptr);
+
+  [[nodiscard]] int rowCount(const QModelIndex& parent = {}) const override;
+  [[nodiscard]] int columnCount(const QModelIndex& parent = {}) const override;
+
+  [[nodiscard]] QVariant data(const QModelIndex& index, int role) const override;
+  [[nodiscard]] QVariant headerData(int section, Qt::Orientation orientation,
+                                    int role) const override;
+
+private:
+  TruthTable  table;
+  QStringList inputNames;
+  QStringList outputNames;
+};
+
+class TruthTableDialog : public QDialog {
+  Q_OBJECT
+
+public:
+  // The names of the primary inputs and outputs of `netlist` are the column headers
+  TruthTableDialog(const Netlist& netlist, TruthTable table, QWidget* parent = nullptr);
+};
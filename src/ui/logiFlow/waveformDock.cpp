@@ -0,0 +1,285 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "waveformDock.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include <QHBoxLayout>
+#include <QPainter>
+#include <QScrollBar>
+#include <QSplitter>
+#include <QWheelEvent>
+
+namespace {
+// Binary values up to 64 bits are shown in hexadecimal
+QString label(const std::string& value)
+{
+  if (value.size() > 64 || value.find_first_not_of("01") != std::string::npos)
+    return QString::fromStdString(value);
+
+  return "0x" + QString::number(std::stoull(value, nullptr, 2), 16).toUpper();
+}
+}  // namespace
+
+/* VIEW */
+
+WaveformView::WaveformView(QWidget* parent) : QAbstractScrollArea(parent)
+{
+  setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOn);
+  setMinimumHeight(ROW_HEIGHT * 3);
+}
+
+void WaveformView::setReader(WaveformReader* reader)
+{
+  this->reader = reader;
+  selection.clear();
+  segments.clear();
+  loadedResolution = 0;
+
+  zoomToFit();
+}
+
+void WaveformView::setSelection(std::vector<uint32_t> selected)
+{
+  selection        = std::move(selected);
+  loadedResolution = 0;
+
+  updateScrollBar();
+  viewport()->update();
+}
+
+void WaveformView::zoomToFit()
+{
+  const uint64_t length = reader ? reader->getEndTime() - reader->getStartTime() + 1 : 1;
+  timePerPixel          = std::max(1.0, static_cast<double>(length) / getWaveWidth());
+
+  horizontalScrollBar()->setValue(0);
+  updateScrollBar();
+  viewport()->update();
+}
+
+int WaveformView::getWaveWidth() const
+{
+  return std::max(1, viewport()->width() - NAME_WIDTH);
+}
+
+uint64_t WaveformView::getViewStart() const
+{
+  const auto start = reader ? reader->getStartTime() : 0;
+  return start + static_cast<uint64_t>(horizontalScrollBar()->value() * timePerPixel);
+}
+
+void WaveformView::setTimePerPixel(const double newTimePerPixel, const int anchorX)
+{
+  if (!reader)
+    return;
+
+  // From 32 pixels per unit of time to the whole trace in a pixel
+  const double length = reader->getEndTime() - reader->getStartTime() + 1;
+  const double clamped =
+      std::clamp(newTimePerPixel, 1.0 / 32, std::max(1.0 / 32, length));
+
+  const double anchorTime = horizontalScrollBar()->value() * timePerPixel
+                            + anchorX * timePerPixel;
+
+  timePerPixel = clamped;
+  updateScrollBar();
+  horizontalScrollBar()->setValue(static_cast<int>(anchorTime / timePerPixel) - anchorX);
+
+  viewport()->update();
+}
+
+void WaveformView::updateScrollBar()
+{
+  const double length = reader ? reader->getEndTime() - reader->getStartTime() + 1 : 0;
+  const auto   width  = static_cast<int>(std::ceil(length / timePerPixel));
+
+  horizontalScrollBar()->setRange(0, std::max(0, width - getWaveWidth()));
+  horizontalScrollBar()->setPageStep(getWaveWidth());
+  horizontalScrollBar()->setSingleStep(std::max(1, getWaveWidth() / 20));
+
+  const int height = static_cast<int>(selection.size()) * ROW_HEIGHT;
+  verticalScrollBar()->setRange(0, std::max(0, height - viewport()->height()));
+  verticalScrollBar()->setPageStep(viewport()->height());
+  verticalScrollBar()->setSingleStep(ROW_HEIGHT);
+}
+
+void WaveformView::reload()
+{
+  const auto resolution = std::max<uint64_t>(1, static_cast<uint64_t>(timePerPixel));
+  const auto start      = getViewStart();
+  const auto end        = std::min<uint64_t>(
+      reader->getEndTime() + 1,
+      start + static_cast<uint64_t>(std::ceil(getWaveWidth() * timePerPixel)) + 1);
+
+  if (start == loadedStart && end == loadedEnd && resolution == loadedResolution)
+    return;
+
+  segments         = reader->load(selection, start, end, resolution);
+  loadedStart      = start;
+  loadedEnd        = end;
+  loadedResolution = resolution;
+}
+
+void WaveformView::paintEvent(QPaintEvent*)
+{
+  QPainter painter(viewport());
+  painter.fillRect(viewport()->rect(), palette().base());
+
+  if (!reader || selection.empty())
+    return;
+
+  reload();
+
+  const auto viewStart = getViewStart();
+  const auto waveArea  = QRect(NAME_WIDTH, 0, getWaveWidth(), viewport()->height());
+
+  for (size_t i = 0; i < selection.size(); i++) {
+    const int   y      = static_cast<int>(i) * ROW_HEIGHT - verticalScrollBar()->value();
+    const auto& signal = reader->getSignals()[selection[i]];
+
+    painter.setPen(palette().text().color());
+    painter.drawText(QRect(4, y, NAME_WIDTH - 8, ROW_HEIGHT),
+                     Qt::AlignVCenter | Qt::AlignLeft,
+                     QString::fromStdString(signal.name));
+
+    painter.setClipRect(waveArea);
+    for (const auto& segment : segments[i])
+      paintSegment(painter, segment, signal.width, y, viewStart);
+    painter.setClipping(false);
+  }
+}
+
+void WaveformView::paintSegment(QPainter& painter, const WaveformReader::Segment& segment,
+                                const uint32_t width, const int y,
+                                const uint64_t viewStart) const
+{
+  const auto toX = [&](const uint64_t time) {
+    const double offset = time >= viewStart ? static_cast<double>(time - viewStart) : 0;
+    return NAME_WIDTH + offset / timePerPixel;
+  };
+
+  const double x0   = toX(segment.start);
+  const double x1   = toX(segment.end);
+  const double high = y + 4, low = y + ROW_HEIGHT - 4, middle = (high + low) / 2;
+
+  // Changing faster than the pixels
+  if (segment.value.empty()) {
+    painter.fillRect(QRectF(x0, high, std::max(1.0, x1 - x0), low - high),
+                     QBrush(Qt::gray, Qt::BDiagPattern));
+    return;
+  }
+
+  const bool known = segment.value.find_first_not_of("01") == std::string::npos;
+  painter.setPen(known ? QColor(Qt::darkGreen) : QColor(Qt::red));
+
+  if (width == 1) {
+    const double level = !known ? middle : segment.value == "1" ? high : low;
+    painter.drawLine(QPointF(x0, high), QPointF(x0, low));
+    painter.drawLine(QPointF(x0, level), QPointF(x1, level));
+    return;
+  }
+
+  painter.drawLine(QPointF(x0, high), QPointF(x0, low));
+  painter.drawLine(QPointF(x0, high), QPointF(x1, high));
+  painter.drawLine(QPointF(x0, low), QPointF(x1, low));
+
+  const auto text = label(segment.value);
+  if (painter.fontMetrics().horizontalAdvance(text) + 6 < x1 - x0)
+    painter.drawText(QRectF(x0 + 3, high, x1 - x0 - 6, low - high), Qt::AlignVCenter,
+                     text);
+}
+
+void WaveformView::wheelEvent(QWheelEvent* event)
+{
+  if (!(event->modifiers() & Qt::ControlModifier)) {
+    QAbstractScrollArea::wheelEvent(event);
+    return;
+  }
+
+  const double factor = event->angleDelta().y() > 0 ? 0.5 : 2;
+  const int    anchor = static_cast<int>(event->position().x()) - NAME_WIDTH;
+
+  setTimePerPixel(timePerPixel * factor, std::max(0, anchor));
+  event->accept();
+}
+
+void WaveformView::resizeEvent(QResizeEvent* event)
+{
+  QAbstractScrollArea::resizeEvent(event);
+  updateScrollBar();
+}
+
+void WaveformView::scrollContentsBy(int, int)
+{
+  viewport()->update();
+}
+
+/* DOCK */
+
+WaveformDock::WaveformDock(QWidget* parent) : QDockWidget(tr("Waveforms"), parent)
+{
+  setFeatures(QDockWidget::DockWidgetMovable | QDockWidget::DockWidgetClosable);
+
+  const auto splitter = new QSplitter(this);
+  signalList          = new QListWidget(splitter);
+  view                = new WaveformView(splitter);
+
+  splitter->addWidget(signalList);
+  splitter->addWidget(view);
+  splitter->setStretchFactor(1, 1);
+  setWidget(splitter);
+
+  connect(signalList, &QListWidget::itemChanged, this, &WaveformDock::signalsChecked);
+}
+
+bool WaveformDock::open(const QString& fileName)
+{
+  auto newReader = std::make_unique<WaveformReader>(fileName.toStdString());
+  if (!newReader->isOpen())
+    return false;
+
+  view->setReader(newReader.get());
+  reader = std::move(newReader);
+
+  // Adding the items would check the signals one at a time
+  const QSignalBlocker blocker(signalList);
+  signalList->clear();
+
+  for (const auto& signal : reader->getSignals()) {
+    const auto name = QString::fromStdString(signal.name);
+    const auto item = new QListWidgetItem(name, signalList);
+    item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+    item->setCheckState(Qt::Checked);
+  }
+
+  signalsChecked();
+  return true;
+}
+
+void WaveformDock::signalsChecked()
+{
+  std::vector<uint32_t> checked{};
+  for (int i = 0; i < signalList->count(); i++)
+    if (signalList->item(i)->checkState() == Qt::Checked)
+      checked.push_back(i);
+
+  view->setSelection(std::move(checked));
+}
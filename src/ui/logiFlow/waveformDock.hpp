@@ -0,0 +1,96 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <QAbstractScrollArea>
+#include <QDockWidget>
+#include <QListWidget>
+
+#include <io/waveform.hpp>
+
+// Plots the selected signals of a WaveformReader over time. Only the window being shown
+// is loaded, with one slot per pixel, so a trace of millions of cycles costs as much as
+// the visible part. Ctrl + wheel zooms around the cursor.
+class WaveformView : public QAbstractScrollArea {
+  Q_OBJECT
+
+public:
+  static constexpr int ROW_HEIGHT = 28;
+  static constexpr int NAME_WIDTH = 140;
+
+  explicit WaveformView(QWidget* parent = nullptr);
+
+  // The reader must outlive the view, or be replaced before being deleted
+  void setReader(WaveformReader* reader);
+  void setSelection(std::vector<uint32_t> selected);
+
+  // The whole trace fits the view
+  void zoomToFit();
+
+protected:
+  void paintEvent(QPaintEvent* event) override;
+  void wheelEvent(QWheelEvent* event) override;
+  void resizeEvent(QResizeEvent* event) override;
+  void scrollContentsBy(int dx, int dy) override;
+
+private:
+  [[nodiscard]] int      getWaveWidth() const;
+  [[nodiscard]] uint64_t getViewStart() const;
+
+  void setTimePerPixel(double newTimePerPixel, int anchorX);
+  void updateScrollBar();
+  void reload();
+
+  void paintSegment(QPainter& painter, const WaveformReader::Segment& segment,
+                    uint32_t width, int y, uint64_t viewStart) const;
+
+  WaveformReader*       reader = nullptr;
+  std::vector<uint32_t> selection;
+  double                timePerPixel = 1;
+
+  // The window of time that was last loaded
+  std::vector<std::vector<WaveformReader::Segment>> segments;
+  uint64_t                                          loadedStart      = 0;
+  uint64_t                                          loadedEnd        = 0;
+  uint64_t                                          loadedResolution = 0;
+};
+
+// The signals of an FST file, to be checked to show their waveforms
+class WaveformDock : public QDockWidget {
+  Q_OBJECT
+
+public:
+  explicit WaveformDock(QWidget* parent = nullptr);
+
+  // False if the file can't be read
+  bool open(const QString& fileName);
+
+private slots:
+  void signalsChecked();
+
+private:
+  std::unique_ptr<WaveformReader> reader;
+
+  QListWidget*  signalList;
+  WaveformView* view;
+};
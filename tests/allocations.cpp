@@ -0,0 +1,131 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "tests.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <new>
+
+#include <extraComponents/arithmetic.hpp>
+
+// Every allocation of the test goes through these, while `counting` they are counted
+namespace {
+bool   counting    = false;
+size_t allocations = 0;
+
+template <typename F>
+size_t countAllocations(F&& f)
+{
+  allocations = 0;
+  counting    = true;
+  f();
+  counting = false;
+  return allocations;
+}
+}  // namespace
+
+void* operator new(const size_t size)
+{
+  if (counting)
+    allocations++;
+
+  if (void* p = std::malloc(size ? size : 1))
+    return p;
+
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+  std::free(p);
+}
+
+TEST(AllocationTest, GateEvaluation)
+{
+  auto a = std::make_shared<Wire>(State::LOW);
+  auto b = std::make_shared<Wire>(State::LOW);
+  auto c = std::make_shared<Wire>(State::LOW);
+
+  std::vector<Wire_ptr> outputs(7);
+  for (auto& w : outputs)
+    w = std::make_shared<Wire>();
+
+  const std::vector<Component_ptr> components{
+      std::make_shared<AndGate>(std::vector<Wire_ptr>{a, b, c}, outputs[0]),
+      std::make_shared<OrGate>(std::vector<Wire_ptr>{a, b}, outputs[1]),
+      std::make_shared<NandGate>(std::vector<Wire_ptr>{a, b}, outputs[2]),
+      std::make_shared<NorGate>(std::vector<Wire_ptr>{a, b}, outputs[3]),
+      std::make_shared<XorGate>(std::array<Wire_ptr, 2>{a, b}, outputs[4]),
+      std::make_shared<NotGate>(a, outputs[5]),
+      std::make_shared<FullAdder>(std::array<Wire_ptr, 2>{a, b}, c, outputs[6],
+                                  std::make_shared<Wire>()),
+  };
+
+  constexpr int evaluations = 10'000;
+
+  const auto start = std::chrono::steady_clock::now();
+
+  const auto count = countAllocations([&] {
+    for (int i = 0; i < evaluations; i++) {
+      a->forceSetCurrentState(i & 1 ? State::HIGH : State::LOW);
+      b->forceSetCurrentState(i & 2 ? State::HIGH : State::LOW);
+      c->forceSetCurrentState(i & 4 ? State::HIGH : State::LOW);
+    }
+  });
+
+  const std::chrono::duration<double, std::micro> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  EXPECT_EQ(count, 0);
+  // The last inputs are all HIGH
+  EXPECT_EQ(outputs[4]->getCurrentState(), State::LOW);
+  EXPECT_EQ(outputs[6]->getCurrentState(), State::HIGH);
+
+  std::cout << "Allocations per evaluation: "
+            << static_cast<double>(count) / evaluations << ", "
+            << elapsed.count() / evaluations << " us per round of input changes\n";
+}
+
+TEST(AllocationTest, BusAccessors)
+{
+  Bus  a(4), b(4), sum(4);
+  auto cout = std::make_shared<Wire>();
+  a.forceSetCurrentValue(0);
+  b.forceSetCurrentValue(0);
+
+  AdderNBits adder({a, b}, sum, cout);
+
+  const auto count = countAllocations([&] {
+    for (unsigned v = 0; v < 256; v++) {
+      a.forceSetCurrentValue(v & 0xF);
+      b.forceSetCurrentValue(v >> 4);
+
+      for (const auto& bus : adder.getOutputs())
+        EXPECT_FALSE(bus.isInErrorState());
+    }
+  });
+
+  EXPECT_EQ(count, 0);
+  EXPECT_EQ(sum.getCurrentValue(), (15 + 15) & 0xF);
+}
@@ -20,6 +20,7 @@
 
 #include <vector>
 
+#include <core/testBench.hpp>
 #include <extraComponents/arithmetic.hpp>
 
 
@@ -122,3 +123,39 @@ TEST(ArithmeticTest, AdderNBitsAtomic) {
   EXPECT_EQ(sum.getCurrentValue(),   0);
 
 }
+
+TEST(ArithmeticTest, AdderNBitsGoldenModel) {
+  auto a    = Bus(8);
+  auto b    = Bus(8);
+  auto sum  = Bus(8);
+  auto cout = std::make_shared<Wire>();
+
+  a.forceSetCurrentValue(0);
+  b.forceSetCurrentValue(0);
+
+  AdderNBits adder({a, b}, sum, cout);
+
+  // The sum with the carry out as its most significant bit
+  std::vector<Wire_ptr> bits(sum.begin(), sum.end());
+  bits.push_back(cout);
+  const auto result = Bus(bits);
+
+  const TestBench bench({{"a", a}, {"b", b}}, {{"sum", result}});
+
+  const auto model = [](std::span<const uint64_t> in, std::span<uint64_t> out) {
+    out[0] = in[0] + in[1];
+  };
+
+  const auto report = bench.random(2000, 1, model);
+  ASSERT_TRUE(report) << report.error();
+  EXPECT_EQ(report->vectors, 2000);
+  EXPECT_FALSE(report->firstMismatch) << to_str(*report);
+
+  // Dropping the carry out is caught
+  const auto wrong = bench.random(2000, 1, [](auto in, auto out) {
+    out[0] = (in[0] + in[1]) & 0xFF;
+  });
+  ASSERT_TRUE(wrong);
+  ASSERT_TRUE(wrong->firstMismatch);
+  EXPECT_GT(wrong->firstMismatch->inputs[0] + wrong->firstMismatch->inputs[1], 0xFF);
+}
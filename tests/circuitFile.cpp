@@ -0,0 +1,195 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tests.hpp"
+
+#include <io/circuitFile.hpp>
+
+namespace {
+CircuitDocument exampleDocument()
+{
+  // in ──► NOT ──► out
+  CircuitDocument doc;
+
+  const auto a = doc.addNet(1, "a");
+  const auto o = doc.addNet(1);
+
+  const uint32_t none = CircuitDocument::NO_NET;
+
+  const auto in  = doc.addComponent("SINGLE_INPUT", "my input", 0, {}, std::array{a});
+  const auto no  = doc.addComponent("NOT_GATE", "Not", 0, std::array{a}, std::array{o});
+  const auto out = doc.addComponent("SINGLE_OUTPUT", "out", 0, std::array{o}, {});
+  doc.addComponent("NOT_GATE", "Not", 0, std::array{none}, std::array{none});
+
+  doc.setPlacement(in, {0, 0, 0, 0});
+  doc.setPlacement(no, {100, 40, 90, 0});
+  doc.setPlacement(out, {200, 40, 0, 0});
+
+  using Point = CircuitDocument::PointRecord;
+
+  doc.addSegment(a, std::array<Point, 3>{{{20, 60}, {20, 80}, {80, 80}}});
+  doc.addSegment(o, std::array<Point, 2>{{{180, 60}, {220, 60}}});
+
+  return doc;
+}
+
+void expectSameDocument(const CircuitDocument& a, const CircuitDocument& b)
+{
+  ASSERT_EQ(a.components.size(), b.components.size());
+  ASSERT_EQ(a.nets.size(), b.nets.size());
+  ASSERT_EQ(a.segments.size(), b.segments.size());
+  ASSERT_EQ(a.placements.size(), b.placements.size());
+
+  for (size_t i = 0; i < a.components.size(); i++) {
+    const auto& ca = a.components[i];
+    const auto& cb = b.components[i];
+
+    EXPECT_EQ(a.getTypeName(ca), b.getTypeName(cb));
+    EXPECT_EQ(a.getString(ca.name), b.getString(cb.name));
+    EXPECT_EQ(ca.variant, cb.variant);
+    EXPECT_TRUE(std::ranges::equal(a.getInputs(ca), b.getInputs(cb)));
+    EXPECT_TRUE(std::ranges::equal(a.getOutputs(ca), b.getOutputs(cb)));
+  }
+
+  for (size_t i = 0; i < a.nets.size(); i++) {
+    EXPECT_EQ(a.nets[i].width, b.nets[i].width);
+    EXPECT_EQ(a.getString(a.nets[i].name), b.getString(b.nets[i].name));
+  }
+
+  for (size_t i = 0; i < a.placements.size(); i++) {
+    EXPECT_EQ(a.placements[i].x, b.placements[i].x);
+    EXPECT_EQ(a.placements[i].y, b.placements[i].y);
+    EXPECT_EQ(a.placements[i].rotation, b.placements[i].rotation);
+  }
+
+  for (size_t i = 0; i < a.segments.size(); i++) {
+    EXPECT_EQ(a.segments[i].net, b.segments[i].net);
+    EXPECT_TRUE(
+        std::ranges::equal(a.getPoints(a.segments[i]), b.getPoints(b.segments[i])));
+  }
+}
+}  // namespace
+
+TEST(CircuitFileTest, BinaryRoundTrip)
+{
+  const auto doc  = exampleDocument();
+  const auto data = CircuitFile::encodeBinary(doc);
+
+  EXPECT_TRUE(CircuitFile::isBinary(data));
+
+  const auto decoded = CircuitFile::decodeBinary(data);
+  ASSERT_TRUE(decoded) << decoded.error();
+  expectSameDocument(doc, *decoded);
+}
+
+TEST(CircuitFileTest, TextRoundTrip)
+{
+  const auto doc  = exampleDocument();
+  const auto text = CircuitFile::encodeText(doc);
+
+  const auto decoded = CircuitFile::decodeText(text);
+  ASSERT_TRUE(decoded) << decoded.error();
+  expectSameDocument(doc, *decoded);
+
+  // The text variant must be stable in order to be diffed
+  EXPECT_EQ(CircuitFile::encodeText(*decoded), text);
+}
+
+TEST(CircuitFileTest, NetlistOnly)
+{
+  const auto data    = CircuitFile::encodeBinary(exampleDocument());
+  const auto decoded = CircuitFile::decodeBinary(data, false);
+
+  ASSERT_TRUE(decoded) << decoded.error();
+  EXPECT_EQ(decoded->components.size(), 4);
+  EXPECT_FALSE(decoded->hasGeometry());
+  EXPECT_TRUE(decoded->segments.empty());
+  EXPECT_TRUE(decoded->points.empty());
+}
+
+TEST(CircuitFileTest, MalformedInput)
+{
+  auto data = CircuitFile::encodeBinary(exampleDocument());
+
+  // Truncated file
+  EXPECT_FALSE(CircuitFile::decodeBinary(std::span(data).first(data.size() / 2)));
+
+  // Not a circuit at all
+  const std::string garbage = "garbage";
+  EXPECT_FALSE(CircuitFile::decode(std::as_bytes(std::span(garbage))));
+
+  // Port referencing a net that doesn't exist
+  EXPECT_FALSE(CircuitFile::decodeText("SILICON-CIRCUIT 1\n"
+                                       "component 0 NOT_GATE 0 \"n\" in 3 out -\n"));
+
+  // Unknown records are errors in the text format
+  EXPECT_FALSE(CircuitFile::decodeText("SILICON-CIRCUIT 1\nfoo\n"));
+}
+
+TEST(CircuitFileTest, AdderRecords)
+{
+  // LogiFlow can't place adders: they must survive the file format anyway, to be skipped
+  // when the scene is loaded
+  auto doc = exampleDocument();
+
+  const auto a = doc.addNet(1), b = doc.addNet(1), s = doc.addNet(1), c = doc.addNet(1);
+  const auto adder =
+      doc.addComponent("HALF_ADDER", "ha", 0, std::array{a, b}, std::array{s, c});
+  doc.setPlacement(adder, {300, 0, 0, 0});
+
+  const auto binary = CircuitFile::decodeBinary(CircuitFile::encodeBinary(doc));
+  ASSERT_TRUE(binary) << binary.error();
+  expectSameDocument(doc, *binary);
+
+  const auto text = CircuitFile::decodeText(CircuitFile::encodeText(doc));
+  ASSERT_TRUE(text) << text.error();
+  expectSameDocument(doc, *text);
+
+  EXPECT_EQ(text->getTypeName(text->components[adder]), "HALF_ADDER");
+}
+
+TEST(CircuitFileTest, Subcircuits)
+{
+  CircuitDocument doc;
+
+  auto definition = exampleDocument();
+  definition.name = "Inverter";
+  doc.subcircuits.push_back(definition);
+
+  const auto a = doc.addNet(1);
+  const auto o = doc.addNet(1);
+  doc.addComponent("SUBCIRCUIT", "first", 0, std::array{a}, std::array{o});
+  doc.addComponent("SUBCIRCUIT", "second", 0, std::array{o}, std::array{a});
+
+  const auto binary = CircuitFile::decodeBinary(CircuitFile::encodeBinary(doc));
+  const auto text   = CircuitFile::decodeText(CircuitFile::encodeText(doc));
+
+  for (const auto& decoded : {binary, text}) {
+    ASSERT_TRUE(decoded) << decoded.error();
+    expectSameDocument(doc, *decoded);
+
+    ASSERT_EQ(decoded->subcircuits.size(), 1);
+    EXPECT_EQ(decoded->subcircuits[0].name, "Inverter");
+    expectSameDocument(definition, decoded->subcircuits[0]);
+  }
+
+  EXPECT_EQ(CircuitFile::encodeText(*text), CircuitFile::encodeText(doc));
+
+  // An instance must refer to an existing definition
+  doc.components[1].variant = 1;
+  EXPECT_FALSE(CircuitFile::decodeBinary(CircuitFile::encodeBinary(doc)));
+}
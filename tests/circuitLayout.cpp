@@ -0,0 +1,228 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tests.hpp"
+
+#include <functional>
+#include <map>
+#include <numeric>
+#include <set>
+#include <sstream>
+
+#include <io/circuitLayout.hpp>
+#include <io/netlistImport.hpp>
+
+namespace {
+using Point = CircuitDocument::PointRecord;
+
+// Same port positions as the LogiFlow components
+CircuitLayout::Footprint footprintOf(const std::string_view type, uint32_t)
+{
+  if (type == "SINGLE_INPUT")
+    return {0, 0, 40, 60, {}, {{20, 60}}};
+  if (type == "SINGLE_OUTPUT")
+    return {0, 0, 40, 60, {{20, 60}}, {}};
+  if (type == "NOT_GATE")
+    return {0, 0, 60, 40, {{-20, 20}}, {{80, 20}}};
+  if (type.ends_with("_GATE"))
+    return {0, 0, 60, 40, {{-20, 10}, {-20, 30}}, {{80, 20}}};
+  return {};
+}
+
+Point portPosition(const CircuitDocument& doc, uint32_t c, bool output, uint32_t index)
+{
+  const auto f = footprintOf(doc.getTypeName(doc.components[c]), 0);
+  const auto p = output ? f.outputs[index] : f.inputs[index];
+  return {doc.placements[c].x + p.x, doc.placements[c].y + p.y};
+}
+
+bool onSegment(const Point p, const Point a, const Point b)
+{
+  return std::min(a.x, b.x) <= p.x && p.x <= std::max(a.x, b.x)
+         && std::min(a.y, b.y) <= p.y && p.y <= std::max(a.y, b.y);
+}
+
+// Checks that every net is drawn as a single connected tree of orthogonal lines, touching
+// all of its ports, and that nets don't share any vertex
+void expectValidGeometry(const CircuitDocument& doc, const int32_t grid = 10)
+{
+  ASSERT_EQ(doc.placements.size(), doc.components.size());
+
+  std::map<uint32_t, std::vector<std::pair<Point, Point>>> lines{};
+  std::map<std::pair<int32_t, int32_t>, uint32_t>          vertexNet{};
+
+  for (const auto& s : doc.segments) {
+    const auto points = doc.getPoints(s);
+    ASSERT_EQ(points.size(), 2);
+
+    const auto a = points[0], b = points[1];
+    EXPECT_TRUE(a.x == b.x || a.y == b.y) << "Diagonal segment";
+
+    for (const auto p : points) {
+      EXPECT_EQ(p.x % grid, 0);
+      EXPECT_EQ(p.y % grid, 0);
+
+      const auto [it, inserted] = vertexNet.emplace(std::pair(p.x, p.y), s.net);
+      EXPECT_EQ(it->second, s.net) << "Nets sharing the vertex " << p.x << ", " << p.y;
+    }
+
+    lines[s.net].emplace_back(a, b);
+  }
+
+  // Ports of every net
+  std::map<uint32_t, std::vector<Point>> ports{};
+  for (uint32_t c = 0; c < doc.components.size(); c++) {
+    const auto& component = doc.components[c];
+    for (const auto [i, net] : doc.getInputs(component) | silicon::views::enumerate)
+      ports[net].push_back(portPosition(doc, c, false, i));
+    for (const auto [i, net] : doc.getOutputs(component) | silicon::views::enumerate)
+      ports[net].push_back(portPosition(doc, c, true, i));
+  }
+
+  for (const auto& [net, netPorts] : ports) {
+    const auto& netLines = lines[net];
+
+    // Union-find over the lines of the net
+    std::vector<size_t> parent(netLines.size());
+    std::iota(parent.begin(), parent.end(), 0);
+    const std::function<size_t(size_t)> find = [&](size_t i) {
+      return parent[i] == i ? i : parent[i] = find(parent[i]);
+    };
+
+    for (size_t i = 0; i < netLines.size(); i++) {
+      for (size_t j = 0; j < netLines.size(); j++) {
+        const auto [a, b] = netLines[i];
+        const auto [c, d] = netLines[j];
+        if (onSegment(a, c, d) || onSegment(b, c, d))
+          parent[find(i)] = find(j);
+      }
+    }
+
+    std::set<size_t> roots{};
+    for (const auto port : netPorts) {
+      const auto it = std::ranges::find_if(netLines, [port](const auto& line) {
+        return line.first == port || line.second == port;
+      });
+      ASSERT_NE(it, netLines.end()) << "Port not reached by net " << net;
+      roots.insert(find(it - netLines.begin()));
+    }
+
+    EXPECT_EQ(roots.size(), 1) << "Net " << net << " is split";
+  }
+}
+}  // namespace
+
+TEST(CircuitLayoutTest, FromNetlist)
+{
+  std::istringstream in(R"(
+module m (input a, input b, input c, output y, output z);
+  wire t;
+  and  (t, a, b, c);
+  xnor (y, t, a);
+  buf  (z, t);
+endmodule
+)");
+
+  const auto netlist = NetlistImporter::readVerilog(in);
+  ASSERT_TRUE(netlist) << netlist.error();
+
+  const auto doc = CircuitLayout::fromNetlist(*netlist);
+
+  std::map<std::string_view, int> count{};
+  for (const auto& c : doc.components)
+    count[doc.getTypeName(c)]++;
+
+  // 3-input AND = 2 ANDs, XNOR = XOR + NOT, the buffer disappears
+  EXPECT_EQ(count["SINGLE_INPUT"], 3);
+  EXPECT_EQ(count["SINGLE_OUTPUT"], 2);
+  EXPECT_EQ(count["AND_GATE"], 2);
+  EXPECT_EQ(count["XOR_GATE"], 1);
+  EXPECT_EQ(count["NOT_GATE"], 1);
+  EXPECT_EQ(doc.components.size(), 9);
+  EXPECT_FALSE(doc.hasGeometry());
+}
+
+TEST(CircuitLayoutTest, AdderGeometry)
+{
+  // 4 bit ripple carry adder
+  std::stringstream blif;
+  blif << ".model adder\n.inputs c0";
+  for (int i = 0; i < 4; i++)
+    blif << " a" << i << " b" << i;
+  blif << "\n.outputs c4";
+  for (int i = 0; i < 4; i++)
+    blif << " s" << i;
+  blif << "\n";
+
+  for (int i = 0; i < 4; i++) {
+    blif << ".names a" << i << " b" << i << " c" << i << " s" << i
+         << "\n100 1\n010 1\n001 1\n111 1\n";
+    blif << ".names a" << i << " b" << i << " c" << i << " c" << i + 1
+         << "\n11- 1\n1-1 1\n-11 1\n";
+  }
+
+  const auto netlist = NetlistImporter::readBlif(blif);
+  ASSERT_TRUE(netlist) << netlist.error();
+
+  auto doc = CircuitLayout::fromNetlist(*netlist);
+
+  std::vector<int> reported{};
+  ASSERT_TRUE(CircuitLayout::layout(doc, footprintOf, [&](const int p) {
+    reported.push_back(p);
+    return true;
+  }));
+
+  EXPECT_TRUE(std::ranges::is_sorted(reported));
+  EXPECT_EQ(reported.back(), 100);
+
+  expectValidGeometry(doc);
+
+  // Components don't overlap
+  for (size_t i = 0; i < doc.components.size(); i++) {
+    for (size_t j = i + 1; j < doc.components.size(); j++) {
+      const auto& p = doc.placements[i];
+      const auto& q = doc.placements[j];
+      EXPECT_FALSE(p.x == q.x && std::abs(p.y - q.y) < 40) << i << " " << j;
+    }
+  }
+
+  // The geometry survives the file format
+  const auto decoded = CircuitFile::decodeBinary(CircuitFile::encodeBinary(doc));
+  ASSERT_TRUE(decoded);
+  EXPECT_EQ(decoded->segments.size(), doc.segments.size());
+}
+
+TEST(CircuitLayoutTest, FeedbackAndCancel)
+{
+  // SR latch made of NOR gates
+  std::istringstream in(R"(
+module sr (input s, input r, output q, output nq);
+  nor (q, r, nq);
+  nor (nq, s, q);
+endmodule
+)");
+
+  const auto netlist = NetlistImporter::readVerilog(in);
+  ASSERT_TRUE(netlist) << netlist.error();
+
+  auto doc = CircuitLayout::fromNetlist(*netlist);
+  ASSERT_TRUE(CircuitLayout::layout(doc, footprintOf));
+  expectValidGeometry(doc);
+
+  auto cancelled = CircuitLayout::fromNetlist(*netlist);
+  EXPECT_FALSE(CircuitLayout::layout(cancelled, footprintOf, [](int) { return false; }));
+}
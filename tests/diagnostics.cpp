@@ -0,0 +1,176 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "tests.hpp"
+
+#include <atomic>
+#include <sstream>
+#include <thread>
+
+#include <core/diagnostics.hpp>
+#include <extraComponents/utils.hpp>
+
+namespace {
+// Every test starts from the default settings, with no diagnostics
+class DiagnosticsTest : public testing::Test {
+protected:
+  void SetUp() override { reset(); }
+  void TearDown() override { reset(); }
+
+  static void reset()
+  {
+    Diagnostics::setLevel(Diagnostics::DEFAULT_LEVEL);
+    Diagnostics::setRateLimit(Diagnostics::DEFAULT_RATE_LIMIT);
+    Diagnostics::setCapacity(Diagnostics::DEFAULT_CAPACITY);
+    Diagnostics::clear();
+  }
+};
+}  // namespace
+
+TEST_F(DiagnosticsTest, Levels)
+{
+  int built = 0;
+  const auto message = [&] {
+    built++;
+    return std::string("message");
+  };
+
+  Diagnostics::report(Severity::DEBUG, DiagnosticCode::MISSING_WIRE, message);
+  EXPECT_EQ(built, 0);
+
+  Diagnostics::report(Severity::WARNING, DiagnosticCode::MISSING_WIRE, message);
+  EXPECT_EQ(built, 1);
+
+  Diagnostics::setLevel(Severity::NONE);
+  Diagnostics::report(Severity::ERROR, DiagnosticCode::MISSING_WIRE, message);
+  EXPECT_EQ(built, 1);
+
+  const auto recent = Diagnostics::getRecent();
+  ASSERT_EQ(recent.size(), 1);
+  EXPECT_EQ(Diagnostics::format(recent[0]), "warning: missing-wire: message");
+}
+
+TEST_F(DiagnosticsTest, RingAndRateLimit)
+{
+  Diagnostics::setCapacity(4);
+  Diagnostics::setRateLimit(6);
+
+  for (int i = 0; i < 10; i++)
+    Diagnostics::report(Severity::ERROR, DiagnosticCode::WIDTH_MISMATCH,
+                        [i] { return std::to_string(i); });
+
+  // 6 were kept, the ring holds the last 4 of them
+  EXPECT_EQ(Diagnostics::getSuppressed(), 4);
+
+  const auto recent = Diagnostics::getRecent();
+  ASSERT_EQ(recent.size(), 4);
+  EXPECT_EQ(recent.front().message, "2");
+  EXPECT_EQ(recent.back().message, "5");
+  EXPECT_EQ(recent.back().sequence, 5);
+
+  // Other codes have their own limit
+  Diagnostics::report(Severity::ERROR, DiagnosticCode::MISSING_WIRE, [] { return "x"; });
+  EXPECT_EQ(Diagnostics::getRecent().back().message, "x");
+}
+
+TEST_F(DiagnosticsTest, Sinks)
+{
+  std::ostringstream log{};
+  const auto         id = Diagnostics::addSink(Diagnostics::streamSink(log));
+
+  Diagnostics::report(Severity::ERROR, DiagnosticCode::MISSING_WIRE, [] { return "a"; });
+  Diagnostics::removeSink(id);
+  Diagnostics::report(Severity::ERROR, DiagnosticCode::MISSING_WIRE, [] { return "b"; });
+
+  EXPECT_EQ(log.str(), "error: missing-wire: a\n");
+}
+
+TEST_F(DiagnosticsTest, RemovingWaitsForSinks)
+{
+  std::atomic<bool> inSink  = false;
+  std::atomic<bool> release = false;
+  std::atomic<bool> removed = false;
+
+  const auto id = Diagnostics::addSink([&](const Diagnostic&) {
+    inSink = true;
+    while (!release)
+      std::this_thread::yield();
+  });
+
+  std::thread reporter([] {
+    Diagnostics::report(Severity::ERROR, DiagnosticCode::MISSING_WIRE,
+                        [] { return "a"; });
+  });
+
+  while (!inSink)
+    std::this_thread::yield();
+
+  // The sink is still running in the reporting thread: removing it must wait
+  std::thread remover([&] {
+    Diagnostics::removeSink(id);
+    removed = true;
+  });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_FALSE(removed);
+
+  release = true;
+  remover.join();
+  reporter.join();
+  EXPECT_TRUE(removed);
+}
+
+TEST_F(DiagnosticsTest, ConflictingDrivers)
+{
+  const auto w = std::make_shared<Wire>();
+  w->setCurrentState(State::HIGH, 1);
+  w->setCurrentState(State::LOW, 2);
+
+  EXPECT_EQ(w->getCurrentState(), State::ERROR);
+
+  const auto recent = Diagnostics::getRecent();
+  ASSERT_EQ(recent.size(), 1);
+  EXPECT_EQ(recent[0].code, DiagnosticCode::CONFLICTING_DRIVERS);
+}
+
+TEST_F(DiagnosticsTest, SplitterIsSilent)
+{
+  Diagnostics::setLevel(Severity::DEBUG);
+  testing::internal::CaptureStdout();
+
+  auto a = std::make_shared<Wire>(), b = std::make_shared<Wire>();
+  auto bus = Bus(2);
+  bus.forceSetCurrentValue(1);
+
+  WireSplitter ws(bus, {{a}, {b}});
+  WireMerger   wm({{a}, {b}}, Bus(2));
+  bus.forceSetCurrentValue(2);
+
+  EXPECT_EQ(testing::internal::GetCapturedStdout(), "");
+  EXPECT_TRUE(Diagnostics::getRecent().empty());
+
+  // A splitter of 3 bits with 2 outputs
+  auto         c = std::make_shared<Wire>(), d = std::make_shared<Wire>();
+  const auto   wide = Bus(3);
+  WireSplitter mismatched(wide, {{c}, {d}});
+  wide.forceSetCurrentValue(5);
+
+  const auto recent = Diagnostics::getRecent();
+  ASSERT_FALSE(recent.empty());
+  EXPECT_EQ(recent.back().code, DiagnosticCode::WIDTH_MISMATCH);
+}
@@ -198,3 +198,140 @@ TEST(LogicTest, BusSettingReading)
     EXPECT_EQ(a.getCurrentValue(), i);
   }
 }
+
+TEST(LogicTest, RingOscillator)
+{
+  // x0 = NAND(en, x2), x1 = NOT(x0), x2 = NOT(x1): stable until it's enabled
+  auto en = std::make_shared<Wire>(State::LOW);
+  auto x0 = std::make_shared<Wire>(State::LOW);
+  auto x1 = std::make_shared<Wire>(State::LOW);
+  auto x2 = std::make_shared<Wire>(State::LOW);
+  auto o  = std::make_shared<Wire>();
+
+  auto g0 = std::make_shared<NandGate>(std::vector<Wire_ptr>{en, x2}, x0);
+  auto g1 = std::make_shared<NotGate>(x0, x1);
+  auto g2 = std::make_shared<NotGate>(x1, x2);
+  auto g3 = std::make_shared<NotGate>(x2, o);
+
+  EXPECT_EQ(x2->getCurrentState(), State::HIGH);
+  EXPECT_EQ(o->getCurrentState(), State::LOW);
+
+  en->forceSetCurrentState(State::HIGH);
+
+  for (const auto& w : {x0, x1, x2, o})
+    EXPECT_EQ(w->getCurrentState(), State::ERROR);
+
+  EXPECT_TRUE(x0->isOscillating() || x1->isOscillating() || x2->isOscillating());
+  EXPECT_FALSE(en->isOscillating());
+  EXPECT_FALSE(o->isOscillating());
+
+  // A latch changes its wires again while they are propagating, but it settles
+  auto s  = std::make_shared<Wire>(State::LOW);
+  auto r  = std::make_shared<Wire>(State::LOW);
+  auto q  = std::make_shared<Wire>(State::LOW);
+  auto nq = std::make_shared<Wire>(State::HIGH);
+
+  auto top    = std::make_shared<NorGate>(std::vector<Wire_ptr>{r, nq}, q);
+  auto bottom = std::make_shared<NorGate>(std::vector<Wire_ptr>{s, q}, nq);
+
+  s->forceSetCurrentState(State::HIGH);
+  s->forceSetCurrentState(State::LOW);
+  EXPECT_EQ(q->getCurrentState(), State::HIGH);
+  EXPECT_EQ(nq->getCurrentState(), State::LOW);
+  EXPECT_FALSE(q->isOscillating() || nq->isOscillating());
+}
+
+TEST(LogicTest, LongRingOscillator)
+{
+  // A NAND and an even number of NOTs: every turn of the ring takes the propagation
+  // thousands of changes deeper, the stack must not overflow anyway
+  constexpr int length = 4001;
+
+  auto en   = std::make_shared<Wire>(State::LOW);
+  auto ring = std::vector<Wire_ptr>(length);
+  for (auto& w : ring)
+    w = std::make_shared<Wire>(State::LOW);
+
+  std::vector<Component_ptr> gates{};
+  gates.push_back(
+      std::make_shared<NandGate>(std::vector<Wire_ptr>{en, ring.back()}, ring[0]));
+  for (int i = 1; i < length; i++)
+    gates.push_back(std::make_shared<NotGate>(ring[i - 1], ring[i]));
+
+  en->forceSetCurrentState(State::HIGH);
+
+  EXPECT_TRUE(std::ranges::all_of(ring, [](const Wire_ptr& w) {
+    return w->getCurrentState() == State::ERROR;
+  }));
+  EXPECT_TRUE(std::ranges::any_of(ring, &Wire::isOscillating));
+
+  // An open chain as long is not an oscillation
+  auto chain = std::vector<Wire_ptr>(length);
+  for (auto& w : chain)
+    w = std::make_shared<Wire>(State::LOW);
+
+  for (int i = 1; i < length; i++)
+    gates.push_back(std::make_shared<NotGate>(chain[i - 1], chain[i]));
+
+  chain[0]->forceSetCurrentState(State::HIGH);
+  EXPECT_EQ(chain.back()->getCurrentState(), State::HIGH);
+  EXPECT_FALSE(std::ranges::any_of(chain, &Wire::isOscillating));
+}
+
+TEST(LogicTest, SingleDriver)
+{
+  auto a = std::make_shared<Wire>(State::HIGH);
+  auto b = std::make_shared<Wire>(State::LOW);
+  auto o = std::make_shared<Wire>();
+
+  auto first = std::make_shared<NotGate>(a, o);
+  EXPECT_EQ(o->getCurrentState(), State::LOW);
+
+  // A second driver makes the wire malformed
+  auto second = std::make_shared<NotGate>(b, o);
+  EXPECT_NE(first->getDriverId(), second->getDriverId());
+  EXPECT_EQ(o->getCurrentState(), State::ERROR);
+
+  // Once the first one is gone the wire can be driven by the other
+  first.reset();
+  b->forceSetCurrentState(State::HIGH);
+  EXPECT_EQ(o->getCurrentState(), State::LOW);
+  b->forceSetCurrentState(State::LOW);
+  EXPECT_EQ(o->getCurrentState(), State::HIGH);
+}
+
+TEST(LogicTest, Arena)
+{
+  constexpr size_t length = 100'000;
+
+  CircuitArena arena;
+  {
+    const auto scope = arena.activate();
+    EXPECT_EQ(CircuitArena::current(), &arena);
+
+    // A chain of NOT gates, built from its input so that nothing propagates far
+    std::vector<Wire_ptr>      wires{CircuitArena::make<Wire>(State::HIGH)};
+    std::vector<Component_ptr> gates{};
+    gates.reserve(length);
+
+    for (size_t i = 0; i < length; i++) {
+      wires.push_back(CircuitArena::make<Wire>());
+      gates.push_back(CircuitArena::make<NotGate>(wires[i], wires[i + 1]));
+    }
+
+    EXPECT_EQ(wires.back()->getCurrentState(), State::HIGH);
+    EXPECT_GT(arena.getReservedBytes(), length * (sizeof(Wire) + sizeof(NotGate)));
+
+    Bus bus(8);
+    bus.forceSetCurrentValue(0xA5);
+    EXPECT_EQ(bus.getCurrentValue(), 0xA5);
+
+    // Everything allocated in the arena is destroyed before it
+    EXPECT_GT(arena.getLiveAllocations(), 2 * length);
+    gates.clear();
+    wires.clear();
+  }
+
+  EXPECT_EQ(arena.getLiveAllocations(), 0);
+  EXPECT_EQ(CircuitArena::current(), nullptr);
+}
@@ -0,0 +1,246 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "tests.hpp"
+
+#include <bit>
+#include <numeric>
+#include <sstream>
+
+#include <core/logicAnalysis.hpp>
+#include <io/netlistImport.hpp>
+
+namespace {
+// Ripple carry adder made of XOR/AND/OR gates. Inputs: cin a0 b0 a1 b1 ..., outputs:
+// s0 s1 ... cout
+Netlist gateAdder(const int width)
+{
+  Netlist n;
+
+  NetId carry = n.addNet("cin");
+  n.addPrimaryInput(carry);
+
+  std::vector<NetId> sums{};
+  for (int i = 0; i < width; i++) {
+    const auto a = n.addNet(), b = n.addNet(), s = n.addNet();
+    n.addPrimaryInput(a);
+    n.addPrimaryInput(b);
+
+    const auto half = n.addNet(), generate = n.addNet(), propagate = n.addNet();
+    const auto next = n.addNet();
+    n.addGate(GateType::XOR, std::array{a, b}, half);
+    n.addGate(GateType::AND, std::array{a, b}, generate);
+    n.addGate(GateType::XOR, std::array{half, carry}, s);
+    n.addGate(GateType::AND, std::array{half, carry}, propagate);
+    n.addGate(GateType::OR, std::array{generate, propagate}, next);
+
+    sums.push_back(s);
+    carry = next;
+  }
+
+  for (const NetId s : sums)
+    n.addPrimaryOutput(s);
+  n.addPrimaryOutput(carry);
+
+  EXPECT_TRUE(n.finalize());
+  return n;
+}
+
+// The same adder as sums of products. If `bug` is true the carry of the last bit ignores
+// the carry in when a and b are both 1 (which is right) but also when only b is (which
+// is not)
+Netlist blifAdder(const int width, const bool bug = false)
+{
+  std::stringstream blif;
+  blif << ".model adder\n.inputs c0";
+  for (int i = 0; i < width; i++)
+    blif << " a" << i << " b" << i;
+  blif << "\n.outputs";
+  for (int i = 0; i < width; i++)
+    blif << " s" << i;
+  blif << " c" << width << "\n";
+
+  for (int i = 0; i < width; i++) {
+    blif << ".names a" << i << " b" << i << " c" << i << " s" << i
+         << "\n100 1\n010 1\n001 1\n111 1\n";
+    blif << ".names a" << i << " b" << i << " c" << i << " c" << i + 1 << "\n"
+         << (bug && i == width - 1 ? "-1- 1\n" : "11- 1\n") << "1-1 1\n-11 1\n";
+  }
+
+  auto netlist = NetlistImporter::readBlif(blif);
+  EXPECT_TRUE(netlist) << netlist.error();
+  return std::move(*netlist);
+}
+}  // namespace
+
+TEST(BddTest, Canonicity)
+{
+  BddManager m(3);
+  const auto a = m.variable(0), b = m.variable(1), c = m.variable(2);
+
+  const auto f = m.disjunction(m.conjunction(a, b), m.conjunction(a, c));
+  const auto g = m.conjunction(a, m.disjunction(b, c));
+  EXPECT_EQ(f, g);
+
+  EXPECT_EQ(m.exclusiveOr(f, g), BddManager::ZERO);
+  EXPECT_EQ(m.negate(m.negate(f)), f);
+  EXPECT_EQ(m.disjunction(a, m.negate(a)), BddManager::ONE);
+
+  for (int v = 0; v < 8; v++) {
+    const std::vector values{bool(v & 1), bool(v & 2), bool(v & 4)};
+    EXPECT_EQ(m.evaluate(f, values), values[0] && (values[1] || values[2]));
+  }
+
+  const auto assignment = m.satisfy(f);
+  ASSERT_TRUE(assignment);
+  EXPECT_TRUE(m.evaluate(f, *assignment));
+  EXPECT_FALSE(m.satisfy(BddManager::ZERO));
+}
+
+TEST(BddTest, GarbageCollection)
+{
+  BddManager m(8);
+
+  Bdd kept{};
+  {
+    BddId parity = BddManager::ZERO;
+    BddId all    = BddManager::ONE;
+    for (uint32_t i = 0; i < 8; i++) {
+      parity = m.exclusiveOr(parity, m.variable(i));
+      all    = m.conjunction(all, m.variable(i));
+    }
+    kept = Bdd(m, all);
+  }
+
+  const auto before = m.getNodeCount();
+  EXPECT_GT(m.collectGarbage(), 0);
+  EXPECT_LT(m.getNodeCount(), before);
+
+  // 8 nodes and the terminals
+  EXPECT_EQ(m.getNodeCount(), 10);
+  EXPECT_TRUE(m.evaluate(kept.getId(), std::vector(8, true)));
+
+  // Rebuilding the function gives back the same node
+  BddId all = BddManager::ONE;
+  for (uint32_t i = 0; i < 8; i++)
+    all = m.conjunction(all, m.variable(i));
+  EXPECT_EQ(all, kept.getId());
+
+  kept = {};
+  m.collectGarbage();
+  EXPECT_EQ(m.getNodeCount(), 2);
+}
+
+TEST(LogicAnalysisTest, FullAdderTruthTable)
+{
+  const auto netlist = gateAdder(1);
+
+  const auto table = LogicAnalysis::truthTable(netlist);
+  ASSERT_TRUE(table) << table.error();
+
+  EXPECT_EQ(table->getInputCount(), 3);
+  EXPECT_EQ(table->getOutputCount(), 2);
+  ASSERT_EQ(table->getRowCount(), 8);
+
+  // cin is bit 0, a bit 1, b bit 2
+  for (uint64_t row = 0; row < 8; row++) {
+    const int total = std::popcount(row);
+    EXPECT_EQ(table->get(0, row), total % 2 == 1) << row;
+    EXPECT_EQ(table->get(1, row), total >= 2) << row;
+  }
+
+  EXPECT_EQ(table->getWords(0)[0], 0b10010110);
+  EXPECT_EQ(table->getWords(1)[0], 0b11101000);
+
+  // More than one word per output, the same function as sums of products
+  const auto wide = LogicAnalysis::truthTable(gateAdder(4));
+  ASSERT_TRUE(wide);
+  EXPECT_EQ(wide->getWords(0).size(), 8);
+  EXPECT_EQ(*wide, *LogicAnalysis::truthTable(blifAdder(4)));
+
+  for (uint64_t row = 0; row < wide->getRowCount(); row++) {
+    uint64_t a = 0, b = 0;
+    for (int i = 0; i < 4; i++) {
+      a |= ((row >> (1 + 2 * i)) & 1) << i;
+      b |= ((row >> (2 + 2 * i)) & 1) << i;
+    }
+
+    const auto sum = a + b + (row & 1);
+    for (uint32_t o = 0; o < 5; o++)
+      ASSERT_EQ(wide->get(o, row), bool((sum >> o) & 1)) << row;
+  }
+}
+
+TEST(LogicAnalysisTest, Equivalence)
+{
+  // 65 inputs: too many for a truth table
+  const auto a = gateAdder(32);
+  const auto b = blifAdder(32);
+
+  EXPECT_FALSE(LogicAnalysis::truthTable(a));
+
+  const auto same = LogicAnalysis::checkEquivalence(a, b);
+  ASSERT_TRUE(same) << same.error();
+  EXPECT_TRUE(same->equivalent);
+
+  const auto different = LogicAnalysis::checkEquivalence(a, blifAdder(32, true));
+  ASSERT_TRUE(different) << different.error();
+  ASSERT_FALSE(different->equivalent);
+  EXPECT_EQ(different->output, 32);
+
+  // The counterexample: b31 = 1, and the carry out is wrong
+  const auto& inputs = different->counterexample;
+  ASSERT_EQ(inputs.size(), 65);
+  EXPECT_TRUE(inputs[64]);
+
+  BddManager            m(65);
+  std::vector<uint32_t> variables(65);
+  std::iota(variables.begin(), variables.end(), 0);
+  const auto fa = LogicAnalysis::buildBdds(m, a, variables);
+  const auto fb = LogicAnalysis::buildBdds(m, blifAdder(32, true), variables);
+  ASSERT_TRUE(fa && fb);
+  EXPECT_NE(m.evaluate((*fa)[32].getId(), inputs), m.evaluate((*fb)[32].getId(), inputs));
+
+  EXPECT_FALSE(LogicAnalysis::checkEquivalence(a, gateAdder(31)));
+}
+
+TEST(LogicAnalysisTest, NotCombinational)
+{
+  std::istringstream sr(R"(
+module sr (input s, input r, output q, output nq);
+  nor (q, r, nq);
+  nor (nq, s, q);
+endmodule
+)");
+
+  const auto latch = NetlistImporter::readVerilog(sr);
+  ASSERT_TRUE(latch) << latch.error();
+  EXPECT_FALSE(LogicAnalysis::checkCombinational(*latch));
+  EXPECT_FALSE(LogicAnalysis::truthTable(*latch));
+
+  Netlist n;
+  const auto d = n.addNet("d"), q = n.addNet("q");
+  n.addPrimaryInput(d);
+  n.addPrimaryOutput(q);
+  n.addGate(GateType::DFF, std::array{d}, q);
+  ASSERT_TRUE(n.finalize());
+
+  const auto res = LogicAnalysis::checkCombinational(n);
+  ASSERT_FALSE(res);
+  EXPECT_EQ(res.error(), "The circuit has registers");
+}
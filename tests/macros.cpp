@@ -0,0 +1,336 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "tests.hpp"
+
+#include <random>
+#include <sstream>
+
+#include <core/macros.hpp>
+#include <core/simulator.hpp>
+#include <io/netlistImport.hpp>
+
+namespace {
+struct Adder {
+  Netlist            netlist;
+  std::vector<NetId> a, b, sum;
+  NetId              cin  = Netlist::NO_NET;
+  NetId              cout = Netlist::NO_NET;
+};
+
+// Ripple carry adder made of XOR/AND/OR full adders, the first one is a half adder if
+// `carryIn` is false
+Adder makeAdder(const int width, const bool carryIn)
+{
+  Adder res;
+  auto& n = res.netlist;
+
+  NetId carry = Netlist::NO_NET;
+  if (carryIn) {
+    res.cin = carry = n.addNet("cin");
+    n.addPrimaryInput(carry);
+  }
+
+  for (int i = 0; i < width; i++) {
+    const auto a = n.addNet(), b = n.addNet(), s = n.addNet();
+    n.addPrimaryInput(a);
+    n.addPrimaryInput(b);
+
+    const auto half = n.addNet(), generate = n.addNet(), next = n.addNet();
+    n.addGate(GateType::XOR, std::array{a, b}, half);
+    n.addGate(GateType::AND, std::array{a, b}, generate);
+
+    if (carry == Netlist::NO_NET) {
+      n.addGate(GateType::BUF, std::array{half}, s);
+      n.addGate(GateType::BUF, std::array{generate}, next);
+    } else {
+      const auto propagate = n.addNet();
+      n.addGate(GateType::XOR, std::array{half, carry}, s);
+      n.addGate(GateType::AND, std::array{half, carry}, propagate);
+      n.addGate(GateType::OR, std::array{generate, propagate}, next);
+    }
+
+    n.addPrimaryOutput(s);
+    res.a.push_back(a);
+    res.b.push_back(b);
+    res.sum.push_back(s);
+    carry = next;
+  }
+
+  n.addPrimaryOutput(carry);
+  res.cout = carry;
+
+  EXPECT_TRUE(n.finalize());
+  return res;
+}
+
+void setWord(Simulator& sim, const std::span<const NetId> nets, const uint64_t value)
+{
+  for (size_t i = 0; i < nets.size(); i++)
+    sim.setState(nets[i], (value >> i) & 1 ? State::HIGH : State::LOW);
+}
+
+uint64_t getWord(const Simulator& sim, const std::vector<NetId>& nets)
+{
+  uint64_t res = 0;
+  for (size_t i = 0; i < nets.size(); i++)
+    if (sim.getState(nets[i]) == State::HIGH)
+      res |= uint64_t{1} << i;
+  return res;
+}
+
+void expectSameOutputs(const Netlist& netlist, const Simulator& a, const Simulator& b)
+{
+  for (const NetId out : netlist.getPrimaryOutputs())
+    EXPECT_EQ(a.getState(out), b.getState(out)) << netlist.getNetName(out);
+}
+}  // namespace
+
+TEST(MacroTest, RippleCarryAdder)
+{
+  constexpr int width = 6;
+
+  const auto adder  = makeAdder(width, true);
+  const auto macros = MacroSet::recognize(adder.netlist);
+
+  ASSERT_EQ(macros.getMacros().size(), 1);
+  EXPECT_EQ(macros.getMacros()[0].type, MacroType::ADDER);
+  EXPECT_EQ(macros.getMacros()[0].width, width);
+  EXPECT_EQ(macros.getCoveredGateCount(), adder.netlist.getGateCount());
+
+  Simulator gates(adder.netlist);
+  Simulator words(adder.netlist, macros);
+
+  for (uint64_t a = 0; a < 1 << width; a++) {
+    for (uint64_t b = 0; b < 1 << width; b++) {
+      for (const auto c : {State::LOW, State::HIGH}) {
+        for (Simulator* sim : {&gates, &words}) {
+          setWord(*sim, adder.a, a);
+          setWord(*sim, adder.b, b);
+          sim->setState(adder.cin, c);
+          sim->settle();
+        }
+
+        const uint64_t expected = a + b + (c == State::HIGH);
+        ASSERT_EQ(getWord(words, adder.sum), expected % (1 << width));
+        const auto carry = expected >> width ? State::HIGH : State::LOW;
+        ASSERT_EQ(words.getState(adder.cout), carry);
+        expectSameOutputs(adder.netlist, gates, words);
+      }
+    }
+  }
+}
+
+TEST(MacroTest, LongAdderIsSplit)
+{
+  constexpr int width = 100;
+
+  const auto adder  = makeAdder(width, false);
+  const auto macros = MacroSet::recognize(adder.netlist);
+
+  ASSERT_EQ(macros.getMacros().size(), 2);
+  EXPECT_EQ(macros.getMacros()[0].width + macros.getMacros()[1].width, width);
+
+  Simulator gates(adder.netlist);
+  Simulator words(adder.netlist, macros);
+
+  std::mt19937_64 rng(42);
+  for (int i = 0; i < 200; i++) {
+    for (const auto& nets : {adder.a, adder.b}) {
+      const auto low = rng(), high = rng();
+      for (Simulator* sim : {&gates, &words}) {
+        setWord(*sim, std::span(nets).first(64), low);
+        setWord(*sim, std::span(nets).subspan(64), high);
+      }
+    }
+
+    gates.settle();
+    words.settle();
+    expectSameOutputs(adder.netlist, gates, words);
+  }
+}
+
+TEST(MacroTest, BlifAdder)
+{
+  // Sum of products covers instead of XOR gates
+  std::stringstream blif;
+  blif << ".model adder\n.inputs c0";
+  for (int i = 0; i < 4; i++)
+    blif << " a" << i << " b" << i;
+  blif << "\n.outputs c4";
+  for (int i = 0; i < 4; i++)
+    blif << " s" << i;
+  blif << "\n";
+
+  for (int i = 0; i < 4; i++) {
+    blif << ".names a" << i << " b" << i << " c" << i << " s" << i
+         << "\n100 1\n010 1\n001 1\n111 1\n";
+    blif << ".names a" << i << " b" << i << " c" << i << " c" << i + 1
+         << "\n11- 1\n1-1 1\n-11 1\n";
+  }
+
+  const auto netlist = NetlistImporter::readBlif(blif);
+  ASSERT_TRUE(netlist) << netlist.error();
+
+  const auto macros = MacroSet::recognize(*netlist);
+  ASSERT_EQ(macros.getMacros().size(), 1);
+  EXPECT_EQ(macros.getMacros()[0].type, MacroType::ADDER);
+  EXPECT_EQ(macros.getMacros()[0].width, 4);
+
+  Simulator gates(*netlist);
+  Simulator words(*netlist, macros);
+
+  for (uint64_t v = 0; v < 1 << 9; v++) {
+    for (Simulator* sim : {&gates, &words}) {
+      setWord(*sim, netlist->getPrimaryInputs(), v);
+      sim->settle();
+    }
+    expectSameOutputs(*netlist, gates, words);
+  }
+}
+
+TEST(MacroTest, MuxAndDecoder)
+{
+  Netlist n;
+
+  // 4 bit 2:1 multiplexer
+  const auto sel = n.addNet("sel"), notSel = n.addNet();
+  n.addPrimaryInput(sel);
+  n.addGate(GateType::NOT, std::array{sel}, notSel);
+
+  std::vector<NetId> inputs{sel};
+  for (int i = 0; i < 4; i++) {
+    const auto a = n.addNet(), b = n.addNet(), y = n.addNet();
+    const auto ta = n.addNet(), tb = n.addNet();
+    n.addPrimaryInput(a);
+    n.addPrimaryInput(b);
+    n.addGate(GateType::AND, std::array{a, notSel}, ta);
+    n.addGate(GateType::AND, std::array{b, sel}, tb);
+    n.addGate(GateType::OR, std::array{ta, tb}, y);
+    n.addPrimaryOutput(y);
+    inputs.push_back(a);
+    inputs.push_back(b);
+  }
+
+  // 2-to-4 decoder
+  const auto s0 = n.addNet("s0"), s1 = n.addNet("s1");
+  const auto n0 = n.addNet(), n1 = n.addNet();
+  n.addPrimaryInput(s0);
+  n.addPrimaryInput(s1);
+  n.addGate(GateType::NOT, std::array{s0}, n0);
+  n.addGate(GateType::NOT, std::array{s1}, n1);
+
+  const std::array<std::array<NetId, 2>, 4> terms{
+      {{n0, n1}, {s0, n1}, {n0, s1}, {s0, s1}}};
+  for (const auto& t : terms) {
+    const auto y = n.addNet();
+    n.addGate(GateType::AND, t, y);
+    n.addPrimaryOutput(y);
+  }
+  inputs.push_back(s0);
+  inputs.push_back(s1);
+
+  ASSERT_TRUE(n.finalize());
+
+  const auto macros = MacroSet::recognize(n);
+  ASSERT_EQ(macros.getMacros().size(), 2);
+  EXPECT_EQ(macros.getCoveredGateCount(), n.getGateCount());
+
+  const auto mux = std::ranges::find(macros.getMacros(), MacroType::MUX, &Macro::type);
+  const auto dec =
+      std::ranges::find(macros.getMacros(), MacroType::DECODER, &Macro::type);
+  ASSERT_NE(mux, macros.getMacros().end());
+  ASSERT_NE(dec, macros.getMacros().end());
+  EXPECT_EQ(mux->width, 4);
+  EXPECT_EQ(dec->width, 2);
+
+  Simulator gates(n);
+  Simulator words(n, macros);
+
+  for (uint64_t v = 0; v < uint64_t{1} << inputs.size(); v++) {
+    for (Simulator* sim : {&gates, &words}) {
+      setWord(*sim, inputs, v);
+      sim->settle();
+    }
+    expectSameOutputs(n, gates, words);
+  }
+}
+
+TEST(MacroTest, ErrorInputsFallBackToGates)
+{
+  const auto adder  = makeAdder(8, true);
+  const auto macros = MacroSet::recognize(adder.netlist);
+  ASSERT_FALSE(macros.empty());
+
+  Simulator gates(adder.netlist);
+  Simulator words(adder.netlist, macros);
+
+  for (Simulator* sim : {&gates, &words}) {
+    setWord(*sim, adder.a, 0x0F);
+    setWord(*sim, adder.b, 0x00);
+    sim->setState(adder.cin, State::LOW);
+    sim->setState(adder.b[5], State::ERROR);
+    sim->settle();
+  }
+
+  // The bits below the ERROR are still known
+  EXPECT_EQ(words.getState(adder.sum[0]), State::HIGH);
+  EXPECT_EQ(words.getState(adder.sum[5]), State::ERROR);
+  expectSameOutputs(adder.netlist, gates, words);
+
+  for (Simulator* sim : {&gates, &words}) {
+    sim->setState(adder.b[5], State::HIGH);
+    sim->settle();
+  }
+
+  EXPECT_EQ(getWord(words, adder.sum), 0x2F);
+  expectSameOutputs(adder.netlist, gates, words);
+}
+
+TEST(MacroTest, VerifyMode)
+{
+  const auto adder  = makeAdder(8, true);
+  const auto macros = MacroSet::recognize(adder.netlist);
+  ASSERT_EQ(macros.getMacros().size(), 1);
+
+  Simulator checked(adder.netlist, macros, Simulator::MacroMode::VERIFY);
+
+  std::mt19937_64 rng(7);
+  for (int i = 0; i < 100; i++) {
+    setWord(checked, adder.a, rng());
+    setWord(checked, adder.b, rng());
+    checked.setState(adder.cin, rng() & 1 ? State::HIGH : State::LOW);
+    checked.settle();
+  }
+
+  EXPECT_TRUE(checked.getMacroMismatches().empty());
+
+  // A wrong macro: two sum bits are swapped
+  auto wrong = macros.getMacros()[0];
+  std::swap(wrong.outputs[0], wrong.outputs[1]);
+  const MacroSet tampered(adder.netlist, {wrong});
+
+  Simulator broken(adder.netlist, tampered, Simulator::MacroMode::VERIFY);
+  setWord(broken, adder.a, 1);
+  setWord(broken, adder.b, 0);
+  broken.setState(adder.cin, State::LOW);
+  broken.settle();
+
+  ASSERT_FALSE(broken.getMacroMismatches().empty());
+  EXPECT_EQ(broken.getMacroMismatches()[0], 0);
+}
@@ -0,0 +1,641 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tests.hpp"
+
+#include <filesystem>
+#include <sstream>
+
+#include <core/netlist.hpp>
+#include <core/netlistOptimizer.hpp>
+#include <core/simulator.hpp>
+#include <io/netlistImport.hpp>
+#include <io/simulationCheckpoint.hpp>
+
+namespace {
+std::vector<NetId> nets(const Netlist& netlist, std::initializer_list<const char*> names)
+{
+  std::vector<NetId> res{};
+  for (const auto name : names) {
+    res.push_back(netlist.findNet(name));
+    EXPECT_NE(res.back(), Netlist::NO_NET) << name;
+  }
+  return res;
+}
+
+// Compares the primary outputs of the two netlists for every assignment of LOW, HIGH and
+// ERROR to the primary inputs, clocking them `cycles` times
+void expectEquivalent(const Netlist& original, const NetlistOptimizer::Result& optimized,
+                      const int cycles = 0)
+{
+  const auto& inputs = original.getPrimaryInputs();
+  ASSERT_LE(inputs.size(), 8);
+
+  size_t combinations = 1;
+  for (size_t i = 0; i < inputs.size(); i++)
+    combinations *= 3;
+
+  constexpr std::array states{State::LOW, State::HIGH, State::ERROR};
+
+  for (size_t v = 0; v < combinations; v++) {
+    Simulator a(original);
+    Simulator b(optimized.netlist);
+
+    auto digits = v;
+    for (const NetId n : inputs) {
+      a.setState(n, states[digits % 3]);
+      b.setState(optimized.netMap[n], states[digits % 3]);
+      digits /= 3;
+    }
+
+    for (int c = 0; c <= cycles; c++) {
+      a.settle();
+      b.settle();
+
+      for (const NetId n : original.getPrimaryOutputs())
+        ASSERT_EQ(a.getState(n), b.getState(optimized.netMap[n]))
+            << original.getNetName(n) << ", inputs " << v << ", cycle " << c;
+
+      a.clock();
+      b.clock();
+    }
+  }
+}
+}  // namespace
+
+TEST(NetlistTest, FanoutAndDrivers)
+{
+  Netlist netlist;
+
+  const auto a = netlist.addNet("a");
+  const auto b = netlist.addNet("b");
+  const auto o = netlist.addNet("o");
+  const auto n = netlist.addNet();
+
+  netlist.addPrimaryInput(a);
+  netlist.addPrimaryInput(b);
+
+  const auto g0 = netlist.addGate(GateType::AND, std::array{a, a, b}, n);
+  const auto g1 = netlist.addGate(GateType::NOT, std::array{n}, o);
+
+  ASSERT_TRUE(netlist.finalize());
+
+  EXPECT_EQ(netlist.getDriver(a), Netlist::NO_GATE);
+  EXPECT_EQ(netlist.getDriver(n), g0);
+  EXPECT_EQ(netlist.getDriver(o), g1);
+
+  EXPECT_TRUE(std::ranges::equal(netlist.getFanout(a), std::array{g0}));
+  EXPECT_TRUE(std::ranges::equal(netlist.getFanout(n), std::array{g1}));
+  EXPECT_TRUE(netlist.getFanout(o).empty());
+
+  netlist.addGate(GateType::BUF, std::array{b}, o);
+  EXPECT_FALSE(netlist.finalize()) << "Multiple drivers must be detected";
+}
+
+TEST(NetlistTest, LongNetNames)
+{
+  Netlist netlist;
+
+  const std::string longName(70 * 1024, 'n');
+
+  const auto a = netlist.addNet("a");
+  const auto l = netlist.addNet(longName);
+  const auto b = netlist.addNet("b");
+  const auto c = netlist.addNet(std::string(100, 'c'));
+
+  EXPECT_EQ(netlist.getNetName(a), "a");
+  EXPECT_EQ(netlist.getNetName(l), longName);
+  EXPECT_EQ(netlist.getNetName(b), "b");
+  EXPECT_EQ(netlist.getNetName(c), std::string(100, 'c'));
+  EXPECT_EQ(netlist.findNet("b"), b);
+}
+
+TEST(NetlistTest, BlifFullAdder)
+{
+  std::istringstream in(R"(
+# Full adder
+.model fa
+.inputs a b \
+        cin
+.outputs s cout
+.names a b cin s
+100 1
+010 1
+001 1
+111 1
+.names a b cin cout
+11- 1
+1-1 1
+-11 1
+.end
+)");
+
+  const auto netlist = NetlistImporter::readBlif(in);
+  ASSERT_TRUE(netlist) << netlist.error();
+
+  const auto inputs  = nets(*netlist, {"a", "b", "cin"});
+  const auto outputs = nets(*netlist, {"s", "cout"});
+
+  Simulator sim(*netlist);
+
+  for (uint64_t v = 0; v < 8; v++) {
+    sim.setValue(inputs, v);
+    sim.settle();
+
+    const auto sum = std::popcount(v);
+    EXPECT_EQ(sim.getValue(outputs), sum) << "a b cin = " << v;
+  }
+}
+
+TEST(NetlistTest, BlifLatchesAndConstants)
+{
+  // 2-bit counter, with an inverted reset value for q1
+  std::istringstream in(R"(
+.model counter
+.outputs q0 q1 one
+.latch d0 q0 re clk 0
+.latch d1 q1 1
+.names q0 d0
+0 1
+.names q0 q1 d1
+01 1
+10 1
+.names one
+1
+)");
+
+  const auto netlist = NetlistImporter::readBlif(in);
+  ASSERT_TRUE(netlist) << netlist.error();
+
+  const auto q   = nets(*netlist, {"q0", "q1"});
+  const auto one = netlist->findNet("one");
+
+  Simulator sim(*netlist);
+  EXPECT_EQ(sim.getState(one), State::HIGH);
+
+  for (uint64_t i = 0; i < 8; i++) {
+    EXPECT_EQ(sim.getValue(q), (i + 2) % 4);
+    sim.clock();
+  }
+}
+
+TEST(NetlistTest, VerilogPrimitivesAndAssign)
+{
+  std::istringstream in(R"(
+`timescale 1ns/1ps
+// 2 bit comparator
+module cmp (input [1:0] a, input [1:0] b, output eq, output [1:0] x);
+  wire [1:0] d;
+  /* Gate primitives */
+  xnor g0 (d[0], a[0], b[0]);
+  xnor (d[1], a[1], b[1]);
+  and  g2 (eq, d[0], d[1]);
+  assign x = a ^ ~{b[1], 1'b1} | 2'b00;
+endmodule
+)");
+
+  const auto netlist = NetlistImporter::readVerilog(in);
+  ASSERT_TRUE(netlist) << netlist.error();
+
+  const auto a  = nets(*netlist, {"a[0]", "a[1]"});
+  const auto b  = nets(*netlist, {"b[0]", "b[1]"});
+  const auto x  = nets(*netlist, {"x[0]", "x[1]"});
+  const auto eq = netlist->findNet("eq");
+
+  EXPECT_EQ(netlist->getPrimaryInputs().size(), 4);
+  EXPECT_EQ(netlist->getPrimaryOutputs().size(), 3);
+
+  Simulator sim(*netlist);
+
+  for (uint64_t va = 0; va < 4; va++) {
+    for (uint64_t vb = 0; vb < 4; vb++) {
+      sim.setValue(a, va);
+      sim.setValue(b, vb);
+      sim.settle();
+
+      EXPECT_EQ(sim.getState(eq), va == vb ? State::HIGH : State::LOW);
+      EXPECT_EQ(sim.getValue(x), (va ^ ~((vb & 2) | 1)) & 3);
+    }
+  }
+}
+
+TEST(NetlistTest, VerilogYosysCells)
+{
+  std::istringstream in(R"(
+module top(clk, s, a, b, q);
+  input clk;
+  input s;
+  input a;
+  input b;
+  output q;
+  wire m;
+  (* src = "top.v:7" *)
+  \$_MUX_  _0_ ( .A(a), .B(b), .S(s), .Y(m) );
+  \$_DFF_P_  _1_ ( .C(clk), .D(m), .Q(q) );
+endmodule
+)");
+
+  const auto netlist = NetlistImporter::readVerilog(in);
+  ASSERT_TRUE(netlist) << netlist.error();
+
+  const auto in3 = nets(*netlist, {"s", "a", "b"});
+  const auto q   = netlist->findNet("q");
+
+  Simulator sim(*netlist);
+  EXPECT_EQ(sim.getState(q), State::ERROR);
+
+  for (uint64_t v = 0; v < 8; v++) {
+    sim.setValue(in3, v);
+    sim.settle();
+    sim.clock();
+
+    const bool s = v & 1, a = v & 2, b = v & 4;
+    EXPECT_EQ(sim.getState(q), (s ? b : a) ? State::HIGH : State::LOW);
+  }
+}
+
+TEST(NetlistTest, MalformedNetlists)
+{
+  std::istringstream twoDrivers(".model m\n.inputs a\n"
+                                ".names a y\n1 1\n"
+                                ".names a y\n0 1\n");
+  EXPECT_FALSE(NetlistImporter::readBlif(twoDrivers));
+
+  std::istringstream badCover(".model m\n.inputs a b\n.names a b y\n1 1\n");
+  EXPECT_FALSE(NetlistImporter::readBlif(badCover));
+
+  std::istringstream subckt(".model m\n.subckt other a=b\n");
+  EXPECT_FALSE(NetlistImporter::readBlif(subckt));
+
+  std::istringstream hierarchy(
+      "module m(a, y); input a; output y; sub u0(a, y); endmodule");
+  const auto res = NetlistImporter::readVerilog(hierarchy);
+  ASSERT_FALSE(res);
+  EXPECT_TRUE(res.error().starts_with("line 1"));
+
+  std::istringstream unterminated("module m(a); input a;");
+  EXPECT_FALSE(NetlistImporter::readVerilog(unterminated));
+
+  // Widths are bounded instead of allocating their bits
+  std::istringstream wideVector("module m(a); input [2000000000:0] a; endmodule");
+  EXPECT_FALSE(NetlistImporter::readVerilog(wideVector));
+
+  std::istringstream wideNumber(
+      "module m(y); output y; assign y = 4000000000'b0; endmodule");
+  EXPECT_FALSE(NetlistImporter::readVerilog(wideNumber));
+
+  std::istringstream wideSelect(
+      "module m(a, y); input [1:0] a; output y; assign y = a[2000000000:0]; endmodule");
+  EXPECT_FALSE(NetlistImporter::readVerilog(wideSelect));
+}
+
+TEST(NetlistTest, VerilogRangeLimits)
+{
+  // A range ending at the largest int doesn't overflow the loops on its bits
+  std::istringstream in(R"(
+module m(input [2147483647:2147483646] a, output [1:0] y);
+  assign y = a;
+endmodule
+)");
+
+  const auto netlist = NetlistImporter::readVerilog(in);
+  ASSERT_TRUE(netlist) << netlist.error();
+
+  const auto a = nets(*netlist, {"a[2147483646]", "a[2147483647]"});
+  const auto y = nets(*netlist, {"y[0]", "y[1]"});
+
+  Simulator sim(*netlist);
+  sim.setValue(a, 2);
+  sim.settle();
+  EXPECT_EQ(sim.getValue(y), 2);
+}
+
+TEST(NetlistTest, LargeChainImport)
+{
+  // A long inverter chain: the import must not depend on recursion or per-gate objects
+  constexpr int length = 100000;
+
+  std::stringstream blif;
+  blif << ".model chain\n.inputs n0\n.outputs n" << length << "\n";
+  for (int i = 0; i < length; i++)
+    blif << ".names n" << i << " n" << i + 1 << "\n0 1\n";
+
+  const auto netlist = NetlistImporter::readBlif(blif);
+  ASSERT_TRUE(netlist) << netlist.error();
+  EXPECT_EQ(netlist->getGateCount(), length);
+
+  Simulator sim(*netlist);
+  const auto input  = netlist->getPrimaryInputs()[0];
+  const auto output = netlist->getPrimaryOutputs()[0];
+
+  EXPECT_EQ(sim.getState(output), State::LOW);
+  sim.setState(input, State::HIGH);
+  sim.settle();
+  EXPECT_EQ(sim.getState(output), State::HIGH);
+}
+
+TEST(NetlistOptimizerTest, RedundantLogic)
+{
+  std::istringstream in(R"(
+module m (input a, input b, input c, output y, output z, output w);
+  wire t1, t2, t3, t4, na, nb, one, unused;
+  or   (t1, a, b);
+  not  (na, a);
+  not  (nb, b);
+  nand (t2, na, nb);       // t1 again
+  not  (t3, t2);
+  not  (t4, t3);           // t2 again
+  assign one = 1'b1;
+  and  (y, t4, one, c);    // the constant doesn't matter
+  xor  (z, t1, c);
+  and  (unused, a, b, c);
+  buf  (w, a);
+endmodule
+)");
+
+  const auto netlist = NetlistImporter::readVerilog(in);
+  ASSERT_TRUE(netlist) << netlist.error();
+
+  const auto optimized = NetlistOptimizer::optimize(*netlist);
+  const auto& report   = optimized.report;
+
+  // OR, AND, XOR (the inverters are absorbed in the OR) and the buffer keeping the net
+  // of w apart from the one of a
+  EXPECT_EQ(report.gatesBefore, netlist->getGateCount());
+  EXPECT_EQ(report.gatesAfter, 5) << to_str(report);
+  EXPECT_EQ(report.duplicates, 1);
+  EXPECT_EQ(report.dead, 1);
+  EXPECT_GE(report.constants, 1);
+
+  // Every port is still there, with its name
+  for (const auto name : {"a", "b", "c", "y", "z", "w"})
+    EXPECT_NE(optimized.netlist.findNet(name), Netlist::NO_NET) << name;
+
+  EXPECT_EQ(optimized.netMap[netlist->findNet("unused")], Netlist::NO_NET);
+
+  expectEquivalent(*netlist, optimized);
+}
+
+TEST(NetlistOptimizerTest, ErrorsArePreserved)
+{
+  Netlist netlist;
+
+  const auto a = netlist.addNet("a"), b = netlist.addNet("b");
+  const auto zero = netlist.addNet(), na = netlist.addNet();
+  const auto y = netlist.addNet("y"), z = netlist.addNet("z");
+
+  netlist.addPrimaryInput(a);
+  netlist.addPrimaryInput(b);
+  netlist.addGate(GateType::CONST0, {}, zero);
+  netlist.addGate(GateType::NOT, std::array{a}, na);
+  netlist.addGate(GateType::AND, std::array{a, zero, b}, y);  // ERROR if a or b is
+  netlist.addGate(GateType::XOR, std::array{a, a, b}, z);     // Not just b
+  netlist.addPrimaryOutput(y);
+  netlist.addPrimaryOutput(z);
+  ASSERT_TRUE(netlist.finalize());
+
+  const auto exact = NetlistOptimizer::optimize(netlist);
+  expectEquivalent(netlist, exact);
+
+  // Without the ERROR state, y is a constant and z is b
+  const auto folded = NetlistOptimizer::optimize(netlist, {.preserveErrors = false});
+  const auto driver = folded.netlist.getDriver(folded.netMap[y]);
+  ASSERT_NE(driver, Netlist::NO_GATE);
+  EXPECT_EQ(folded.netlist.getGateType(driver), GateType::CONST0);
+  EXPECT_LT(folded.report.gatesAfter, exact.report.gatesAfter);
+
+  Simulator sim(folded.netlist);
+  sim.setState(folded.netMap[a], State::HIGH);
+  sim.setState(folded.netMap[b], State::HIGH);
+  sim.settle();
+  EXPECT_EQ(sim.getState(folded.netMap[z]), State::HIGH);
+}
+
+TEST(NetlistOptimizerTest, SequentialAndLoops)
+{
+  // A counter enabled by a NOR latch, with its next state computed twice
+  std::istringstream in(R"(
+.model m
+.inputs s r unused
+.outputs q q0 q1
+.names r nq q
+00 1
+.names s q nq
+00 1
+.names q0 q d0
+01 1
+10 1
+.names q1 d0 d1
+01 1
+10 1
+.names d0 q1 d1b
+10 1
+01 1
+.latch d0 q0 0
+.latch d1b q1 0
+.latch d1 q2 1
+)");
+
+  const auto netlist = NetlistImporter::readBlif(in);
+  ASSERT_TRUE(netlist) << netlist.error();
+
+  const auto optimized = NetlistOptimizer::optimize(*netlist);
+
+  // The latch is kept, d1 is merged with d1b and q2 is never read
+  EXPECT_EQ(optimized.report.duplicates, 1);
+  EXPECT_EQ(optimized.report.dead, 1);
+  EXPECT_LT(optimized.report.gatesAfter, netlist->getGateCount());
+  EXPECT_NE(optimized.netlist.findNet("q"), Netlist::NO_NET);
+
+  expectEquivalent(*netlist, optimized, 4);
+}
+
+TEST(NetlistTest, OscillationsAreBroken)
+{
+  std::istringstream in(R"(
+module m (input en, input s, input r, output x2, output y, output q);
+  wire x0, x1, nq;
+  nand (x0, en, x2);
+  not  (x1, x0);
+  not  (x2, x1);
+  not  (y, x2);
+  nor  (q, r, nq);
+  nor  (nq, s, q);
+endmodule
+)");
+
+  auto netlist = NetlistImporter::readVerilog(in);
+  ASSERT_TRUE(netlist) << netlist.error();
+
+  const auto ring = nets(*netlist, {"x0", "x1", "x2"});
+  for (const NetId n : ring)
+    netlist->setInitialState(n, State::LOW);
+  netlist->setInitialState(netlist->findNet("q"), State::LOW);
+  netlist->setInitialState(netlist->findNet("nq"), State::HIGH);
+
+  // The ring and the latch
+  const auto loops = netlist->getCombinationalLoops();
+  ASSERT_EQ(loops.size(), 2);
+  EXPECT_EQ(loops[0].size() + loops[1].size(), 5);
+  EXPECT_EQ(netlist->getCombinationalOrder().size(), 1);
+
+  const auto [en, s, r, y, q] = std::array{
+      netlist->findNet("en"), netlist->findNet("s"), netlist->findNet("r"),
+      netlist->findNet("y"), netlist->findNet("q")};
+
+  Simulator sim(*netlist);
+  sim.setIterationLimit(50);
+  ASSERT_EQ(sim.getLoops().size(), 2);
+
+  sim.setState(en, State::LOW);
+  sim.setState(s, State::HIGH);
+  sim.setState(r, State::LOW);
+  sim.settle();
+  EXPECT_EQ(sim.getState(y), State::LOW);
+  EXPECT_EQ(sim.getState(q), State::HIGH);
+  EXPECT_TRUE(sim.getOscillations().empty());
+
+  sim.setState(en, State::HIGH);
+  sim.settle();
+
+  for (const NetId n : ring)
+    EXPECT_EQ(sim.getState(n), State::ERROR);
+  EXPECT_EQ(sim.getState(y), State::ERROR);
+
+  ASSERT_EQ(sim.getOscillations().size(), 1);
+  const auto& loop = sim.getLoops()[sim.getOscillations()[0]];
+  EXPECT_NE(std::ranges::find(loop, netlist->getDriver(ring[0])), loop.end());
+
+  // The latch is not affected
+  sim.setState(s, State::LOW);
+  sim.settle();
+  EXPECT_EQ(sim.getState(q), State::HIGH);
+
+  sim.reset();
+  EXPECT_TRUE(sim.getOscillations().empty());
+}
+
+TEST(NetlistTest, DeepLogicIntoLatch)
+{
+  // A chain deeper than the iteration limit sets a latch: the latch settles in a few waves
+  // and isn't oscillating, whichever wave of the settle it's evaluated in
+  for (int depth = 20; depth < 40; depth++) {
+    Netlist netlist;
+
+    const auto s  = netlist.addNet("s");
+    const auto r  = netlist.addNet("r");
+    const auto q  = netlist.addNet("q");
+    const auto nq = netlist.addNet("nq");
+
+    netlist.addPrimaryInput(s);
+    netlist.addPrimaryInput(r);
+    netlist.setInitialState(s, State::LOW);
+    netlist.setInitialState(r, State::LOW);
+    netlist.setInitialState(q, State::LOW);
+    netlist.setInitialState(nq, State::HIGH);
+
+    NetId end = s;
+    for (int i = 0; i < depth; i++) {
+      const auto next = netlist.addNet();
+      netlist.addGate(GateType::BUF, std::array{end}, next);
+      end = next;
+    }
+
+    netlist.addGate(GateType::NOR, std::array{r, nq}, q);
+    netlist.addGate(GateType::NOR, std::array{end, q}, nq);
+    ASSERT_TRUE(netlist.finalize());
+
+    Simulator sim(netlist);
+    sim.setIterationLimit(10);
+    ASSERT_EQ(sim.getLoops().size(), 1);
+
+    sim.setState(s, State::HIGH);
+    sim.settle();
+
+    EXPECT_EQ(sim.getState(q), State::HIGH) << depth;
+    EXPECT_EQ(sim.getState(nq), State::LOW) << depth;
+    EXPECT_TRUE(sim.getOscillations().empty()) << depth;
+  }
+}
+
+TEST(NetlistTest, Checkpoint)
+{
+  // 8 bit counter
+  Netlist            n;
+  std::vector<NetId> q{};
+
+  NetId carry = n.addNet("one");
+  n.setInitialState(carry, State::HIGH);
+  n.addPrimaryInput(carry);
+
+  for (int i = 0; i < 8; i++) {
+    const auto bit = n.addNet(), d = n.addNet(), next = n.addNet();
+    n.setInitialState(bit, State::LOW);
+    n.addGate(GateType::DFF, std::array{d}, bit);
+    n.addGate(GateType::XOR, std::array{bit, carry}, d);
+    n.addGate(GateType::AND, std::array{bit, carry}, next);
+    q.push_back(bit);
+    carry = next;
+  }
+  ASSERT_TRUE(n.finalize());
+
+  Simulator warmUp(n);
+  for (int i = 0; i < 100; i++)
+    warmUp.clock();
+
+  const auto path =
+      (std::filesystem::temp_directory_path() / "silicon_checkpoint.bin").string();
+  ASSERT_TRUE(SimulationCheckpoint::save(path, warmUp));
+
+  const auto snapshot = SimulationCheckpoint::load(path, n);
+  std::filesystem::remove(path);
+  ASSERT_TRUE(snapshot) << snapshot.error();
+  EXPECT_EQ(snapshot->cycle, 100);
+
+  // Several simulations forked from the same state
+  for (int fork = 1; fork <= 3; fork++) {
+    Simulator sim(n);
+    ASSERT_TRUE(sim.restore(*snapshot));
+    EXPECT_EQ(sim.getValue(q), 100);
+
+    for (int i = 0; i < fork; i++)
+      sim.clock();
+    EXPECT_EQ(sim.getValue(q), 100 + fork);
+    EXPECT_EQ(sim.getCycle(), 100 + fork);
+  }
+
+  // The gates still scheduled are saved too: stopping the counter
+  warmUp.setState(n.findNet("one"), State::LOW);
+  const auto data      = SimulationCheckpoint::encode(warmUp);
+  const auto unsettled = SimulationCheckpoint::decode(data, n);
+  ASSERT_TRUE(unsettled) << unsettled.error();
+
+  Simulator sim(n);
+  ASSERT_TRUE(sim.restore(*unsettled));
+  sim.settle();
+  sim.clock();
+  EXPECT_EQ(sim.getValue(q), 100);
+
+  // A checkpoint of another circuit is refused
+  Netlist other;
+  const auto a = other.addNet(), y = other.addNet();
+  other.addGate(GateType::NOT, std::array{a}, y);
+  ASSERT_TRUE(other.finalize());
+
+  EXPECT_FALSE(SimulationCheckpoint::decode(data, other));
+  EXPECT_FALSE(SimulationCheckpoint::decode({}, n));
+}
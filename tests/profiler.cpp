@@ -0,0 +1,128 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "tests.hpp"
+
+#include <sstream>
+
+#include <core/activityProfiler.hpp>
+#include <core/simulator.hpp>
+
+TEST(ProfilerTest, Components)
+{
+  // a -> NOT -> b -> NOT -> c, and c AND a
+  auto a = std::make_shared<Wire>(State::LOW);
+  auto b = std::make_shared<Wire>();
+  auto c = std::make_shared<Wire>();
+  auto d = std::make_shared<Wire>();
+
+  auto first  = std::make_shared<NotGate>(a, b);
+  auto second = std::make_shared<NotGate>(b, c);
+  auto both   = std::make_shared<AndGate>(std::vector<Wire_ptr>{a, c}, d);
+
+  ActivityProfiler profiler;
+  profiler.start();
+  EXPECT_EQ(ActivityProfiler::current(), &profiler);
+
+  a->forceSetCurrentState(State::HIGH);
+  a->forceSetCurrentState(State::LOW);
+  a->forceSetCurrentState(State::HIGH);
+
+  profiler.stop();
+  EXPECT_EQ(d->getCurrentState(), State::HIGH);
+
+  // Not recorded
+  a->forceSetCurrentState(State::LOW);
+
+  EXPECT_EQ(profiler.getEvaluations(first.get()), 3);
+  EXPECT_EQ(profiler.getEvaluations(second.get()), 3);
+  EXPECT_EQ(profiler.getToggles(a.get()), 3);
+  EXPECT_EQ(profiler.getToggles(c.get()), 3);
+
+  // The AND is evaluated when a changes and when c does
+  EXPECT_EQ(profiler.getEvaluations(both.get()), 6);
+  EXPECT_EQ(profiler.getMaxEvaluations(), 6);
+
+  // a, b, c, then d (which only changes once per pair of changes of its inputs)
+  const auto& deltas = profiler.getEventsPerDelta();
+  ASSERT_GE(deltas.size(), 3);
+  EXPECT_EQ(deltas[0], 3);
+  EXPECT_EQ(deltas[1], 3);
+
+  const auto types = profiler.getTypes();
+  ASSERT_EQ(types.size(), 2);
+  for (const auto& t : types) {
+    EXPECT_EQ(t.components, t.type == "Not" ? 2 : 1);
+    EXPECT_EQ(t.evaluations, 6);
+  }
+
+  std::ostringstream csv;
+  profiler.writeCsv(csv);
+  EXPECT_NE(csv.str().find("type,0,"), std::string::npos);
+  EXPECT_NE(csv.str().find("delta,0,,3,"), std::string::npos);
+
+  std::ostringstream json;
+  profiler.writeJson(json);
+  EXPECT_NE(json.str().find("\"eventsPerDelta\": [3, 3"), std::string::npos);
+
+  profiler.clear();
+  EXPECT_EQ(profiler.getEvaluations(first.get()), 0);
+}
+
+TEST(ProfilerTest, Simulator)
+{
+  Netlist    n;
+  const auto a = n.addNet("a"), b = n.addNet("b"), c = n.addNet("c");
+  n.addPrimaryInput(a);
+  n.addGate(GateType::NOT, std::array{a}, b);
+  n.addGate(GateType::AND, std::array{a, b}, c);
+  n.addPrimaryOutput(c);
+  ASSERT_TRUE(n.finalize());
+
+  Simulator plain(n);
+  Simulator profiled(n);
+  EXPECT_EQ(profiled.getProfile(), nullptr);
+
+  profiled.setProfiling(true);
+  ASSERT_NE(profiled.getProfile(), nullptr);
+
+  for (const auto s : {State::LOW, State::HIGH, State::LOW}) {
+    for (auto* sim : {&plain, &profiled}) {
+      sim->setState(a, s);
+      sim->settle();
+    }
+    EXPECT_EQ(plain.getStates(), profiled.getStates());
+  }
+
+  const auto& profile = *profiled.getProfile();
+  EXPECT_EQ(profile.netToggles[a], 3);
+  EXPECT_EQ(profile.netToggles[b], 3);
+  EXPECT_EQ(profile.gateEvaluations[0], 3);
+
+  // The AND is scheduled by a and by b in the same wave: it's only evaluated once
+  EXPECT_EQ(profile.gateEvaluations[1], 3);
+  EXPECT_EQ(profile.typeEvaluations[static_cast<size_t>(GateType::AND)], 3);
+  EXPECT_EQ(profile.eventsPerDelta, (std::vector<uint64_t>{2, 2, 2}));
+
+  std::ostringstream csv;
+  profile.writeCsv(csv, n);
+  EXPECT_NE(csv.str().find("net,0,a,3,"), std::string::npos);
+
+  profiled.setProfiling(false);
+  EXPECT_EQ(profiled.getProfile(), nullptr);
+}
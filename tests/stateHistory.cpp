@@ -0,0 +1,164 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "tests.hpp"
+
+#include <random>
+
+#include <core/simulator.hpp>
+#include <core/stateHistory.hpp>
+
+namespace {
+struct Counter {
+  Netlist            netlist;
+  std::vector<NetId> q;
+};
+
+// Counter made of DFFs and half adders, incremented at every clock
+Counter makeCounter(const int width)
+{
+  Counter res;
+  auto&   n = res.netlist;
+
+  NetId carry = n.addNet("one");
+  n.setInitialState(carry, State::HIGH);
+  n.addPrimaryInput(carry);
+
+  for (int i = 0; i < width; i++) {
+    const auto q = n.addNet(), d = n.addNet(), next = n.addNet();
+    n.setInitialState(q, State::LOW);
+    n.addGate(GateType::DFF, std::array{d}, q);
+    n.addGate(GateType::XOR, std::array{q, carry}, d);
+    n.addGate(GateType::AND, std::array{q, carry}, next);
+    n.addPrimaryOutput(q);
+    res.q.push_back(q);
+    carry = next;
+  }
+
+  EXPECT_TRUE(n.finalize());
+  return res;
+}
+}  // namespace
+
+TEST(StateHistoryTest, StepBackAndForward)
+{
+  const auto counter = makeCounter(8);
+
+  Simulator    sim(counter.netlist);
+  StateHistory history;
+  history.record(sim);
+
+  for (int i = 0; i < 100; i++) {
+    sim.clock();
+    history.record(sim);
+  }
+
+  EXPECT_EQ(history.getFirstStep(), 0);
+  EXPECT_EQ(history.getLastStep(), 100);
+
+  for (int i = 0; i < 10; i++) {
+    ASSERT_TRUE(history.stepBack());
+    history.apply(sim);
+  }
+  EXPECT_EQ(history.getCurrentStep(), 90);
+  EXPECT_EQ(sim.getValue(counter.q), 90);
+
+  // 90 -> 89 only changes the nets of the two lowest bits
+  ASSERT_TRUE(history.stepBack());
+  EXPECT_LT(history.getChanged().size(), counter.netlist.getNetCount() / 2);
+  history.apply(sim);
+  EXPECT_EQ(sim.getValue(counter.q), 89);
+
+  ASSERT_TRUE(history.stepForward());
+  history.apply(sim);
+  EXPECT_EQ(sim.getValue(counter.q), 90);
+
+  // The simulation goes on from the restored step, overwriting the following ones
+  sim.clock();
+  history.record(sim);
+  EXPECT_EQ(sim.getValue(counter.q), 91);
+  EXPECT_EQ(history.getLastStep(), 91);
+  EXPECT_FALSE(history.stepForward());
+
+  EXPECT_TRUE(history.jumpTo(0));
+  EXPECT_FALSE(history.stepBack());
+}
+
+TEST(StateHistoryTest, JumpToCycle)
+{
+  constexpr int width = 10;
+
+  const auto counter = makeCounter(width);
+
+  Simulator    sim(counter.netlist);
+  StateHistory history(StateHistory::DEFAULT_BUDGET, 16);
+  history.record(sim);
+
+  for (int i = 0; i < 1000; i++) {
+    sim.clock();
+    history.record(sim);
+  }
+
+  std::mt19937 rng(3);
+  for (int i = 0; i < 200; i++) {
+    const uint64_t step = rng() % 1001;
+    ASSERT_TRUE(history.jumpTo(step));
+    history.apply(sim);
+    ASSERT_EQ(history.getCurrentStep(), step);
+    ASSERT_EQ(sim.getValue(counter.q), step % (1 << width));
+  }
+
+  EXPECT_FALSE(history.jumpTo(1001));
+}
+
+TEST(StateHistoryTest, MemoryBudget)
+{
+  const auto counter = makeCounter(16);
+
+  constexpr size_t budget = 4096;
+
+  Simulator    sim(counter.netlist);
+  StateHistory history(budget, 8);
+  history.record(sim);
+
+  for (int i = 0; i < 1000; i++) {
+    sim.clock();
+    history.record(sim);
+    ASSERT_LE(history.getMemoryUsage(), budget);
+  }
+
+  // The oldest steps were dropped
+  const auto first = history.getFirstStep();
+  EXPECT_GT(first, 0);
+  EXPECT_EQ(history.getLastStep(), 1000);
+  EXPECT_FALSE(history.jumpTo(first - 1));
+
+  ASSERT_TRUE(history.jumpTo(first));
+  history.apply(sim);
+  EXPECT_EQ(sim.getValue(counter.q), first);
+
+  const auto middle = (first + history.getLastStep()) / 2;
+  ASSERT_TRUE(history.jumpTo(middle));
+  history.apply(sim);
+  EXPECT_EQ(sim.getValue(counter.q), middle);
+
+  // A smaller budget drops the steps before the current one
+  history.setBudget(0);
+  EXPECT_EQ(history.getFirstStep(), middle);
+  EXPECT_TRUE(history.stepForward());
+}
@@ -0,0 +1,197 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "tests.hpp"
+
+#include <sstream>
+
+#include <core/gates.hpp>
+#include <core/simulator.hpp>
+#include <core/stimulus.hpp>
+#include <io/netlistImport.hpp>
+#include <io/stimulusFile.hpp>
+
+namespace {
+// 4 bit ripple carry adder as sums of products
+Netlist adderNetlist()
+{
+  std::stringstream blif;
+  blif << ".model adder\n.inputs c0";
+  for (int i = 0; i < 4; i++)
+    blif << " a" << i << " b" << i;
+  blif << "\n.outputs s0 s1 s2 s3 c4\n";
+
+  for (int i = 0; i < 4; i++) {
+    blif << ".names a" << i << " b" << i << " c" << i << " s" << i
+         << "\n100 1\n010 1\n001 1\n111 1\n";
+    blif << ".names a" << i << " b" << i << " c" << i << " c" << i + 1
+         << "\n11- 1\n1-1 1\n-11 1\n";
+  }
+
+  auto netlist = NetlistImporter::readBlif(blif);
+  EXPECT_TRUE(netlist) << netlist.error();
+  return std::move(*netlist);
+}
+
+SubcircuitDefinition::Port port(const Netlist& netlist, const std::string& name,
+                                std::initializer_list<const char*> nets)
+{
+  SubcircuitDefinition::Port res{name, {}};
+  for (const auto net : nets)
+    res.nets.push_back(netlist.findNet(net));
+  return res;
+}
+}  // namespace
+
+TEST(StimulusTest, Script)
+{
+  std::istringstream in(R"(
+# Two steps and a half
+@10  a=0x3 b=0b01   # comment
+     cin=1
++5   a[2]=1 b=x
+@0   cin=0
+)");
+
+  const auto stimulus = StimulusFile::read(in);
+  ASSERT_TRUE(stimulus) << stimulus.error();
+
+  const auto& assignments = stimulus->getAssignments();
+  ASSERT_EQ(assignments.size(), 6);
+  EXPECT_EQ(assignments[0].time, 10);
+  EXPECT_EQ(assignments[0].input, "a");
+  EXPECT_EQ(assignments[0].value, 3);
+  EXPECT_EQ(assignments[2].time, 10);
+  EXPECT_EQ(assignments[3].time, 15);
+  EXPECT_EQ(assignments[3].mask, 4);
+  EXPECT_EQ(assignments[3].value, 4);
+  EXPECT_TRUE(assignments[4].error);
+  EXPECT_EQ(assignments[5].time, 0);
+
+  // The same assignments, sorted by time
+  std::stringstream out;
+  StimulusFile::write(out, *stimulus);
+
+  const auto again = StimulusFile::read(out);
+  ASSERT_TRUE(again) << again.error();
+  ASSERT_EQ(again->getAssignments().size(), assignments.size());
+  EXPECT_EQ(again->getAssignments()[0].input, "cin");
+  EXPECT_EQ(again->getAssignments()[0].time, 0);
+  EXPECT_EQ(again->getAssignments()[4].mask, 4);
+  EXPECT_TRUE(again->getAssignments()[5].error);
+
+  for (const auto bad : {"a", "@1 a=1 +2 b=0", "a=0xg", "a[1]=2", "@t a=1", "=1"}) {
+    std::istringstream badIn(bad);
+    EXPECT_FALSE(StimulusFile::read(badIn)) << bad;
+  }
+}
+
+TEST(StimulusTest, Netlist)
+{
+  const auto netlist = adderNetlist();
+
+  const std::vector inputs{port(netlist, "a", {"a0", "a1", "a2", "a3"}),
+                           port(netlist, "b", {"b0", "b1", "b2", "b3"}),
+                           port(netlist, "cin", {"c0"})};
+  const auto       sum = port(netlist, "s", {"s0", "s1", "s2", "s3", "c4"});
+
+  Stimulus stimulus;
+  stimulus.set(0, "a", 0);
+  stimulus.set(0, "b", 0);
+  stimulus.set(0, "cin", 0);
+  for (uint64_t t = 1; t < 256; t++) {
+    stimulus.set(t, "a", t & 0xF);
+    stimulus.set(t, "b", t >> 4);
+  }
+  stimulus.setBit(256, "a", 3, State::HIGH);
+  stimulus.set(257, "cin", 1);
+
+  const auto program = stimulus.compile(std::array<std::string, 3>{"a", "b", "cin"},
+                                        std::array<size_t, 3>{4, 4, 1});
+  ASSERT_TRUE(program) << program.error();
+  EXPECT_EQ(program->size(), 258);
+
+  // Replayed many times without compiling it again
+  Simulator sim(netlist);
+  for (int run = 0; run < 10; run++) {
+    sim.reset();
+
+    uint64_t steps = 0;
+    program->run(sim, inputs, [&](const uint64_t time) {
+      const uint64_t a   = sim.getValue(inputs[0].nets);
+      const uint64_t b   = sim.getValue(inputs[1].nets);
+      const uint64_t cin = sim.getValue(inputs[2].nets);
+
+      ASSERT_EQ(time, steps++);
+      ASSERT_EQ(sim.getValue(sum.nets), a + b + cin) << time;
+    });
+
+    EXPECT_EQ(steps, 258);
+  }
+
+  // The last step of 255 + bit 3 of a + carry in
+  EXPECT_EQ(sim.getValue(sum.nets), 0xF + 0xF + 1);
+
+  Stimulus wrong;
+  wrong.set(0, "c", 1);
+  EXPECT_FALSE(wrong.run(sim, inputs));
+
+  Stimulus tooLarge;
+  tooLarge.set(0, "a", 0x10);
+  EXPECT_FALSE(tooLarge.run(sim, inputs));
+
+  Stimulus noBit;
+  noBit.setBit(0, "cin", 1, State::HIGH);
+  EXPECT_FALSE(noBit.run(sim, inputs));
+}
+
+TEST(StimulusTest, Buses)
+{
+  // 2 bit input made of single bit ports, and a 2 bit bus ANDed with it
+  auto a0 = std::make_shared<Wire>(State::LOW);
+  auto a1 = std::make_shared<Wire>(State::LOW);
+  auto b  = Bus(2);
+  auto y0 = std::make_shared<Wire>();
+  auto y1 = std::make_shared<Wire>();
+
+  auto g0 = AndGate({a0, b[0]}, y0);
+  auto g1 = AndGate({a1, b[1]}, y1);
+
+  const std::vector<TestBench::BusPort> inputs{
+      {"a[0]", Bus({a0})}, {"a[1]", Bus({a1})}, {"b", b}};
+
+  std::istringstream in(R"(
+@0  a=0b11 b=0b01
+@1  a[0]=0 b[1]=1
+@2  a=x
+)");
+  const auto stimulus = StimulusFile::read(in);
+  ASSERT_TRUE(stimulus) << stimulus.error();
+
+  std::vector<std::pair<State, State>> outputs{};
+  const auto                           steps = stimulus->run(inputs, [&](uint64_t) {
+    outputs.emplace_back(y0->getCurrentState(), y1->getCurrentState());
+  });
+
+  ASSERT_TRUE(steps) << steps.error();
+  EXPECT_EQ(*steps, 3);
+  ASSERT_EQ(outputs.size(), 3);
+  EXPECT_EQ(outputs[0], std::pair(State::HIGH, State::LOW));
+  EXPECT_EQ(outputs[1], std::pair(State::LOW, State::HIGH));
+  EXPECT_EQ(outputs[2], std::pair(State::ERROR, State::ERROR));
+}
@@ -0,0 +1,137 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tests.hpp"
+
+#include <io/circuitCompiler.hpp>
+
+namespace {
+CircuitDocument halfAdder()
+{
+  CircuitDocument doc;
+  doc.name = "HalfAdder";
+
+  const auto a = doc.addNet(1), b = doc.addNet(1);
+  const auto s = doc.addNet(1), c = doc.addNet(1);
+
+  doc.addComponent("SINGLE_INPUT", "a", 0, {}, std::array{a});
+  doc.addComponent("SINGLE_INPUT", "b", 0, {}, std::array{b});
+  doc.addComponent("XOR_GATE", "Xor", 0, std::array{a, b}, std::array{s});
+  doc.addComponent("AND_GATE", "And", 0, std::array{a, b}, std::array{c});
+  doc.addComponent("SINGLE_OUTPUT", "s", 0, std::array{s}, {});
+  doc.addComponent("SINGLE_OUTPUT", "c", 0, std::array{c}, {});
+
+  return doc;
+}
+}  // namespace
+
+TEST(SubcircuitTest, SharedDefinition)
+{
+  const auto def = CircuitCompiler::compile(halfAdder(), "HalfAdder");
+  ASSERT_TRUE(def) << def.error();
+
+  ASSERT_EQ((*def)->getInputs().size(), 2);
+  ASSERT_EQ((*def)->getOutputs().size(), 2);
+  EXPECT_EQ((*def)->getInputs()[1].name, "b");
+  EXPECT_EQ((*def)->getNetlist().getGateCount(), 2);
+
+  std::vector<std::shared_ptr<Subcircuit>> instances{};
+  for (int i = 0; i < 4; i++)
+    instances.push_back(std::make_shared<Subcircuit>(*def));
+
+  // One definition, many states
+  EXPECT_EQ(def->use_count(), 5);
+
+  const auto a = std::make_shared<Wire>(State::LOW);
+  const auto b = std::make_shared<Wire>(State::LOW);
+  const auto s = std::make_shared<Wire>();
+  const auto c = std::make_shared<Wire>();
+
+  instances[0]->setInputs({Bus{a}, Bus{b}});
+  instances[0]->setOutputs({Bus{s}, Bus{c}});
+
+  a->forceSetCurrentState(State::HIGH);
+  EXPECT_EQ(s->getCurrentState(), State::HIGH);
+  EXPECT_EQ(c->getCurrentState(), State::LOW);
+
+  b->forceSetCurrentState(State::HIGH);
+  EXPECT_EQ(s->getCurrentState(), State::LOW);
+  EXPECT_EQ(c->getCurrentState(), State::HIGH);
+
+  // The other instances are untouched
+  auto sum = instances[1]->getOutputs()[0];
+  EXPECT_EQ(sum[0]->getCurrentState(), State::ERROR);
+}
+
+TEST(SubcircuitTest, NestedAndSplitters)
+{
+  // 2 bit adder without carry in: a bus is split into the inputs of two half adders
+  CircuitDocument doc;
+  doc.subcircuits.push_back(halfAdder());
+
+  const auto a = doc.addNet(1), bus = doc.addNet(1);
+  const auto b0 = doc.addNet(1), b1 = doc.addNet(1);
+  const auto s0 = doc.addNet(1), c0 = doc.addNet(1);
+  const auto s1 = doc.addNet(1), c1 = doc.addNet(1);
+
+  doc.addComponent("SINGLE_INPUT", "a", 0, {}, std::array{a});
+  doc.addComponent("SINGLE_INPUT", "b", 0, {}, std::array{bus});
+  doc.addComponent("WIRE_SPLITTER", "", 2, std::array{bus}, std::array{b0, b1});
+  doc.addComponent("SUBCIRCUIT", "h0", 0, std::array{a, b0}, std::array{s0, c0});
+  doc.addComponent("SUBCIRCUIT", "h1", 0, std::array{c0, b1}, std::array{s1, c1});
+  doc.addComponent("SINGLE_OUTPUT", "s0", 0, std::array{s0}, {});
+  doc.addComponent("SINGLE_OUTPUT", "s1", 0, std::array{s1}, {});
+
+  const auto def = CircuitCompiler::compile(doc, "Adder");
+  ASSERT_TRUE(def) << def.error();
+
+  const auto& netlist = (*def)->getNetlist();
+  const auto& in      = (*def)->getInputs();
+  const auto& out     = (*def)->getOutputs();
+
+  ASSERT_EQ(in[1].nets.size(), 2) << "The width comes from the splitter";
+
+  Simulator sim(netlist);
+  for (uint64_t x = 0; x < 2; x++) {
+    for (uint64_t y = 0; y < 4; y++) {
+      sim.setValue(in[0].nets, x);
+      sim.setValue(in[1].nets, y);
+      sim.settle();
+
+      const uint64_t sum = sim.getValue(out[0].nets) | sim.getValue(out[1].nets) << 1;
+      EXPECT_EQ(sum, (x + y) % 4) << x << " + " << y;
+    }
+  }
+
+  // Conflicting drivers are reported
+  doc.addComponent("NOT_GATE", "Not", 0, std::array{a}, std::array{s1});
+  EXPECT_FALSE(CircuitCompiler::compile(doc, "Broken"));
+}
+
+TEST(SubcircuitTest, PackagesAreShared)
+{
+  const auto first  = CircuitCompiler::package(halfAdder());
+  const auto second = CircuitCompiler::package(halfAdder());
+
+  ASSERT_TRUE(first && second);
+  EXPECT_EQ(*first, *second);
+  EXPECT_EQ((*first)->definition->getName(), "HalfAdder");
+
+  auto other = halfAdder();
+  other.name = "Other";
+  EXPECT_NE(*CircuitCompiler::package(other), *first);
+}
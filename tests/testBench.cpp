@@ -0,0 +1,278 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "tests.hpp"
+
+#include <sstream>
+
+#include <core/simulator.hpp>
+#include <core/testBench.hpp>
+#include <io/netlistImport.hpp>
+#include <io/testVectorFile.hpp>
+
+namespace {
+// 4 bit adder as sums of products. If `bug` is true the carry out is also 1 when b3 is
+// and the other inputs of the last bit are 0.
+Netlist adderNetlist(const bool bug = false)
+{
+  std::stringstream blif;
+  blif << ".model adder\n.inputs c0";
+  for (int i = 0; i < 4; i++)
+    blif << " a" << i << " b" << i;
+  blif << "\n.outputs s0 s1 s2 s3 c4\n";
+
+  for (int i = 0; i < 4; i++) {
+    blif << ".names a" << i << " b" << i << " c" << i << " s" << i
+         << "\n100 1\n010 1\n001 1\n111 1\n";
+    blif << ".names a" << i << " b" << i << " c" << i << " c" << i + 1 << "\n"
+         << (bug && i == 3 ? "-1- 1\n" : "11- 1\n") << "1-1 1\n-11 1\n";
+  }
+
+  auto netlist = NetlistImporter::readBlif(blif);
+  EXPECT_TRUE(netlist) << netlist.error();
+  return std::move(*netlist);
+}
+
+TestBench::Port port(const Netlist& netlist, const std::string& name,
+                     std::initializer_list<const char*> nets)
+{
+  TestBench::Port res{name, {}};
+  for (const auto net : nets) {
+    res.nets.push_back(netlist.findNet(net));
+    EXPECT_NE(res.nets.back(), Netlist::NO_NET) << net;
+  }
+  return res;
+}
+
+TestBench adderBench(const Netlist& netlist)
+{
+  return TestBench(netlist,
+                   {port(netlist, "a", {"a0", "a1", "a2", "a3"}),
+                    port(netlist, "b", {"b0", "b1", "b2", "b3"}),
+                    port(netlist, "cin", {"c0"})},
+                   {port(netlist, "s", {"s0", "s1", "s2", "s3", "c4"})});
+}
+
+void addModel(std::span<const uint64_t> in, std::span<uint64_t> out)
+{
+  out[0] = in[0] + in[1] + in[2];
+}
+}  // namespace
+
+TEST(TestBenchTest, Exhaustive)
+{
+  const auto netlist = adderNetlist();
+  const auto bench   = adderBench(netlist);
+
+  const auto report = bench.exhaustive(addModel, {.threads = 4});
+  ASSERT_TRUE(report) << report.error();
+
+  EXPECT_EQ(report->vectors, 512);
+  EXPECT_EQ(report->mismatches, 0);
+  EXPECT_FALSE(report->firstMismatch);
+  EXPECT_EQ(report->threads, 2);  // 512 vectors are 2 chunks
+  EXPECT_TRUE(report->bitParallel);
+
+  // The model drops the carry in, so every vector with cin = 1 differs
+  const auto noCarry = [](std::span<const uint64_t> in, std::span<uint64_t> out) {
+    out[0] = in[0] + in[1];
+  };
+
+  const auto wrong = bench.exhaustive(noCarry, {.stopAtFirstMismatch = false});
+  ASSERT_TRUE(wrong);
+  EXPECT_EQ(wrong->mismatches, 256);
+  ASSERT_TRUE(wrong->firstMismatch);
+  EXPECT_EQ(wrong->firstMismatch->index, 256);
+  EXPECT_EQ(wrong->firstMismatch->inputs, (std::vector<uint64_t>{0, 0, 1}));
+  EXPECT_EQ(wrong->firstMismatch->actual[0], 1);
+  EXPECT_EQ(wrong->firstMismatch->expected[0], 0);
+
+  EXPECT_FALSE(bench.exhaustive(addModel, {.maxExhaustiveBits = 8}));
+}
+
+TEST(TestBenchTest, BitParallelMatchesSimulator)
+{
+  const auto netlist = adderNetlist(true);
+  const auto bench   = adderBench(netlist);
+  ASSERT_TRUE(bench.isBitParallel());
+
+  const auto words = bench.exhaustive(addModel, {.stopAtFirstMismatch = false});
+  const auto simulated =
+      bench.exhaustive(addModel, {.stopAtFirstMismatch = false, .bitParallel = false});
+  ASSERT_TRUE(words && simulated);
+
+  EXPECT_TRUE(words->bitParallel);
+  EXPECT_FALSE(simulated->bitParallel);
+  EXPECT_EQ(words->mismatches, simulated->mismatches);
+  EXPECT_EQ(words->firstMismatch->index, simulated->firstMismatch->index);
+  EXPECT_EQ(words->firstMismatch->actual, simulated->firstMismatch->actual);
+
+  // Missing an input: the simulator leaves it as it is
+  const auto partial = TestBench(netlist,
+                                 {port(netlist, "a", {"a0", "a1", "a2", "a3"}),
+                                  port(netlist, "b", {"b0", "b1", "b2", "b3"})},
+                                 {port(netlist, "s", {"s0", "s1", "s2", "s3", "c4"})});
+  EXPECT_FALSE(partial.isBitParallel());
+
+  // Registers
+  std::istringstream in(".model r\n.inputs d\n.outputs q\n.latch d q 0\n");
+  const auto registers = NetlistImporter::readBlif(in);
+  ASSERT_TRUE(registers) << registers.error();
+
+  const auto clocked = TestBench(*registers, {port(*registers, "d", {"d"})},
+                                 {port(*registers, "q", {"q"})});
+  EXPECT_FALSE(clocked.isBitParallel());
+
+  const auto identity = [](std::span<const uint64_t> in, std::span<uint64_t> out) {
+    out[0] = in[0];
+  };
+  EXPECT_EQ(clocked.exhaustive(identity, {.cycles = 1})->mismatches, 0);
+  EXPECT_EQ(clocked.exhaustive(identity, {.cycles = 0})->mismatches, 1);
+}
+
+TEST(TestBenchTest, RandomIsDeterministic)
+{
+  const auto netlist = adderNetlist(true);
+  const auto bench   = adderBench(netlist);
+
+  const auto single = bench.random(20000, 42, addModel, {.threads = 1});
+  const auto many   = bench.random(20000, 42, addModel, {.threads = 8});
+  ASSERT_TRUE(single && many);
+
+  // Only wrong if a < 8, b >= 8 and there's no carry into the last bit (about 1 in 8)
+  ASSERT_TRUE(single->firstMismatch);
+  ASSERT_TRUE(many->firstMismatch);
+  EXPECT_EQ(single->firstMismatch->index, many->firstMismatch->index);
+  EXPECT_EQ(single->firstMismatch->inputs, many->firstMismatch->inputs);
+  EXPECT_LT(single->vectors, 20000);
+
+  const auto& inputs = many->firstMismatch->inputs;
+  EXPECT_LT(inputs[0], 8);
+  EXPECT_GE(inputs[1], 8);
+  EXPECT_LT((inputs[0] & 7) + (inputs[1] & 7) + inputs[2], 8);
+
+  const auto all = bench.random(20000, 42, addModel, {.stopAtFirstMismatch = false});
+  ASSERT_TRUE(all);
+  EXPECT_EQ(all->vectors, 20000);
+  EXPECT_GT(all->mismatches, 20000 / 16);
+  EXPECT_LT(all->mismatches, 20000 / 4);
+  EXPECT_EQ(all->firstMismatch->index, single->firstMismatch->index);
+
+  // Another seed, other vectors
+  const auto other = bench.random(20000, 43, addModel);
+  ASSERT_TRUE(other && other->firstMismatch);
+  EXPECT_NE(other->firstMismatch->index, single->firstMismatch->index);
+
+  EXPECT_FALSE(adderBench(adderNetlist()).random(20000, 42, addModel)->firstMismatch);
+}
+
+TEST(TestBenchTest, GoldenFile)
+{
+  const auto netlist = adderNetlist();
+  const auto bench   = adderBench(netlist);
+
+  const std::vector<uint64_t> stimuli = {3, 5, 0, 15, 15, 1, 7, 8, 1, 0, 0, 0};
+
+  const auto recorded = bench.record(stimuli, {});
+  ASSERT_TRUE(recorded) << recorded.error();
+  ASSERT_EQ(recorded->size(), 4);
+  EXPECT_EQ(recorded->outputs, (std::vector<uint64_t>{8, 31, 16, 0}));
+
+  std::stringstream file;
+  TestVectorFile::write(file, *recorded);
+
+  auto golden = TestVectorFile::read(file);
+  ASSERT_TRUE(golden) << golden.error();
+  EXPECT_EQ(golden->inputNames, (std::vector<std::string>{"a", "b", "cin"}));
+  EXPECT_EQ(golden->inputs, stimuli);
+
+  const auto report = bench.golden(*golden);
+  ASSERT_TRUE(report) << report.error();
+  EXPECT_EQ(report->vectors, 4);
+  EXPECT_FALSE(report->firstMismatch);
+
+  // Columns in another order
+  std::istringstream swapped(R"(
+# cin first
+.inputs cin b a
+.outputs s
+1 0b1111 0xF 31
+0 2 3 6   # wrong
+)");
+
+  const auto vectors = TestVectorFile::read(swapped);
+  ASSERT_TRUE(vectors) << vectors.error();
+
+  const auto wrong = bench.golden(*vectors);
+  ASSERT_TRUE(wrong);
+  ASSERT_TRUE(wrong->firstMismatch);
+  EXPECT_EQ(wrong->firstMismatch->index, 1);
+  EXPECT_EQ(wrong->firstMismatch->actual[0], 5);
+
+  std::istringstream malformed(".inputs a b cin\n.outputs s\n1 2 3\n");
+  EXPECT_FALSE(TestVectorFile::read(malformed));
+
+  std::istringstream unknown(".inputs a b c\n.outputs s\n");
+  EXPECT_FALSE(bench.golden(*TestVectorFile::read(unknown)));
+}
+
+TEST(TestBenchTest, InitialState)
+{
+  // 4 bit register toggled by its input at every clock
+  Netlist         n;
+  TestBench::Port a{"a", {}}, q{"q", {}};
+
+  for (int i = 0; i < 4; i++) {
+    const auto in = n.addNet(), bit = n.addNet(), d = n.addNet();
+    n.addPrimaryInput(in);
+    n.addGate(GateType::DFF, std::array{d}, bit);
+    n.addGate(GateType::XOR, std::array{bit, in}, d);
+    a.nets.push_back(in);
+    q.nets.push_back(bit);
+  }
+  ASSERT_TRUE(n.finalize());
+
+  // Warm-up: the register is cleared then set to 5
+  Simulator warmUp(n);
+  for (const NetId bit : q.nets)
+    warmUp.restoreState(bit, State::LOW);
+  warmUp.setValue(a.nets, 5);
+  warmUp.settle();
+  warmUp.clock();
+  ASSERT_EQ(warmUp.getValue(q.nets), 5);
+
+  const auto snapshot = warmUp.save();
+
+  TestBench::Options options{};
+  options.cycles       = 1;
+  options.initialState = &snapshot;
+
+  const TestBench bench(n, {a}, {q});
+  const auto      report = bench.exhaustive(
+      [](const auto in, const auto out) { out[0] = in[0] ^ 5; }, options);
+
+  ASSERT_TRUE(report) << report.error();
+  EXPECT_EQ(report->vectors, 16);
+  EXPECT_EQ(report->mismatches, 0);
+
+  // Without it the register starts in the ERROR state
+  const auto reset = bench.exhaustive(
+      [](const auto in, const auto out) { out[0] = in[0] ^ 5; }, {.cycles = 1});
+  ASSERT_TRUE(reset);
+  EXPECT_GT(reset->mismatches, 0);
+}
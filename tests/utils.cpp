@@ -18,6 +18,7 @@
 
 #include "tests.hpp"
 
+#include <core/gates.hpp>
 #include <extraComponents/utils.hpp>
 
 TEST(UtilsTest, WireMergerCase)
@@ -45,3 +46,84 @@ TEST(UtilsTest, WireSplitterCase)
   EXPECT_EQ(a->getCurrentState(), State::LOW);
   EXPECT_EQ(b->getCurrentState(), State::HIGH);
 }
+
+TEST(UtilsTest, WireSplitterAlias)
+{
+  auto bus = Bus(3);
+  bus.forceSetCurrentValue(5);
+
+  const auto outputs = WireSplitter::aliasOutputs(bus, Bus(3));
+  ASSERT_EQ(outputs.size(), 3);
+  for (unsigned short i = 0; i < 3; i++) {
+    ASSERT_EQ(outputs[i].size(), 1);
+    EXPECT_EQ(outputs[i][0], bus[i]);
+  }
+
+  // A gate on an aliased bit follows the input bus without anything in between
+  auto out = std::make_shared<Wire>();
+  auto g   = NotGate(outputs[1][0], out);
+  EXPECT_EQ(out->getCurrentState(), State::HIGH);
+
+  bus.forceSetCurrentValue(2);
+  EXPECT_EQ(out->getCurrentState(), State::LOW);
+}
+
+TEST(UtilsTest, WireMergerAlias)
+{
+  auto a = std::make_shared<Wire>(State::HIGH);
+  auto b = std::make_shared<Wire>(State::LOW);
+
+  const auto errors = Bus(3);
+
+  // The second input isn't connected: its bit is the one of the errors
+  const std::vector<Bus> inputs{{a}, {}, {b}};
+  const auto             merged = WireMerger::aliasOutput(inputs, errors);
+
+  ASSERT_EQ(merged.size(), 3);
+  EXPECT_EQ(merged[0], a);
+  EXPECT_EQ(merged[1], errors[1]);
+  EXPECT_EQ(merged[2], b);
+
+  // Aliasing again gives the same bus
+  EXPECT_EQ(WireMerger::aliasOutput(inputs, errors), merged);
+
+  b->forceSetCurrentState(State::HIGH);
+  EXPECT_EQ(merged[1]->getCurrentState(), State::ERROR);
+  EXPECT_EQ(merged[2]->getCurrentState(), State::HIGH);
+}
+
+TEST(UtilsTest, AliasMatchesEvaluation)
+{
+  // Splitters that don't fit their input, in both directions
+  for (const auto& [inputSize, outputCount] : {std::pair{3, 2}, std::pair{2, 3}}) {
+    auto input = Bus(inputSize);
+    input.forceSetCurrentValue(1);
+
+    std::vector<Bus> evaluated(outputCount);
+    for (auto& output : evaluated)
+      output = Bus(1);
+
+    auto ws      = WireSplitter(input, evaluated);
+    auto aliased = WireSplitter::aliasOutputs(input, Bus(outputCount));
+
+    ASSERT_EQ(aliased.size(), evaluated.size());
+    for (int i = 0; i < outputCount; i++) {
+      EXPECT_EQ(evaluated[i][0]->getCurrentState(), State::ERROR);
+      EXPECT_EQ(aliased[i][0]->getCurrentState(), evaluated[i][0]->getCurrentState());
+    }
+  }
+
+  // A merger with an unconnected input
+  auto a = std::make_shared<Wire>(State::HIGH);
+  auto b = std::make_shared<Wire>(State::LOW);
+
+  const std::vector<Bus> inputs{{a}, {}, {b}};
+
+  auto evaluated = Bus(3);
+  auto wm        = WireMerger(inputs, evaluated);
+  auto aliased   = WireMerger::aliasOutput(inputs, Bus(3));
+
+  for (unsigned short i = 0; i < 3; i++)
+    EXPECT_EQ(aliased[i]->getCurrentState(), evaluated[i]->getCurrentState());
+  EXPECT_EQ(aliased[1]->getCurrentState(), State::ERROR);
+}
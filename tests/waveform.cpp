@@ -0,0 +1,349 @@
+/*
+  Copyright (C) 2026 Giulio Cocconi
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "tests.hpp"
+
+#include <filesystem>
+#include <sstream>
+
+#include <io/vcd.hpp>
+#include <io/waveform.hpp>
+
+namespace {
+std::string tempPath(const std::string& name)
+{
+  return (std::filesystem::temp_directory_path() / name).string();
+}
+
+struct Change {
+  uint64_t    time;
+  uint32_t    signal;
+  std::string value;
+
+  bool operator==(const Change&) const = default;
+};
+
+std::vector<Change> readChanges(std::istream& vcd, std::vector<WaveformSignal>& signals)
+{
+  std::vector<Change> res{};
+
+  const auto read = VcdReader::read(
+      vcd,
+      [&](const std::span<const WaveformSignal> s) {
+        signals.assign(s.begin(), s.end());
+      },
+      [&](const uint64_t time, const uint32_t signal, const std::string_view value) {
+        res.push_back({time, signal, std::string(value)});
+      });
+
+  EXPECT_TRUE(read) << read.error();
+  return res;
+}
+}  // namespace
+
+TEST(WaveformTest, WriteAndRead)
+{
+  const auto path = tempPath("silicon_waveform.fst");
+
+  {
+    WaveformWriter writer(path);
+    ASSERT_TRUE(writer.isOpen());
+
+    const auto clk   = writer.addSignal("clk");
+    const auto count = writer.addSignal("top.count", 4);
+
+    for (uint64_t t = 0; t < 100; t++) {
+      writer.setTime(t);
+      writer.sample(clk, t % 2 ? State::HIGH : State::LOW);
+
+      const auto value = t / 2 % 16;
+      std::array<State, 4> bits{};
+      for (int i = 0; i < 4; i++)
+        bits[i] = (value >> i) & 1 ? State::HIGH : State::LOW;
+      if (t == 50)
+        bits[3] = State::ERROR;
+
+      writer.sample(count, bits);
+    }
+  }
+
+  WaveformReader reader(path);
+  ASSERT_TRUE(reader.isOpen());
+
+  ASSERT_EQ(reader.getSignals().size(), 2);
+  EXPECT_EQ(reader.getSignals()[0].name, "clk");
+  EXPECT_EQ(reader.getSignals()[1].name, "top.count");
+  EXPECT_EQ(reader.getSignals()[1].width, 4);
+  EXPECT_EQ(reader.getEndTime(), 99);
+
+  EXPECT_EQ(reader.getValue(1, 7), "0011");
+  EXPECT_EQ(reader.getValue(1, 50), "x001");
+
+  // One unit of time per slot: every change is a segment
+  const std::array<uint32_t, 2> both{0, 1};
+  const auto                    exact = reader.load(both, 10, 20, 1);
+  ASSERT_EQ(exact.size(), 2);
+
+  ASSERT_EQ(exact[0].size(), 10);
+  for (size_t i = 0; i < exact[0].size(); i++) {
+    EXPECT_EQ(exact[0][i].start, 10 + i);
+    EXPECT_EQ(exact[0][i].end, 11 + i);
+    EXPECT_EQ(exact[0][i].value, i % 2 ? "1" : "0");
+  }
+
+  ASSERT_EQ(exact[1].size(), 5);
+  EXPECT_EQ(exact[1][0].value, "0101");
+  EXPECT_EQ(exact[1][4].value, "1001");
+  EXPECT_EQ(exact[1][4].end, 20);
+
+  // The clock changes in every unit of time, so it's busy in every slot of 4
+  const std::array<uint32_t, 2> reversed{1, 0};
+  const auto                    coarse = reader.load(reversed, 0, 100, 4);
+
+  ASSERT_EQ(coarse[1].size(), 25);
+  for (const auto& s : coarse[1]) {
+    EXPECT_TRUE(s.value.empty());
+    EXPECT_EQ(s.end - s.start, 4);
+  }
+
+  EXPECT_LE(coarse[0].size(), 3 * 25);
+  EXPECT_EQ(coarse[0].front().start, 0);
+  EXPECT_EQ(coarse[0].back().end, 100);
+
+  std::filesystem::remove(path);
+}
+
+TEST(WaveformTest, BoundedMemory)
+{
+  const auto path = tempPath("silicon_long_waveform.fst");
+
+  constexpr uint64_t cycles = 1'000'000;
+
+  {
+    WaveformWriter writer(path);
+    const auto     clk = writer.addSignal("clk");
+
+    for (uint64_t t = 0; t < cycles; t++) {
+      writer.setTime(t);
+      writer.sample(clk, t % 2 ? State::HIGH : State::LOW);
+    }
+  }
+
+  WaveformReader reader(path);
+  ASSERT_TRUE(reader.isOpen());
+
+  // A million changes on 1000 pixels
+  const std::array<uint32_t, 1> clk{0};
+  const auto                    whole = reader.load(clk, 0, cycles, cycles / 1000);
+  EXPECT_LE(whole[0].size(), 1000);
+
+  // Zooming in on the last cycles
+  const auto tail = reader.load(clk, cycles - 10, cycles, 1);
+  ASSERT_EQ(tail[0].size(), 10);
+  EXPECT_EQ(tail[0].back().value, "1");
+
+  std::filesystem::remove(path);
+}
+
+TEST(WaveformTest, VcdWriteAndRead)
+{
+  std::stringstream vcd{};
+
+  {
+    VcdWriter writer(vcd);
+    const auto a = writer.addSignal("top.a");
+    const auto b = writer.addSignal("top.alu.b", 3);
+    const auto c = writer.addSignal("c");
+
+    writer.setTime(0);
+    writer.sample(a, State::LOW);
+    writer.sample(b, std::array{State::HIGH, State::LOW, State::ERROR});
+    writer.sample(c, "1");
+
+    // Nothing changes at 5, so it isn't written
+    writer.setTime(5);
+    writer.sample(a, State::LOW);
+
+    writer.setTime(10);
+    writer.sample(a, State::HIGH);
+    writer.sample(b, "011");
+  }
+
+  EXPECT_EQ(vcd.str().find("#5"), std::string::npos);
+
+  std::vector<WaveformSignal> signals{};
+  const auto                  changes = readChanges(vcd, signals);
+
+  ASSERT_EQ(signals.size(), 3);
+  EXPECT_EQ(signals[0].name, "top.a");
+  EXPECT_EQ(signals[1].name, "top.alu.b");
+  EXPECT_EQ(signals[1].width, 3);
+  EXPECT_EQ(signals[2].name, "c");
+
+  const std::vector<Change> expected{
+      {0, 0, "0"}, {0, 1, "x01"}, {0, 2, "1"}, {10, 0, "1"}, {10, 1, "011"}};
+  EXPECT_EQ(changes, expected);
+}
+
+TEST(WaveformTest, VcdStreaming)
+{
+  constexpr uint32_t signalCount = 16;
+  constexpr uint64_t cycles      = 1 << 17;
+
+  std::stringstream vcd{};
+
+  {
+    VcdWriter             writer(vcd);
+    std::vector<uint32_t> ids{};
+    for (uint32_t i = 0; i < signalCount; i++)
+      ids.push_back(writer.addSignal("s" + std::to_string(i)));
+
+    for (uint64_t t = 0; t < cycles; t++) {
+      writer.setTime(t);
+      for (const auto id : ids)
+        writer.sample(id, (t >> (id % 2)) & 1 ? State::HIGH : State::LOW);
+    }
+  }
+
+  // Half the signals toggle at every cycle, the other half every 2 cycles
+  uint64_t count = 0, last = 0;
+  const auto read = VcdReader::read(
+      vcd, [](std::span<const WaveformSignal>) {},
+      [&](const uint64_t time, uint32_t, std::string_view) {
+        EXPECT_GE(time, last);
+        last = time;
+        count++;
+      });
+
+  ASSERT_TRUE(read) << read.error();
+  EXPECT_EQ(last, cycles - 1);
+  EXPECT_EQ(count, signalCount / 2 * cycles + signalCount / 2 * cycles / 2);
+}
+
+TEST(WaveformTest, VcdStimulus)
+{
+  // Written by another tool: short vectors, uppercase values and a $dumpvars section
+  std::istringstream vcd(R"($date today $end
+$timescale 1ps $end
+$scope module tb $end
+$var wire 1 ! clk $end
+$scope module dut $end
+$var reg 4 " data [3:0] $end
+$var wire 1 # unused $end
+$upscope $end
+$upscope $end
+$enddefinitions $end
+$dumpvars
+0!
+bX "
+1#
+$end
+#10
+1!
+b11 "
+#20
+0!
+#30
+0#
+#40
+b1010 "
+)");
+
+  const std::vector<std::string> names{"clk", "tb.dut.data", "reset"};
+  const auto                     stimulus = VcdStimulus::read(vcd, names);
+  ASSERT_TRUE(stimulus) << stimulus.error();
+
+  EXPECT_TRUE(stimulus->isDriven(0));
+  EXPECT_TRUE(stimulus->isDriven(1));
+  EXPECT_FALSE(stimulus->isDriven(2));
+
+  // Nothing that was asked for changes at 30
+  ASSERT_EQ(stimulus->size(), 4);
+  EXPECT_EQ(stimulus->getTime(0), 0);
+  EXPECT_EQ(stimulus->getTime(3), 40);
+
+  const std::array<Bus, 3> buses{Bus(1), Bus(4), Bus(1)};
+
+  stimulus->apply(0, buses);
+  EXPECT_EQ(buses[0][0]->getCurrentState(), State::LOW);
+  EXPECT_TRUE(buses[1].isInErrorState());
+
+  stimulus->apply(1, buses);
+  EXPECT_EQ(buses[0][0]->getCurrentState(), State::HIGH);
+  EXPECT_EQ(buses[1].getCurrentValue(), 3);
+
+  stimulus->apply(2, buses);
+  stimulus->apply(3, buses);
+  EXPECT_EQ(buses[0][0]->getCurrentState(), State::LOW);
+  EXPECT_EQ(buses[1].getCurrentValue(), 10);
+
+  // Only the bits that changed are stored
+  EXPECT_EQ(stimulus->getChanges(3).size(), 2);
+
+  std::istringstream missing("$var wire 1 ! x $end $enddefinitions $end #0 1!");
+  EXPECT_FALSE(VcdStimulus::read(missing, names));
+
+  std::istringstream unknown("$var wire 1 ! clk $end $enddefinitions $end #0 1?");
+  EXPECT_FALSE(VcdStimulus::read(unknown, names));
+}
+
+TEST(WaveformTest, FstVcdConversion)
+{
+  const auto path = tempPath("silicon_converted.fst");
+  const auto back = tempPath("silicon_converted_back.fst");
+
+  {
+    WaveformWriter writer(path);
+    const auto     clk  = writer.addSignal("top.clk");
+    const auto     data = writer.addSignal("top.core.data", 8);
+
+    for (uint64_t t = 0; t < 1000; t++) {
+      writer.setTime(t * 5);
+      writer.sample(clk, t % 2 ? State::HIGH : State::LOW);
+
+      std::array<State, 8> bits{};
+      for (int i = 0; i < 8; i++)
+        bits[i] = (t / 3 >> i) & 1 ? State::HIGH : State::LOW;
+      writer.sample(data, bits);
+    }
+  }
+
+  std::stringstream vcd{};
+  const auto        toVcd = WaveformConverter::fstToVcd(path, vcd);
+  ASSERT_TRUE(toVcd) << toVcd.error();
+
+  const auto toFst = WaveformConverter::vcdToFst(vcd, back);
+  ASSERT_TRUE(toFst) << toFst.error();
+
+  WaveformReader original(path), converted(back);
+  ASSERT_TRUE(converted.isOpen());
+
+  ASSERT_EQ(converted.getSignals().size(), 2);
+  EXPECT_EQ(converted.getSignals()[0].name, "top.clk");
+  EXPECT_EQ(converted.getSignals()[1].name, "top.core.data");
+  EXPECT_EQ(converted.getEndTime(), original.getEndTime());
+
+  for (uint64_t t = 0; t < 5000; t += 7)
+    for (uint32_t s = 0; s < 2; s++)
+      ASSERT_EQ(converted.getValue(s, t), original.getValue(s, t)) << s << " " << t;
+
+  EXPECT_FALSE(WaveformConverter::fstToVcd(tempPath("silicon_missing.fst"), vcd));
+
+  std::filesystem::remove(path);
+  std::filesystem::remove(back);
+}